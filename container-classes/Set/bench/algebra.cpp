@@ -0,0 +1,87 @@
+/*
+* Set algebra benchmark for %set.
+*
+* Merges a small delta into a big set and combines two big sets with the
+* join based operations, next to std::set with insert loops and the
+* iterator based std::set_* algorithms. The join based versions fork over
+* subtrees, so they gain on machines with more than one core.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../set.hpp"
+
+template<typename F>
+double measure(F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<int> random_keys(size_t n, std::mt19937 &engine)
+{
+	std::vector<int> keys(n);
+	for(auto &k : keys)
+		k = static_cast<int>(engine() % 4000000);
+
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	return keys;
+}
+
+int
+main (void)
+{
+	std::mt19937 engine{42};
+	std::vector<int> big{random_keys(1000000, engine)}, other{random_keys(1000000, engine)}, delta{random_keys(1000, engine)};
+	bool ok{true};
+
+	auto base{containers::set<int>::from_sorted(big.begin(), big.end())};
+	std::set<int> std_base(big.begin(), big.end());
+
+	std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+	std::cout << "merge " << delta.size() << " keys into " << big.size() << ":" << std::endl;
+	{
+		containers::set<int> s{base}, d{containers::set<int>::from_sorted(delta.begin(), delta.end())};
+		std::cout << "  containers::set, merge(set&&):      " << measure([&] { s.merge(std::move(d)); }) << " ms" << std::endl;
+
+		std::set<int> r{std_base}, rd(delta.begin(), delta.end());
+		std::cout << "  std::set, merge:                    " << measure([&] { r.merge(rd); }) << " ms" << std::endl;
+		ok = ok && s.size() == r.size() && std::equal(s.begin(), s.end(), r.begin());
+	}
+
+	std::cout << big.size() << " keys against " << other.size() << ":" << std::endl;
+	auto rhs{containers::set<int>::from_sorted(other.begin(), other.end())};
+	std::set<int> std_rhs(other.begin(), other.end());
+
+	auto run{[&](const char *name, auto op, auto std_op) {
+		containers::set<int> a{base}, b{rhs}, result;
+		double ms{measure([&] { result = op(std::move(a), std::move(b)); })};
+
+		std::set<int> expected;
+		double std_ms{measure([&] { std_op(std_base.begin(), std_base.end(), std_rhs.begin(), std_rhs.end(),
+				std::inserter(expected, expected.end())); })};
+
+		ok = ok && result.size() == expected.size() && std::equal(result.begin(), result.end(), expected.begin());
+		std::cout << "  " << name << ms << " ms, std::set + std algorithm: " << std_ms << " ms" << std::endl;
+	}};
+
+	using S = containers::set<int>;
+	using It = std::set<int>::const_iterator;
+	using Out = std::insert_iterator<std::set<int>>;
+	run("set_union:        ", [](S a, S b) { return set_union(std::move(a), std::move(b)); }, std::set_union<It, It, Out>);
+	run("set_intersection: ", [](S a, S b) { return set_intersection(std::move(a), std::move(b)); }, std::set_intersection<It, It, Out>);
+	run("set_difference:   ", [](S a, S b) { return set_difference(std::move(a), std::move(b)); }, std::set_difference<It, It, Out>);
+
+	std::cout << "contents match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
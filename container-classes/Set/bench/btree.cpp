@@ -0,0 +1,96 @@
+/*
+* B-tree benchmark, %btree_set next to %set with int keys.
+*
+* For 1e3 to 1e7 keys times random inserts, successful and failed finds,
+* lower_bound and a full iteration, per operation. A larger size can be
+* given on the command line (e.g. 100000000); %set is skipped above 1e7
+* keys, a node per key would not fit in memory on small machines.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../set.hpp"
+#include "../btree_set.hpp"
+
+constexpr size_t set_limit = 10000000;
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints ns per operation for @Set over @keys, returns a checksum of the results.
+*/
+template<typename Set>
+size_t run(const char *name, const std::vector<int> &keys, const std::vector<int> &probes)
+{
+	Set set;
+	size_t sum{0};
+
+	double insert{measure(keys.size(), [&] {
+		for(int k : keys)
+			set.insert(k);
+	})};
+	double hit{measure(keys.size(), [&] {
+		for(int k : keys)
+			sum += set.end() != set.find(k);
+	})};
+	double miss{measure(probes.size(), [&] {
+		for(int k : probes)
+			sum += set.end() != set.find(k | 1);
+	})};
+	double bound{measure(probes.size(), [&] {
+		for(int k : probes)
+		{
+			auto it{set.lower_bound(k | 1)};
+			sum += it != set.end() ? static_cast<size_t>(*it) : 0;
+		}
+	})};
+	double iterate{measure(keys.size(), [&] {
+		for(int k : set)
+			sum += static_cast<size_t>(k);
+	})};
+
+	std::cout << "  " << name << "insert " << insert << ", find " << hit << ", miss " << miss
+		<< ", lower_bound " << bound << ", iterate " << iterate << std::endl;
+
+	return sum;
+}
+
+int
+main (int argc, char *argv[])
+{
+	size_t largest{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : set_limit};
+	bool ok{true};
+
+	std::cout << "ns per operation, int keys, " << containers::btree_set<int>::node_capacity
+		<< " keys per btree_set node:" << std::endl;
+	for(size_t count = 1000; count <= largest; count *= 10)
+	{
+		std::vector<int> keys(count);
+		std::iota(keys.begin(), keys.end(), 0);
+		for(auto &k : keys)
+			k *= 2;
+		std::mt19937 engine{static_cast<unsigned>(count)};
+		std::shuffle(keys.begin(), keys.end(), engine);
+		std::vector<int> probes(keys.begin(), keys.begin() + std::min<size_t>(count, 1000000));
+
+		std::cout << count << " keys:" << std::endl;
+		size_t b{run<containers::btree_set<int>>("containers::btree_set: ", keys, probes)};
+		if(count <= set_limit)
+			ok = ok && b == run<containers::set<int>>("containers::set:       ", keys, probes);
+	}
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+/*
+* Bulk build benchmark for %set.
+*
+* Loads 1e6 sorted keys one insert at a time and through from_sorted(),
+* then copies the result, next to the same operations on std::set.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+template<typename F>
+double measure(F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int
+main (void)
+{
+	std::vector<int> keys(1000000);
+	for(size_t i = 0; i < keys.size(); ++i)
+		keys[i] = static_cast<int>(3 * i);
+
+	bool ok{true};
+	containers::set<int> looped, built;
+	std::set<int> reference;
+
+	std::cout << keys.size() << " sorted keys:" << std::endl;
+	std::cout << "  containers::set, insert loop:   "
+		<< measure([&] { for(const auto &k : keys) looped.insert(k); }) << " ms" << std::endl;
+	std::cout << "  containers::set, from_sorted:   "
+		<< measure([&] { built = containers::set<int>::from_sorted(keys.begin(), keys.end()); }) << " ms" << std::endl;
+	std::cout << "  std::set, range constructor:    "
+		<< measure([&] { reference = std::set<int>(keys.begin(), keys.end()); }) << " ms" << std::endl;
+
+	ok = ok && std::equal(looped.begin(), looped.end(), keys.begin(), keys.end());
+	ok = ok && std::equal(built.begin(), built.end(), keys.begin(), keys.end());
+
+	std::cout << "copy of " << keys.size() << " keys:" << std::endl;
+	std::cout << "  containers::set, copy:          "
+		<< measure([&] { containers::set<int> copy{built}; ok = ok && copy.size() == keys.size(); }) << " ms" << std::endl;
+	std::cout << "  std::set, copy:                 "
+		<< measure([&] { std::set<int> copy{reference}; ok = ok && copy.size() == keys.size(); }) << " ms" << std::endl;
+
+	std::vector<int> odd(keys.size() / 2);
+	for(size_t i = 0; i < odd.size(); ++i)
+		odd[i] = static_cast<int>(6 * i + 1);
+
+	std::cout << "merge of " << odd.size() << " sorted keys:" << std::endl;
+	std::cout << "  containers::set, insert_sorted: "
+		<< measure([&] { built.insert_sorted(odd.begin(), odd.end()); }) << " ms" << std::endl;
+	std::cout << "  std::set, range insert:         "
+		<< measure([&] { reference.insert(odd.begin(), odd.end()); }) << " ms" << std::endl;
+
+	ok = ok && built.size() == reference.size() && std::equal(built.begin(), built.end(), reference.begin());
+	std::cout << "contents match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/*
+* Comparator benchmark, stored stateless and stateful comparators in %set.
+*
+* Prints the size of %set with std::less and with a comparator holding a
+* pointer. Then times insert and find per key for 1e6 random ints with
+* std::less, with a comparator reading a runtime flag and in std::set,
+* and for 2e5 words ordered by a precomputed collation table, once held
+* by the comparator and once read from a global, the only way before
+* comparators were stored.
+*/
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr size_t int_count = 1000000;
+constexpr size_t word_count = 200000;
+
+using table = std::array<unsigned char, 256>;
+
+/*
+* Orders ints ascending or descending, chosen at runtime.
+*/
+struct runtime_order
+{
+	bool descending;
+
+	bool operator()(int a, int b) const { return descending ? b < a : a < b; }
+};
+
+/*
+* Case insensitive order with ties broken by case, from a table built at startup.
+*/
+struct collation
+{
+	const table *weights;
+
+	bool operator()(const std::string &a, const std::string &b) const
+	{
+		return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+				[w = weights](char x, char y) { return (*w)[static_cast<unsigned char>(x)] < (*w)[static_cast<unsigned char>(y)]; });
+	}
+};
+
+static table global_weights;
+
+/*
+* Same order as %collation, stateless, reading the global table.
+*/
+struct global_collation
+{
+	bool operator()(const std::string &a, const std::string &b) const
+	{
+		return collation{&global_weights}(a, b);
+	}
+};
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints ns per insert and find of @keys into @set, returns a checksum.
+*/
+template<typename Set, typename K>
+size_t run(const char *name, Set set, const std::vector<K> &keys)
+{
+	size_t sum{0};
+	double insert{measure(keys.size(), [&] {
+		for(const auto &k : keys)
+			set.insert(k);
+	})};
+	double find{measure(keys.size(), [&] {
+		for(const auto &k : keys)
+			sum += set.end() != set.find(k);
+	})};
+
+	std::cout << "  " << name << "insert " << insert << ", find " << find << std::endl;
+
+	return sum + set.size();
+}
+
+int
+main (void)
+{
+	std::cout << "sizeof containers::set<int>:                " << sizeof(containers::set<int>) << std::endl;
+	std::cout << "sizeof containers::set<int, runtime_order>: " << sizeof(containers::set<int, runtime_order>) << std::endl;
+
+	std::mt19937 engine{17};
+	std::vector<int> ints(int_count);
+	std::iota(ints.begin(), ints.end(), 0);
+	std::shuffle(ints.begin(), ints.end(), engine);
+
+	std::cout << "ns per operation, " << int_count << " ints:" << std::endl;
+	size_t a{run("containers::set, std::less:     ", containers::set<int>{}, ints)};
+	size_t b{run("containers::set, runtime_order: ", containers::set<int, runtime_order>{runtime_order{false}}, ints)};
+	size_t c{run("std::set, std::less:            ", std::set<int>{}, ints)};
+
+	for(int i = 0; i < 256; ++i)
+		global_weights[i] = static_cast<unsigned char>(i);
+	for(int i = 0; i < 26; ++i)
+	{
+		global_weights['A' + i] = static_cast<unsigned char>('A' + 2 * i);
+		global_weights['a' + i] = static_cast<unsigned char>('A' + 2 * i + 1);
+	}
+	table weights{global_weights};
+
+	std::vector<std::string> words(word_count);
+	for(auto &w : words)
+		for(size_t n = 4 + engine() % 8; n > 0; --n)
+			w += static_cast<char>((engine() % 2 ? 'a' : 'A') + engine() % 26);
+
+	std::cout << "ns per operation, " << word_count << " words:" << std::endl;
+	size_t d{run("containers::set, collation:     ", containers::set<std::string, collation>{collation{&weights}}, words)};
+	size_t e{run("containers::set, global table:  ", containers::set<std::string, global_collation>{}, words)};
+	size_t f{run("std::set, collation:            ", std::set<std::string, collation>{collation{&weights}}, words)};
+
+	bool ok{a == b && a == c && d == e && d == f};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/*
+* Concurrent set benchmark.
+*
+* 1 to 64 threads run a mix of 90% lookups, 5% inserts and 5% erases
+* over 1e5 keys, half of which are present at the start, on a
+* %concurrent_set and on a %set behind a std::mutex.
+* The total number of operations is the same for every thread count.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../set.hpp"
+#include "../concurrent_set.hpp"
+
+constexpr int key_range = 100000;
+constexpr size_t total_ops = 1600000;
+
+/*
+* Mutex wrapped %set with the interface of %concurrent_set.
+*/
+class locked_set
+{
+	public:
+		bool insert(int key)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			return set.insert(key).second;
+		}
+
+		bool erase(int key)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			return 0 != set.erase(key);
+		}
+
+		bool contains(int key) const
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			return set.end() != set.find(key);
+		}
+	private:
+		mutable std::mutex mutex;
+		containers::set<int> set;
+};
+
+/*
+* Returns throughput in millions of operations per second.
+*/
+template<typename Set>
+double run(Set &set, size_t threads)
+{
+	for(int k = 0; k < key_range; k += 2)
+		set.insert(k);
+
+	std::vector<std::thread> workers;
+	auto start{std::chrono::steady_clock::now()};
+	for(size_t t = 0; t < threads; ++t)
+		workers.emplace_back([&set, t, threads] {
+			std::mt19937 engine{static_cast<unsigned>(t)};
+			size_t hits{0};
+			for(size_t i = 0; i < total_ops / threads; ++i)
+			{
+				int key{static_cast<int>(engine() % key_range)};
+				unsigned op{static_cast<unsigned>(engine() % 100)};
+				if(op < 5)
+					hits += set.insert(key);
+				else if(op < 10)
+					hits += set.erase(key);
+				else
+					hits += set.contains(key);
+			}
+			volatile size_t sink{hits};
+			(void)sink;
+		});
+
+	for(auto &w : workers)
+		w.join();
+
+	double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+	return total_ops / seconds / 1e6;
+}
+
+int
+main (void)
+{
+	std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+	std::cout << "Mops/s, 90% contains, 5% insert, 5% erase:" << std::endl;
+
+	for(size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		containers::concurrent_set<int> concurrent;
+		locked_set locked;
+
+		double c{run(concurrent, threads)};
+		double l{run(locked, threads)};
+		std::cout << "  threads = " << threads << ":\tconcurrent_set " << c
+			<< ",\tmutex + set " << l << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+* Shard rebalancing benchmark, moving keys between %set shards.
+*
+* 8 shards of 125000 string keys, each round moves the first 10% of every
+* shard to the next one: erase() then insert() of the key, extract() then
+* insert() of the node, and merge() of a split off shard. Prints time and
+* allocations per moved key. operator new is replaced to count them.
+* Then merges a refilled set into a long lived one and erases as many keys
+* for 400 rounds, the slabs they share must stop growing after the first.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr size_t shard_count = 8;
+constexpr size_t shard_size = 125000;
+constexpr size_t rounds = 10;
+constexpr size_t churn_size = 3000;
+constexpr size_t churn_rounds = 400;
+
+static size_t allocations{0};
+
+void* operator new(size_t size)
+{
+	++allocations;
+	if(void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+using shard = containers::set<std::string>;
+
+std::vector<shard> make_shards(void)
+{
+	std::vector<shard> shards(shard_count);
+	for(size_t s = 0; s < shard_count; ++s)
+		for(size_t i = 0; i < shard_size; ++i)
+			shards[s].insert("user:" + std::to_string(s) + ":" + std::to_string(100000000 + i));
+
+	return shards;
+}
+
+/*
+* Runs @move on every pair of neighbouring shards, returns the total size as a check.
+*/
+template<typename Move>
+size_t run(const char *name, Move move)
+{
+	std::vector<shard> shards{make_shards()};
+	size_t moved{0}, before{allocations};
+
+	auto start{std::chrono::steady_clock::now()};
+	for(size_t r = 0; r < rounds; ++r)
+		for(size_t s = 0; s < shard_count; ++s)
+			moved += move(shards[s], shards[(s + 1) % shard_count]);
+	double ns{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()};
+
+	std::cout << "  " << name << ns / moved << " ns, "
+		<< static_cast<double>(allocations - before) / moved << " allocations per key" << std::endl;
+
+	size_t total{0};
+	for(auto &s : shards)
+		total += s.size();
+	return total;
+}
+
+/*
+* Returns whether the slabs shared by repeated merge() reach a fixed size,
+* prints their size after the first rounds and at the end.
+*/
+bool churn(void)
+{
+	containers::set<int> kept, part;
+	for(size_t i = 0; i < churn_size; ++i)
+		kept.insert(static_cast<int>(i));
+
+	size_t warm{0};
+	for(size_t r = 0; r < churn_rounds; ++r)
+	{
+		int fill{static_cast<int>((r + 1) % 2 * churn_size)}, drop{static_cast<int>(r % 2 * churn_size)};
+		for(size_t i = 0; i < churn_size; ++i)
+			part.insert(fill + static_cast<int>(i));
+		kept.merge(part);
+		part.clear();
+		for(size_t i = 0; i < churn_size; ++i)
+			kept.erase(drop + static_cast<int>(i));
+
+		if(4 == r)
+			warm = kept.stats().reserved_bytes;
+	}
+	size_t reserved{kept.stats().reserved_bytes};
+
+	std::cout << "merge of " << churn_size << " keys, " << churn_rounds << " times: " << warm
+		<< " bytes reserved after 5 rounds, " << reserved << " at the end" << std::endl;
+
+	return kept.size() == churn_size && reserved <= warm;
+}
+
+int
+main (void)
+{
+	std::cout << shard_count << " shards of " << shard_size << " keys, moving 10% per round:" << std::endl;
+
+	size_t a{run("erase + insert:    ", [](shard &from, shard &to) {
+		size_t count{from.size() / 10};
+		for(size_t i = 0; i < count; ++i)
+		{
+			std::string key{*from.begin()};
+			from.erase(from.cbegin());
+			to.insert(std::move(key));
+		}
+		return count;
+	})};
+	size_t b{run("extract + insert:  ", [](shard &from, shard &to) {
+		size_t count{from.size() / 10};
+		for(size_t i = 0; i < count; ++i)
+			to.insert(from.extract(from.cbegin()));
+		return count;
+	})};
+	size_t c{run("merge:             ", [](shard &from, shard &to) {
+		size_t count{from.size() / 10};
+		shard part;
+		for(size_t i = 0; i < count; ++i)
+			part.insert(part.cend(), from.extract(from.cbegin()));
+		to.merge(part);
+		return count;
+	})};
+
+	bool ok{a == shard_count * shard_size && a == b && a == c && churn()};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
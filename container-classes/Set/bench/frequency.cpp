@@ -0,0 +1,95 @@
+/*
+* Frequency table benchmark, %counted_set against %multiset, std::multiset
+* and the std::map<std::string, int> of misc/word-counter.
+*
+* Counts 2e6 words drawn from 1e5 distinct ones with a skewed (Zipf like)
+* distribution, then asks the count of every distinct word. %counted_set
+* and std::map keep one node per distinct word, the multisets one node per
+* occurrence. Prints ns per word and per count, and nodes held.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../counted_set.hpp"
+#include "../multiset.hpp"
+
+constexpr size_t distinct = 100000;
+constexpr size_t draws = 2000000;
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints ns per counted word and per count lookup on @table, returns a checksum.
+*/
+template<typename Table, typename Add, typename Count, typename Nodes>
+size_t run(const char *name, Table table, const std::vector<std::string> &words, const std::vector<size_t> &text,
+		Add add, Count count, Nodes nodes)
+{
+	size_t sum{0};
+	double insert{measure(text.size(), [&] {
+		for(size_t i : text)
+			add(table, words[i]);
+	})};
+	double lookup{measure(words.size(), [&] {
+		for(const auto &w : words)
+			sum += count(table, w);
+	})};
+
+	std::cout << "  " << name << "count word " << insert << ", lookup " << lookup
+		<< ", nodes " << nodes(table) << std::endl;
+
+	return sum;
+}
+
+int
+main (void)
+{
+	std::mt19937_64 engine{41};
+	std::vector<std::string> words(distinct);
+	for(auto &w : words)
+		w = "word" + std::to_string(engine());
+
+	// Rank r is drawn with weight 1 / (r + 1), like words in a text
+	std::vector<double> weights(distinct);
+	for(size_t r = 0; r < distinct; ++r)
+		weights[r] = 1.0 / static_cast<double>(r + 1);
+	std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+	std::vector<size_t> text(draws);
+	for(auto &i : text)
+		i = zipf(engine);
+
+	auto size{[](const auto &t) { return t.size(); }};
+
+	std::cout << "ns per operation, " << draws << " words, " << distinct << " distinct:" << std::endl;
+	size_t a{run("containers::counted_set: ", containers::counted_set<std::string>{}, words, text,
+			[](auto &t, const std::string &w) { t.insert(w); },
+			[](const auto &t, const std::string &w) { return t.count(w); },
+			[](const auto &t) { return t.distinct(); })};
+	size_t b{run("containers::multiset:    ", containers::multiset<std::string>{}, words, text,
+			[](auto &t, const std::string &w) { t.insert(w); },
+			[](const auto &t, const std::string &w) { return t.count(w); }, size)};
+	size_t c{run("std::multiset:           ", std::multiset<std::string>{}, words, text,
+			[](auto &t, const std::string &w) { t.insert(w); },
+			[](const auto &t, const std::string &w) { return t.count(w); }, size)};
+	size_t d{run("std::map, ++map[word]:   ", std::map<std::string, size_t>{}, words, text,
+			[](auto &t, const std::string &w) { ++t[w]; },
+			[](const auto &t, const std::string &w) { auto it{t.find(w)}; return t.end() == it ? 0 : it->second; }, size)};
+
+	bool ok{a == draws && a == b && a == c && a == d};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+* Unordered lookup benchmark, %hash_set against %set and std::unordered_set.
+*
+* Inserts 1e6 random ints, then finds all of them, finds 1e6 absent keys,
+* erases half and inserts them back (reusing tombstones), once into an
+* empty set and once after reserve(). Then the same for 2e5 strings, with
+* heterogeneous lookup through std::string_view in %hash_set. Prints ns
+* per operation.
+*/
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "../hash_set.hpp"
+#include "../set.hpp"
+
+constexpr size_t int_count = 1000000;
+constexpr size_t string_count = 200000;
+
+/*
+* Hashes std::string and std::string_view alike.
+*/
+struct string_hash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+struct string_equal
+{
+	using is_transparent = void;
+
+	bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints ns per insert, hit, miss and erase + reinsert on @set, returns a checksum.
+*/
+template<typename Set, typename K, typename Reserve>
+size_t run(const char *name, Set set, const std::vector<K> &keys, const std::vector<K> &absent, Reserve reserve)
+{
+	size_t sum{0};
+	double insert{measure(keys.size(), [&] {
+		reserve(set, keys.size());
+		for(const auto &k : keys)
+			set.insert(k);
+	})};
+	double hit{measure(keys.size(), [&] {
+		for(const auto &k : keys)
+			sum += set.end() != set.find(k);
+	})};
+	double miss{measure(absent.size(), [&] {
+		for(const auto &k : absent)
+			sum += set.count(k);
+	})};
+	double churn{measure(keys.size(), [&] {
+		for(size_t i = 0; i < keys.size(); i += 2)
+			sum += set.erase(keys[i]);
+		for(size_t i = 0; i < keys.size(); i += 2)
+			set.insert(keys[i]);
+	})};
+
+	std::cout << "  " << name << "insert " << insert << ", hit " << hit << ", miss " << miss
+		<< ", erase + insert " << churn << std::endl;
+
+	return sum + set.size();
+}
+
+int
+main (void)
+{
+	auto none{[](auto &, size_t) {}};
+	auto reserve{[](auto &set, size_t count) { set.reserve(count); }};
+
+	std::mt19937_64 engine{31};
+	std::vector<int> ints(int_count), missing(int_count);
+	for(auto &k : ints)
+		k = static_cast<int>(engine() >> 33);					// [0, 2^31)
+	for(auto &k : missing)
+		k = -1 - static_cast<int>(engine() >> 33);
+
+	std::cout << "ns per operation, " << int_count << " ints:" << std::endl;
+	size_t a{run("containers::hash_set:           ", containers::hash_set<int>{}, ints, missing, none)};
+	size_t b{run("containers::hash_set, reserve:  ", containers::hash_set<int>{}, ints, missing, reserve)};
+	size_t c{run("std::unordered_set:             ", std::unordered_set<int>{}, ints, missing, none)};
+	size_t d{run("std::unordered_set, reserve:    ", std::unordered_set<int>{}, ints, missing, reserve)};
+	size_t e{run("containers::set:                ", containers::set<int>{}, ints, missing, none)};
+
+	std::vector<std::string> words(string_count), other(string_count);
+	for(auto &w : words)
+		w = "key:" + std::to_string(engine());
+	for(auto &w : other)
+		w = "absent:" + std::to_string(engine());
+
+	std::cout << "ns per operation, " << string_count << " strings:" << std::endl;
+	size_t f{run("containers::hash_set:           ", containers::hash_set<std::string, string_hash, string_equal>{}, words, other, none)};
+	size_t g{run("std::unordered_set:             ", std::unordered_set<std::string>{}, words, other, none)};
+	size_t h{run("containers::set:                ", containers::set<std::string>{}, words, other, none)};
+
+	containers::hash_set<std::string, string_hash, string_equal> views;
+	views.insert(words.begin(), words.end());
+	std::vector<std::string_view> probes(words.begin(), words.end());
+	size_t x{0};
+	double view{measure(probes.size(), [&] {
+		for(auto p : probes)
+			x += views.contains(p);
+	})};
+	std::cout << "  containers::hash_set, find by std::string_view " << view << std::endl;
+
+	bool ok{a == b && a == c && a == d && a == e && f == g && f == h && x == views.size()};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/*
+* Hinted and batched insertion benchmark for %set.
+*
+* Streams 1e6 keys into an empty set: increasing (sequence numbers), nearly
+* sorted (1% of keys swapped with a key up to 64 positions away) and random.
+* Each stream goes through insert(key), insert(end(), key), insert_batch()
+* in chunks of 1000 keys and std::set::insert(end(), key). Times are ns per key.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr size_t stream_size = 1000000;
+constexpr size_t chunk = 1000;
+
+template<typename F>
+double measure(F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / stream_size;
+}
+
+/*
+* Runs every insertion method over @keys, returns whether all sets agree.
+*/
+bool run(const char *name, const std::vector<int> &keys)
+{
+	containers::set<int> plain, hinted, batched;
+	std::set<int> reference;
+
+	std::cout << name << ":" << std::endl;
+	std::cout << "  containers::set, insert(key):           "
+		<< measure([&] { for(int k : keys) plain.insert(k); }) << std::endl;
+	std::cout << "  containers::set, insert(end(), key):    "
+		<< measure([&] { for(int k : keys) hinted.insert(hinted.cend(), k); }) << std::endl;
+	std::cout << "  containers::set, insert_batch(chunk):   "
+		<< measure([&] {
+			for(size_t i = 0; i < keys.size(); i += chunk)
+				batched.insert_batch(keys.begin() + i, keys.begin() + std::min(i + chunk, keys.size()));
+		}) << std::endl;
+	std::cout << "  std::set, insert(end(), key):           "
+		<< measure([&] { for(int k : keys) reference.insert(reference.end(), k); }) << std::endl;
+
+	return std::equal(plain.begin(), plain.end(), reference.begin(), reference.end()) &&
+		std::equal(hinted.begin(), hinted.end(), reference.begin(), reference.end()) &&
+		std::equal(batched.begin(), batched.end(), reference.begin(), reference.end());
+}
+
+int
+main (void)
+{
+	std::mt19937 engine{11};
+	std::vector<int> keys(stream_size);
+	std::iota(keys.begin(), keys.end(), 0);
+
+	{
+		containers::set<int> warm_up;									// first touch of the heap
+		warm_up.insert(keys.begin(), keys.end());
+	}
+
+	std::cout << "ns per key, " << stream_size << " keys:" << std::endl;
+	bool ok{run("increasing", keys)};
+
+	for(size_t i = 0; i < keys.size() / 100; ++i)
+	{
+		size_t a{engine() % keys.size()};
+		size_t b{std::min(keys.size() - 1, a + engine() % 64)};
+		std::swap(keys[a], keys[b]);
+	}
+	ok = run("nearly sorted", keys) && ok;
+
+	std::shuffle(keys.begin(), keys.end(), engine);
+	ok = run("random", keys) && ok;
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
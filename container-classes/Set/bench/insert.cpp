@@ -0,0 +1,58 @@
+/*
+* Insert/erase benchmark for %set.
+*
+* Inserts n random keys for n = 1e3 .. 1e6 and erases every other one,
+* checking the contents against std::set. With O(1) balance factors the
+* time per insert divided by log2 n should stay roughly flat (it creeps
+* up once the tree no longer fits in cache).
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+int
+main (void)
+{
+	std::mt19937 engine{42};
+	bool ok{true};
+
+	std::cout << "random inserts, then erase of every other key:" << std::endl;
+	for(size_t n = 1000; n <= 1000000; n *= 10)
+	{
+		std::vector<int> keys(n);
+		for(auto &k : keys)
+			k = static_cast<int>(engine());
+
+		containers::set<int> s;
+		auto start{std::chrono::steady_clock::now()};
+		for(const auto &k : keys)
+			s.insert(k);
+		double ns{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()};
+
+		std::set<int> reference(keys.begin(), keys.end());
+		ok = ok && s.size() == reference.size() && std::equal(s.begin(), s.end(), reference.begin());
+
+		start = std::chrono::steady_clock::now();
+		for(size_t i = 0; i < n; i += 2)
+		{
+			s.erase(keys[i]);
+			reference.erase(keys[i]);
+		}
+		double erase_ns{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()};
+		ok = ok && s.size() == reference.size() && std::equal(s.begin(), s.end(), reference.begin());
+
+		std::cout << "  n = " << n << ":\t" << ns / n << " ns/insert,\t"
+			<< ns / n / std::log2(n) << " ns/(insert * log2 n),\t"
+			<< erase_ns / (n / 2) << " ns/erase" << std::endl;
+	}
+
+	std::cout << "contents match std::set: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+/*
+* Interval benchmark, %interval_tree and %interval_set queries against a
+* linear scan of an std::multimap from start to end.
+*
+* Builds 1e5 scheduling windows with random starts and skewed lengths
+* (about 10 windows over any point), then times stabbing queries ("which
+* windows hold x") and overlap queries ("which windows meet [x, x + w)").
+* The scan visits every window starting before the query ends, so it only
+* runs the first 1000 queries. %interval_set coalesces windows 50 times
+* shorter (under 1 in 5 points held, most windows stay apart)
+* and answers point queries, checked against an %interval_tree of them.
+* Prints ns per operation and intervals reported.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../interval_tree.hpp"
+#include "../interval_set.hpp"
+
+constexpr size_t windows = 100000;
+constexpr size_t queries = 100000;
+constexpr size_t scanned = 1000;
+constexpr long horizon = 100000000;
+constexpr long width = 10000;
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Counts windows of @scan meeting [@lo, @hi), or holding @lo if @point.
+*/
+size_t scan_count(const std::multimap<long, long> &scan, long lo, long hi, bool point)
+{
+	size_t ret{0};
+	for(auto it = scan.begin(), stop = point ? scan.upper_bound(lo) : scan.lower_bound(hi); it != stop; ++it)
+		ret += lo < it->second;
+	return ret;
+}
+
+int
+main (void)
+{
+	std::mt19937_64 engine{50};
+	std::uniform_int_distribution<long> start{0, horizon};
+	std::exponential_distribution<double> length{1.0 / width};
+
+	std::vector<containers::interval<long>> input(windows);
+	for(auto &w : input)
+	{
+		w.lo = start(engine);
+		w.hi = w.lo + 1 + static_cast<long>(length(engine));
+	}
+
+	std::vector<long> probes(queries);
+	for(auto &p : probes)
+		p = start(engine);
+
+	containers::interval_tree<long> tree;
+	std::multimap<long, long> scan;
+	double tree_build{measure(windows, [&]() { for(const auto &w : input) tree.insert(w); })};
+	double scan_build{measure(windows, [&]() { for(const auto &w : input) scan.emplace(w.lo, w.hi); })};
+
+	bool ok{true};
+	size_t stabbed{0}, met{0};
+	double tree_stab{measure(queries, [&]() {
+		for(long p : probes)
+			tree.visit_containing(p, [&stabbed](const containers::interval<long>&) { ++stabbed; });
+	})};
+	double tree_meet{measure(queries, [&]() {
+		for(long p : probes)
+			tree.visit_overlapping(p, p + width, [&met](const containers::interval<long>&) { ++met; });
+	})};
+
+	size_t scan_stabbed{0}, scan_met{0}, tree_stabbed{0}, tree_met{0};
+	double scan_stab{measure(scanned, [&]() {
+		for(size_t i = 0; i < scanned; ++i)
+			scan_stabbed += scan_count(scan, probes[i], probes[i], true);
+	})};
+	double scan_meet{measure(scanned, [&]() {
+		for(size_t i = 0; i < scanned; ++i)
+			scan_met += scan_count(scan, probes[i], probes[i] + width, false);
+	})};
+	for(size_t i = 0; i < scanned; ++i)
+	{
+		tree_stabbed += tree.containing(probes[i]).size();
+		tree_met += tree.overlapping(probes[i], probes[i] + width).size();
+	}
+	ok &= scan_stabbed == tree_stabbed && scan_met == tree_met;
+
+	containers::interval_tree<long> short_tree;
+	for(auto &w : input)
+	{
+		w.hi = w.lo + 1 + (w.hi - w.lo) / 50;
+		short_tree.insert(w);
+	}
+
+	containers::interval_set<long> merged;
+	double set_build{measure(windows, [&]() { for(const auto &w : input) merged.insert(w); })};
+	size_t held{0};
+	double set_contains{measure(queries, [&]() { for(long p : probes) held += merged.contains(p); })};
+	for(long p : probes)
+		ok &= merged.contains(p) == short_tree.overlaps(p, p + 1);
+
+	std::cout << windows << " windows, ns per operation:" << std::endl
+		<< "  interval_tree: insert " << tree_build << ", stab " << tree_stab << " (" << stabbed / queries
+		<< " found), overlap " << tree_meet << " (" << met / queries << " found)" << std::endl
+		<< "  multimap scan: insert " << scan_build << ", stab " << scan_stab << ", overlap " << scan_meet << std::endl
+		<< "  interval_set:  insert " << set_build << " (" << merged.size() << " intervals left), contains "
+		<< set_contains << " (" << held << " held)" << std::endl
+		<< "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+/*
+* Lookup benchmark for %set with std::string keys.
+*
+* Searches 1e3 and 1e5 long strings 1e6 times, once through a
+* std::string built from each probe and once with the std::string_view
+* probe itself through the transparent comparator, next to std::set.
+* operator new is replaced to count allocations on the lookup path.
+* The small set stays in cache, so the cost of the temporary shows, in
+* the large one cache misses on the nodes and strings dominate.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../set.hpp"
+
+static size_t allocations{0};
+
+void* operator new(size_t size)
+{
+	++allocations;
+	if(void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+/*
+* Runs @f on every probe, prints ns and allocations per lookup.
+*/
+template<typename F>
+size_t measure(const char *name, const std::vector<std::string_view> &probes, F f)
+{
+	size_t hits{0}, before{allocations};
+	auto start{std::chrono::steady_clock::now()};
+	for(const auto &probe : probes)
+		hits += f(probe);
+	double ns{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()};
+
+	std::cout << "  " << name << ns / probes.size() << " ns/lookup, "
+		<< static_cast<double>(allocations - before) / probes.size() << " allocations/lookup" << std::endl;
+
+	return hits;
+}
+
+/*
+* Runs the three lookups over @count keys, returns whether they agree.
+*/
+bool run(size_t count)
+{
+	std::vector<std::string> keys;
+	for(size_t i = 0; i < count; ++i)
+		keys.push_back("/usr/share/containers/key/" + std::to_string(2 * i));
+
+	std::mt19937 engine{7};
+	std::vector<std::string> storage;
+	for(size_t i = 0; i < 1000000; ++i)
+		storage.push_back("/usr/share/containers/key/" + std::to_string(engine() % (2 * count)));
+	std::vector<std::string_view> probes(storage.begin(), storage.end());
+
+	containers::set<std::string> plain;
+	containers::set<std::string, std::less<>> transparent;
+	plain.insert(keys.begin(), keys.end());
+	transparent.insert(keys.begin(), keys.end());
+	std::set<std::string, std::less<>> reference(keys.begin(), keys.end());
+
+	std::cout << probes.size() << " lookups in " << keys.size() << " strings:" << std::endl;
+	size_t a{measure("containers::set, find(std::string):      ", probes,
+			[&](std::string_view p) { return plain.end() != plain.find(std::string{p}); })};
+	size_t b{measure("containers::set, find(std::string_view): ", probes,
+			[&](std::string_view p) { return transparent.end() != transparent.find(p); })};
+	size_t c{measure("std::set, find(std::string_view):        ", probes,
+			[&](std::string_view p) { return reference.end() != reference.find(p); })};
+
+	return a == b && b == c;
+}
+
+int
+main (void)
+{
+	bool ok{run(1000) && run(100000)};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+* Map benchmark, single descent updates of %map against std::map.
+*
+* Counts 2e6 draws from 2e5 distinct keys with operator[], then updates
+* every distinct key with insert_or_assign(), with try_emplace() of present
+* keys, and with the find() then insert() pair the single descent calls
+* replace, and walks the map once. Keys are strings, then ints. Prints
+* ns per operation.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../map.hpp"
+
+constexpr size_t distinct = 200000;
+constexpr size_t draws = 2000000;
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints ns per operation on @map, returns a checksum.
+*/
+template<typename Map, typename K>
+size_t run(const char *name, Map map, const std::vector<K> &words, const std::vector<size_t> &text)
+{
+	size_t sum{0};
+	double count{measure(text.size(), [&] {
+		for(size_t i : text)
+			++map[words[i]];
+	})};
+	double assign{measure(words.size(), [&] {
+		for(const auto &w : words)
+			map.insert_or_assign(w, sizeof(w));
+	})};
+	double emplace{measure(words.size(), [&] {
+		for(const auto &w : words)
+			sum += map.try_emplace(w, 0).first->second;
+	})};
+	double twice{measure(words.size(), [&] {
+		for(const auto &w : words)
+		{
+			auto it{map.find(w)};
+			if(it == map.end())
+				it = map.insert({w, 0}).first;
+			sum += ++it->second;
+		}
+	})};
+	double walk{measure(map.size(), [&] {
+		for(const auto &kv : map)
+			sum += kv.second;
+	})};
+
+	std::cout << "  " << name << "operator[] " << count << ", insert_or_assign " << assign
+		<< ", try_emplace " << emplace << ", find + insert " << twice << ", iterate " << walk << std::endl;
+
+	return sum + map.size();
+}
+
+int
+main (void)
+{
+	std::mt19937_64 engine{37};
+	std::vector<std::string> words(distinct);
+	for(auto &w : words)
+		w = "word" + std::to_string(engine());
+
+	std::vector<size_t> text(draws);
+	for(auto &i : text)
+		i = engine() % distinct;
+
+	std::vector<long> ints(distinct);
+	for(auto &k : ints)
+		k = static_cast<long>(engine() >> 1);
+
+	std::cout << "ns per operation, " << draws << " words, " << distinct << " distinct:" << std::endl;
+	size_t a{run("containers::map: ", containers::map<std::string, size_t>{}, words, text)};
+	size_t b{run("std::map:        ", std::map<std::string, size_t>{}, words, text)};
+
+	std::cout << "ns per operation, " << draws << " ints, " << distinct << " distinct:" << std::endl;
+	size_t c{run("containers::map: ", containers::map<long, size_t>{}, ints, text)};
+	size_t d{run("std::map:        ", std::map<long, size_t>{}, ints, text)};
+
+	bool ok{a == b && c == d};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
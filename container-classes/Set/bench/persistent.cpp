@@ -0,0 +1,119 @@
+/*
+* Snapshot benchmark, %persistent_set next to deep copies of %set.
+*
+* 1e6 keys, a writer applies random inserts and erases and takes a
+* snapshot every 1000 updates, 100 snapshots in all, which stay alive
+* like open read views. Prints time per snapshot and per update, and
+* the bytes allocated per update and snapshot. operator new is replaced
+* to count them.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "../set.hpp"
+#include "../persistent_set.hpp"
+
+constexpr int key_count = 1000000;
+constexpr size_t snapshots = 100;
+constexpr size_t updates_per_snapshot = 1000;
+
+static size_t allocated{0};
+
+void* operator new(size_t size)
+{
+	allocated += size;
+	if(void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+using clock_type = std::chrono::steady_clock;
+
+double since(clock_type::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+}
+
+/*
+* Runs the writer on @Set, @snapshot takes a view, returns a checksum of the last view.
+*/
+template<typename Set, typename Update, typename Snapshot>
+long run(const char *name, Set set, Update update, Snapshot snapshot)
+{
+	std::mt19937 engine{3};
+	std::vector<Set> views;
+	double update_us{0}, snapshot_us{0};
+	size_t update_bytes{0}, snapshot_bytes{0};
+
+	for(size_t s = 0; s < snapshots; ++s)
+	{
+		size_t before{allocated};
+		auto start{clock_type::now()};
+		for(size_t u = 0; u < updates_per_snapshot; ++u)
+			set = update(set, static_cast<int>(engine() % (2 * key_count)), 0 == engine() % 2);
+		update_us += since(start);
+		update_bytes += allocated - before;
+
+		before = allocated;
+		start = clock_type::now();
+		views.push_back(snapshot(set));
+		snapshot_us += since(start);
+		snapshot_bytes += allocated - before;
+	}
+
+	std::cout << "  " << name << "snapshot " << snapshot_us / snapshots << " us, "
+		<< snapshot_bytes / snapshots << " B; update " << update_us * 1000 / (snapshots * updates_per_snapshot)
+		<< " ns, " << update_bytes / (snapshots * updates_per_snapshot) << " B" << std::endl;
+
+	long sum{0};
+	for(int k : views.back())
+		sum += k;
+	return sum;
+}
+
+int
+main (void)
+{
+	std::vector<int> keys(key_count);
+	for(int i = 0; i < key_count; ++i)
+		keys[i] = 2 * i;
+
+	containers::set<int> set{containers::set<int>::from_sorted(keys.begin(), keys.end())};
+	containers::persistent_set<int> persistent{set};
+
+	std::cout << key_count << " keys, a snapshot every " << updates_per_snapshot << " updates:" << std::endl;
+	long a{run("containers::set, copy:          ", std::move(set),
+			[](containers::set<int> &s, int key, bool add) -> containers::set<int>&& {
+				if(add)
+					s.insert(key);
+				else
+					s.erase(key);
+				return std::move(s);
+			},
+			[](const containers::set<int> &s) { return s; })};
+	long b{run("containers::persistent_set:     ", persistent,
+			[](const containers::persistent_set<int> &s, int key, bool add) {
+				return add ? s.insert(key) : s.erase(key);
+			},
+			[](const containers::persistent_set<int> &s) { return s; })};
+
+	std::cout << "results match: " << (a == b ? "yes" : "NO") << std::endl;
+
+	return a == b ? 0 : 1;
+}
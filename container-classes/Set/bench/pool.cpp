@@ -0,0 +1,90 @@
+/*
+* Node pool benchmark for %set.
+*
+* Runs the same insert / erase / re-insert / clear cycle on 1e6 random keys
+* with %set and std::set, both through an allocator that counts calls,
+* and reports the time of each step and how often the allocator was hit.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+size_t allocations{0};
+
+/*
+* std::allocator that counts allocate() calls.
+*/
+template<typename T>
+struct counting_allocator : std::allocator<T>
+{
+	typedef T value_type;
+
+	template<typename U>
+	struct rebind
+	{
+		typedef counting_allocator<U> other;
+	};
+
+	counting_allocator(void) = default;
+	template<typename U>
+	counting_allocator(const counting_allocator<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		++allocations;
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+template<typename F>
+double measure(F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Set>
+bool cycle(const char *name, const std::vector<int> &keys)
+{
+	allocations = 0;
+	Set s;
+	double insert{measure([&] { for(const auto &k : keys) s.insert(k); })};
+	double erase{measure([&] { for(size_t i = 0; i < keys.size(); i += 2) s.erase(keys[i]); })};
+	double reinsert{measure([&] { for(size_t i = 0; i < keys.size(); i += 2) s.insert(keys[i]); })};
+
+	std::vector<int> sorted(keys);
+	std::sort(sorted.begin(), sorted.end());
+	sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+	bool ok{s.size() == sorted.size() && std::equal(s.begin(), s.end(), sorted.begin())};
+
+	double scan{measure([&] { long sum{0}; for(const auto &k : s) sum += k; ok = ok && (sum != 1); })};
+	double clear{measure([&] { s.clear(); })};
+
+	std::cout << name << "insert " << insert << " ms, erase half " << erase << " ms, re-insert " << reinsert
+		<< " ms, scan " << scan << " ms, clear " << clear << " ms, " << allocations << " allocations" << std::endl;
+
+	return ok && s.empty();
+}
+
+int
+main (void)
+{
+	std::mt19937 engine{42};
+	std::vector<int> keys(1000000);
+	for(auto &k : keys)
+		k = static_cast<int>(engine());
+
+	bool ok{cycle<containers::set<int, std::less<int>, counting_allocator<int>>>("  containers::set: ", keys)};
+	ok = cycle<std::set<int, std::less<int>, counting_allocator<int>>>("  std::set:        ", keys) && ok;
+
+	std::cout << "contents match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
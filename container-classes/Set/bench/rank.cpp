@@ -0,0 +1,76 @@
+/*
+* Order statistics benchmark for %set.
+*
+* Looks up random positions, ranks and distances in a set of 1e6 keys
+* with nth(), rank() and distance(), next to walking iterators of
+* std::set to get the same answers. The walks are linear, so std::set
+* only gets the first hundred queries and times are per query.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	for(size_t i = 0; i < count; ++i)
+		f(i);
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+int
+main (void)
+{
+	std::vector<int> keys(1000000);
+	for(size_t i = 0; i < keys.size(); ++i)
+		keys[i] = static_cast<int>(2 * i);
+
+	containers::set<int> set{containers::set<int>::from_sorted(keys.begin(), keys.end())};
+	std::set<int> reference(keys.begin(), keys.end());
+
+	std::mt19937 engine{42};
+	std::vector<size_t> queries(10000);
+	for(auto &q : queries)
+		q = engine() % keys.size();
+
+	bool ok{true};
+	const size_t walked{100};
+	std::vector<size_t> fast(queries.size()), slow(walked);
+
+	std::cout << "per query on " << keys.size() << " keys:" << std::endl;
+	std::cout << "  containers::set, nth:           "
+		<< measure(queries.size(), [&](size_t i) { fast[i] = static_cast<size_t>(*set.nth(queries[i])); }) << " us" << std::endl;
+	std::cout << "  std::set, std::next:            "
+		<< measure(walked, [&](size_t i) { slow[i] = static_cast<size_t>(*std::next(reference.begin(), queries[i])); }) << " us" << std::endl;
+	ok = ok && std::equal(slow.begin(), slow.end(), fast.begin());
+
+	std::cout << "  containers::set, rank:          "
+		<< measure(queries.size(), [&](size_t i) { fast[i] = set.rank(keys[queries[i]] + 1); }) << " us" << std::endl;
+	std::cout << "  std::set, std::distance:        "
+		<< measure(walked, [&](size_t i) {
+			slow[i] = static_cast<size_t>(std::distance(reference.begin(), reference.upper_bound(keys[queries[i]])));
+		}) << " us" << std::endl;
+	ok = ok && std::equal(slow.begin(), slow.end(), fast.begin());
+
+	std::cout << "  containers::set, distance:      "
+		<< measure(queries.size(), [&](size_t i) {
+			using std::distance;
+			fast[i] = static_cast<size_t>(distance(set.nth(queries[i]), set.end()));
+		}) << " us" << std::endl;
+	std::cout << "  std::set, std::distance:        "
+		<< measure(walked, [&](size_t i) {
+			slow[i] = static_cast<size_t>(std::distance(reference.find(keys[queries[i]]), reference.end()));
+		}) << " us" << std::endl;
+	ok = ok && std::equal(slow.begin(), slow.end(), fast.begin());
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
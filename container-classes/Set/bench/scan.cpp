@@ -0,0 +1,103 @@
+/*
+* Range scan benchmark for the threaded iterators of %set.
+*
+* Builds 1e7 int keys, inserted in random order (nodes scattered in
+* memory) and in increasing order (nodes in key order), and scans them:
+* the whole set forwards and backwards, and 1e4 ranges of 1000 keys from
+* lower_bound(). Prints ns per key next to std::set. A smaller size can be
+* given on the command line.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr size_t default_count = 10000000;
+constexpr size_t ranges = 10000;
+constexpr size_t range_length = 1000;
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints ns per key scanned in @set, returns a checksum.
+*/
+template<typename Set>
+long run(const char *name, const Set &set, const std::vector<int> &starts)
+{
+	long sum{0};
+	double forward{measure(set.size(), [&] {
+		for(auto it = set.begin(); it != set.end(); ++it)
+			sum += *it;
+	})};
+	double backward{measure(set.size(), [&] {
+		for(auto it = set.end(); it != set.begin();)
+			sum -= *--it;
+	})};
+	double range{measure(ranges * range_length, [&] {
+		for(int start : starts)
+		{
+			auto it{set.lower_bound(start)};
+			for(size_t i = 0; i < range_length && it != set.end(); ++i, ++it)
+				sum += *it;
+		}
+	})};
+
+	std::cout << "  " << name << "forward " << forward << ", backward " << backward
+		<< ", ranges of " << range_length << " " << range << std::endl;
+
+	return sum;
+}
+
+int
+main (int argc, char *argv[])
+{
+	size_t count{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : default_count};
+	std::mt19937 engine{23};
+
+	std::vector<int> keys(count);
+	std::iota(keys.begin(), keys.end(), 0);
+	std::shuffle(keys.begin(), keys.end(), engine);
+
+	std::vector<int> starts(ranges);
+	for(auto &s : starts)
+		s = static_cast<int>(engine() % count);
+
+	bool ok{true};
+	for(const char *order : {"random", "increasing"})
+	{
+		std::cout << "ns per key, " << count << " keys inserted in " << order << " order:" << std::endl;
+		long a, b;
+		{
+			containers::set<int> set;
+			for(int k : keys)
+				set.insert(k);
+			a = run("containers::set: ", set, starts);
+		}
+		{
+			std::set<int> set;
+			for(int k : keys)
+				set.insert(k);
+			b = run("std::set:        ", set, starts);
+		}
+		ok = ok && a == b;
+
+		std::sort(keys.begin(), keys.end());
+	}
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
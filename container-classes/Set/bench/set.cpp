@@ -0,0 +1,141 @@
+/*
+* Set benchmark, throughput and latency of %set against std::set.
+*
+* For int and string keys at 1e3, 1e4, ... elements, times insert of
+* random keys, find of every key, lower_bound of random probes and erase
+* of every key, each in random order, and one full iteration. Every
+* operation is timed on its own, so each prints mean / p50 / p99 ns, the
+* cost of a clock read included. Iteration prints ns per element.
+* Sizes go up to 1e6 by default, `set.out 10000000` goes up to 1e7 (about
+* 2 GB for the string sets).
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../set.hpp"
+
+using clock_type = std::chrono::steady_clock;
+
+/*
+* Mean and percentiles of one operation, in ns.
+*/
+struct latency
+{
+	double mean, p50, p99;
+};
+
+std::ostream& operator<<(std::ostream &out, const latency &l)
+{
+	return out << l.mean << " / " << l.p50 << " / " << l.p99;
+}
+
+/*
+* Calls @op(i) for every i below @count, timing each call.
+*/
+template<typename F>
+latency timed(size_t count, std::vector<double> &samples, F op)
+{
+	samples.resize(count);
+	for(size_t i = 0; i < count; ++i)
+	{
+		auto start{clock_type::now()};
+		op(i);
+		samples[i] = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+	}
+
+	double sum{0};
+	for(double s : samples)
+		sum += s;
+	std::sort(samples.begin(), samples.end());
+
+	return latency{sum / count, samples[count / 2], samples[count * 99 / 100]};
+}
+
+/*
+* Checksum contribution of a key, keeps iteration from being optimized away.
+*/
+size_t weight(int key) { return static_cast<size_t>(key) & 0xff; }
+size_t weight(const std::string &key) { return key.size(); }
+
+/*
+* Runs every operation on an empty @Set, returns a checksum.
+*/
+template<typename Set, typename K>
+size_t run(const char *name, const std::vector<K> &keys, const std::vector<K> &shuffled,
+		const std::vector<K> &probes, std::vector<double> &samples)
+{
+	Set set;
+	size_t sum{0};
+	size_t n{keys.size()};
+
+	latency insert{timed(n, samples, [&](size_t i) { set.insert(keys[i]); })};
+	sum += set.size();
+	latency find{timed(n, samples, [&](size_t i) { sum += set.end() != set.find(shuffled[i]); })};
+	latency bound{timed(n, samples, [&](size_t i) { sum += set.end() != set.lower_bound(probes[i]); })};
+
+	auto start{clock_type::now()};
+	for(const auto &k : set)
+		sum += weight(k);
+	double iterate{std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / set.size()};
+
+	latency erase{timed(n, samples, [&](size_t i) { sum += set.erase(shuffled[i]); })};
+
+	std::cout << "  " << name << "insert " << insert << ", find " << find << ", lower_bound " << bound
+		<< ", erase " << erase << ", iterate " << iterate << std::endl;
+
+	return sum + set.size();
+}
+
+int
+main (int argc, char **argv)
+{
+	size_t largest{argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000};
+
+	std::mt19937_64 engine{47};
+	std::vector<double> samples;
+	bool ok{true};
+
+	std::cout << std::fixed << std::setprecision(1);
+	for(size_t n = 1000; n <= largest; n *= 10)
+	{
+		std::vector<int> ints(n), int_probes(n);
+		for(size_t i = 0; i < n; ++i)
+		{
+			ints[i] = static_cast<int>(engine() >> 33);
+			int_probes[i] = static_cast<int>(engine() >> 33);
+		}
+		std::vector<int> ints_shuffled(ints);
+		std::shuffle(ints_shuffled.begin(), ints_shuffled.end(), engine);
+
+		std::cout << "ns per operation (mean / p50 / p99), " << n << " ints:" << std::endl;
+		size_t a{run<containers::set<int>>("containers::set: ", ints, ints_shuffled, int_probes, samples)};
+		size_t b{run<std::set<int>>("std::set:        ", ints, ints_shuffled, int_probes, samples)};
+
+		std::vector<std::string> words(n), word_probes(n);
+		for(size_t i = 0; i < n; ++i)
+		{
+			words[i] = "key:" + std::to_string(engine());
+			word_probes[i] = "key:" + std::to_string(engine());
+		}
+		std::vector<std::string> words_shuffled(words);
+		std::shuffle(words_shuffled.begin(), words_shuffled.end(), engine);
+
+		std::cout << "ns per operation (mean / p50 / p99), " << n << " strings:" << std::endl;
+		size_t c{run<containers::set<std::string>>("containers::set: ", words, words_shuffled, word_probes, samples)};
+		size_t d{run<std::set<std::string>>("std::set:        ", words, words_shuffled, word_probes, samples)};
+
+		ok &= a == b && c == d;
+	}
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+* Tree shape benchmark, set::stats() under different key distributions.
+*
+* Builds a %set of 1e6 longs from random keys, ascending keys, descending
+* keys, ascending keys hinted with end(), 16 ascending runs whose keys
+* interleave, and random keys after 4e6 erase + insert pairs of churn.
+* For each prints
+* height against the minimum, average depth, the balance factor
+* distribution, bytes per key and ns per successful find() in random
+* order, so a depth regression shows up next to the lookup time it costs.
+* Every tree also goes through validate().
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr size_t count = 1000000;
+constexpr size_t churn = 4000000;
+constexpr size_t runs = 16;
+
+template<typename F>
+double measure(size_t count, F f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+/*
+* Prints the shape of @set and ns per find() of every key, returns whether all were found.
+*/
+bool report(const char *name, const containers::set<long> &set, std::mt19937_64 &engine)
+{
+	try
+	{
+		set.validate();
+	}
+	catch(const std::logic_error &e)
+	{
+		std::cout << "  " << name << e.what() << std::endl;
+		return false;
+	}
+
+	std::vector<long> probes(set.begin(), set.end());
+	std::shuffle(probes.begin(), probes.end(), engine);
+
+	size_t found{0};
+	double find{measure(probes.size(), [&] {
+		for(long k : probes)
+			found += set.end() != set.find(k);
+	})};
+
+	containers::tree_stats s{set.stats()};
+	std::cout << "  " << name << "height " << s.height << " (min " << s.min_height << "), depth "
+		<< std::fixed << std::setprecision(2) << s.average_depth << ", balance "
+		<< s.left_heavy << "/" << s.balanced << "/" << s.right_heavy << ", bytes per key "
+		<< static_cast<double>(s.reserved_bytes) / s.size << ", find " << find << std::endl;
+
+	return found == set.size() && s.size == set.size();
+}
+
+int
+main (void)
+{
+	std::mt19937_64 engine{43};
+	std::vector<long> random(count);
+	for(auto &k : random)
+		k = static_cast<long>(engine() >> 1);
+
+	containers::set<long> shuffled, ascending, descending, hinted, interleaved, churned;
+	for(long k : random)
+		shuffled.insert(k);
+	for(size_t i = 0; i < count; ++i)
+		ascending.insert(static_cast<long>(i));
+	for(size_t i = count; i > 0; --i)
+		descending.insert(static_cast<long>(i));
+	for(size_t i = 0; i < count; ++i)
+		hinted.insert(hinted.cend(), static_cast<long>(i));
+	for(size_t r = 0; r < runs; ++r)							// run r inserts keys r, r + runs, ...
+		for(size_t i = 0; i < count / runs; ++i)
+			interleaved.insert(static_cast<long>(i * runs + r));
+
+	std::vector<long> live(random);
+	for(long k : live)
+		churned.insert(k);
+	for(size_t i = 0; i < churn; ++i)
+	{
+		size_t victim{engine() % count};
+		churned.erase(live[victim]);
+		live[victim] = static_cast<long>(engine() >> 1);
+		churned.insert(live[victim]);
+	}
+
+	std::cout << "shape of " << count << " keys, balance as left heavy/balanced/right heavy, find in ns:" << std::endl;
+	bool ok{true};
+	ok &= report("random:       ", shuffled, engine);
+	ok &= report("ascending:    ", ascending, engine);
+	ok &= report("descending:   ", descending, engine);
+	ok &= report("hinted end(): ", hinted, engine);
+	ok &= report("interleaved:  ", interleaved, engine);
+	ok &= report("churned:      ", churned, engine);
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
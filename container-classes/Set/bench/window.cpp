@@ -0,0 +1,104 @@
+/*
+* Time window eviction benchmark, range erase and range count of %set.
+*
+* Keeps the last 4e6 timestamps. Each of 40 ticks inserts 1e5 new ones and
+* evicts everything older than the window: with erase_range(), with
+* erase() of the oldest key one at a time, and with std::set::erase(first,
+* last). Then counts keys in 1e5 random windows with count_range() and
+* with std::distance() over std::set. Prints ns per evicted key and per count.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr long window = 4000000;
+constexpr long per_tick = 100000;
+constexpr long ticks = 40;
+constexpr size_t queries = 100000;
+
+using clock_type = std::chrono::steady_clock;
+
+double since(clock_type::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+}
+
+/*
+* Runs the ticks on @set, @evict removes keys below a cutoff. Returns the final size.
+*/
+template<typename Set, typename Evict>
+size_t run(const char *name, Set &set, Evict evict)
+{
+	long now{0};
+	for(; now < window; ++now)
+		set.insert(now);
+
+	double ns{0};
+	size_t evicted{0};
+	for(long t = 0; t < ticks; ++t)
+	{
+		for(long i = 0; i < per_tick; ++i, ++now)
+			set.insert(set.end(), now);
+
+		size_t before{set.size()};
+		auto start{clock_type::now()};
+		evict(set, now - window);
+		ns += since(start);
+		evicted += before - set.size();
+	}
+
+	std::cout << "  " << name << ns / evicted << std::endl;
+
+	return set.size();
+}
+
+int
+main (void)
+{
+	std::cout << "ns per evicted key, " << window << " live keys, " << per_tick << " per tick:" << std::endl;
+
+	containers::set<long> ranged, single;
+	std::set<long> reference;
+	size_t a{run("containers::set, erase_range():   ", ranged, [](auto &s, long cutoff) { s.erase_range(0, cutoff); })};
+	size_t b{run("containers::set, erase() per key: ", single, [](auto &s, long cutoff) {
+		while(!s.empty() && *s.begin() < cutoff)
+			s.erase(s.cbegin());
+	})};
+	size_t c{run("std::set, erase(first, last):     ", reference, [](auto &s, long cutoff) {
+		s.erase(s.begin(), s.lower_bound(cutoff));
+	})};
+
+	std::mt19937_64 engine{29};
+	long low{*reference.begin()}, span{static_cast<long>(reference.size())};
+	std::vector<std::pair<long, long>> windows(queries);
+	for(auto &w : windows)
+	{
+		w.first = low + static_cast<long>(engine() % span);
+		w.second = w.first + static_cast<long>(engine() % 100000);
+	}
+
+	size_t x{0}, y{0};
+	auto start{clock_type::now()};
+	for(auto &w : windows)
+		x += ranged.count_range(w.first, w.second);
+	double count_ns{since(start) / queries};
+	start = clock_type::now();
+	for(auto &w : windows)
+		y += static_cast<size_t>(std::distance(reference.lower_bound(w.first), reference.lower_bound(w.second)));
+	double distance_ns{since(start) / queries};
+
+	std::cout << "ns per count of up to 1e5 keys:" << std::endl;
+	std::cout << "  containers::set, count_range():   " << count_ns << std::endl;
+	std::cout << "  std::set, distance():             " << distance_ns << std::endl;
+
+	bool ok{a == b && a == c && x == y};
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
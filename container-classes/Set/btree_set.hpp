@@ -0,0 +1,1925 @@
+#ifndef _CONTAINERS_BTREE_SET_HPP_
+#define _CONTAINERS_BTREE_SET_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "set_detail.hpp"
+
+namespace containers::btree::detail
+{
+
+	template<typename Key, size_t Capacity>
+	struct btree_internal;
+
+	// B-tree Node declaration:
+	// @@{
+	/*
+	* @brief A node of %btree_set.
+	*
+	* @param Key Type of key objects.
+	* @param Capacity Maximum number of keys per node.
+	*
+	* Keys are stored sorted in uninitialized storage, only the first
+	* @count are constructed. Internal nodes are %btree_internal, which
+	* appends @count + 1 child pointers, so leaves (most of the nodes)
+	* carry no child array.
+	* @position is the index of the node in the child array of its parent.
+	*/
+	template<typename Key, size_t Capacity>
+	struct btree_node
+	{
+		// Constructor
+		explicit btree_node(bool leaf);
+
+		// Access
+		Key* keys(void);
+		const Key* keys(void) const;
+		btree_node*& child(size_t i);
+		btree_node* child(size_t i) const;
+
+		// Data
+		btree_node *parent;
+		unsigned short position, count;
+		bool leaf;
+		alignas(Key) unsigned char storage[Capacity * sizeof(Key)];
+	};
+
+	template<typename Key, size_t Capacity>
+	struct btree_internal : btree_node<Key, Capacity>
+	{
+		btree_internal(void);
+
+		btree_node<Key, Capacity> *children[Capacity + 1];
+	};
+	// @@}
+
+	// B-tree Node implementation:
+	// @@{
+	template<typename Key, size_t Capacity>
+	btree_node<Key, Capacity>::btree_node(bool leaf)
+		:	parent{nullptr},
+			position{0},
+			count{0},
+			leaf{leaf}
+	{}
+
+	template<typename Key, size_t Capacity>
+	btree_internal<Key, Capacity>::btree_internal(void)
+		:	btree_node<Key, Capacity>{false},
+			children{}
+	{}
+
+	template<typename Key, size_t Capacity>
+	Key* btree_node<Key, Capacity>::keys(void)
+	{
+		return std::launder(reinterpret_cast<Key*>(storage));
+	}
+
+	template<typename Key, size_t Capacity>
+	const Key* btree_node<Key, Capacity>::keys(void) const
+	{
+		return std::launder(reinterpret_cast<const Key*>(storage));
+	}
+
+	/*
+	* Returns @i-th child, only valid on internal nodes.
+	*/
+	template<typename Key, size_t Capacity>
+	btree_node<Key, Capacity>*& btree_node<Key, Capacity>::child(size_t i)
+	{
+		return static_cast<btree_internal<Key, Capacity>*>(this)->children[i];
+	}
+
+	template<typename Key, size_t Capacity>
+	btree_node<Key, Capacity>* btree_node<Key, Capacity>::child(size_t i) const
+	{
+		return static_cast<const btree_internal<Key, Capacity>*>(this)->children[i];
+	}
+	// @@}
+
+	/*
+	* Returns number of keys that fit a node of @bytes bytes, at least 3.
+	*/
+	template<typename Key>
+	constexpr size_t node_capacity(size_t bytes)
+	{
+		constexpr size_t header{sizeof(btree_node<Key, 1>) - sizeof(Key)};
+		size_t fit{bytes > header ? (bytes - header) / sizeof(Key) : 0};
+
+		return fit < 3 ? 3 : fit;
+	}
+
+	// In-node search:
+	// @{
+	/*
+	* True if keys of type @Key looked up with @K under @Compare can be
+	* searched with vector compares: arithmetic keys in plain ascending order.
+	*/
+	template<typename Key, typename K, typename Compare>
+	struct simd_searchable
+		: std::integral_constant<bool,
+			std::is_arithmetic<Key>::value && std::is_same<Key, K>::value &&
+			(std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::less<>>::value)>
+	{};
+
+	/*
+	* @brief Counts keys in [@keys, @keys + @count) less than @key (or not
+	* greater than @key if @Inclusive).
+	*
+	* The node is sorted, so that is the index lower_bound (upper_bound)
+	* would return. Nodes are small, so every key is compared, 8 (AVX2) or
+	* 4 (SSE2) at a time with no branches. Types without a vector path
+	* use the scalar loop, which the compiler vectorizes where it can.
+	*/
+	template<bool Inclusive, typename Key>
+	size_t count_before(const Key *keys, size_t count, Key key)
+	{
+		size_t ret{0}, i{0};
+#if defined(__AVX2__)
+		if constexpr(std::is_integral<Key>::value && std::is_signed<Key>::value && 4 == sizeof(Key))
+		{
+			const __m256i k{_mm256_set1_epi32(static_cast<int>(key))};
+			for(; i + 8 <= count; i += 8)
+			{
+				__m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i))};
+				int mask{_mm256_movemask_ps(_mm256_castsi256_ps(Inclusive ? _mm256_cmpgt_epi32(v, k) : _mm256_cmpgt_epi32(k, v)))};
+				ret += Inclusive ? 8 - __builtin_popcount(mask) : __builtin_popcount(mask);
+			}
+		}
+		else if constexpr(std::is_integral<Key>::value && std::is_signed<Key>::value && 8 == sizeof(Key))
+		{
+			const __m256i k{_mm256_set1_epi64x(static_cast<long long>(key))};
+			for(; i + 4 <= count; i += 4)
+			{
+				__m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i))};
+				int mask{_mm256_movemask_pd(_mm256_castsi256_pd(Inclusive ? _mm256_cmpgt_epi64(v, k) : _mm256_cmpgt_epi64(k, v)))};
+				ret += Inclusive ? 4 - __builtin_popcount(mask) : __builtin_popcount(mask);
+			}
+		}
+		else if constexpr(std::is_same<Key, float>::value)
+		{
+			const __m256 k{_mm256_set1_ps(key)};
+			for(; i + 8 <= count; i += 8)
+			{
+				__m256 v{_mm256_loadu_ps(keys + i)};
+				ret += __builtin_popcount(_mm256_movemask_ps(Inclusive ? _mm256_cmp_ps(v, k, _CMP_LE_OQ) : _mm256_cmp_ps(v, k, _CMP_LT_OQ)));
+			}
+		}
+		else if constexpr(std::is_same<Key, double>::value)
+		{
+			const __m256d k{_mm256_set1_pd(key)};
+			for(; i + 4 <= count; i += 4)
+			{
+				__m256d v{_mm256_loadu_pd(keys + i)};
+				ret += __builtin_popcount(_mm256_movemask_pd(Inclusive ? _mm256_cmp_pd(v, k, _CMP_LE_OQ) : _mm256_cmp_pd(v, k, _CMP_LT_OQ)));
+			}
+		}
+#elif defined(__SSE2__)
+		if constexpr(std::is_integral<Key>::value && std::is_signed<Key>::value && 4 == sizeof(Key))
+		{
+			const __m128i k{_mm_set1_epi32(static_cast<int>(key))};
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i))};
+				int mask{_mm_movemask_ps(_mm_castsi128_ps(Inclusive ? _mm_cmpgt_epi32(v, k) : _mm_cmplt_epi32(v, k)))};
+				ret += Inclusive ? 4 - __builtin_popcount(mask) : __builtin_popcount(mask);
+			}
+		}
+		else if constexpr(std::is_same<Key, float>::value)
+		{
+			const __m128 k{_mm_set1_ps(key)};
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128 v{_mm_loadu_ps(keys + i)};
+				ret += __builtin_popcount(_mm_movemask_ps(Inclusive ? _mm_cmple_ps(v, k) : _mm_cmplt_ps(v, k)));
+			}
+		}
+		else if constexpr(std::is_same<Key, double>::value)
+		{
+			const __m128d k{_mm_set1_pd(key)};
+			for(; i + 2 <= count; i += 2)
+			{
+				__m128d v{_mm_loadu_pd(keys + i)};
+				ret += __builtin_popcount(_mm_movemask_pd(Inclusive ? _mm_cmple_pd(v, k) : _mm_cmplt_pd(v, k)));
+			}
+		}
+#endif
+		for(; i < count; ++i)
+			ret += Inclusive ? !(key < keys[i]) : keys[i] < key;
+
+		return ret;
+	}
+
+	/*
+	* Returns index of the first key in @node not less than @key.
+	*/
+	template<typename Node, typename K, typename Compare>
+	size_t lower_index(const Node *node, const K &key, Compare comp)
+	{
+		using Key = std::remove_const_t<std::remove_pointer_t<decltype(node->keys())>>;
+		if constexpr(simd_searchable<Key, K, Compare>::value)
+			return count_before<false>(node->keys(), node->count, key);
+		else
+			return std::lower_bound(node->keys(), node->keys() + node->count, key, comp) - node->keys();
+	}
+
+	/*
+	* Returns index of the first key in @node greater than @key.
+	*/
+	template<typename Node, typename K, typename Compare>
+	size_t upper_index(const Node *node, const K &key, Compare comp)
+	{
+		using Key = std::remove_const_t<std::remove_pointer_t<decltype(node->keys())>>;
+		if constexpr(simd_searchable<Key, K, Compare>::value)
+			return count_before<true>(node->keys(), node->count, key);
+		else
+			return std::upper_bound(node->keys(), node->keys() + node->count, key, comp) - node->keys();
+	}
+	// @}
+
+	// Positions:
+	// @{
+	/*
+	* @brief Moves (@node, @pos) to the next key in order.
+	*
+	* Past the last key the position becomes (rightmost leaf, its count),
+	* which is what end() is.
+	*/
+	template<typename Node>
+	void next_position(Node *&node, int &pos)
+	{
+		if(!node->leaf)									// leftmost key of the right subtree
+		{
+			node = node->child(pos + 1);
+			while(!node->leaf)
+				node = node->child(0);
+			pos = 0;
+			return;
+		}
+
+		if(++pos < node->count)
+			return;
+
+		Node *leaf{node};
+		int end{pos};
+		while(node->parent && pos == node->count)		// climb to the first key on the right
+		{
+			pos = node->position;
+			node = node->parent;
+		}
+
+		if(pos == node->count)
+		{
+			node = leaf;
+			pos = end;
+		}
+	}
+
+	/*
+	* @brief Moves (@node, @pos) to the previous key in order.
+	*/
+	template<typename Node>
+	void prev_position(Node *&node, int &pos)
+	{
+		if(!node->leaf)									// rightmost key of the left subtree
+		{
+			node = node->child(pos);
+			while(!node->leaf)
+				node = node->child(node->count);
+			pos = node->count - 1;
+			return;
+		}
+
+		while(node->parent && 0 == pos)					// climb to the first key on the left
+		{
+			pos = node->position;
+			node = node->parent;
+		}
+		--pos;
+	}
+	// @}
+
+} // nested namespace containers::btree::detail
+
+namespace containers
+{
+
+	// B-tree Set declaration:
+	// @@@{
+	/*
+	*	@brief A sorted container of unique keys with the interface of %set,
+	*	stored in a B-tree.
+	*
+	*	@param Key Type of key objects.
+	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*	@param NodeBytes Target size of a leaf node in bytes, defaults to 256.
+	*	@param Allocator Allocator type, rebound to the node types.
+	*
+	*	Every node holds up to node_capacity keys in one block, so a lookup
+	*	touches a few cache lines per level and there are log(node_capacity)
+	*	times fewer levels than in the AVL tree of %set. Arithmetic keys under
+	*	std::less are searched inside a node with vector compares.
+	*	Unlike %set, insert and erase move keys between nodes, so they
+	*	invalidate all iterators (erase returns a valid one).
+	*/
+	template<
+			typename Key,
+			typename Compare = std::less<Key>,
+			size_t NodeBytes = 256,
+			typename Allocator = std::allocator<Key>
+			>
+	class btree_set
+	{
+		public:
+			// Constants:
+			// @{
+			static constexpr size_t node_capacity = btree::detail::node_capacity<Key>(NodeBytes);
+			static constexpr size_t min_keys = (node_capacity - 1) / 2;
+			// @}
+		private:
+			static_assert(node_capacity <= 0xffff, "btree_set: NodeBytes too large for the key type");
+
+			// Convenience
+			using node_type = btree::detail::btree_node<Key, node_capacity>;
+			using internal_type = btree::detail::btree_internal<Key, node_capacity>;
+			using leaf_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+			using internal_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<internal_type>;
+			template<typename K>
+			using transparent_key = std::enable_if_t<avl::detail::is_transparent<Compare>::value, K>;
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef Key value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef Compare key_compare;
+			typedef Compare value_compare;
+			typedef Key& reference;
+			typedef Key* pointer;
+			typedef const Key& const_reference;
+			typedef const Key* const_pointer;
+			typedef Allocator allocator_type;
+			// @}
+
+			class const_iterator;
+
+			// Iterator
+			// @@{
+			/*
+			* @brief Bidirectional %btree_set iterator, a node and a key index in it.
+			*
+			* Keys are read-only like in every set, so it only differs from
+			* %const_iterator in type.
+			*/
+			class iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef Key value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const Key* pointer;
+					typedef const Key& reference;
+
+					// Friend <3
+					friend class btree_set;
+					friend class const_iterator;
+
+					// Constructor
+					iterator(node_type *node = nullptr, int pos = 0);
+
+					// Operators
+					iterator& operator++();
+					iterator operator++(int);
+					iterator& operator--();
+					iterator operator--(int);
+
+					// Relation
+					bool operator==(const iterator &other) const;
+					bool operator!=(const iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *node;
+					int pos;
+			};
+			// @@}
+
+			// Const Iterator
+			// @@{
+			class const_iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef Key value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const Key* pointer;
+					typedef const Key& reference;
+
+					// Friend <3
+					friend class btree_set;
+
+					// Constructor
+					const_iterator(node_type *node = nullptr, int pos = 0);
+					const_iterator(const iterator &other);							// Convert
+
+					// Operators
+					const_iterator& operator++();
+					const_iterator operator++(int);
+					const_iterator& operator--();
+					const_iterator operator--(int);
+
+					// Relation
+					bool operator==(const const_iterator &other) const;
+					bool operator!=(const const_iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *node;
+					int pos;
+			};
+			// @@}
+
+			// Reverse Iterator
+			typedef std::reverse_iterator<iterator> reverse_iterator;
+
+			// Const Reverse Iterator
+			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			// Constructor
+			btree_set(void);										// Default
+			explicit btree_set(const Allocator &alloc);				// Allocator
+			btree_set(const btree_set &other);						// Copy
+			btree_set(btree_set &&other) noexcept;					// Move
+			btree_set(const std::initializer_list<Key> &ilist);		// Init list
+
+			// Destructor
+			~btree_set(void);
+
+			// Assignment
+			btree_set& operator=(const btree_set &other);						// Copy
+			btree_set& operator=(btree_set &&other) noexcept;					// Move
+			btree_set& operator=(const std::initializer_list<Key> &ilist);		// Init list
+
+			// Iterators
+			iterator begin(void) noexcept;
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			iterator end(void) noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+
+			// Reverse Iterators
+			reverse_iterator rbegin(void) noexcept;
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			reverse_iterator rend(void) noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+			size_type height(void) const noexcept;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			std::pair<iterator, bool> insert(const value_type &value);
+			std::pair<iterator, bool> insert(value_type &&value);
+			void insert(const std::initializer_list<Key> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+
+			// Emplace
+			template<class... Args>
+			std::pair<iterator, bool> emplace(Args &&...args);
+
+			// Erase
+			const_iterator erase(const_iterator position);
+			const_iterator erase(const_iterator first, const_iterator last);
+			size_type erase(const key_type &key);
+
+			// Swap
+			void swap(btree_set &other) noexcept;
+
+			// Lookup
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
+
+			// Find
+			iterator find(const key_type &key);
+			const_iterator find(const key_type &key) const;
+
+			// Equal range
+			std::pair<iterator, iterator> equal_range(const key_type &key);
+			std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const;
+
+			// Bounds
+			iterator lower_bound(const key_type &key);
+			const_iterator lower_bound(const key_type &key) const;
+			iterator upper_bound(const key_type &key);
+			const_iterator upper_bound(const key_type &key) const;
+
+			// Heterogeneous lookup, only with a transparent Compare (e.g. std::less<>)
+			template<typename K, typename = transparent_key<K>>
+			size_type count(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			bool contains(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator find(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator find(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			std::pair<iterator, iterator> equal_range(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator lower_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator lower_bound(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator upper_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator upper_bound(const K &key) const;
+
+			// Observers
+			key_compare key_comp(void) const;
+			value_compare value_comp(void) const;
+			allocator_type get_allocator(void) const;
+		private:
+			// Position of a key, node is nullptr for none
+			using position_type = std::pair<node_type*, int>;
+
+			// Nodes
+			node_type* new_node(bool leaf);
+			void delete_node(node_type *node);
+			void destroy(node_type *node);
+			node_type* clone(const node_type *source, node_type *parent);
+
+			// Key shuffling
+			void insert_key(node_type *node, size_t pos, Key &&key);
+			void remove_key(node_type *node, size_t pos);
+			void insert_child(node_type *node, size_t pos, node_type *child);
+			void remove_child(node_type *node, size_t pos);
+			Key split(node_type *node, node_type *right);
+
+			// Insertion
+			template<typename K>
+			std::pair<iterator, bool> insert_unique(K &&key);
+			position_type insert_leaf(node_type *leaf, size_t pos, Key &&key);
+
+			// Erasure
+			void rotate_right(node_type *parent, size_t pos, position_type &track);
+			void rotate_left(node_type *parent, size_t pos, position_type &track);
+			void merge_children(node_type *parent, size_t pos, position_type &track);
+			void rebalance(node_type *node, position_type &track);
+
+			// Lookup
+			template<typename K>
+			position_type find_position(const K &key) const;
+			template<typename K>
+			position_type lower_position(const K &key) const;
+			template<typename K>
+			position_type upper_position(const K &key) const;
+
+			// Helpers
+			iterator make_iterator(position_type position);
+			const_iterator make_iterator(position_type position) const;
+			void update_bounds(void);
+
+			// Data
+			Allocator alloc;
+			node_type *root, *leftmost, *rightmost;
+			size_type _size;
+	};
+	// @@@}
+
+// B-tree Set implementation:
+// @@@{
+// Iterator
+// @@{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::iterator(node_type *node, int pos)
+	:	node{node},
+		pos{pos}
+{}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator&
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator++()
+{
+	btree::detail::next_position(node, pos);
+	return *this;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator++(int)
+{
+	iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator&
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator--()
+{
+	btree::detail::prev_position(node, pos);
+	return *this;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator--(int)
+{
+	iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator==(const iterator &other) const
+{
+	return node == other.node && pos == other.pos;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator!=(const iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator::reference
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator*() const
+{
+	return node->keys()[pos];
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator::pointer
+btree_set<Key, Compare, NodeBytes, Allocator>::iterator::operator->() const
+{
+	return node->keys() + pos;
+}
+// @@}
+
+// Const Iterator
+// @@{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::const_iterator(node_type *node, int pos)
+	:	node{node},
+		pos{pos}
+{}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::const_iterator(const iterator &other)
+	:	node{other.node},
+		pos{other.pos}
+{}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator&
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator++()
+{
+	btree::detail::next_position(node, pos);
+	return *this;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator++(int)
+{
+	const_iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator&
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator--()
+{
+	btree::detail::prev_position(node, pos);
+	return *this;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator--(int)
+{
+	const_iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator==(const const_iterator &other) const
+{
+	return node == other.node && pos == other.pos;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator!=(const const_iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::reference
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator*() const
+{
+	return node->keys()[pos];
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::pointer
+btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator::operator->() const
+{
+	return node->keys() + pos;
+}
+// @@}
+
+// B-tree Set
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds empty %btree_set, no node is allocated until the first insert.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::btree_set(void)
+	:	btree_set(Allocator{})
+{}
+
+/*
+* @brief Builds empty %btree_set that allocates nodes through @alloc.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::btree_set(const Allocator &alloc)
+	:	alloc{alloc},
+		root{nullptr},
+		leftmost{nullptr},
+		rightmost{nullptr},
+		_size{0}
+{}
+
+/*
+* @brief %btree_set Copy constructor, copies the tree node for node.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::btree_set(const btree_set &other)
+	:	btree_set(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc))
+{
+	if(other.root)
+		root = clone(other.root, nullptr);
+	_size = other._size;
+	update_bounds();
+}
+
+/*
+* @brief %btree_set Move constructor, @other is left empty.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::btree_set(btree_set &&other) noexcept
+	:	alloc{std::move(other.alloc)},
+		root{other.root},
+		leftmost{other.leftmost},
+		rightmost{other.rightmost},
+		_size{other._size}
+{
+	other.root = other.leftmost = other.rightmost = nullptr;
+	other._size = 0;
+}
+
+/*
+* @brief Builds %btree_set from initializer list.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::btree_set(const std::initializer_list<Key> &ilist)
+	:	btree_set()
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>::~btree_set(void)
+{
+	clear();
+}
+// @}
+
+// Assignment:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>&
+btree_set<Key, Compare, NodeBytes, Allocator>::operator=(const btree_set &other)
+{
+	if(this != &other)
+	{
+		btree_set tmp{other};
+		swap(tmp);
+	}
+
+	return *this;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>&
+btree_set<Key, Compare, NodeBytes, Allocator>::operator=(btree_set &&other) noexcept
+{
+	swap(other);
+	other.clear();
+
+	return *this;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+btree_set<Key, Compare, NodeBytes, Allocator>&
+btree_set<Key, Compare, NodeBytes, Allocator>::operator=(const std::initializer_list<Key> &ilist)
+{
+	btree_set tmp{ilist};
+	swap(tmp);
+
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::begin(void) noexcept
+{
+	return iterator{leftmost, 0};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::begin(void) const noexcept
+{
+	return const_iterator{leftmost, 0};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::cbegin(void) const noexcept
+{
+	return begin();
+}
+
+/*
+* End is one past the last key of the rightmost leaf, so it can be decremented.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::end(void) noexcept
+{
+	return iterator{rightmost, rightmost ? rightmost->count : 0};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::end(void) const noexcept
+{
+	return const_iterator{rightmost, rightmost ? rightmost->count : 0};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::cend(void) const noexcept
+{
+	return end();
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::reverse_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::rbegin(void) noexcept
+{
+	return reverse_iterator{end()};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_reverse_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::rbegin(void) const noexcept
+{
+	return const_reverse_iterator{end()};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_reverse_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::crbegin(void) const noexcept
+{
+	return rbegin();
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::reverse_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::rend(void) noexcept
+{
+	return reverse_iterator{begin()};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_reverse_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::rend(void) const noexcept
+{
+	return const_reverse_iterator{begin()};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_reverse_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::crend(void) const noexcept
+{
+	return rend();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::empty(void) const noexcept
+{
+	return 0 == _size;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::size_type
+btree_set<Key, Compare, NodeBytes, Allocator>::size(void) const noexcept
+{
+	return _size;
+}
+
+/*
+* Returns number of levels of the tree, 0 when empty.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::size_type
+btree_set<Key, Compare, NodeBytes, Allocator>::height(void) const noexcept
+{
+	size_type ret{0};
+	for(const node_type *node{root}; node; node = node->leaf ? nullptr : node->child(0))
+		++ret;
+
+	return ret;
+}
+// @}
+
+// Modifiers:
+// @{
+/*
+* @brief Destroys all keys and frees all nodes.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::clear(void)
+{
+	if(root)
+		destroy(root);
+
+	root = leftmost = rightmost = nullptr;
+	_size = 0;
+}
+
+/*
+* @brief Inserts copy of @value unless an equivalent key is present.
+*
+* @return std::pair Iterator to the key with @value and whether it was inserted.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator, bool>
+btree_set<Key, Compare, NodeBytes, Allocator>::insert(const value_type &value)
+{
+	return insert_unique(value);
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator, bool>
+btree_set<Key, Compare, NodeBytes, Allocator>::insert(value_type &&value)
+{
+	return insert_unique(std::move(value));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::insert(const std::initializer_list<Key> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename InputIt>
+void btree_set<Key, Compare, NodeBytes, Allocator>::insert(InputIt first, InputIt last)
+{
+	for(; first != last; ++first)
+		insert_unique(*first);
+}
+
+/*
+* @brief Builds a key from @args and inserts it unless an equivalent key is present.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<class... Args>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator, bool>
+btree_set<Key, Compare, NodeBytes, Allocator>::emplace(Args &&...args)
+{
+	return insert_unique(Key(std::forward<Args>(args)...));
+}
+
+/*
+* @brief Erases key at @position.
+*
+* @return %const_iterator to the key that followed the erased one.
+*
+* A key in an internal node is replaced by its predecessor, which always
+* sits in a leaf, so only leaves lose keys. A leaf left with fewer than
+* min_keys keys borrows one from a sibling or is merged with it, which
+* may repeat up to the root. The returned position is moved along with
+* every key that is shuffled on the way.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::erase(const_iterator position)
+{
+	node_type *node{position.node}, *leaf{node};
+	size_t pos{static_cast<size_t>(position.pos)};
+	position_type next;
+
+	if(node->leaf)
+	{
+		remove_key(node, pos);
+		next = position_type{node, static_cast<int>(pos)};
+	}
+	else														// take over the predecessor
+	{
+		next = position_type{node, static_cast<int>(pos)};
+		btree::detail::next_position(next.first, next.second);
+
+		leaf = node->child(pos);
+		while(!leaf->leaf)
+			leaf = leaf->child(leaf->count);
+
+		node->keys()[pos] = std::move(leaf->keys()[leaf->count - 1]);
+		remove_key(leaf, leaf->count - 1);
+	}
+	--_size;
+
+	rebalance(leaf, next);
+	if(nullptr == root)
+		next = position_type{nullptr, 0};
+
+	// Resolve a position one past the end of its leaf
+	if(next.first && next.second == next.first->count)
+	{
+		node_type *up{next.first};
+		int index{next.second};
+		while(up->parent && index == up->count)
+		{
+			index = up->position;
+			up = up->parent;
+		}
+		next = (index == up->count) ? position_type{nullptr, 0} : position_type{up, index};
+	}
+
+	update_bounds();
+	return make_iterator(next);
+}
+
+/*
+* @brief Erases keys in [@first, @last).
+*
+* Every erase invalidates the iterators, so the range is counted first.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::erase(const_iterator first, const_iterator last)
+{
+	for(auto n{std::distance(first, last)}; n > 0; --n)
+		first = erase(first);
+
+	return first;
+}
+
+/*
+* @brief Erases key equivalent to @key, returns number of keys erased.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::size_type
+btree_set<Key, Compare, NodeBytes, Allocator>::erase(const key_type &key)
+{
+	position_type position{find_position(key)};
+	if(nullptr == position.first)
+		return 0;
+
+	erase(const_iterator{position.first, position.second});
+	return 1;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::swap(btree_set &other) noexcept
+{
+	using std::swap;
+	swap(alloc, other.alloc);
+	swap(root, other.root);
+	swap(leftmost, other.leftmost);
+	swap(rightmost, other.rightmost);
+	swap(_size, other._size);
+}
+// @}
+
+// Lookup:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::size_type
+btree_set<Key, Compare, NodeBytes, Allocator>::count(const key_type &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::contains(const key_type &key) const
+{
+	return nullptr != find_position(key).first;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::find(const key_type &key)
+{
+	return make_iterator(find_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::find(const key_type &key) const
+{
+	return make_iterator(find_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator,
+		typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator>
+btree_set<Key, Compare, NodeBytes, Allocator>::equal_range(const key_type &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator,
+		typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator>
+btree_set<Key, Compare, NodeBytes, Allocator>::equal_range(const key_type &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+/*
+* @brief Returns %iterator to the first key not less than @key, or end().
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::lower_bound(const key_type &key)
+{
+	return make_iterator(lower_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::lower_bound(const key_type &key) const
+{
+	return make_iterator(lower_position(key));
+}
+
+/*
+* @brief Returns %iterator to the first key greater than @key, or end().
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::upper_bound(const key_type &key)
+{
+	return make_iterator(upper_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::upper_bound(const key_type &key) const
+{
+	return make_iterator(upper_position(key));
+}
+// @}
+
+// Heterogeneous lookup:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::size_type
+btree_set<Key, Compare, NodeBytes, Allocator>::count(const K &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+bool btree_set<Key, Compare, NodeBytes, Allocator>::contains(const K &key) const
+{
+	return nullptr != find_position(key).first;
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::find(const K &key)
+{
+	return make_iterator(find_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::find(const K &key) const
+{
+	return make_iterator(find_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator,
+		typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator>
+btree_set<Key, Compare, NodeBytes, Allocator>::equal_range(const K &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator,
+		typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator>
+btree_set<Key, Compare, NodeBytes, Allocator>::equal_range(const K &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::lower_bound(const K &key)
+{
+	return make_iterator(lower_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::lower_bound(const K &key) const
+{
+	return make_iterator(lower_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::upper_bound(const K &key)
+{
+	return make_iterator(upper_position(key));
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K, typename>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::upper_bound(const K &key) const
+{
+	return make_iterator(upper_position(key));
+}
+// @}
+
+// Observers:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::key_compare
+btree_set<Key, Compare, NodeBytes, Allocator>::key_comp(void) const
+{
+	return Compare{};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::value_compare
+btree_set<Key, Compare, NodeBytes, Allocator>::value_comp(void) const
+{
+	return Compare{};
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::allocator_type
+btree_set<Key, Compare, NodeBytes, Allocator>::get_allocator(void) const
+{
+	return alloc;
+}
+// @}
+
+// Nodes:
+// @{
+/*
+* Allocates an empty leaf or internal node.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::node_type*
+btree_set<Key, Compare, NodeBytes, Allocator>::new_node(bool leaf)
+{
+	if(leaf)
+	{
+		leaf_allocator a{alloc};
+		node_type *node{std::allocator_traits<leaf_allocator>::allocate(a, 1)};
+		return ::new(static_cast<void*>(node)) node_type{true};
+	}
+
+	internal_allocator a{alloc};
+	internal_type *node{std::allocator_traits<internal_allocator>::allocate(a, 1)};
+	return ::new(static_cast<void*>(node)) internal_type{};
+}
+
+/*
+* Frees @node, its keys have to be destroyed already. Nodes themselves are
+* trivially destructible.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::delete_node(node_type *node)
+{
+	static_assert(std::is_trivially_destructible<internal_type>::value, "btree_set: nodes must be trivially destructible");
+
+	if(node->leaf)
+	{
+		leaf_allocator a{alloc};
+		std::allocator_traits<leaf_allocator>::deallocate(a, node, 1);
+	}
+	else
+	{
+		internal_allocator a{alloc};
+		std::allocator_traits<internal_allocator>::deallocate(a, static_cast<internal_type*>(node), 1);
+	}
+}
+
+/*
+* Destroys keys of the subtree rooted at @node and frees its nodes.
+* Recursion depth is the height of the tree.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::destroy(node_type *node)
+{
+	if(!node->leaf)
+		for(size_t i = 0; i <= node->count; ++i)
+			if(node->child(i))
+				destroy(node->child(i));
+
+	std::destroy_n(node->keys(), node->count);
+	delete_node(node);
+}
+
+/*
+* @brief Copies subtree rooted at @source, the copy hangs off @parent.
+*
+* If a copy throws, everything copied so far is freed.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::node_type*
+btree_set<Key, Compare, NodeBytes, Allocator>::clone(const node_type *source, node_type *parent)
+{
+	node_type *node{new_node(source->leaf)};
+	node->parent = parent;
+	node->position = source->position;
+
+	try
+	{
+		for(; node->count < source->count; ++node->count)
+			::new(static_cast<void*>(node->keys() + node->count)) Key(source->keys()[node->count]);
+
+		if(!source->leaf)
+			for(size_t i = 0; i <= source->count; ++i)
+				node->child(i) = clone(source->child(i), node);
+	}
+	catch(...)
+	{
+		destroy(node);
+		throw;
+	}
+
+	return node;
+}
+// @}
+
+// Key shuffling:
+// @{
+/*
+* @brief Moves @key into @node at index @pos, @node must not be full.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::insert_key(node_type *node, size_t pos, Key &&key)
+{
+	Key *keys{node->keys()};
+	if(pos < node->count)
+	{
+		::new(static_cast<void*>(keys + node->count)) Key(std::move(keys[node->count - 1]));
+		std::move_backward(keys + pos, keys + node->count - 1, keys + node->count);
+		keys[pos] = std::move(key);
+	}
+	else
+		::new(static_cast<void*>(keys + pos)) Key(std::move(key));
+
+	++node->count;
+}
+
+/*
+* @brief Removes key at index @pos from @node, keys after it move down.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::remove_key(node_type *node, size_t pos)
+{
+	Key *keys{node->keys()};
+	std::move(keys + pos + 1, keys + node->count, keys + pos);
+	std::destroy_at(keys + node->count - 1);
+	--node->count;
+}
+
+/*
+* @brief Puts @child at index @pos of @node, children from @pos on move up.
+*
+* Called right after the matching key was inserted, so @node->count
+* already includes it and @node has @node->count + 1 children after this.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::insert_child(node_type *node, size_t pos, node_type *child)
+{
+	for(size_t i = node->count; i > pos; --i)
+	{
+		node->child(i) = node->child(i - 1);
+		node->child(i)->position = static_cast<unsigned short>(i);
+	}
+
+	node->child(pos) = child;
+	child->parent = node;
+	child->position = static_cast<unsigned short>(pos);
+}
+
+/*
+* @brief Removes child at index @pos of @node, children after it move down.
+*
+* Called right after the matching key was removed, @node->count is already
+* the new one.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::remove_child(node_type *node, size_t pos)
+{
+	for(size_t i = pos; i <= node->count; ++i)
+	{
+		node->child(i) = node->child(i + 1);
+		node->child(i)->position = static_cast<unsigned short>(i);
+	}
+	node->child(node->count + 1) = nullptr;
+}
+
+/*
+* @brief Splits full @node, the upper half goes to the empty node @right.
+*
+* @return Key The median, which belongs between @node and @right in the parent.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+Key btree_set<Key, Compare, NodeBytes, Allocator>::split(node_type *node, node_type *right)
+{
+	constexpr size_t middle{node_capacity / 2};
+	Key *keys{node->keys()};
+
+	std::uninitialized_move(keys + middle + 1, keys + node_capacity, right->keys());
+	std::destroy(keys + middle + 1, keys + node_capacity);
+	right->count = static_cast<unsigned short>(node_capacity - middle - 1);
+
+	if(!node->leaf)
+		for(size_t i = 0; i <= right->count; ++i)
+		{
+			right->child(i) = node->child(middle + 1 + i);
+			right->child(i)->parent = right;
+			right->child(i)->position = static_cast<unsigned short>(i);
+			node->child(middle + 1 + i) = nullptr;
+		}
+
+	Key median{std::move(keys[middle])};
+	std::destroy_at(keys + middle);
+	node->count = static_cast<unsigned short>(middle);
+
+	return median;
+}
+// @}
+
+// Insertion:
+// @{
+/*
+* @brief Inserts key built from @key unless an equivalent key is present.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K>
+std::pair<typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator, bool>
+btree_set<Key, Compare, NodeBytes, Allocator>::insert_unique(K &&key)
+{
+	if(nullptr == root)
+	{
+		node_type *leaf{new_node(true)};
+		try
+		{
+			::new(static_cast<void*>(leaf->keys())) Key(std::forward<K>(key));
+		}
+		catch(...)
+		{
+			delete_node(leaf);
+			throw;
+		}
+		leaf->count = 1;
+
+		root = leftmost = rightmost = leaf;
+		_size = 1;
+		return std::make_pair(begin(), true);
+	}
+
+	Compare comp{};
+	node_type *node{root};
+	size_t pos;
+	for(;;)
+	{
+		pos = btree::detail::lower_index(node, key, comp);
+		if(pos < node->count && !comp(key, node->keys()[pos]))
+			return std::make_pair(iterator{node, static_cast<int>(pos)}, false);
+		if(node->leaf)
+			break;
+		node = node->child(pos);
+	}
+
+	position_type position{insert_leaf(node, pos, Key(std::forward<K>(key)))};
+	++_size;
+
+	return std::make_pair(iterator{position.first, position.second}, true);
+}
+
+/*
+* @brief Inserts @key at index @pos of @leaf, splitting full nodes on the way up.
+*
+* @return position_type Where @key ended up.
+*
+* Every node the split will need is allocated before any key moves, so
+* if allocation throws the tree is untouched.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::position_type
+btree_set<Key, Compare, NodeBytes, Allocator>::insert_leaf(node_type *leaf, size_t pos, Key &&key)
+{
+	if(leaf->count < node_capacity)
+	{
+		insert_key(leaf, pos, std::move(key));
+		return position_type{leaf, static_cast<int>(pos)};
+	}
+
+	// One new node per full level, plus a new root if every level is full
+	node_type *spare[64], *top{leaf};
+	size_t needed{0};
+	for(; top && top->count == node_capacity; top = top->parent)
+		++needed;
+	bool grow{nullptr == top};
+
+	size_t made{0};
+	try
+	{
+		for(; made < needed + grow; ++made)
+			spare[made] = new_node(0 == made);
+	}
+	catch(...)
+	{
+		while(made)
+			delete_node(spare[--made]);
+		throw;
+	}
+
+	position_type ret;
+	node_type *node{leaf}, *carry_child{nullptr};
+	Key carry{std::move(key)};
+
+	for(size_t level = 0; ; ++level)
+	{
+		if(node->count < node_capacity)
+		{
+			insert_key(node, pos, std::move(carry));
+			if(carry_child)
+				insert_child(node, pos + 1, carry_child);
+			if(0 == level)
+				ret = position_type{node, static_cast<int>(pos)};
+			break;
+		}
+
+		node_type *right{spare[level]};
+		Key median{split(node, right)};
+
+		node_type *target{node};
+		if(pos > node->count)
+		{
+			target = right;
+			pos -= node->count + 1;
+		}
+		insert_key(target, pos, std::move(carry));
+		if(carry_child)
+			insert_child(target, pos + 1, carry_child);
+		if(0 == level)
+			ret = position_type{target, static_cast<int>(pos)};
+
+		if(nullptr == node->parent)						// the root split, grow a level
+		{
+			node_type *top{spare[level + 1]};
+			::new(static_cast<void*>(top->keys())) Key(std::move(median));
+			top->count = 1;
+			top->child(0) = node;
+			top->child(1) = right;
+			node->parent = right->parent = top;
+			node->position = 0;
+			right->position = 1;
+			root = top;
+			break;
+		}
+
+		carry = std::move(median);
+		carry_child = right;
+		pos = node->position;
+		node = node->parent;
+	}
+
+	update_bounds();
+	return ret;
+}
+// @}
+
+// Erasure:
+// @{
+/*
+* @brief Moves the last key of child @pos of @parent through the parent
+* into child @pos + 1, which is short of keys.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::rotate_right(node_type *parent, size_t pos, position_type &track)
+{
+	node_type *left{parent->child(pos)}, *node{parent->child(pos + 1)};
+	int last{left->count - 1};
+
+	if(track.first == node)
+		++track.second;
+	else if(track.first == parent && track.second == static_cast<int>(pos))
+		track = position_type{node, 0};
+	else if(track.first == left && track.second == last)
+		track = position_type{parent, static_cast<int>(pos)};
+
+	insert_key(node, 0, std::move(parent->keys()[pos]));
+	parent->keys()[pos] = std::move(left->keys()[last]);
+	remove_key(left, last);
+
+	if(!node->leaf)
+	{
+		node_type *child{left->child(last + 1)};
+		left->child(last + 1) = nullptr;
+		insert_child(node, 0, child);
+	}
+}
+
+/*
+* @brief Moves the first key of child @pos + 1 of @parent through the
+* parent into child @pos, which is short of keys.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::rotate_left(node_type *parent, size_t pos, position_type &track)
+{
+	node_type *node{parent->child(pos)}, *right{parent->child(pos + 1)};
+
+	if(track.first == parent && track.second == static_cast<int>(pos))
+		track = position_type{node, node->count};
+	else if(track.first == right)
+		track = (0 == track.second) ? position_type{parent, static_cast<int>(pos)}
+				: position_type{right, track.second - 1};
+
+	insert_key(node, node->count, std::move(parent->keys()[pos]));
+	parent->keys()[pos] = std::move(right->keys()[0]);
+	remove_key(right, 0);
+
+	if(!node->leaf)
+	{
+		node_type *child{right->child(0)};
+		for(size_t i = 0; i <= right->count; ++i)
+		{
+			right->child(i) = right->child(i + 1);
+			right->child(i)->position = static_cast<unsigned short>(i);
+		}
+		right->child(right->count + 1) = nullptr;
+		insert_child(node, node->count, child);
+	}
+}
+
+/*
+* @brief Merges child @pos + 1 of @parent and the key between them into child @pos.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::merge_children(node_type *parent, size_t pos, position_type &track)
+{
+	node_type *left{parent->child(pos)}, *right{parent->child(pos + 1)};
+	int base{left->count};
+
+	if(track.first == parent)
+	{
+		if(track.second == static_cast<int>(pos))
+			track = position_type{left, base};
+		else if(track.second > static_cast<int>(pos))
+			--track.second;
+	}
+	else if(track.first == right)
+		track = position_type{left, base + 1 + track.second};
+
+	insert_key(left, left->count, std::move(parent->keys()[pos]));
+	std::uninitialized_move(right->keys(), right->keys() + right->count, left->keys() + left->count);
+	std::destroy_n(right->keys(), right->count);
+
+	if(!left->leaf)
+		for(size_t i = 0; i <= right->count; ++i)
+		{
+			node_type *child{right->child(i)};
+			left->child(left->count + i) = child;
+			child->parent = left;
+			child->position = static_cast<unsigned short>(left->count + i);
+		}
+	left->count = static_cast<unsigned short>(left->count + right->count);
+	right->count = 0;
+
+	remove_key(parent, pos);
+	remove_child(parent, pos + 1);
+	delete_node(right);
+}
+
+/*
+* @brief Restores the minimum fill from @node up after it lost a key.
+*
+* @param track Position kept pointing at the same key while keys move.
+*
+* A sibling with keys to spare lends one through the parent, otherwise
+* the node is merged with a sibling, which takes a key from the parent.
+* An empty root is replaced by its only child.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::rebalance(node_type *node, position_type &track)
+{
+	while(node != root && node->count < min_keys)
+	{
+		node_type *parent{node->parent};
+		size_t pos{node->position};
+
+		if(pos > 0 && parent->child(pos - 1)->count > min_keys)
+		{
+			rotate_right(parent, pos - 1, track);
+			return;
+		}
+		if(pos < parent->count && parent->child(pos + 1)->count > min_keys)
+		{
+			rotate_left(parent, pos, track);
+			return;
+		}
+
+		merge_children(parent, pos < parent->count ? pos : pos - 1, track);
+		node = parent;
+	}
+
+	if(0 == root->count)
+	{
+		node_type *old{root};
+		root = root->leaf ? nullptr : root->child(0);
+		if(root)
+		{
+			root->parent = nullptr;
+			root->position = 0;
+		}
+		delete_node(old);
+	}
+}
+// @}
+
+// Lookup helpers:
+// @{
+/*
+* Returns position of key equivalent to @key, node is nullptr if there is none.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::position_type
+btree_set<Key, Compare, NodeBytes, Allocator>::find_position(const K &key) const
+{
+	Compare comp{};
+	for(node_type *node{root}; node; )
+	{
+		size_t pos{btree::detail::lower_index(node, key, comp)};
+		if(pos < node->count && !comp(key, node->keys()[pos]))
+			return position_type{node, static_cast<int>(pos)};
+		if(node->leaf)
+			break;
+		node = node->child(pos);
+	}
+
+	return position_type{nullptr, 0};
+}
+
+/*
+* Returns position of the first key not less than @key. The bound is in
+* the leaf the search ends in, or it is the last key passed on the way down.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::position_type
+btree_set<Key, Compare, NodeBytes, Allocator>::lower_position(const K &key) const
+{
+	Compare comp{};
+	position_type ret{nullptr, 0};
+	for(node_type *node{root}; node; )
+	{
+		size_t pos{btree::detail::lower_index(node, key, comp)};
+		if(pos < node->count)
+			ret = position_type{node, static_cast<int>(pos)};
+		node = node->leaf ? nullptr : node->child(pos);
+	}
+
+	return ret;
+}
+
+/*
+* Returns position of the first key greater than @key.
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+template<typename K>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::position_type
+btree_set<Key, Compare, NodeBytes, Allocator>::upper_position(const K &key) const
+{
+	Compare comp{};
+	position_type ret{nullptr, 0};
+	for(node_type *node{root}; node; )
+	{
+		size_t pos{btree::detail::upper_index(node, key, comp)};
+		if(pos < node->count)
+			ret = position_type{node, static_cast<int>(pos)};
+		node = node->leaf ? nullptr : node->child(pos);
+	}
+
+	return ret;
+}
+// @}
+
+// Helpers:
+// @{
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::make_iterator(position_type position)
+{
+	return position.first ? iterator{position.first, position.second} : end();
+}
+
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+typename btree_set<Key, Compare, NodeBytes, Allocator>::const_iterator
+btree_set<Key, Compare, NodeBytes, Allocator>::make_iterator(position_type position) const
+{
+	return position.first ? const_iterator{position.first, position.second} : end();
+}
+
+/*
+* Finds leftmost and rightmost leaf, O(height).
+*/
+template<typename Key, typename Compare, size_t NodeBytes, typename Allocator>
+void btree_set<Key, Compare, NodeBytes, Allocator>::update_bounds(void)
+{
+	leftmost = rightmost = root;
+	if(nullptr == root)
+		return;
+
+	while(!leftmost->leaf)
+		leftmost = leftmost->child(0);
+	while(!rightmost->leaf)
+		rightmost = rightmost->child(rightmost->count);
+}
+// @}
+// @@}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_BTREE_SET_HPP_
@@ -0,0 +1,874 @@
+#ifndef _CONTAINERS_CONCURRENT_SET_HPP_
+#define _CONTAINERS_CONCURRENT_SET_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace containers::skip::detail
+{
+
+	constexpr size_t cache_line = 64;
+
+	// Skip Node declaration:
+	// @@{
+	/*
+	* @brief A node of %concurrent_set.
+	*
+	* @param Key Type of key objects.
+	*
+	* The forward links live right behind the node in the same allocation,
+	* one per level. The key is constructed in place only for real nodes,
+	* the head of the list has no key.
+	* @marked is set once the node is logically erased, @linked once it is
+	* reachable on all of its levels, and @locked is a spinlock taken by
+	* writers that relink the node or its successors.
+	*/
+	template<typename Key>
+	struct skip_node
+	{
+		// Convenience
+		using link = std::atomic<skip_node*>;
+
+		// Constructor
+		skip_node(link *next, int levels);
+
+		// Access
+		Key& key(void);
+		const Key& key(void) const;
+
+		// Lock
+		void lock(void);
+		void unlock(void);
+
+		// Data
+		alignas(Key) unsigned char storage[sizeof(Key)];
+		link *next;
+		int levels;
+		std::atomic<bool> marked, linked, locked;
+	};
+	// @@}
+
+	// Skip Node implementation:
+	// @@{
+	/*
+	* @brief Builds unmarked and unlinked %skip_node, the key is not constructed.
+	*/
+	template<typename Key>
+	skip_node<Key>::skip_node(link *next, int levels)
+		:	next{next},
+			levels{levels},
+			marked{false},
+			linked{false},
+			locked{false}
+	{}
+
+	template<typename Key>
+	Key& skip_node<Key>::key(void)
+	{
+		return *std::launder(reinterpret_cast<Key*>(storage));
+	}
+
+	template<typename Key>
+	const Key& skip_node<Key>::key(void) const
+	{
+		return *std::launder(reinterpret_cast<const Key*>(storage));
+	}
+
+	/*
+	* Test and test-and-set, yields after a few rounds so a preempted
+	* owner gets to run.
+	*/
+	template<typename Key>
+	void skip_node<Key>::lock(void)
+	{
+		for(int spins{0}; locked.exchange(true, std::memory_order_acquire); )
+			while(locked.load(std::memory_order_relaxed))
+				if(++spins > 64)
+					std::this_thread::yield();
+	}
+
+	template<typename Key>
+	void skip_node<Key>::unlock(void)
+	{
+		locked.store(false, std::memory_order_release);
+	}
+	// @@}
+
+	// Node memory:
+	// @{
+	/*
+	* @brief Allocates node with @levels links, all null, key not constructed.
+	*/
+	template<typename Key>
+	skip_node<Key>* allocate_node(int levels)
+	{
+		using node = skip_node<Key>;
+		using link = typename node::link;
+		constexpr size_t offset{(sizeof(node) + alignof(link) - 1) / alignof(link) * alignof(link)};
+
+		unsigned char *raw{static_cast<unsigned char*>(::operator new(offset + levels * sizeof(link),
+				std::align_val_t{alignof(node)}))};
+		link *next{reinterpret_cast<link*>(raw + offset)};
+		for(int l{0}; l < levels; ++l)
+			::new(static_cast<void*>(next + l)) link{nullptr};
+
+		return ::new(static_cast<void*>(raw)) node{next, levels};
+	}
+
+	/*
+	* @brief Frees node made by allocate_node(), the key has to be destroyed already.
+	*/
+	template<typename Key>
+	void deallocate_node(skip_node<Key> *node)
+	{
+		using link = typename skip_node<Key>::link;
+		for(int l{0}; l < node->levels; ++l)
+			node->next[l].~link();
+
+		node->~skip_node();
+		::operator delete(static_cast<void*>(node), std::align_val_t{alignof(skip_node<Key>)});
+	}
+
+	/*
+	* @brief Allocates node with @levels links and a key built from @args.
+	*/
+	template<typename Key, class ...Args>
+	skip_node<Key>* make_node(int levels, Args &&...args)
+	{
+		skip_node<Key> *node{allocate_node<Key>(levels)};
+		try
+		{
+			::new(static_cast<void*>(node->storage)) Key(std::forward<Args>(args)...);
+		}
+		catch(...)
+		{
+			deallocate_node(node);
+			throw;
+		}
+
+		return node;
+	}
+
+	/*
+	* @brief Destroys key of @node and frees it.
+	*/
+	template<typename Key>
+	struct release_node
+	{
+		void operator()(skip_node<Key> *node) const
+		{
+			node->key().~Key();
+			deallocate_node(node);
+		}
+	};
+	// @}
+
+	// Epoch Domain declaration:
+	// @@{
+	/*
+	* @brief Deferred reclamation of unlinked nodes.
+	*
+	* @param Node Type of nodes retired.
+	* @param Release Called on a node once no reader can see it anymore.
+	*
+	* Every operation pins the current epoch for as long as it may hold
+	* node pointers. Pins are counted per epoch parity in striped counters,
+	* so readers only ever touch their own cache line.
+	* A node retired in epoch e can only be seen by readers pinned in e or
+	* earlier. The epoch moves from e to e + 1 once nobody is pinned in
+	* e - 1, after which the nodes retired in e - 1 are released.
+	*/
+	template<typename Node, typename Release>
+	class epoch_domain
+	{
+		public:
+			// Constants:
+			// @{
+			static constexpr size_t stripes = 16;
+			static constexpr size_t collect_every = 64;
+			// @}
+
+			/*
+			* @brief Keeps the epoch it was made in pinned until destroyed.
+			*/
+			class guard
+			{
+				public:
+					guard(std::atomic<size_t> *counter);
+					guard(const guard &other) = delete;
+					guard(guard &&other) noexcept;
+					~guard(void);
+				private:
+					std::atomic<size_t> *counter;
+			};
+
+			// Constructor
+			epoch_domain(void);
+			epoch_domain(const epoch_domain &other) = delete;
+
+			// Destructor
+			~epoch_domain(void);
+
+			// Readers
+			guard pin(void);
+
+			// Writers
+			void retire(Node *node);
+		private:
+			struct alignas(cache_line) counter
+			{
+				std::atomic<size_t> active{0};
+			};
+
+			// Helpers
+			static size_t stripe(void);
+			bool quiescent(size_t parity) const;
+			void collect(void);
+
+			// Data
+			counter readers[2][stripes];
+			alignas(cache_line) std::atomic<uint64_t> epoch;
+			std::mutex limbo_lock;
+			std::vector<Node*> limbo[3];
+			size_t pending;
+	};
+	// @@}
+
+	// Epoch Domain implementation:
+	// @@{
+	template<typename Node, typename Release>
+	epoch_domain<Node, Release>::guard::guard(std::atomic<size_t> *counter)
+		:	counter{counter}
+	{}
+
+	template<typename Node, typename Release>
+	epoch_domain<Node, Release>::guard::guard(guard &&other) noexcept
+		:	counter{other.counter}
+	{
+		other.counter = nullptr;
+	}
+
+	template<typename Node, typename Release>
+	epoch_domain<Node, Release>::guard::~guard(void)
+	{
+		if(counter)
+			counter->fetch_sub(1, std::memory_order_release);
+	}
+
+	template<typename Node, typename Release>
+	epoch_domain<Node, Release>::epoch_domain(void)
+		:	epoch{0},
+			pending{0}
+	{}
+
+	/*
+	* Releases every retired node, nobody may be pinned anymore.
+	*/
+	template<typename Node, typename Release>
+	epoch_domain<Node, Release>::~epoch_domain(void)
+	{
+		for(auto &list : limbo)
+			for(Node *node : list)
+				Release{}(node);
+	}
+
+	/*
+	* @brief Pins the current epoch.
+	*
+	* Retries only if the epoch moved between reading it and announcing
+	* the pin, which happens at most once per collect().
+	*/
+	template<typename Node, typename Release>
+	typename epoch_domain<Node, Release>::guard
+	epoch_domain<Node, Release>::pin(void)
+	{
+		size_t slot{stripe()};
+		for(;;)
+		{
+			uint64_t current{epoch.load()};
+			std::atomic<size_t> *counter{&readers[current & 1][slot].active};
+
+			counter->fetch_add(1);
+			if(epoch.load() == current)
+				return guard{counter};
+			counter->fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	/*
+	* @brief Hands an unlinked @node over for deferred release.
+	*
+	* Every collect_every retirements an attempt is made to advance the epoch.
+	*/
+	template<typename Node, typename Release>
+	void epoch_domain<Node, Release>::retire(Node *node)
+	{
+		std::lock_guard<std::mutex> lock{limbo_lock};
+		limbo[epoch.load() % 3].push_back(node);
+
+		if(++pending >= collect_every)
+		{
+			pending = 0;
+			collect();
+		}
+	}
+
+	/*
+	* Returns stripe of the calling thread, threads are spread round robin.
+	*/
+	template<typename Node, typename Release>
+	size_t epoch_domain<Node, Release>::stripe(void)
+	{
+		static std::atomic<size_t> next{0};
+		thread_local size_t slot{next.fetch_add(1, std::memory_order_relaxed) % stripes};
+
+		return slot;
+	}
+
+	template<typename Node, typename Release>
+	bool epoch_domain<Node, Release>::quiescent(size_t parity) const
+	{
+		for(const auto &c : readers[parity])
+			if(c.active.load())
+				return false;
+
+		return true;
+	}
+
+	/*
+	* Advances the epoch if nobody is pinned in the previous one and releases
+	* what was retired there. Called with @limbo_lock held, which makes the
+	* caller the only thread that may move the epoch.
+	*/
+	template<typename Node, typename Release>
+	void epoch_domain<Node, Release>::collect(void)
+	{
+		uint64_t current{epoch.load()};
+		if(!quiescent((current + 1) & 1))
+			return;
+
+		epoch.store(current + 1);
+
+		std::vector<Node*> &safe{limbo[(current + 2) % 3]};
+		for(Node *node : safe)
+			Release{}(node);
+		safe.clear();
+	}
+	// @@}
+
+} // nested namespace containers::skip::detail
+
+namespace containers
+{
+
+	// Concurrent Set declaration:
+	// @@@{
+	/*
+	*	@brief An ordered set of unique keys that any number of threads
+	*	may use at once.
+	*
+	*	@param Key Type of key objects.
+	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*
+	*	Keys are kept in a lazy skip list (Herlihy, Lev, Luchangco, Shavit).
+	*	Lookups take no locks and never retry, they only pin the current
+	*	epoch. insert() and erase() lock just the predecessors of the key on
+	*	the levels they change, so writers on different parts of the set do
+	*	not wait for each other.
+	*	Erased nodes are unlinked right away but freed only once no
+	*	operation that started before the unlink is still running.
+	*	size() and for_each() are not linearizable, they see every key that
+	*	stays in the set for the duration of the call.
+	*/
+	template<
+			typename Key,
+			typename Compare = std::less<Key>
+			>
+	class concurrent_set
+	{
+		// Convenience
+		using node_type = skip::detail::skip_node<Key>;
+		using domain_type = skip::detail::epoch_domain<node_type, skip::detail::release_node<Key>>;
+
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef Key value_type;
+			typedef size_t size_type;
+			typedef Compare key_compare;
+			typedef Compare value_compare;
+			// @}
+
+			// Constants:
+			// @{
+			static constexpr int max_level = 24;
+			// @}
+
+			// Constructor
+			concurrent_set(void);
+			concurrent_set(const concurrent_set &other) = delete;
+
+			// Destructor
+			~concurrent_set(void);
+
+			// Assignment
+			concurrent_set& operator=(const concurrent_set &other) = delete;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Modifiers
+			bool insert(const key_type &key);
+			bool insert(key_type &&key);
+			bool erase(const key_type &key);
+
+			// Lookup
+			bool contains(const key_type &key) const;
+			size_type count(const key_type &key) const;
+
+			// Traversal
+			template<class Function>
+			void for_each(Function f) const;
+
+			// Diagnostics
+			void validate(void) const;
+		private:
+			// Helpers
+			template<typename K>
+			bool insert_unique(K &&key);
+			int find(const key_type &key, node_type **preds, node_type **succs) const;
+			bool lock_preds(node_type **preds, node_type **succs, int levels, const node_type *victim, int &locked) const;
+			static void unlock_preds(node_type **preds, int locked);
+			static int random_level(void);
+
+			// Data
+			node_type *head;
+			std::atomic<int> height;
+			std::atomic<size_type> _size;
+			mutable domain_type domain;
+	};
+	// @@@}
+
+	// Concurrent Set implementation:
+	// @@@{
+	// Construction/destruction:
+	// @{
+	/*
+	* @brief Builds empty %concurrent_set.
+	*/
+	template<typename Key, typename Compare>
+	concurrent_set<Key, Compare>::concurrent_set(void)
+		:	head{skip::detail::allocate_node<Key>(max_level)},
+			height{1},
+			_size{0}
+	{}
+
+	/*
+	* Frees all nodes, no other thread may use *this anymore.
+	*/
+	template<typename Key, typename Compare>
+	concurrent_set<Key, Compare>::~concurrent_set(void)
+	{
+		node_type *node{head->next[0].load(std::memory_order_relaxed)};
+		while(node)
+		{
+			node_type *next{node->next[0].load(std::memory_order_relaxed)};
+			skip::detail::release_node<Key>{}(node);
+			node = next;
+		}
+
+		skip::detail::deallocate_node(head);
+	}
+	// @}
+
+	// Capacity:
+	// @{
+	template<typename Key, typename Compare>
+	bool concurrent_set<Key, Compare>::empty(void) const noexcept
+	{
+		return 0 == size();
+	}
+
+	/*
+	* Returns number of keys, exact only while no insert or erase is running.
+	*/
+	template<typename Key, typename Compare>
+	typename concurrent_set<Key, Compare>::size_type
+	concurrent_set<Key, Compare>::size(void) const noexcept
+	{
+		return _size.load(std::memory_order_relaxed);
+	}
+	// @}
+
+	// Modifiers:
+	// @{
+	/*
+	* @brief Inserts copy of @key.
+	*
+	* @return bool True if @key was inserted, false if an equivalent key was present.
+	*/
+	template<typename Key, typename Compare>
+	bool concurrent_set<Key, Compare>::insert(const key_type &key)
+	{
+		return insert_unique(key);
+	}
+
+	/*
+	* @brief Moves @key into %concurrent_set.
+	*
+	* @return bool True if @key was inserted, false if an equivalent key was present.
+	*/
+	template<typename Key, typename Compare>
+	bool concurrent_set<Key, Compare>::insert(key_type &&key)
+	{
+		return insert_unique(std::move(key));
+	}
+
+	/*
+	* @brief Erases key equivalent to @key.
+	*
+	* @return bool True if this call erased the key.
+	*
+	* The node is marked first, which is the point the key leaves the set,
+	* then unlinked on every level with its predecessors locked.
+	*/
+	template<typename Key, typename Compare>
+	bool concurrent_set<Key, Compare>::erase(const key_type &key)
+	{
+		auto guard{domain.pin()};
+		node_type *preds[max_level], *succs[max_level];
+		node_type *victim{nullptr};
+
+		for(;;)
+		{
+			int found{find(victim ? victim->key() : key, preds, succs)};
+
+			if(nullptr == victim)
+			{
+				if(-1 == found)
+					return false;
+
+				node_type *node{succs[found]};
+				if(!node->linked.load(std::memory_order_acquire) || node->levels - 1 != found
+						|| node->marked.load(std::memory_order_acquire))
+					return false;
+
+				node->lock();
+				if(node->marked.load(std::memory_order_relaxed))
+				{
+					node->unlock();
+					return false;
+				}
+				node->marked.store(true, std::memory_order_release);
+				victim = node;
+			}
+
+			int locked{-1};
+			if(!lock_preds(preds, succs, victim->levels, victim, locked))
+			{
+				unlock_preds(preds, locked);
+				continue;
+			}
+
+			for(int l{victim->levels - 1}; l >= 0; --l)
+				preds[l]->next[l].store(victim->next[l].load(std::memory_order_relaxed), std::memory_order_release);
+
+			victim->unlock();
+			unlock_preds(preds, locked);
+			_size.fetch_sub(1, std::memory_order_relaxed);
+			domain.retire(victim);
+
+			return true;
+		}
+	}
+	// @}
+
+	// Lookup:
+	// @{
+	/*
+	* @brief Checks whether a key equivalent to @key is in %concurrent_set.
+	*
+	* Wait-free apart from pinning the epoch, no locks are taken.
+	*/
+	template<typename Key, typename Compare>
+	bool concurrent_set<Key, Compare>::contains(const key_type &key) const
+	{
+		auto guard{domain.pin()};
+		Compare comp{};
+
+		node_type *pred{head};
+		for(int l{height.load(std::memory_order_acquire) - 1}; l >= 0; --l)
+		{
+			node_type *curr{pred->next[l].load(std::memory_order_acquire)};
+			while(curr && comp(curr->key(), key))
+			{
+				pred = curr;
+				curr = pred->next[l].load(std::memory_order_acquire);
+			}
+
+			if(curr && !comp(key, curr->key()))
+				return curr->linked.load(std::memory_order_acquire) && !curr->marked.load(std::memory_order_acquire);
+		}
+
+		return false;
+	}
+
+	/*
+	* @brief Returns 1 if a key equivalent to @key is in %concurrent_set, 0 otherwise.
+	*/
+	template<typename Key, typename Compare>
+	typename concurrent_set<Key, Compare>::size_type
+	concurrent_set<Key, Compare>::count(const key_type &key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+	// @}
+
+	// Traversal:
+	// @{
+	/*
+	* @brief Calls @f on every key in ascending order.
+	*
+	* Keys inserted or erased while the walk is running may or may not be seen.
+	*/
+	template<typename Key, typename Compare>
+	template<class Function>
+	void concurrent_set<Key, Compare>::for_each(Function f) const
+	{
+		auto guard{domain.pin()};
+
+		for(node_type *node{head->next[0].load(std::memory_order_acquire)}; node;
+				node = node->next[0].load(std::memory_order_acquire))
+			if(node->linked.load(std::memory_order_acquire) && !node->marked.load(std::memory_order_acquire))
+				f(static_cast<const Key&>(node->key()));
+	}
+	// @}
+
+	// Diagnostics:
+	// @{
+	/*
+	* @brief Checks every invariant of the skip list, throws std::logic_error
+	* naming the first one broken.
+	*
+	* Keys are strictly ascending on every level, every node on a level is on
+	* the level below too, no node is marked or half linked, nothing is
+	* linked above the height, and the size matches. Only meaningful while
+	* no other thread uses *this.
+	*/
+	template<typename Key, typename Compare>
+	void concurrent_set<Key, Compare>::validate(void) const
+	{
+		Compare comp{};
+		const char *error{nullptr};
+		int top{height.load(std::memory_order_acquire)};
+
+		for(int l{max_level - 1}; nullptr == error && l >= 0; --l)
+		{
+			const node_type *lower{l > 0 ? head->next[l - 1].load(std::memory_order_acquire) : nullptr};
+			const node_type *prev{nullptr};
+			size_type count{0};
+
+			for(const node_type *node{head->next[l].load(std::memory_order_acquire)}; nullptr == error && node;
+					prev = node, node = node->next[l].load(std::memory_order_acquire))
+			{
+				++count;
+				if(l >= top || node->levels <= l)
+					error = "node linked above the height";
+				else if(node->marked.load(std::memory_order_acquire) || !node->linked.load(std::memory_order_acquire))
+					error = "marked or half linked node reachable";
+				else if(prev && !comp(prev->key(), node->key()))
+					error = "keys out of order on a level";
+				else if(l > 0)
+				{
+					// Every level is a subsequence of the one below
+					while(lower && lower != node)
+						lower = lower->next[l - 1].load(std::memory_order_acquire);
+					if(nullptr == lower)
+						error = "node missing from the level below";
+				}
+			}
+
+			if(nullptr == error && 0 == l && count != size())
+				error = "size does not match the number of nodes";
+		}
+
+		if(error)
+			throw std::logic_error(std::string("concurrent_set: ") + error);
+	}
+	// @}
+
+	// Helpers:
+	// @{
+	/*
+	* @brief Inserts key built from @key unless an equivalent key is present.
+	*
+	* The node is built before any lock is taken, and linked bottom-up, so
+	* a key is in the set as soon as it is on level 0. It only counts as
+	* present once all of its levels are linked.
+	*/
+	template<typename Key, typename Compare>
+	template<typename K>
+	bool concurrent_set<Key, Compare>::insert_unique(K &&key)
+	{
+		auto guard{domain.pin()};
+		node_type *preds[max_level], *succs[max_level];
+		node_type *node{nullptr};
+		int levels{random_level()};
+
+		for(;;)
+		{
+			int found{find(node ? node->key() : key, preds, succs)};
+			if(-1 != found)
+			{
+				node_type *other{succs[found]};
+				if(other->marked.load(std::memory_order_acquire))
+				{
+					std::this_thread::yield();		// being erased, wait for the unlink
+					continue;
+				}
+
+				while(!other->linked.load(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				if(node)
+					skip::detail::release_node<Key>{}(node);
+				return false;
+			}
+
+			if(nullptr == node)
+				node = skip::detail::make_node<Key>(levels, std::forward<K>(key));
+
+			int locked{-1};
+			if(!lock_preds(preds, succs, levels, nullptr, locked))
+			{
+				unlock_preds(preds, locked);
+				continue;
+			}
+
+			for(int l{0}; l < levels; ++l)
+				node->next[l].store(succs[l], std::memory_order_relaxed);
+			for(int l{0}; l < levels; ++l)
+				preds[l]->next[l].store(node, std::memory_order_release);
+			node->linked.store(true, std::memory_order_release);
+
+			unlock_preds(preds, locked);
+
+			int top{height.load(std::memory_order_relaxed)};
+			while(top < levels && !height.compare_exchange_weak(top, levels, std::memory_order_release))
+				;
+			_size.fetch_add(1, std::memory_order_relaxed);
+
+			return true;
+		}
+	}
+
+	/*
+	* @brief Fills predecessors and successors of @key on every level.
+	*
+	* @return int Highest level a key equivalent to @key was found on, -1 if none.
+	*
+	* Every level is walked, not only those under the height: an insert
+	* raises the height after linking its node, so a taller node may already
+	* be on a level above the height. An empty level costs one null check.
+	*/
+	template<typename Key, typename Compare>
+	int concurrent_set<Key, Compare>::find(const key_type &key, node_type **preds, node_type **succs) const
+	{
+		Compare comp{};
+		int found{-1};
+
+		node_type *pred{head};
+		for(int l{max_level - 1}; l >= 0; --l)
+		{
+			node_type *curr{pred->next[l].load(std::memory_order_acquire)};
+			while(curr && comp(curr->key(), key))
+			{
+				pred = curr;
+				curr = pred->next[l].load(std::memory_order_acquire);
+			}
+
+			if(-1 == found && curr && !comp(key, curr->key()))
+				found = l;
+			preds[l] = pred;
+			succs[l] = curr;
+		}
+
+		return found;
+	}
+
+	/*
+	* @brief Locks the distinct predecessors on levels [0, @levels) and validates them.
+	*
+	* @param victim Node being erased, which has to be the successor on
+	* 		every level, nullptr for an insert.
+	* @param locked Set to the highest level processed, for unlock_preds().
+	*
+	* @return bool True if no predecessor is marked, no successor other than
+	* 		@victim is, and each predecessor still links to its successor,
+	* 		i.e. the find() result still holds.
+	*
+	* Predecessors are locked from level 0 up, which is right to left in
+	* key order, the same order erase() locks its victim and its
+	* predecessors in, so writers cannot deadlock.
+	*/
+	template<typename Key, typename Compare>
+	bool concurrent_set<Key, Compare>::lock_preds(node_type **preds, node_type **succs, int levels,
+		const node_type *victim, int &locked) const
+	{
+		for(int l{0}; l < levels; ++l)
+		{
+			node_type *pred{preds[l]}, *succ{succs[l]};
+			if(0 == l || pred != preds[l - 1])
+				pred->lock();
+			locked = l;
+
+			if(pred->marked.load(std::memory_order_acquire)
+					|| (victim ? succ != victim : succ && succ->marked.load(std::memory_order_acquire))
+					|| pred->next[l].load(std::memory_order_acquire) != succ)
+				return false;
+		}
+
+		return true;
+	}
+
+	/*
+	* Unlocks what lock_preds() locked up to level @locked.
+	*/
+	template<typename Key, typename Compare>
+	void concurrent_set<Key, Compare>::unlock_preds(node_type **preds, int locked)
+	{
+		for(int l{0}; l <= locked; ++l)
+			if(0 == l || preds[l] != preds[l - 1])
+				preds[l]->unlock();
+	}
+
+	/*
+	* Returns level of a new node, level n + 1 is half as likely as level n.
+	*/
+	template<typename Key, typename Compare>
+	int concurrent_set<Key, Compare>::random_level(void)
+	{
+		thread_local uint64_t state{0x9e3779b97f4a7c15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id())};
+
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+
+		return 1 + __builtin_ctzll(state | (uint64_t{1} << (max_level - 1)));
+	}
+	// @}
+	// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_CONCURRENT_SET_HPP_
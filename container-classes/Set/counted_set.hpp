@@ -0,0 +1,464 @@
+#ifndef _CONTAINERS_COUNTED_SET_HPP_
+#define _CONTAINERS_COUNTED_SET_HPP_
+
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "map.hpp"
+
+namespace containers
+{
+
+	// Counted set declaration:
+	// @@@{
+	/*
+	*	@brief A multiset that keeps one node per distinct key with the
+	*	number of its occurrences, for frequency tables.
+	*
+	*	@param Key Type of key objects.
+	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*	@param Allocator Allocator type, rebound to the node type.
+	*
+	*	The counts live in a %map<Key, size_type>, so nodes are
+	*	%set_node<std::pair<const Key, size_type>> on the %set AVL tree and
+	*	insert() finds the key and the place for a new one in a single
+	*	descent (map::try_emplace()). Memory grows with the number of
+	*	distinct keys, not of occurrences as in %multiset, but equivalent
+	*	keys are not kept apart: the first one inserted stands for all.
+	*	Iteration yields (key, count) pairs in key order and is read only,
+	*	size() is the number of occurrences, distinct() the number of keys.
+	*/
+	template<
+			typename Key,
+			typename Compare = std::less<Key>,
+			typename Allocator = std::allocator<Key>
+			>
+	class counted_set
+	{
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef size_t size_type;
+			typedef std::pair<const Key, size_type> value_type;
+			typedef ptrdiff_t difference_type;
+			typedef Compare key_compare;
+			typedef const value_type& reference;
+			typedef const value_type& const_reference;
+			typedef Allocator allocator_type;
+			// @}
+		private:
+			// Convenience
+			using map_type = map<Key, size_type, Compare,
+					typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>>;
+		public:
+			// Iterators, read only since a count must not change behind size()
+			typedef typename map_type::const_iterator iterator;
+			typedef typename map_type::const_iterator const_iterator;
+			typedef typename map_type::const_reverse_iterator reverse_iterator;
+			typedef typename map_type::const_reverse_iterator const_reverse_iterator;
+
+			// Constructor
+			counted_set(void) = default;																// Default
+			explicit counted_set(const Compare &comp, const Allocator &alloc = Allocator{});			// Comparator
+			counted_set(const std::initializer_list<key_type> &ilist);								// Init list
+			counted_set(const counted_set &other) = default;											// Copy
+			counted_set(counted_set &&other) noexcept;													// Move
+
+			// Assignment
+			counted_set& operator=(const counted_set &other) = default;		// Copy
+			counted_set& operator=(counted_set &&other) noexcept;			// Move
+
+			// Iterators
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+			size_type distinct(void) const noexcept;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			const_iterator insert(const key_type &key, size_type n = 1);
+			const_iterator insert(key_type &&key, size_type n = 1);
+			const_iterator insert(const_iterator hint, const key_type &key, size_type n = 1);
+			void insert(const std::initializer_list<key_type> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+
+			// Erase
+			const_iterator erase(const_iterator position);
+			size_type erase(const key_type &key);
+			size_type remove(const key_type &key, size_type n = 1);
+
+			// Swap
+			void swap(counted_set &other) noexcept;
+
+			// Lookup
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
+			const_iterator find(const key_type &key) const;
+			const_iterator lower_bound(const key_type &key) const;
+			const_iterator upper_bound(const key_type &key) const;
+
+			// Observers
+			key_compare key_comp(void) const;
+			allocator_type get_allocator(void) const;
+		private:
+			// Data
+			map_type counts;
+			size_type total{0};
+	};
+	// @@@}
+
+// Counted set implementation:
+// @@@{
+// Construction:
+// @{
+/*
+* @brief Builds empty %counted_set ordered by @comp.
+*/
+template<typename Key, typename Compare, typename Allocator>
+counted_set<Key, Compare, Allocator>::counted_set(const Compare &comp, const Allocator &alloc)
+	:	counts{comp, typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>{alloc}}
+{}
+
+/*
+* @brief Builds %counted_set from an std::initializer_list, counting repeated keys.
+*/
+template<typename Key, typename Compare, typename Allocator>
+counted_set<Key, Compare, Allocator>::counted_set(const std::initializer_list<key_type> &ilist)
+{
+	insert(ilist);
+}
+
+/*
+* @brief %counted_set Move constructor, @other is left empty.
+*/
+template<typename Key, typename Compare, typename Allocator>
+counted_set<Key, Compare, Allocator>::counted_set(counted_set &&other) noexcept
+	:	counts{std::move(other.counts)},
+		total{other.total}
+{
+	other.total = 0;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+counted_set<Key, Compare, Allocator>&
+counted_set<Key, Compare, Allocator>::operator=(counted_set &&other) noexcept
+{
+	if(this != &other)
+	{
+		swap(other);
+		other.clear();
+	}
+
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::begin(void) const noexcept
+{
+	return counts.begin();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::cbegin(void) const noexcept
+{
+	return counts.cbegin();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::end(void) const noexcept
+{
+	return counts.end();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::cend(void) const noexcept
+{
+	return counts.cend();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_reverse_iterator
+counted_set<Key, Compare, Allocator>::rbegin(void) const noexcept
+{
+	return counts.rbegin();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_reverse_iterator
+counted_set<Key, Compare, Allocator>::crbegin(void) const noexcept
+{
+	return counts.crbegin();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_reverse_iterator
+counted_set<Key, Compare, Allocator>::rend(void) const noexcept
+{
+	return counts.rend();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_reverse_iterator
+counted_set<Key, Compare, Allocator>::crend(void) const noexcept
+{
+	return counts.crend();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+bool counted_set<Key, Compare, Allocator>::empty(void) const noexcept
+{
+	return 0 == total;
+}
+
+/*
+* @brief Returns number of occurrences of all keys, what size() of a %multiset would be.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::size_type
+counted_set<Key, Compare, Allocator>::size(void) const noexcept
+{
+	return total;
+}
+
+/*
+* @brief Returns number of distinct keys, which is also the number of nodes.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::size_type
+counted_set<Key, Compare, Allocator>::distinct(void) const noexcept
+{
+	return counts.size();
+}
+// @}
+
+// Modifiers:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+void counted_set<Key, Compare, Allocator>::clear(void)
+{
+	counts.clear();
+	total = 0;
+}
+
+/*
+* @brief Adds @n occurrences of @key, a node is only built the first time.
+*
+* @return %const_iterator to the (key, count) entry of @key.
+*
+* Inserting 0 occurrences of a new key does nothing and returns end().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::insert(const key_type &key, size_type n)
+{
+	if(0 == n)
+		return find(key);
+
+	auto it{counts.try_emplace(key, 0).first};
+	it->second += n;
+	total += n;
+
+	return it;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::insert(key_type &&key, size_type n)
+{
+	if(0 == n)
+		return find(key);
+
+	auto it{counts.try_emplace(std::move(key), 0).first};
+	it->second += n;
+	total += n;
+
+	return it;
+}
+
+/*
+* @brief Adds @n occurrences of @key, searching from @hint, see map::try_emplace().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::insert(const_iterator hint, const key_type &key, size_type n)
+{
+	if(0 == n)
+		return find(key);
+
+	auto it{counts.try_emplace(hint, key, 0)};
+	it->second += n;
+	total += n;
+
+	return it;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void counted_set<Key, Compare, Allocator>::insert(const std::initializer_list<key_type> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+/*
+* @brief Adds one occurrence of every key in [@first, @last), each one
+* hinted with end() like map::insert(InputIt, InputIt).
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename InputIt>
+void counted_set<Key, Compare, Allocator>::insert(InputIt first, InputIt last)
+{
+	for(; first != last; ++first)
+		insert(cend(), *first);
+}
+
+/*
+* @brief Erases every occurrence of the key at @position, returns %const_iterator to the next key.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::erase(const_iterator position)
+{
+	if(cend() == position)
+		return cend();
+
+	total -= position->second;
+	return counts.erase(position);
+}
+
+/*
+* @brief Erases every occurrence of @key, returns number of occurrences erased.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::size_type
+counted_set<Key, Compare, Allocator>::erase(const key_type &key)
+{
+	const_iterator it{find(key)};
+	if(cend() == it)
+		return 0;
+
+	size_type n{it->second};
+	erase(it);
+
+	return n;
+}
+
+/*
+* @brief Removes up to @n occurrences of @key, the node goes with the last one.
+*
+* @return Number of occurrences removed.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::size_type
+counted_set<Key, Compare, Allocator>::remove(const key_type &key, size_type n)
+{
+	auto it{counts.find(key)};
+	if(counts.end() == it)
+		return 0;
+
+	if(it->second <= n)
+	{
+		n = it->second;
+		counts.erase(it);
+	}
+	else
+		it->second -= n;
+	total -= n;
+
+	return n;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void counted_set<Key, Compare, Allocator>::swap(counted_set &other) noexcept
+{
+	using std::swap;
+	counts.swap(other.counts);
+	swap(total, other.total);
+}
+// @}
+
+// Lookup:
+// @{
+/*
+* @brief Returns number of occurrences of @key, 0 if it is not present.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::size_type
+counted_set<Key, Compare, Allocator>::count(const key_type &key) const
+{
+	const_iterator it{find(key)};
+	return cend() == it ? 0 : it->second;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+bool counted_set<Key, Compare, Allocator>::contains(const key_type &key) const
+{
+	return counts.contains(key);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::find(const key_type &key) const
+{
+	return counts.find(key);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::lower_bound(const key_type &key) const
+{
+	return counts.lower_bound(key);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::const_iterator
+counted_set<Key, Compare, Allocator>::upper_bound(const key_type &key) const
+{
+	return counts.upper_bound(key);
+}
+// @}
+
+// Observers:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::key_compare
+counted_set<Key, Compare, Allocator>::key_comp(void) const
+{
+	return counts.key_comp();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename counted_set<Key, Compare, Allocator>::allocator_type
+counted_set<Key, Compare, Allocator>::get_allocator(void) const
+{
+	return allocator_type{counts.get_allocator()};
+}
+// @}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_COUNTED_SET_HPP_
@@ -0,0 +1,1343 @@
+#ifndef _CONTAINERS_HASH_SET_HPP_
+#define _CONTAINERS_HASH_SET_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "set_detail.hpp"
+
+namespace containers::hash::detail
+{
+
+	// Control bytes:
+	// @{
+	/*
+	* Every slot of the table has one control byte. A full slot stores the
+	* low 7 bits of the hash of its key (0 to 127), the other states are
+	* negative, so a byte tells full from not full by its sign.
+	*/
+	typedef signed char ctrl_t;
+
+	constexpr ctrl_t empty = -128;				// never used since the last rehash
+	constexpr ctrl_t deleted = -2;				// tombstone, probing continues past it
+	constexpr ctrl_t sentinel = -1;				// one past the last slot, stops iteration
+
+	constexpr size_t group_width = 16;
+
+	inline bool is_full(ctrl_t c) { return c >= 0; }
+	// @}
+
+	/*
+	* @brief Mixes the bits of @hash.
+	*
+	* Hashes like std::hash<int> are the identity, so their low bits alone
+	* would pick the group and the tag. Multiplying by the golden ratio and
+	* folding the 128 bit product spreads every input bit over the result.
+	*/
+	inline uint64_t mix(uint64_t hash)
+	{
+		unsigned __int128 product{static_cast<unsigned __int128>(hash) * 0x9e3779b97f4a7c15ull};
+
+		return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+	}
+
+	/*
+	* Tag of a hash, stored in the control byte of its slot.
+	*/
+	inline ctrl_t h2(uint64_t hash) { return static_cast<ctrl_t>(hash & 0x7f); }
+
+	/*
+	* Group of a hash, where its probe sequence starts.
+	*/
+	inline size_t h1(uint64_t hash) { return static_cast<size_t>(hash >> 7); }
+
+	/*
+	* @brief %group_width control bytes, looked at all at once.
+	*
+	* Each match returns a bit mask, bit i set if byte i matches. With SSE2
+	* that is one compare and one movemask, the scalar loop is the fallback.
+	*/
+	class group
+	{
+		public:
+			explicit group(const ctrl_t *pos) : pos{pos} {}
+
+			// Bytes equal to @tag
+			unsigned match(ctrl_t tag) const
+			{
+#if defined(__SSE2__)
+				__m128i ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))};
+				return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+				unsigned mask{0};
+				for(size_t i = 0; i < group_width; ++i)
+					mask |= static_cast<unsigned>(pos[i] == tag) << i;
+				return mask;
+#endif
+			}
+
+			// Empty bytes
+			unsigned match_empty(void) const
+			{
+				return match(empty);
+			}
+
+			// Empty or deleted bytes, both are below sentinel
+			unsigned match_free(void) const
+			{
+#if defined(__SSE2__)
+				__m128i ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))};
+				return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(sentinel), ctrl)));
+#else
+				unsigned mask{0};
+				for(size_t i = 0; i < group_width; ++i)
+					mask |= static_cast<unsigned>(pos[i] < sentinel) << i;
+				return mask;
+#endif
+			}
+		private:
+			const ctrl_t *pos;
+	};
+
+	/*
+	* Returns number of keys a table of @capacity slots holds before it grows, 7/8 of it.
+	*/
+	constexpr size_t max_load(size_t capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	/*
+	* Returns smallest capacity, a power of two of at least one group, for @keys keys.
+	*/
+	constexpr size_t capacity_for(size_t keys)
+	{
+		size_t capacity{group_width};
+		while(max_load(capacity) < keys)
+			capacity *= 2;
+
+		return capacity;
+	}
+
+} // nested namespace containers::hash::detail
+
+namespace containers
+{
+
+	// Hash Set declaration:
+	// @@@{
+	/*
+	*	@brief An unordered container of unique keys with the insert, erase
+	*	and lookup interface of %set, stored in an open addressing table.
+	*
+	*	@param Key Type of key objects.
+	*	@param Hash Hash function object type, defaults to std::hash<Key>.
+	*	@param KeyEqual Equality function object type, defaults to std::equal_to<Key>.
+	*	@param Allocator Allocator type, rebound to the key and control byte types.
+	*
+	*	Keys sit in one flat array of slots, next to an array of one byte per
+	*	slot holding 7 bits of the hash of the key. The table is split in
+	*	groups of 16 slots: a lookup hashes once, then compares the tag with
+	*	a whole group of control bytes in one vector compare and only looks at
+	*	keys whose tag matches. Groups are probed triangularly until one with
+	*	an empty slot, the load is kept under 7/8.
+	*	Iterators stay valid until a rehash, which an insert may cause.
+	*/
+	template<
+			typename Key,
+			typename Hash = std::hash<Key>,
+			typename KeyEqual = std::equal_to<Key>,
+			typename Allocator = std::allocator<Key>
+			>
+	class hash_set
+	{
+		public:
+			// Constants:
+			// @{
+			static constexpr size_t group_width = hash::detail::group_width;
+			// @}
+		private:
+			// Convenience
+			using ctrl_t = hash::detail::ctrl_t;
+			using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+			using ctrl_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ctrl_t>;
+			template<typename K>
+			using transparent_key = std::enable_if_t<avl::detail::is_transparent<Hash>::value && avl::detail::is_transparent<KeyEqual>::value, K>;
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef Key value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef Hash hasher;
+			typedef KeyEqual key_equal;
+			typedef Key& reference;
+			typedef Key* pointer;
+			typedef const Key& const_reference;
+			typedef const Key* const_pointer;
+			typedef Allocator allocator_type;
+			// @}
+
+			class const_iterator;
+
+			// Iterator
+			// @@{
+			/*
+			* @brief Forward %hash_set iterator, a control byte and its slot.
+			*
+			* Keys are read-only like in every set, so it only differs from
+			* %const_iterator in type.
+			*/
+			class iterator
+			{
+				public:
+					// Typedefs
+					typedef std::forward_iterator_tag iterator_category;
+					typedef Key value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const Key* pointer;
+					typedef const Key& reference;
+
+					// Friend <3
+					friend class hash_set;
+					friend class const_iterator;
+
+					// Constructor
+					iterator(const ctrl_t *ctrl = nullptr, Key *slot = nullptr);
+
+					// Operators
+					iterator& operator++();
+					iterator operator++(int);
+
+					// Relation
+					bool operator==(const iterator &other) const;
+					bool operator!=(const iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					const ctrl_t *ctrl;
+					Key *slot;
+			};
+			// @@}
+
+			// Const Iterator
+			// @@{
+			class const_iterator
+			{
+				public:
+					// Typedefs
+					typedef std::forward_iterator_tag iterator_category;
+					typedef Key value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const Key* pointer;
+					typedef const Key& reference;
+
+					// Friend <3
+					friend class hash_set;
+
+					// Constructor
+					const_iterator(const ctrl_t *ctrl = nullptr, Key *slot = nullptr);
+					const_iterator(const iterator &other);							// Convert
+
+					// Operators
+					const_iterator& operator++();
+					const_iterator operator++(int);
+
+					// Relation
+					bool operator==(const const_iterator &other) const;
+					bool operator!=(const const_iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					const ctrl_t *ctrl;
+					Key *slot;
+			};
+			// @@}
+
+			// Constructor
+			hash_set(void);																	// Default
+			explicit hash_set(size_type bucket_count, const Hash &hash = Hash{},
+					const KeyEqual &equal = KeyEqual{}, const Allocator &alloc = Allocator{});	// Buckets
+			explicit hash_set(const Allocator &alloc);										// Allocator
+			hash_set(const hash_set &other);												// Copy
+			hash_set(hash_set &&other) noexcept;											// Move
+			hash_set(const std::initializer_list<Key> &ilist);								// Init list
+
+			// Destructor
+			~hash_set(void);
+
+			// Assignment
+			hash_set& operator=(const hash_set &other);							// Copy
+			hash_set& operator=(hash_set &&other) noexcept;						// Move
+			hash_set& operator=(const std::initializer_list<Key> &ilist);		// Init list
+
+			// Iterators
+			iterator begin(void) noexcept;
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			iterator end(void) noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			std::pair<iterator, bool> insert(const value_type &value);
+			std::pair<iterator, bool> insert(value_type &&value);
+			void insert(const std::initializer_list<Key> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+			iterator insert(const_iterator hint, const value_type &value);
+			iterator insert(const_iterator hint, value_type &&value);
+
+			// Emplace
+			template<class... Args>
+			std::pair<iterator, bool> emplace(Args &&...args);
+			template<class... Args>
+			iterator emplace_hint(const_iterator hint, Args &&...args);
+
+			// Erase
+			const_iterator erase(const_iterator position);
+			const_iterator erase(const_iterator first, const_iterator last);
+			size_type erase(const key_type &key);
+
+			// Swap
+			void swap(hash_set &other) noexcept;
+
+			// Lookup
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
+
+			// Find
+			iterator find(const key_type &key);
+			const_iterator find(const key_type &key) const;
+
+			// Equal range
+			std::pair<iterator, iterator> equal_range(const key_type &key);
+			std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const;
+
+			// Heterogeneous lookup, only with a transparent Hash and KeyEqual
+			template<typename K, typename = transparent_key<K>>
+			size_type count(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			bool contains(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator find(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator find(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			std::pair<iterator, iterator> equal_range(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+
+			// Hash policy
+			size_type bucket_count(void) const noexcept;
+			float load_factor(void) const noexcept;
+			float max_load_factor(void) const noexcept;
+			void rehash(size_type count);
+			void reserve(size_type count);
+
+			// Observers
+			hasher hash_function(void) const;
+			key_equal key_eq(void) const;
+			allocator_type get_allocator(void) const;
+		private:
+			// Table
+			void allocate(size_type new_capacity);
+			void deallocate(void);
+			void destroy_keys(void);
+			void resize(size_type new_capacity);
+
+			// Slots
+			size_type find_free(uint64_t hash) const;
+
+			// Insertion
+			template<typename K>
+			std::pair<iterator, bool> insert_unique(K &&key);
+
+			// Lookup
+			template<typename K>
+			size_type find_index(const K &key) const;
+
+			// Helpers
+			template<typename K>
+			uint64_t hash_of(const K &key) const;
+			iterator make_iterator(size_type index);
+			const_iterator make_iterator(size_type index) const;
+
+			// Data
+			Hash hash_fn;
+			KeyEqual equal_fn;
+			Allocator alloc;
+			ctrl_t *ctrl;
+			Key *slots;
+			size_type capacity, _size, growth_left;
+	};
+	// @@@}
+
+// Hash Set implementation:
+// @@@{
+// Iterator
+// @@{
+/*
+* Builds iterator at @ctrl, moved forward to the first full slot.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::iterator::iterator(const ctrl_t *ctrl, Key *slot)
+	:	ctrl{ctrl},
+		slot{slot}
+{
+	if(ctrl)
+		for(; *this->ctrl < hash::detail::sentinel; ++this->ctrl, ++this->slot);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator&
+hash_set<Key, Hash, KeyEqual, Allocator>::iterator::operator++()
+{
+	do
+	{
+		++ctrl;
+		++slot;
+	}
+	while(*ctrl < hash::detail::sentinel);
+
+	return *this;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::iterator::operator++(int)
+{
+	iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::iterator::operator==(const iterator &other) const
+{
+	return ctrl == other.ctrl;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::iterator::operator!=(const iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator::reference
+hash_set<Key, Hash, KeyEqual, Allocator>::iterator::operator*() const
+{
+	return *slot;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator::pointer
+hash_set<Key, Hash, KeyEqual, Allocator>::iterator::operator->() const
+{
+	return slot;
+}
+// @@}
+
+// Const Iterator
+// @@{
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::const_iterator(const ctrl_t *ctrl, Key *slot)
+	:	ctrl{ctrl},
+		slot{slot}
+{
+	if(ctrl)
+		for(; *this->ctrl < hash::detail::sentinel; ++this->ctrl, ++this->slot);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::const_iterator(const iterator &other)
+	:	ctrl{other.ctrl},
+		slot{other.slot}
+{}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator&
+hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::operator++()
+{
+	do
+	{
+		++ctrl;
+		++slot;
+	}
+	while(*ctrl < hash::detail::sentinel);
+
+	return *this;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::operator++(int)
+{
+	const_iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::operator==(const const_iterator &other) const
+{
+	return ctrl == other.ctrl;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::operator!=(const const_iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::reference
+hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::operator*() const
+{
+	return *slot;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::pointer
+hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator::operator->() const
+{
+	return slot;
+}
+// @@}
+
+// Hash Set
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds empty %hash_set, no table is allocated until the first insert.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_set(void)
+	:	hash_set(Allocator{})
+{}
+
+/*
+* @brief Builds empty %hash_set with room for at least @bucket_count slots.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_set(size_type bucket_count, const Hash &hash,
+		const KeyEqual &equal, const Allocator &alloc)
+	:	hash_fn{hash},
+		equal_fn{equal},
+		alloc{alloc},
+		ctrl{nullptr},
+		slots{nullptr},
+		capacity{0},
+		_size{0},
+		growth_left{0}
+{
+	rehash(bucket_count);
+}
+
+/*
+* @brief Builds empty %hash_set that allocates its table through @alloc.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_set(const Allocator &alloc)
+	:	hash_set(0, Hash{}, KeyEqual{}, alloc)
+{}
+
+/*
+* @brief %hash_set Copy constructor, copies the table slot for slot.
+*
+* Keys keep their slots, so nothing is rehashed. If a copy throws,
+* everything copied so far is destroyed.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_set(const hash_set &other)
+	:	hash_set(0, other.hash_fn, other.equal_fn,
+			std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc))
+{
+	if(0 == other.capacity)
+		return;
+
+	allocate(other.capacity);
+	try
+	{
+		for(size_type i = 0; i < capacity; ++i)
+			if(hash::detail::is_full(other.ctrl[i]))
+			{
+				::new(static_cast<void*>(slots + i)) Key(other.slots[i]);
+				ctrl[i] = other.ctrl[i];
+				++_size;
+			}
+	}
+	catch(...)
+	{
+		destroy_keys();
+		deallocate();
+		throw;
+	}
+	std::memcpy(ctrl, other.ctrl, capacity);
+	growth_left = other.growth_left;
+}
+
+/*
+* @brief %hash_set Move constructor, @other is left empty.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_set(hash_set &&other) noexcept
+	:	hash_fn{std::move(other.hash_fn)},
+		equal_fn{std::move(other.equal_fn)},
+		alloc{std::move(other.alloc)},
+		ctrl{other.ctrl},
+		slots{other.slots},
+		capacity{other.capacity},
+		_size{other._size},
+		growth_left{other.growth_left}
+{
+	other.ctrl = nullptr;
+	other.slots = nullptr;
+	other.capacity = other._size = other.growth_left = 0;
+}
+
+/*
+* @brief Builds %hash_set from initializer list, sized for it up front.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_set(const std::initializer_list<Key> &ilist)
+	:	hash_set()
+{
+	reserve(ilist.size());
+	insert(ilist.begin(), ilist.end());
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>::~hash_set(void)
+{
+	destroy_keys();
+	deallocate();
+}
+// @}
+
+// Assignment:
+// @{
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>&
+hash_set<Key, Hash, KeyEqual, Allocator>::operator=(const hash_set &other)
+{
+	if(this != &other)
+	{
+		hash_set tmp{other};
+		swap(tmp);
+	}
+
+	return *this;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>&
+hash_set<Key, Hash, KeyEqual, Allocator>::operator=(hash_set &&other) noexcept
+{
+	swap(other);
+	other.clear();
+
+	return *this;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+hash_set<Key, Hash, KeyEqual, Allocator>&
+hash_set<Key, Hash, KeyEqual, Allocator>::operator=(const std::initializer_list<Key> &ilist)
+{
+	hash_set tmp{ilist};
+	swap(tmp);
+
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+/*
+* Begin is the first full slot, found by scanning the control bytes.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::begin(void) noexcept
+{
+	return iterator{ctrl, slots};
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::begin(void) const noexcept
+{
+	return const_iterator{ctrl, slots};
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::cbegin(void) const noexcept
+{
+	return begin();
+}
+
+/*
+* End is the sentinel byte after the last slot.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::end(void) noexcept
+{
+	return make_iterator(capacity);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::end(void) const noexcept
+{
+	return make_iterator(capacity);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::cend(void) const noexcept
+{
+	return end();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::empty(void) const noexcept
+{
+	return 0 == _size;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::size(void) const noexcept
+{
+	return _size;
+}
+// @}
+
+// Modifiers:
+// @{
+/*
+* @brief Destroys all keys, the table is kept for reuse.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::clear(void)
+{
+	if(0 == capacity)
+		return;
+
+	destroy_keys();
+	std::memset(ctrl, hash::detail::empty, capacity);
+	growth_left = hash::detail::max_load(capacity);
+}
+
+/*
+* @brief Inserts copy of @value unless an equal key is present.
+*
+* @return std::pair Iterator to the key equal to @value and whether it was inserted.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator, bool>
+hash_set<Key, Hash, KeyEqual, Allocator>::insert(const value_type &value)
+{
+	return insert_unique(value);
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator, bool>
+hash_set<Key, Hash, KeyEqual, Allocator>::insert(value_type &&value)
+{
+	return insert_unique(std::move(value));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::insert(const std::initializer_list<Key> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+/*
+* @brief Inserts keys in [@first, @last), a forward range is reserved for up front.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename InputIt>
+void hash_set<Key, Hash, KeyEqual, Allocator>::insert(InputIt first, InputIt last)
+{
+	if constexpr(std::is_base_of<std::forward_iterator_tag,
+			typename std::iterator_traits<InputIt>::iterator_category>::value)
+		reserve(_size + static_cast<size_type>(std::distance(first, last)));
+
+	for(; first != last; ++first)
+		insert_unique(*first);
+}
+
+/*
+* @brief Inserts copy of @value, the hint is ignored (there is no order to
+* hint at) and only kept for the interface of %set.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::insert(const_iterator, const value_type &value)
+{
+	return insert_unique(value).first;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::insert(const_iterator, value_type &&value)
+{
+	return insert_unique(std::move(value)).first;
+}
+
+/*
+* @brief Builds a key from @args and inserts it unless an equal key is present.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<class... Args>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator, bool>
+hash_set<Key, Hash, KeyEqual, Allocator>::emplace(Args &&...args)
+{
+	return insert_unique(Key(std::forward<Args>(args)...));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<class... Args>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::emplace_hint(const_iterator, Args &&...args)
+{
+	return insert_unique(Key(std::forward<Args>(args)...)).first;
+}
+
+/*
+* @brief Erases key at @position.
+*
+* @return %const_iterator to the next full slot.
+*
+* Probing stops at a group with an empty slot. A group that has one now
+* never was without, so no probe sequence went past it and the slot can
+* simply become empty. Otherwise it becomes a tombstone, which lookups
+* skip and inserts reuse, and which are dropped on the next rehash.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::erase(const_iterator position)
+{
+	size_type index{static_cast<size_type>(position.ctrl - ctrl)};
+	std::destroy_at(slots + index);
+	--_size;
+
+	if(hash::detail::group{ctrl + (index & ~(group_width - 1))}.match_empty())
+	{
+		ctrl[index] = hash::detail::empty;
+		++growth_left;
+	}
+	else
+		ctrl[index] = hash::detail::deleted;
+
+	return ++position;
+}
+
+/*
+* @brief Erases keys in [@first, @last), no key moves so the range stays valid.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::erase(const_iterator first, const_iterator last)
+{
+	while(first != last)
+		first = erase(first);
+
+	return first;
+}
+
+/*
+* @brief Erases key equal to @key, returns number of keys erased.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::erase(const key_type &key)
+{
+	size_type index{find_index(key)};
+	if(index == capacity)
+		return 0;
+
+	erase(make_iterator(index));
+	return 1;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::swap(hash_set &other) noexcept
+{
+	using std::swap;
+	swap(hash_fn, other.hash_fn);
+	swap(equal_fn, other.equal_fn);
+	swap(alloc, other.alloc);
+	swap(ctrl, other.ctrl);
+	swap(slots, other.slots);
+	swap(capacity, other.capacity);
+	swap(_size, other._size);
+	swap(growth_left, other.growth_left);
+}
+// @}
+
+// Lookup:
+// @{
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::count(const key_type &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::contains(const key_type &key) const
+{
+	return find_index(key) != capacity;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::find(const key_type &key)
+{
+	return make_iterator(find_index(key));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::find(const key_type &key) const
+{
+	return make_iterator(find_index(key));
+}
+
+/*
+* @brief Returns range of the key equal to @key, empty if there is none.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator,
+		typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator>
+hash_set<Key, Hash, KeyEqual, Allocator>::equal_range(const key_type &key)
+{
+	iterator it{find(key)};
+	return it == end() ? std::make_pair(it, it) : std::make_pair(it, std::next(it));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator,
+		typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator>
+hash_set<Key, Hash, KeyEqual, Allocator>::equal_range(const key_type &key) const
+{
+	const_iterator it{find(key)};
+	return it == end() ? std::make_pair(it, it) : std::make_pair(it, std::next(it));
+}
+
+/*
+* @brief Heterogeneous lookup, @key is hashed and compared as it is, e.g. a
+* std::string_view in a %hash_set of std::string, without building a Key.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::count(const K &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename>
+bool hash_set<Key, Hash, KeyEqual, Allocator>::contains(const K &key) const
+{
+	return find_index(key) != capacity;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::find(const K &key)
+{
+	return make_iterator(find_index(key));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::find(const K &key) const
+{
+	return make_iterator(find_index(key));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator,
+		typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator>
+hash_set<Key, Hash, KeyEqual, Allocator>::equal_range(const K &key)
+{
+	iterator it{find(key)};
+	return it == end() ? std::make_pair(it, it) : std::make_pair(it, std::next(it));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator,
+		typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator>
+hash_set<Key, Hash, KeyEqual, Allocator>::equal_range(const K &key) const
+{
+	const_iterator it{find(key)};
+	return it == end() ? std::make_pair(it, it) : std::make_pair(it, std::next(it));
+}
+// @}
+
+// Hash policy:
+// @{
+/*
+* Returns number of slots, a power of two, 0 before the first insert.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::bucket_count(void) const noexcept
+{
+	return capacity;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+float hash_set<Key, Hash, KeyEqual, Allocator>::load_factor(void) const noexcept
+{
+	return capacity ? static_cast<float>(_size) / static_cast<float>(capacity) : 0.0f;
+}
+
+/*
+* The table grows past 7/8 full, that is fixed.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+float hash_set<Key, Hash, KeyEqual, Allocator>::max_load_factor(void) const noexcept
+{
+	return 0.875f;
+}
+
+/*
+* @brief Rebuilds the table with at least @count slots and room for all
+* keys, which drops every tombstone. rehash(0) fits the table to size().
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::rehash(size_type count)
+{
+	if(0 == count && 0 == _size)
+	{
+		deallocate();
+		return;
+	}
+
+	size_type new_capacity{hash::detail::capacity_for(_size)};
+	while(new_capacity < count)
+		new_capacity *= 2;
+
+	resize(new_capacity);
+}
+
+/*
+* @brief Makes room for @count keys without a rehash.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::reserve(size_type count)
+{
+	if(count > _size + growth_left)
+		resize(hash::detail::capacity_for(count));
+}
+// @}
+
+// Observers:
+// @{
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::hasher
+hash_set<Key, Hash, KeyEqual, Allocator>::hash_function(void) const
+{
+	return hash_fn;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::key_equal
+hash_set<Key, Hash, KeyEqual, Allocator>::key_eq(void) const
+{
+	return equal_fn;
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::allocator_type
+hash_set<Key, Hash, KeyEqual, Allocator>::get_allocator(void) const
+{
+	return alloc;
+}
+// @}
+
+// Table:
+// @{
+/*
+* @brief Allocates an empty table of @new_capacity slots, the old one has
+* to be released already.
+*
+* Control bytes are @new_capacity + 1, the last one is the sentinel end()
+* points at.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::allocate(size_type new_capacity)
+{
+	ctrl_allocator ca{alloc};
+	slot_allocator sa{alloc};
+	ctrl_t *new_ctrl{std::allocator_traits<ctrl_allocator>::allocate(ca, new_capacity + 1)};
+	try
+	{
+		slots = std::allocator_traits<slot_allocator>::allocate(sa, new_capacity);
+	}
+	catch(...)
+	{
+		std::allocator_traits<ctrl_allocator>::deallocate(ca, new_ctrl, new_capacity + 1);
+		throw;
+	}
+
+	ctrl = new_ctrl;
+	capacity = new_capacity;
+	std::memset(ctrl, hash::detail::empty, capacity);
+	ctrl[capacity] = hash::detail::sentinel;
+	growth_left = hash::detail::max_load(capacity);
+}
+
+/*
+* Frees the table, its keys have to be destroyed already.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::deallocate(void)
+{
+	if(0 == capacity)
+		return;
+
+	ctrl_allocator ca{alloc};
+	slot_allocator sa{alloc};
+	std::allocator_traits<ctrl_allocator>::deallocate(ca, ctrl, capacity + 1);
+	std::allocator_traits<slot_allocator>::deallocate(sa, slots, capacity);
+	ctrl = nullptr;
+	slots = nullptr;
+	capacity = _size = growth_left = 0;
+}
+
+/*
+* Destroys the key of every full slot, control bytes are left as they are.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::destroy_keys(void)
+{
+	if constexpr(!std::is_trivially_destructible<Key>::value)
+		for(size_type i = 0; i < capacity; ++i)
+			if(hash::detail::is_full(ctrl[i]))
+				std::destroy_at(slots + i);
+	_size = 0;
+}
+
+/*
+* @brief Moves every key into a new table of @new_capacity slots.
+*
+* The new table has no tombstones and only distinct keys, so each key
+* goes to the first free slot of its probe sequence with no compare.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void hash_set<Key, Hash, KeyEqual, Allocator>::resize(size_type new_capacity)
+{
+	ctrl_t *old_ctrl{ctrl};
+	Key *old_slots{slots};
+	size_type old_capacity{capacity}, size{_size};
+
+	allocate(new_capacity);
+	for(size_type i = 0; i < old_capacity; ++i)
+		if(hash::detail::is_full(old_ctrl[i]))
+		{
+			uint64_t h{hash_of(old_slots[i])};
+			size_type index{find_free(h)};
+			::new(static_cast<void*>(slots + index)) Key(std::move(old_slots[i]));
+			std::destroy_at(old_slots + i);
+			ctrl[index] = hash::detail::h2(h);
+		}
+	_size = size;
+	growth_left -= size;
+
+	if(old_capacity)
+	{
+		ctrl_allocator ca{alloc};
+		slot_allocator sa{alloc};
+		std::allocator_traits<ctrl_allocator>::deallocate(ca, old_ctrl, old_capacity + 1);
+		std::allocator_traits<slot_allocator>::deallocate(sa, old_slots, old_capacity);
+	}
+}
+// @}
+
+// Slots:
+// @{
+/*
+* Returns index of the first empty or deleted slot on the probe sequence of @hash.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::find_free(uint64_t hash) const
+{
+	const size_type mask{capacity / group_width - 1};
+	for(size_type g{hash::detail::h1(hash) & mask}, step{0};; g = (g + ++step) & mask)
+	{
+		const size_type base{g * group_width};
+		if(unsigned free{hash::detail::group{ctrl + base}.match_free()})
+			return base + static_cast<size_type>(__builtin_ctz(free));
+	}
+}
+
+// @}
+
+// Insertion:
+// @{
+/*
+* @brief Inserts @key unless an equal key is present.
+*
+* One probe both looks for the key and remembers the first free slot. A
+* tombstone is reused as it is, an empty slot uses up growth, and when
+* none is left the table is rebuilt first: at the same size if at least
+* half the load is tombstones, at twice the size otherwise.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+std::pair<typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator, bool>
+hash_set<Key, Hash, KeyEqual, Allocator>::insert_unique(K &&key)
+{
+	const uint64_t h{hash_of(key)};
+	const ctrl_t tag{hash::detail::h2(h)};
+	size_type index{capacity};
+
+	if(capacity)
+	{
+		const size_type mask{capacity / group_width - 1};
+		for(size_type g{hash::detail::h1(h) & mask}, step{0};; g = (g + ++step) & mask)
+		{
+			const size_type base{g * group_width};
+			hash::detail::group group{ctrl + base};
+			for(unsigned match{group.match(tag)}; match; match &= match - 1)
+			{
+				size_type i{base + static_cast<size_type>(__builtin_ctz(match))};
+				if(equal_fn(slots[i], key))
+					return std::make_pair(make_iterator(i), false);
+			}
+
+			unsigned free{group.match_free()};
+			if(index == capacity && free)
+				index = base + static_cast<size_type>(__builtin_ctz(free));
+			if(group.match_empty())
+				break;
+		}
+	}
+
+	if(0 == capacity || (0 == growth_left && hash::detail::empty == ctrl[index]))
+	{
+		resize(_size < hash::detail::max_load(capacity) / 2 ? capacity : hash::detail::capacity_for(_size + 1));
+		index = find_free(h);
+	}
+
+	::new(static_cast<void*>(slots + index)) Key(std::forward<K>(key));
+	if(hash::detail::empty == ctrl[index])
+		--growth_left;
+	ctrl[index] = tag;
+	++_size;
+
+	return std::make_pair(make_iterator(index), true);
+}
+// @}
+
+// Lookup:
+// @{
+/*
+* @brief Returns index of the slot holding a key equal to @key, capacity if none.
+*
+* Each group costs one vector compare of the tag, keys are only compared
+* where the tag matches, 1 in 128 for other keys. A group with an empty
+* slot ends the probe sequence.
+*/
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::size_type
+hash_set<Key, Hash, KeyEqual, Allocator>::find_index(const K &key) const
+{
+	if(0 == _size)
+		return capacity;
+
+	const uint64_t h{hash_of(key)};
+	const ctrl_t tag{hash::detail::h2(h)};
+	const size_type mask{capacity / group_width - 1};
+	for(size_type g{hash::detail::h1(h) & mask}, step{0};; g = (g + ++step) & mask)
+	{
+		const size_type base{g * group_width};
+		hash::detail::group group{ctrl + base};
+		for(unsigned match{group.match(tag)}; match; match &= match - 1)
+		{
+			size_type i{base + static_cast<size_type>(__builtin_ctz(match))};
+			if(equal_fn(slots[i], key))
+				return i;
+		}
+
+		if(group.match_empty())
+			return capacity;
+	}
+}
+// @}
+
+// Helpers:
+// @{
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+uint64_t hash_set<Key, Hash, KeyEqual, Allocator>::hash_of(const K &key) const
+{
+	return hash::detail::mix(static_cast<uint64_t>(hash_fn(key)));
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::make_iterator(size_type index)
+{
+	return capacity ? iterator{ctrl + index, slots + index} : iterator{};
+}
+
+template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+typename hash_set<Key, Hash, KeyEqual, Allocator>::const_iterator
+hash_set<Key, Hash, KeyEqual, Allocator>::make_iterator(size_type index) const
+{
+	return capacity ? const_iterator{ctrl + index, slots + index} : const_iterator{};
+}
+// @}
+// @@}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_HASH_SET_HPP_
@@ -0,0 +1,522 @@
+#ifndef _CONTAINERS_INTERVAL_SET_HPP_
+#define _CONTAINERS_INTERVAL_SET_HPP_
+
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "interval_tree.hpp"
+
+namespace containers
+{
+
+	// Interval Set declaration:
+	// @@@{
+	/*
+	*	@brief A set of points of T, stored as the fewest disjoint half open
+	*	intervals [lo, hi).
+	*
+	*	@param T Type of the bounds, ordered by operator<.
+	*	@param Allocator Allocator type, rebound to the node type.
+	*
+	*	Inserting an interval merges it with every interval it overlaps or
+	*	touches ([1, 3) and [3, 5) become [1, 5)), erasing one cuts it out of
+	*	the intervals it overlaps, so the stored intervals never overlap nor
+	*	touch. They are kept in an %interval_tree, their ends ascend with their
+	*	starts, so every query finds its first interval in logN and walks the
+	*	k it reports: point and overlap queries are O(log n + k), inserting
+	*	and erasing O((k + 1) log n) for k intervals merged or cut.
+	*/
+	template<
+			typename T,
+			typename Allocator = std::allocator<interval<T>>
+			>
+	class interval_set
+	{
+		private:
+			using tree_type = interval_tree<T, Allocator>;
+		public:
+			// Typedefs:
+			// @{
+			typedef T bound_type;
+			typedef interval<T> value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef const value_type& reference;
+			typedef const value_type& const_reference;
+			typedef const value_type* pointer;
+			typedef const value_type* const_pointer;
+			typedef Allocator allocator_type;
+			// @}
+
+			// Iterators, intervals are read only
+			typedef typename tree_type::const_iterator iterator;
+			typedef typename tree_type::const_iterator const_iterator;
+			typedef typename tree_type::const_reverse_iterator reverse_iterator;
+			typedef typename tree_type::const_reverse_iterator const_reverse_iterator;
+
+			// Constructor
+			interval_set(void) = default;														// Default
+			explicit interval_set(const Allocator &alloc);										// Allocator
+			interval_set(const std::initializer_list<value_type> &ilist);						// Init list
+
+			// Assignment
+			interval_set& operator=(const std::initializer_list<value_type> &ilist);		// Init list
+
+			// Iterators
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			const_iterator insert(const value_type &value);
+			const_iterator insert(const T &lo, const T &hi);
+			void insert(const std::initializer_list<value_type> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+
+			// Erase
+			const_iterator erase(const_iterator position);
+			void erase(const value_type &value);
+			void erase(const T &lo, const T &hi);
+
+			// Swap
+			void swap(interval_set &other) noexcept;
+
+			// Lookup
+			bool contains(const T &point) const;
+			bool covers(const T &lo, const T &hi) const;
+			const_iterator find(const T &point) const;
+
+			// Overlap queries
+			bool overlaps(const T &lo, const T &hi) const;
+			std::vector<value_type> overlapping(const T &lo, const T &hi) const;
+			template<typename F>
+			void visit_overlapping(const T &lo, const T &hi, F f) const;
+
+			// Observers
+			allocator_type get_allocator(void) const;
+
+			// Diagnostics
+			tree_stats stats(void) const;
+			void validate(void) const;
+
+			// Relation
+			bool operator==(const interval_set &other) const;
+			bool operator!=(const interval_set &other) const;
+		private:
+			// Helpers
+			const_iterator first_reaching(const T &point, bool touching) const;
+
+			// Data
+			tree_type tree;
+	};
+	// @@@}
+
+// Interval Set implementation:
+// @@@{
+// Construction:
+// @{
+/*
+* @brief Builds empty %interval_set whose nodes are allocated through @alloc.
+*/
+template<typename T, typename Allocator>
+interval_set<T, Allocator>::interval_set(const Allocator &alloc)
+	:	tree{alloc}
+{}
+
+/*
+* @brief Builds %interval_set of the union of the intervals in @ilist.
+*/
+template<typename T, typename Allocator>
+interval_set<T, Allocator>::interval_set(const std::initializer_list<value_type> &ilist)
+	:	interval_set()
+{
+	insert(ilist);
+}
+// @}
+
+// Assignment:
+// @{
+template<typename T, typename Allocator>
+interval_set<T, Allocator>&
+interval_set<T, Allocator>::operator=(const std::initializer_list<value_type> &ilist)
+{
+	clear();
+	insert(ilist);
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::begin(void) const noexcept
+{
+	return tree.begin();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::cbegin(void) const noexcept
+{
+	return begin();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::end(void) const noexcept
+{
+	return tree.end();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::cend(void) const noexcept
+{
+	return end();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_reverse_iterator
+interval_set<T, Allocator>::rbegin(void) const noexcept
+{
+	return tree.rbegin();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_reverse_iterator
+interval_set<T, Allocator>::crbegin(void) const noexcept
+{
+	return rbegin();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_reverse_iterator
+interval_set<T, Allocator>::rend(void) const noexcept
+{
+	return tree.rend();
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_reverse_iterator
+interval_set<T, Allocator>::crend(void) const noexcept
+{
+	return rend();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename T, typename Allocator>
+bool interval_set<T, Allocator>::empty(void) const noexcept
+{
+	return tree.empty();
+}
+
+/*
+* @brief Returns number of disjoint intervals, not of points.
+*/
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::size_type
+interval_set<T, Allocator>::size(void) const noexcept
+{
+	return tree.size();
+}
+// @}
+
+// Modifiers:
+// @{
+template<typename T, typename Allocator>
+void interval_set<T, Allocator>::clear(void)
+{
+	tree.clear();
+}
+
+/*
+* @brief Adds the points of @value, merging it with every interval it
+* overlaps or touches.
+*
+* @return %const_iterator to the interval now holding @value, end() for an
+* empty interval.
+*/
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::insert(const value_type &value)
+{
+	if(!(value.lo < value.hi))
+		return cend();
+
+	const_iterator it{first_reaching(value.lo, true)};
+	if(cend() != it && !(value.lo < it->lo) && !(it->hi < value.hi))
+		return it;													// already covered, nothing to merge
+
+	value_type merged{value};
+	while(cend() != it && !(value.hi < it->lo))
+	{
+		if(it->lo < merged.lo)
+			merged.lo = it->lo;
+		if(merged.hi < it->hi)
+			merged.hi = it->hi;
+		it = tree.erase(it);
+	}
+
+	// Everything left of @it ends before @merged, so it goes right before @it
+	return tree.insert(it, merged);
+}
+
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::insert(const T &lo, const T &hi)
+{
+	return insert(value_type{lo, hi});
+}
+
+template<typename T, typename Allocator>
+void interval_set<T, Allocator>::insert(const std::initializer_list<value_type> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+template<typename T, typename Allocator>
+template<typename InputIt>
+void interval_set<T, Allocator>::insert(InputIt first, InputIt last)
+{
+	for(; first != last; ++first)
+		insert(*first);
+}
+
+/*
+* @brief Erases the whole interval at @position, returns %const_iterator to the next one.
+*/
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::erase(const_iterator position)
+{
+	return tree.erase(position);
+}
+
+template<typename T, typename Allocator>
+void interval_set<T, Allocator>::erase(const value_type &value)
+{
+	erase(value.lo, value.hi);
+}
+
+/*
+* @brief Removes the points of [@lo, @hi), intervals sticking out of it keep the rest.
+*
+* An interval strictly containing [@lo, @hi) is split in two.
+*/
+template<typename T, typename Allocator>
+void interval_set<T, Allocator>::erase(const T &lo, const T &hi)
+{
+	if(!(lo < hi))
+		return;
+
+	const_iterator it{first_reaching(lo, false)};
+	if(cend() == it || !(it->lo < hi))
+		return;
+
+	// Only the first and the last interval cut can stick out
+	value_type left{it->lo, lo}, right{hi, hi};
+	while(cend() != it && it->lo < hi)
+	{
+		right.hi = it->hi;
+		it = tree.erase(it);
+	}
+
+	tree.insert(it, left);
+	tree.insert(it, right);
+}
+
+template<typename T, typename Allocator>
+void interval_set<T, Allocator>::swap(interval_set &other) noexcept
+{
+	tree.swap(other.tree);
+}
+// @}
+
+// Lookup:
+// @{
+/*
+* @brief Returns whether @point is in the set.
+*/
+template<typename T, typename Allocator>
+bool interval_set<T, Allocator>::contains(const T &point) const
+{
+	return cend() != find(point);
+}
+
+/*
+* @brief Returns whether every point of [@lo, @hi) is in the set, true for an empty interval.
+*/
+template<typename T, typename Allocator>
+bool interval_set<T, Allocator>::covers(const T &lo, const T &hi) const
+{
+	if(!(lo < hi))
+		return true;
+
+	const_iterator it{find(lo)};
+	return cend() != it && !(it->hi < hi);
+}
+
+/*
+* @brief Returns %const_iterator to the interval holding @point, or end().
+*/
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::find(const T &point) const
+{
+	const_iterator it{first_reaching(point, false)};
+	return cend() != it && !(point < it->lo) ? it : cend();
+}
+// @}
+
+// Overlap queries:
+// @{
+/*
+* @brief Returns whether any point of [@lo, @hi) is in the set.
+*/
+template<typename T, typename Allocator>
+bool interval_set<T, Allocator>::overlaps(const T &lo, const T &hi) const
+{
+	if(!(lo < hi))
+		return false;
+
+	const_iterator it{first_reaching(lo, false)};
+	return cend() != it && it->lo < hi;
+}
+
+/*
+* @brief Returns the intervals overlapping [@lo, @hi), whole and in order.
+*/
+template<typename T, typename Allocator>
+std::vector<typename interval_set<T, Allocator>::value_type>
+interval_set<T, Allocator>::overlapping(const T &lo, const T &hi) const
+{
+	std::vector<value_type> ret;
+	visit_overlapping(lo, hi, [&ret](const value_type &value) { ret.push_back(value); });
+	return ret;
+}
+
+/*
+* @brief Calls @f with every interval overlapping [@lo, @hi), in order.
+*/
+template<typename T, typename Allocator>
+template<typename F>
+void interval_set<T, Allocator>::visit_overlapping(const T &lo, const T &hi, F f) const
+{
+	if(!(lo < hi))
+		return;
+
+	for(const_iterator it = first_reaching(lo, false); cend() != it && it->lo < hi; ++it)
+		f(*it);
+}
+// @}
+
+// Observers:
+// @{
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::allocator_type
+interval_set<T, Allocator>::get_allocator(void) const
+{
+	return tree.get_allocator();
+}
+// @}
+
+// Diagnostics:
+// @{
+/*
+* @brief Returns shape and memory of the tree, see set::stats().
+*/
+template<typename T, typename Allocator>
+tree_stats interval_set<T, Allocator>::stats(void) const
+{
+	return tree.stats();
+}
+
+/*
+* @brief Checks the invariants of the underlying %interval_tree, and that
+* intervals neither overlap nor touch.
+*/
+template<typename T, typename Allocator>
+void interval_set<T, Allocator>::validate(void) const
+{
+	tree.validate();
+
+	for(const_iterator it = cbegin(), next = cbegin(); cend() != it && cend() != ++next; it = next)
+		if(!(it->hi < next->lo))
+			throw std::logic_error("interval_set: intervals overlap or touch");
+}
+// @}
+
+// Relation:
+// @{
+/*
+* @brief Two sets hold the same points if and only if they store the same intervals.
+*/
+template<typename T, typename Allocator>
+bool interval_set<T, Allocator>::operator==(const interval_set &other) const
+{
+	if(size() != other.size())
+		return false;
+
+	for(const_iterator a = cbegin(), b = other.cbegin(); cend() != a; ++a, ++b)
+		if(*a != *b)
+			return false;
+
+	return true;
+}
+
+template<typename T, typename Allocator>
+bool interval_set<T, Allocator>::operator!=(const interval_set &other) const
+{
+	return !(*this == other);
+}
+// @}
+
+// Helpers:
+// @{
+/*
+* @brief Returns %const_iterator to the first interval ending after @point,
+* or at it too if @touching, end() if there is none.
+*
+* Ends ascend with starts, so that is the last interval starting at or
+* before @point if it reaches it, else the next one.
+*/
+template<typename T, typename Allocator>
+typename interval_set<T, Allocator>::const_iterator
+interval_set<T, Allocator>::first_reaching(const T &point, bool touching) const
+{
+	const_iterator it{tree.upper_bound(point)};
+	if(cbegin() != it)
+	{
+		const_iterator prev{std::prev(it)};
+		if(point < prev->hi || (touching && !(prev->hi < point)))
+			return prev;
+	}
+
+	return it;
+}
+// @}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_INTERVAL_SET_HPP_
@@ -0,0 +1,781 @@
+#ifndef _CONTAINERS_INTERVAL_TREE_HPP_
+#define _CONTAINERS_INTERVAL_TREE_HPP_
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "set_node.hpp"
+#include "set_detail.hpp"
+
+namespace containers
+{
+
+	// Interval declaration:
+	// @@{
+	/*
+	* @brief Half open interval [lo, hi), empty unless lo < hi.
+	*/
+	template<typename T>
+	struct interval
+	{
+		T lo, hi;
+
+		bool operator==(const interval &other) const { return lo == other.lo && hi == other.hi; }
+		bool operator!=(const interval &other) const { return !(*this == other); }
+	};
+	// @@}
+
+} // namespace containers
+
+namespace containers::avl::detail
+{
+
+	/*
+	* @brief Node value of %interval_tree, an interval and the largest end
+	* in its subtree, kept by update_node() (see is_augmented).
+	*/
+	template<typename T>
+	struct interval_entry
+	{
+		interval_entry(void) = default;
+		interval_entry(const interval<T> &value) : value(value), max(value.hi) {}
+
+		void update(const interval_entry *left, const interval_entry *right)
+		{
+			max = value.hi;
+			if(left && max < left->max)
+				max = left->max;
+			if(right && max < right->max)
+				max = right->max;
+		}
+
+		interval<T> value;
+		T max;
+	};
+
+	/*
+	* @brief Key extractor ordering %interval_tree nodes by the start of their interval.
+	*/
+	struct interval_start
+	{
+		template<typename T>
+		const T& operator()(const interval_entry<T> &entry) const noexcept { return entry.value.lo; }
+	};
+
+} // nested namespace container::avl::detail
+
+namespace containers
+{
+
+	// Interval Tree declaration:
+	// @@@{
+	/*
+	*	@brief A sorted container of intervals that may overlap, with
+	*	overlap and point queries.
+	*
+	*	@param T Type of the bounds, ordered by operator<.
+	*	@param Allocator Allocator type, rebound to the node type.
+	*
+	*	Intervals are ordered by their start (equal starts in insertion order)
+	*	in the AVL tree of %set. Every node also stores the largest end in
+	*	its subtree, refreshed by avl::detail::update_node() like the subtree
+	*	size wherever avl::detail::tree_base relinks a node, so a query
+	*	skips every subtree that ends before the range it looks at. An
+	*	overlap query is O(log n) to find the first overlap, and O(k log n)
+	*	at worst to report k of them (O(log n + k) when the reported
+	*	intervals are adjacent in start order, as in %interval_set).
+	*	Intervals cannot be changed in place, all iterators are constant.
+	*	The end sentinel is a node too, so T has to be default constructible.
+	*/
+	template<
+			typename T,
+			typename Allocator = std::allocator<interval<T>>
+			>
+	class interval_tree : private avl::detail::tree_base<set_node<avl::detail::interval_entry<T>>,
+			avl::detail::interval_start, std::less<T>, Allocator, false>
+	{
+		public:
+			// Typedefs:
+			// @{
+			typedef T bound_type;
+			typedef interval<T> value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef const value_type& reference;
+			typedef const value_type& const_reference;
+			typedef const value_type* pointer;
+			typedef const value_type* const_pointer;
+			typedef Allocator allocator_type;
+			// @}
+		private:
+			// Convenience
+			using entry_type = avl::detail::interval_entry<T>;
+			using tree_type = avl::detail::tree_base<set_node<entry_type>, avl::detail::interval_start, std::less<T>, Allocator, false>;
+			using typename tree_type::node_type;
+			using typename tree_type::pool_type;
+			using typename tree_type::position_type;
+
+			// Tree
+			using tree_type::pool;
+			using tree_type::root;
+			using tree_type::first;
+			using tree_type::last;
+			using tree_type::END;
+			using tree_type::_size;
+			using tree_type::lower_node;
+			using tree_type::upper_node;
+			using tree_type::hint_position;
+			using tree_type::link_node;
+			using tree_type::unlink;
+			using tree_type::ensure_end;
+		public:
+			// Const Iterator
+			// @@{
+			/*
+			* @brief Bidirectional %interval_tree iterator, a node threaded in start order.
+			*/
+			class const_iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef typename interval_tree::value_type value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const value_type* pointer;
+					typedef const value_type& reference;
+
+					// Friend <3
+					friend class interval_tree;
+
+					// Constructor
+					const_iterator(node_type *ptr = nullptr);
+
+					// Operators
+					const_iterator& operator++();
+					const_iterator operator++(int);
+					const_iterator& operator--();
+					const_iterator operator--(int);
+
+					// Relation
+					bool operator==(const const_iterator &other) const;
+					bool operator!=(const const_iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *ptr;
+			};
+			// @@}
+
+			// Iterators, intervals are read only
+			typedef const_iterator iterator;
+			typedef std::reverse_iterator<const_iterator> reverse_iterator;
+			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			// Constructor
+			interval_tree(void);																// Default
+			explicit interval_tree(const Allocator &alloc);										// Allocator
+			interval_tree(const interval_tree &other);											// Copy
+			interval_tree(interval_tree &&other) noexcept;										// Move
+			interval_tree(const std::initializer_list<value_type> &ilist);						// Init list
+
+			// Assignment
+			interval_tree& operator=(const interval_tree &other);							// Copy
+			interval_tree& operator=(interval_tree &&other) noexcept;						// Move
+			interval_tree& operator=(const std::initializer_list<value_type> &ilist);		// Init list
+
+			// Iterators
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			const_iterator insert(const value_type &value);
+			const_iterator insert(const T &lo, const T &hi);
+			const_iterator insert(const_iterator hint, const value_type &value);
+			void insert(const std::initializer_list<value_type> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+
+			// Erase
+			const_iterator erase(const_iterator position);
+			size_type erase(const value_type &value);
+
+			// Swap
+			void swap(interval_tree &other) noexcept;
+
+			// Lookup
+			const_iterator find(const value_type &value) const;
+			const_iterator lower_bound(const T &lo) const;
+			const_iterator upper_bound(const T &lo) const;
+
+			// Overlap queries
+			bool overlaps(const T &lo, const T &hi) const;
+			std::vector<value_type> overlapping(const T &lo, const T &hi) const;
+			std::vector<value_type> containing(const T &point) const;
+			template<typename F>
+			void visit_overlapping(const T &lo, const T &hi, F f) const;
+			template<typename F>
+			void visit_containing(const T &point, F f) const;
+
+			// Observers
+			allocator_type get_allocator(void) const;
+
+			// Diagnostics
+			using tree_type::stats;
+			void validate(void) const;
+		private:
+			// Helpers
+			template<typename F>
+			static void visit(const node_type *node, const T &lo, const T &hi, bool point, F &f);
+	};
+	// @@@}
+
+// Interval Tree implementation:
+// @@@{
+// Const Iterator
+// @@{
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>::const_iterator::const_iterator(node_type *ptr)
+	:	ptr{ptr}
+{}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator&
+interval_tree<T, Allocator>::const_iterator::operator++()
+{
+	ptr = ptr->next;
+	return *this;
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::const_iterator::operator++(int)
+{
+	const_iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator&
+interval_tree<T, Allocator>::const_iterator::operator--()
+{
+	ptr = ptr->prev;
+	return *this;
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::const_iterator::operator--(int)
+{
+	const_iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename T, typename Allocator>
+bool interval_tree<T, Allocator>::const_iterator::operator==(const const_iterator &other) const
+{
+	return ptr == other.ptr;
+}
+
+template<typename T, typename Allocator>
+bool interval_tree<T, Allocator>::const_iterator::operator!=(const const_iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator::reference
+interval_tree<T, Allocator>::const_iterator::operator*() const
+{
+	return ptr->key.value;
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator::pointer
+interval_tree<T, Allocator>::const_iterator::operator->() const
+{
+	return &ptr->key.value;
+}
+// @@}
+
+// Interval Tree
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds empty %interval_tree.
+*/
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>::interval_tree(void)
+	:	interval_tree(Allocator{})
+{}
+
+/*
+* @brief Builds empty %interval_tree whose nodes are allocated through @alloc.
+*/
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>::interval_tree(const Allocator &alloc)
+	:	tree_type{std::less<T>{}, alloc}
+{}
+
+/*
+* @brief %interval_tree Copy constructor, copies the tree node for node
+* with its shape and subtree ends, in linear time.
+*/
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>::interval_tree(const interval_tree &other)
+	:	interval_tree(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+{
+	tree_type::copy_nodes(other);
+}
+
+/*
+* @brief %interval_tree Move constructor, @other is left empty.
+*/
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>::interval_tree(interval_tree &&other) noexcept
+	:	tree_type{std::move(other)}
+{}
+
+/*
+* @brief Builds %interval_tree from an std::initializer_list.
+*/
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>::interval_tree(const std::initializer_list<value_type> &ilist)
+	:	interval_tree()
+{
+	insert(ilist);
+}
+// @}
+
+// Assignment:
+// @{
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>&
+interval_tree<T, Allocator>::operator=(const interval_tree &other)
+{
+	if(this != &other)
+	{
+		interval_tree tmp{other};
+		swap(tmp);
+	}
+
+	return *this;
+}
+
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>&
+interval_tree<T, Allocator>::operator=(interval_tree &&other) noexcept
+{
+	if(this != &other)
+	{
+		swap(other);
+		other.clear();
+	}
+
+	return *this;
+}
+
+template<typename T, typename Allocator>
+interval_tree<T, Allocator>&
+interval_tree<T, Allocator>::operator=(const std::initializer_list<value_type> &ilist)
+{
+	clear();
+	insert(ilist);
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::begin(void) const noexcept
+{
+	return empty() ? const_iterator{END} : const_iterator{first};
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::cbegin(void) const noexcept
+{
+	return begin();
+}
+
+/*
+* End is the sentinel closing the threaded list, so it can be decremented.
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::end(void) const noexcept
+{
+	return const_iterator{END};
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::cend(void) const noexcept
+{
+	return end();
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_reverse_iterator
+interval_tree<T, Allocator>::rbegin(void) const noexcept
+{
+	return const_reverse_iterator{end()};
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_reverse_iterator
+interval_tree<T, Allocator>::crbegin(void) const noexcept
+{
+	return rbegin();
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_reverse_iterator
+interval_tree<T, Allocator>::rend(void) const noexcept
+{
+	return const_reverse_iterator{begin()};
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_reverse_iterator
+interval_tree<T, Allocator>::crend(void) const noexcept
+{
+	return rend();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename T, typename Allocator>
+bool interval_tree<T, Allocator>::empty(void) const noexcept
+{
+	return 0 == _size;
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::size_type
+interval_tree<T, Allocator>::size(void) const noexcept
+{
+	return _size;
+}
+// @}
+
+// Modifiers:
+// @{
+/*
+* @brief Erases all intervals, node memory is released one chunk at a time.
+*/
+template<typename T, typename Allocator>
+void interval_tree<T, Allocator>::clear(void)
+{
+	tree_type::clear_nodes();
+}
+
+/*
+* @brief Inserts @value after the intervals starting where it starts.
+*
+* @return %const_iterator to the inserted interval, end() for an empty
+* interval, which is not stored.
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::insert(const value_type &value)
+{
+	return insert(cend(), value);
+}
+
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::insert(const T &lo, const T &hi)
+{
+	return insert(value_type{lo, hi});
+}
+
+/*
+* @brief Inserts @value right before @hint if it starts there, see
+* avl::detail::bst_hint_equal_position(), so a sorted range is appended
+* with one comparison per interval.
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::insert(const_iterator hint, const value_type &value)
+{
+	if(!(value.lo < value.hi))
+		return cend();
+
+	position_type position{hint_position(hint.ptr, value.lo)};
+
+	ensure_end();
+	node_type *created{pool.create(value)};
+	link_node(position, created);
+
+	return const_iterator{created};
+}
+
+template<typename T, typename Allocator>
+void interval_tree<T, Allocator>::insert(const std::initializer_list<value_type> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+template<typename T, typename Allocator>
+template<typename InputIt>
+void interval_tree<T, Allocator>::insert(InputIt first, InputIt last)
+{
+	for(; first != last; ++first)
+		insert(cend(), *first);
+}
+
+/*
+* @brief Erases interval at @position, returns %const_iterator to the next one.
+*
+* Only iterators to the erased interval are invalidated.
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::erase(const_iterator position)
+{
+	if(cend() == position)
+		return cend();
+
+	const_iterator ret{position.ptr->next};
+	unlink(position.ptr);
+	pool.destroy(position.ptr);
+
+	return ret;
+}
+
+/*
+* @brief Erases every interval equal to @value, returns number of intervals erased.
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::size_type
+interval_tree<T, Allocator>::erase(const value_type &value)
+{
+	size_type count{0};
+	for(const_iterator it = lower_bound(value.lo); cend() != it && !(value.lo < it->lo); )
+	{
+		if(*it == value)
+		{
+			it = erase(it);
+			++count;
+		}
+		else
+			++it;
+	}
+
+	return count;
+}
+
+template<typename T, typename Allocator>
+void interval_tree<T, Allocator>::swap(interval_tree &other) noexcept
+{
+	tree_type::swap_tree(other);
+}
+// @}
+
+// Lookup:
+// @{
+/*
+* @brief Returns %const_iterator to the first interval equal to @value, or end().
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::find(const value_type &value) const
+{
+	for(const_iterator it = lower_bound(value.lo); cend() != it && !(value.lo < it->lo); ++it)
+		if(*it == value)
+			return it;
+
+	return cend();
+}
+
+/*
+* @brief Returns %const_iterator to the first interval starting at or after @lo, or end().
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::lower_bound(const T &lo) const
+{
+	return const_iterator{lower_node(lo)};
+}
+
+/*
+* @brief Returns %const_iterator to the first interval starting after @lo, or end().
+*/
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::const_iterator
+interval_tree<T, Allocator>::upper_bound(const T &lo) const
+{
+	return const_iterator{upper_node(lo)};
+}
+// @}
+
+// Overlap queries:
+// @{
+/*
+* @brief Returns whether any interval overlaps [@lo, @hi), in logN.
+*
+* Goes left whenever the left subtree ends after @lo: if no interval
+* there overlaps, none on the right can either, since they start later.
+*/
+template<typename T, typename Allocator>
+bool interval_tree<T, Allocator>::overlaps(const T &lo, const T &hi) const
+{
+	if(!(lo < hi))
+		return false;
+
+	for(const node_type *node = root; node; )
+	{
+		const value_type &value{node->key.value};
+		if(value.lo < hi && lo < value.hi)
+			return true;
+
+		if(node->left && lo < node->left->key.max)
+			node = node->left;
+		else
+			node = node->right;
+	}
+
+	return false;
+}
+
+/*
+* @brief Returns the intervals overlapping [@lo, @hi), in start order.
+*/
+template<typename T, typename Allocator>
+std::vector<typename interval_tree<T, Allocator>::value_type>
+interval_tree<T, Allocator>::overlapping(const T &lo, const T &hi) const
+{
+	std::vector<value_type> ret;
+	visit_overlapping(lo, hi, [&ret](const value_type &value) { ret.push_back(value); });
+	return ret;
+}
+
+/*
+* @brief Returns the intervals containing @point, in start order.
+*/
+template<typename T, typename Allocator>
+std::vector<typename interval_tree<T, Allocator>::value_type>
+interval_tree<T, Allocator>::containing(const T &point) const
+{
+	std::vector<value_type> ret;
+	visit_containing(point, [&ret](const value_type &value) { ret.push_back(value); });
+	return ret;
+}
+
+/*
+* @brief Calls @f with every interval overlapping [@lo, @hi), in start
+* order, without building a vector.
+*/
+template<typename T, typename Allocator>
+template<typename F>
+void interval_tree<T, Allocator>::visit_overlapping(const T &lo, const T &hi, F f) const
+{
+	if(lo < hi)
+		visit(root, lo, hi, false, f);
+}
+
+/*
+* @brief Calls @f with every interval containing @point, in start order.
+*/
+template<typename T, typename Allocator>
+template<typename F>
+void interval_tree<T, Allocator>::visit_containing(const T &point, F f) const
+{
+	visit(root, point, point, true, f);
+}
+// @}
+
+// Observers:
+// @{
+template<typename T, typename Allocator>
+typename interval_tree<T, Allocator>::allocator_type
+interval_tree<T, Allocator>::get_allocator(void) const
+{
+	return allocator_type{pool.get_allocator()};
+}
+// @}
+
+// Diagnostics:
+// @{
+/*
+* @brief Checks every invariant of the tree, see avl::detail::tree_base::check_tree(),
+* and that no interval is empty and every stored subtree end is up to date.
+*/
+template<typename T, typename Allocator>
+void interval_tree<T, Allocator>::validate(void) const
+{
+	tree_type::check_tree("interval_tree", [](const node_type *node) -> const char* {
+		entry_type expected{node->key.value};
+		expected.update(node->left ? &node->left->key : nullptr, node->right ? &node->right->key : nullptr);
+		if(!(node->key.value.lo < node->key.value.hi))
+			return "empty interval stored";
+		if(expected.max < node->key.max || node->key.max < expected.max)
+			return "stored subtree end does not match the children";
+		return nullptr;
+	});
+}
+// @}
+
+// Helpers:
+// @{
+/*
+* @brief Calls @f in start order with every interval under @node that
+* overlaps [@lo, @hi), or contains @lo if @point.
+*
+* Subtrees whose largest end is not past @lo are skipped, and so is
+* everything right of a node starting at or after @hi. Recursion depth
+* is the height of the tree.
+*/
+template<typename T, typename Allocator>
+template<typename F>
+void interval_tree<T, Allocator>::visit(const node_type *node, const T &lo, const T &hi, bool point, F &f)
+{
+	while(node && lo < node->key.max)
+	{
+		const value_type &value{node->key.value};
+
+		visit(node->left, lo, hi, point, f);
+		if(point ? lo < value.lo : !(value.lo < hi))
+			return;
+		if(lo < value.hi)
+			f(value);
+
+		node = node->right;
+	}
+}
+// @}
+// @@}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_INTERVAL_TREE_HPP_
@@ -0,0 +1,1247 @@
+#ifndef _CONTAINERS_MAP_HPP_
+#define _CONTAINERS_MAP_HPP_
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "set_node.hpp"
+#include "set_detail.hpp"
+#include "set_join.hpp"
+#include "set_stats.hpp"
+#include "node_pool.hpp"
+
+namespace containers
+{
+
+	// Map declaration:
+	// @@@{
+	/*
+	*	@brief A sorted container of unique keys, each with a mapped value,
+	*	stored in the same AVL tree as %set.
+	*
+	*	@param Key Type of key objects.
+	*	@param T Type of mapped objects.
+	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*	@param Allocator Allocator type, rebound to the node type.
+	*
+	*	Nodes are %set_node<std::pair<const Key, T>>, so balancing, threading,
+	*	splits and joins are the avl::detail code of %set. Searches get
+	*	avl::detail::first_key to look at the key of a node only. Nodes come
+	*	from a %node_pool, the comparator is stored like in %set, and the
+	*	bookkeeping of both is avl::detail::tree_base.
+	*	try_emplace(), insert_or_assign() and operator[] find the key and the
+	*	place for a new node in one descent.
+	*	The end sentinel is a node too, so Key and T have to be default
+	*	constructible.
+	*/
+	template<
+			typename Key,
+			typename T,
+			typename Compare = std::less<Key>,
+			typename Allocator = std::allocator<std::pair<const Key, T>>
+			>
+	class map : private avl::detail::tree_base<set_node<std::pair<const Key, T>>, avl::detail::first_key, Compare, Allocator>
+	{
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef std::pair<const Key, T> value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef Compare key_compare;
+			typedef value_type& reference;
+			typedef value_type* pointer;
+			typedef const value_type& const_reference;
+			typedef const value_type* const_pointer;
+			typedef Allocator allocator_type;
+			// @}
+		private:
+			// Convenience
+			using tree_type = avl::detail::tree_base<set_node<value_type>, avl::detail::first_key, Compare, Allocator>;
+			using typename tree_type::node_type;
+			using typename tree_type::pool_type;
+			using typename tree_type::position_type;
+			using tree_type::compare;
+
+			// Tree
+			using tree_type::pool;
+			using tree_type::root;
+			using tree_type::first;
+			using tree_type::last;
+			using tree_type::END;
+			using tree_type::_size;
+			using tree_type::find_node;
+			using tree_type::lower_node;
+			using tree_type::upper_node;
+			using tree_type::insert_position;
+			using tree_type::hint_position;
+			using tree_type::link_node;
+			using tree_type::unlink;
+			using tree_type::erase_nodes;
+			using tree_type::ensure_end;
+			template<typename K>
+			using transparent_key = std::enable_if_t<avl::detail::is_transparent<Compare>::value, K>;
+		public:
+			class const_iterator;
+
+			// Value Compare
+			// @@{
+			/*
+			* @brief Orders values of %map by their keys.
+			*/
+			class value_compare
+			{
+				public:
+					// Friend <3
+					friend class map;
+
+					bool operator()(const value_type &a, const value_type &b) const { return comp(a.first, b.first); }
+				private:
+					explicit value_compare(const Compare &comp) : comp(comp) {}
+
+					Compare comp;
+			};
+			// @@}
+
+			// Iterator
+			// @@{
+			/*
+			* @brief Bidirectional %map iterator, a node threaded in key order.
+			*
+			* The key is const, the mapped value can be changed through it.
+			*/
+			class iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef typename map::value_type value_type;
+					typedef ptrdiff_t difference_type;
+					typedef value_type* pointer;
+					typedef value_type& reference;
+
+					// Friend <3
+					friend class map;
+					friend class const_iterator;
+
+					// Constructor
+					iterator(node_type *ptr = nullptr);
+
+					// Operators
+					iterator& operator++();
+					iterator operator++(int);
+					iterator& operator--();
+					iterator operator--(int);
+
+					// Relation
+					bool operator==(const iterator &other) const;
+					bool operator!=(const iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *ptr;
+			};
+			// @@}
+
+			// Const Iterator
+			// @@{
+			class const_iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef typename map::value_type value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const value_type* pointer;
+					typedef const value_type& reference;
+
+					// Friend <3
+					friend class map;
+
+					// Constructor
+					const_iterator(node_type *ptr = nullptr);
+					const_iterator(const iterator &other);							// Convert
+
+					// Operators
+					const_iterator& operator++();
+					const_iterator operator++(int);
+					const_iterator& operator--();
+					const_iterator operator--(int);
+
+					// Relation
+					bool operator==(const const_iterator &other) const;
+					bool operator!=(const const_iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *ptr;
+			};
+			// @@}
+
+			// Reverse Iterator
+			typedef std::reverse_iterator<iterator> reverse_iterator;
+
+			// Const Reverse Iterator
+			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			// Constructor
+			map(void);																		// Default
+			explicit map(const Allocator &alloc);											// Allocator
+			explicit map(const Compare &comp, const Allocator &alloc = Allocator{});		// Comparator
+			map(const map &other);															// Copy
+			map(map &&other) noexcept;														// Move
+			map(const std::initializer_list<value_type> &ilist);							// Init list
+			map(const std::initializer_list<value_type> &ilist, const Compare &comp,
+					const Allocator &alloc = Allocator{});									// Init list, comparator
+
+			// Assignment
+			map& operator=(const map &other);									// Copy
+			map& operator=(map &&other) noexcept;								// Move
+			map& operator=(const std::initializer_list<value_type> &ilist);		// Init list
+
+			// Iterators
+			iterator begin(void) noexcept;
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			iterator end(void) noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+
+			// Reverse Iterators
+			reverse_iterator rbegin(void) noexcept;
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			reverse_iterator rend(void) noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Element access
+			T& operator[](const key_type &key);
+			T& operator[](key_type &&key);
+			T& at(const key_type &key);
+			const T& at(const key_type &key) const;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			std::pair<iterator, bool> insert(const value_type &value);
+			std::pair<iterator, bool> insert(value_type &&value);
+			iterator insert(const_iterator hint, const value_type &value);
+			iterator insert(const_iterator hint, value_type &&value);
+			void insert(const std::initializer_list<value_type> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+
+			// Insert or assign
+			template<typename M>
+			std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj);
+			template<typename M>
+			std::pair<iterator, bool> insert_or_assign(key_type &&key, M &&obj);
+			template<typename M>
+			iterator insert_or_assign(const_iterator hint, const key_type &key, M &&obj);
+			template<typename M>
+			iterator insert_or_assign(const_iterator hint, key_type &&key, M &&obj);
+
+			// Emplace
+			template<class... Args>
+			std::pair<iterator, bool> emplace(Args &&...args);
+			template<class... Args>
+			iterator emplace_hint(const_iterator hint, Args &&...args);
+			template<class... Args>
+			std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args);
+			template<class... Args>
+			std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args);
+			template<class... Args>
+			iterator try_emplace(const_iterator hint, const key_type &key, Args &&...args);
+			template<class... Args>
+			iterator try_emplace(const_iterator hint, key_type &&key, Args &&...args);
+
+			// Erase
+			iterator erase(const_iterator position);
+			iterator erase(const_iterator first, const_iterator last);
+			size_type erase(const key_type &key);
+
+			// Swap
+			void swap(map &other) noexcept;
+
+			// Lookup
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
+
+			// Find
+			iterator find(const key_type &key);
+			const_iterator find(const key_type &key) const;
+
+			// Equal range
+			std::pair<iterator, iterator> equal_range(const key_type &key);
+			std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const;
+
+			// Bounds
+			iterator lower_bound(const key_type &key);
+			const_iterator lower_bound(const key_type &key) const;
+			iterator upper_bound(const key_type &key);
+			const_iterator upper_bound(const key_type &key) const;
+
+			// Heterogeneous lookup, only with a transparent Compare (e.g. std::less<>)
+			template<typename K, typename = transparent_key<K>>
+			size_type count(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			bool contains(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator find(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator find(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			std::pair<iterator, iterator> equal_range(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator lower_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator lower_bound(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator upper_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator upper_bound(const K &key) const;
+
+			// Observers
+			key_compare key_comp(void) const;
+			value_compare value_comp(void) const;
+			allocator_type get_allocator(void) const;
+
+			// Diagnostics
+			using tree_type::stats;
+			void validate(void) const;
+		private:
+			// Helpers
+			template<class... Args>
+			std::pair<iterator, bool> insert_at(position_type position, Args &&...args);
+			template<typename K, class... Args>
+			std::pair<iterator, bool> emplace_key_at(position_type position, K &&key, Args &&...args);
+			template<typename K, typename M>
+			std::pair<iterator, bool> assign_at(position_type position, K &&key, M &&obj);
+	};
+	// @@@}
+
+// Map implementation:
+// @@@{
+// Iterator
+// @@{
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::iterator::iterator(node_type *ptr)
+	:	ptr{ptr}
+{}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator&
+map<Key, T, Compare, Allocator>::iterator::operator++()
+{
+	ptr = ptr->next;
+	return *this;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::iterator::operator++(int)
+{
+	iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator&
+map<Key, T, Compare, Allocator>::iterator::operator--()
+{
+	ptr = ptr->prev;
+	return *this;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::iterator::operator--(int)
+{
+	iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+bool map<Key, T, Compare, Allocator>::iterator::operator==(const iterator &other) const
+{
+	return ptr == other.ptr;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+bool map<Key, T, Compare, Allocator>::iterator::operator!=(const iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator::reference
+map<Key, T, Compare, Allocator>::iterator::operator*() const
+{
+	return ptr->key;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator::pointer
+map<Key, T, Compare, Allocator>::iterator::operator->() const
+{
+	return &ptr->key;
+}
+// @@}
+
+// Const Iterator
+// @@{
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::const_iterator::const_iterator(node_type *ptr)
+	:	ptr{ptr}
+{}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::const_iterator::const_iterator(const iterator &other)
+	:	ptr{other.ptr}
+{}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator&
+map<Key, T, Compare, Allocator>::const_iterator::operator++()
+{
+	ptr = ptr->next;
+	return *this;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::const_iterator::operator++(int)
+{
+	const_iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator&
+map<Key, T, Compare, Allocator>::const_iterator::operator--()
+{
+	ptr = ptr->prev;
+	return *this;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::const_iterator::operator--(int)
+{
+	const_iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+bool map<Key, T, Compare, Allocator>::const_iterator::operator==(const const_iterator &other) const
+{
+	return ptr == other.ptr;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+bool map<Key, T, Compare, Allocator>::const_iterator::operator!=(const const_iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator::reference
+map<Key, T, Compare, Allocator>::const_iterator::operator*() const
+{
+	return ptr->key;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator::pointer
+map<Key, T, Compare, Allocator>::const_iterator::operator->() const
+{
+	return &ptr->key;
+}
+// @@}
+
+// Map
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds empty %map.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(void)
+	:	map(Allocator{})
+{}
+
+/*
+* @brief Builds empty %map whose nodes are allocated through @alloc.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(const Allocator &alloc)
+	:	map(Compare{}, alloc)
+{}
+
+/*
+* @brief Builds empty %map ordered by @comp.
+*
+* @param comp Comparator, copied once and used by reference afterwards.
+* @param alloc Allocator for the nodes.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(const Compare &comp, const Allocator &alloc)
+	:	tree_type{comp, alloc}
+{}
+
+/*
+* @brief %map Copy constructor, copies the tree node for node with its
+* shape, without comparisons or rebalancing, in linear time.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(const map &other)
+	:	map(other.compare(), std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+{
+	tree_type::copy_nodes(other);
+}
+
+/*
+* @brief %map Move constructor, @other is left empty.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(map &&other) noexcept
+	:	tree_type{std::move(other)}
+{}
+
+/*
+* @brief Builds %map from an std::initializer_list, the first of equivalent keys is kept.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(const std::initializer_list<value_type> &ilist)
+	:	map()
+{
+	insert(ilist);
+}
+
+/*
+* @brief Builds %map ordered by @comp from an std::initializer_list.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>::map(const std::initializer_list<value_type> &ilist, const Compare &comp, const Allocator &alloc)
+	:	map(comp, alloc)
+{
+	insert(ilist);
+}
+// @}
+
+// Assignment:
+// @{
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>&
+map<Key, T, Compare, Allocator>::operator=(const map &other)
+{
+	if(this != &other)
+	{
+		map tmp{other};
+		swap(tmp);
+	}
+
+	return *this;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>&
+map<Key, T, Compare, Allocator>::operator=(map &&other) noexcept
+{
+	if(this != &other)
+	{
+		swap(other);
+		other.clear();
+	}
+
+	return *this;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator>&
+map<Key, T, Compare, Allocator>::operator=(const std::initializer_list<value_type> &ilist)
+{
+	clear();
+	insert(ilist);
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::begin(void) noexcept
+{
+	return empty() ? iterator{END} : iterator{first};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::begin(void) const noexcept
+{
+	return empty() ? const_iterator{END} : const_iterator{first};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::cbegin(void) const noexcept
+{
+	return begin();
+}
+
+/*
+* End is the sentinel closing the threaded list, so it can be decremented.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::end(void) noexcept
+{
+	return iterator{END};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::end(void) const noexcept
+{
+	return const_iterator{END};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::cend(void) const noexcept
+{
+	return end();
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::reverse_iterator
+map<Key, T, Compare, Allocator>::rbegin(void) noexcept
+{
+	return reverse_iterator{end()};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_reverse_iterator
+map<Key, T, Compare, Allocator>::rbegin(void) const noexcept
+{
+	return const_reverse_iterator{end()};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_reverse_iterator
+map<Key, T, Compare, Allocator>::crbegin(void) const noexcept
+{
+	return rbegin();
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::reverse_iterator
+map<Key, T, Compare, Allocator>::rend(void) noexcept
+{
+	return reverse_iterator{begin()};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_reverse_iterator
+map<Key, T, Compare, Allocator>::rend(void) const noexcept
+{
+	return const_reverse_iterator{begin()};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_reverse_iterator
+map<Key, T, Compare, Allocator>::crend(void) const noexcept
+{
+	return rend();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename Key, typename T, typename Compare, typename Allocator>
+bool map<Key, T, Compare, Allocator>::empty(void) const noexcept
+{
+	return 0 == _size;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::size_type
+map<Key, T, Compare, Allocator>::size(void) const noexcept
+{
+	return _size;
+}
+// @}
+
+// Element access:
+// @{
+/*
+* @brief Returns the value mapped to @key, inserting a value initialized one if there is none.
+*
+* One descent finds both the key and the place for a new node.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+T& map<Key, T, Compare, Allocator>::operator[](const key_type &key)
+{
+	return try_emplace(key).first->second;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+T& map<Key, T, Compare, Allocator>::operator[](key_type &&key)
+{
+	return try_emplace(std::move(key)).first->second;
+}
+
+/*
+* @brief Returns the value mapped to @key, throws std::out_of_range if there is none.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+T& map<Key, T, Compare, Allocator>::at(const key_type &key)
+{
+	node_type *node{avl::detail::bst_find(root, key, compare(), avl::detail::first_key{})};
+	if(nullptr == node)
+		throw std::out_of_range("map: key not found");
+
+	return node->key.second;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+const T& map<Key, T, Compare, Allocator>::at(const key_type &key) const
+{
+	const node_type *node{avl::detail::bst_find(root, key, compare(), avl::detail::first_key{})};
+	if(nullptr == node)
+		throw std::out_of_range("map: key not found");
+
+	return node->key.second;
+}
+// @}
+
+// Modifiers:
+// @{
+/*
+* @brief Erases all elements, node memory is released one chunk at a time.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key, T, Compare, Allocator>::clear(void)
+{
+	tree_type::clear_nodes();
+}
+
+/*
+* @brief Inserts a copy of @value unless its key is present.
+*
+* @return std::pair Iterator to the element with the key of @value and whether it was inserted.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::insert(const value_type &value)
+{
+	return insert_at(insert_position(value.first), value);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::insert(value_type &&value)
+{
+	return insert_at(insert_position(value.first), std::move(value));
+}
+
+/*
+* @brief Inserts a copy of @value, searching from @hint, see avl::detail::bst_hint_position().
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::insert(const_iterator hint, const value_type &value)
+{
+	return insert_at(hint_position(hint.ptr, value.first), value).first;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::insert(const_iterator hint, value_type &&value)
+{
+	return insert_at(hint_position(hint.ptr, value.first), std::move(value)).first;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key, T, Compare, Allocator>::insert(const std::initializer_list<value_type> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+/*
+* @brief Inserts elements of [@first, @last), each one hinted with end(),
+* so a sorted range is appended with one comparison per element.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename InputIt>
+void map<Key, T, Compare, Allocator>::insert(InputIt first, InputIt last)
+{
+	for(; first != last; ++first)
+		insert(cend(), *first);
+}
+
+/*
+* @brief Maps @key to @obj, inserting @key if it is not present.
+*
+* @return std::pair Iterator to the element of @key and whether it was inserted.
+*
+* One descent, the node is only built when the key is new.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename M>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::insert_or_assign(const key_type &key, M &&obj)
+{
+	return assign_at(insert_position(key), key, std::forward<M>(obj));
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename M>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::insert_or_assign(key_type &&key, M &&obj)
+{
+	return assign_at(insert_position(key), std::move(key), std::forward<M>(obj));
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename M>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::insert_or_assign(const_iterator hint, const key_type &key, M &&obj)
+{
+	return assign_at(hint_position(hint.ptr, key), key, std::forward<M>(obj)).first;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename M>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::insert_or_assign(const_iterator hint, key_type &&key, M &&obj)
+{
+	return assign_at(hint_position(hint.ptr, key), std::move(key), std::forward<M>(obj)).first;
+}
+
+/*
+* @brief Builds an element from @args and inserts it unless its key is present.
+*
+* The key is only known once the element is built, so a node is always
+* taken from the pool and given back if the key is present. try_emplace()
+* does not need to.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::emplace(Args &&...args)
+{
+	ensure_end();
+	node_type *node{pool.create(std::forward<Args>(args)...)};
+	position_type position{insert_position(node->key.first)};
+	if(position.first && 0 == position.second)
+	{
+		pool.destroy(node);
+		return std::make_pair(iterator{position.first}, false);
+	}
+
+	link_node(position, node);
+	return std::make_pair(iterator{node}, true);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::emplace_hint(const_iterator hint, Args &&...args)
+{
+	ensure_end();
+	node_type *node{pool.create(std::forward<Args>(args)...)};
+	position_type position{hint_position(hint.ptr, node->key.first)};
+	if(position.first && 0 == position.second)
+	{
+		pool.destroy(node);
+		return iterator{position.first};
+	}
+
+	link_node(position, node);
+	return iterator{node};
+}
+
+/*
+* @brief Inserts @key with a value built from @args, unless @key is present.
+*
+* @return std::pair Iterator to the element of @key and whether it was inserted.
+*
+* If @key is present nothing is built and @key and @args are not moved from.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::try_emplace(const key_type &key, Args &&...args)
+{
+	return emplace_key_at(insert_position(key), key, std::forward<Args>(args)...);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::try_emplace(key_type &&key, Args &&...args)
+{
+	return emplace_key_at(insert_position(key), std::move(key), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::try_emplace(const_iterator hint, const key_type &key, Args &&...args)
+{
+	return emplace_key_at(hint_position(hint.ptr, key), key, std::forward<Args>(args)...).first;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::try_emplace(const_iterator hint, key_type &&key, Args &&...args)
+{
+	return emplace_key_at(hint_position(hint.ptr, key), std::move(key), std::forward<Args>(args)...).first;
+}
+
+/*
+* @brief Erases element at @position, returns %iterator to the next one.
+*
+* Only iterators to the erased element are invalidated.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::erase(const_iterator position)
+{
+	if(cend() == position)
+		return end();
+
+	iterator ret{position.ptr->next};
+	unlink(position.ptr);
+	pool.destroy(position.ptr);
+
+	return ret;
+}
+
+/*
+* @brief Erases elements in [@first, @last) with two splits and one join,
+* logN + K for K elements, see set::erase(const_iterator, const_iterator).
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::erase(const_iterator first, const_iterator last)
+{
+	if(first != last)
+		erase_nodes(first.ptr, last.ptr);
+
+	return iterator{last.ptr};
+}
+
+/*
+* @brief Erases element with key equivalent to @key, returns number of elements erased.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::size_type
+map<Key, T, Compare, Allocator>::erase(const key_type &key)
+{
+	node_type *node{avl::detail::bst_find(root, key, compare(), avl::detail::first_key{})};
+	if(nullptr == node)
+		return 0;
+
+	unlink(node);
+	pool.destroy(node);
+
+	return 1;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key, T, Compare, Allocator>::swap(map &other) noexcept
+{
+	tree_type::swap_tree(other);
+}
+// @}
+
+// Lookup:
+// @{
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::size_type
+map<Key, T, Compare, Allocator>::count(const key_type &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+bool map<Key, T, Compare, Allocator>::contains(const key_type &key) const
+{
+	return nullptr != avl::detail::bst_find(root, key, compare(), avl::detail::first_key{});
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::find(const key_type &key)
+{
+	return iterator{find_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::find(const key_type &key) const
+{
+	return const_iterator{find_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator,
+		typename map<Key, T, Compare, Allocator>::iterator>
+map<Key, T, Compare, Allocator>::equal_range(const key_type &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+std::pair<typename map<Key, T, Compare, Allocator>::const_iterator,
+		typename map<Key, T, Compare, Allocator>::const_iterator>
+map<Key, T, Compare, Allocator>::equal_range(const key_type &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+/*
+* @brief Returns %iterator to the first element whose key is not less than @key, or end().
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::lower_bound(const key_type &key)
+{
+	return iterator{lower_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::lower_bound(const key_type &key) const
+{
+	return const_iterator{lower_node(key)};
+}
+
+/*
+* @brief Returns %iterator to the first element whose key is greater than @key, or end().
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::upper_bound(const key_type &key)
+{
+	return iterator{upper_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::upper_bound(const key_type &key) const
+{
+	return const_iterator{upper_node(key)};
+}
+
+/*
+* @brief Heterogeneous lookup, @key is compared as it is, without building a Key.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::size_type
+map<Key, T, Compare, Allocator>::count(const K &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+bool map<Key, T, Compare, Allocator>::contains(const K &key) const
+{
+	return nullptr != avl::detail::bst_find(root, key, compare(), avl::detail::first_key{});
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::find(const K &key)
+{
+	return iterator{find_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::find(const K &key) const
+{
+	return const_iterator{find_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator,
+		typename map<Key, T, Compare, Allocator>::iterator>
+map<Key, T, Compare, Allocator>::equal_range(const K &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+std::pair<typename map<Key, T, Compare, Allocator>::const_iterator,
+		typename map<Key, T, Compare, Allocator>::const_iterator>
+map<Key, T, Compare, Allocator>::equal_range(const K &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::lower_bound(const K &key)
+{
+	return iterator{lower_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::lower_bound(const K &key) const
+{
+	return const_iterator{lower_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::iterator
+map<Key, T, Compare, Allocator>::upper_bound(const K &key)
+{
+	return iterator{upper_node(key)};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename>
+typename map<Key, T, Compare, Allocator>::const_iterator
+map<Key, T, Compare, Allocator>::upper_bound(const K &key) const
+{
+	return const_iterator{upper_node(key)};
+}
+// @}
+
+// Observers:
+// @{
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::key_compare
+map<Key, T, Compare, Allocator>::key_comp(void) const
+{
+	return compare();
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::value_compare
+map<Key, T, Compare, Allocator>::value_comp(void) const
+{
+	return value_compare{compare()};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key, T, Compare, Allocator>::allocator_type
+map<Key, T, Compare, Allocator>::get_allocator(void) const
+{
+	return allocator_type{pool.get_allocator()};
+}
+// @}
+
+// Diagnostics:
+// @{
+/*
+* @brief Checks every invariant of %map, see avl::detail::tree_base::check_tree().
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key, T, Compare, Allocator>::validate(void) const
+{
+	tree_type::check_tree("map");
+}
+// @}
+
+// Helpers:
+// @{
+/*
+* @brief Links a new node built from @args at @position, unless @position
+* is an equivalent key.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::insert_at(position_type position, Args &&...args)
+{
+	if(position.first && 0 == position.second)
+		return std::make_pair(iterator{position.first}, false);
+
+	ensure_end();
+	node_type *node{pool.create(std::forward<Args>(args)...)};
+	link_node(position, node);
+
+	return std::make_pair(iterator{node}, true);
+}
+
+/*
+* @brief Links a node with @key and a value built from @args at @position,
+* unless @position is an equivalent key.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, class... Args>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::emplace_key_at(position_type position, K &&key, Args &&...args)
+{
+	return insert_at(position, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+			std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+/*
+* @brief Assigns @obj to the element at @position, or links a new node
+* with @key and @obj there.
+*/
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename K, typename M>
+std::pair<typename map<Key, T, Compare, Allocator>::iterator, bool>
+map<Key, T, Compare, Allocator>::assign_at(position_type position, K &&key, M &&obj)
+{
+	if(position.first && 0 == position.second)
+	{
+		position.first->key.second = std::forward<M>(obj);
+		return std::make_pair(iterator{position.first}, false);
+	}
+
+	return emplace_key_at(position, std::forward<K>(key), std::forward<M>(obj));
+}
+// @}
+// @@}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_MAP_HPP_
@@ -0,0 +1,1038 @@
+#ifndef _CONTAINERS_MULTISET_HPP_
+#define _CONTAINERS_MULTISET_HPP_
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "set_node.hpp"
+#include "set_detail.hpp"
+#include "set_join.hpp"
+#include "set_stats.hpp"
+#include "node_pool.hpp"
+
+namespace containers
+{
+
+	// Multiset declaration:
+	// @@@{
+	/*
+	*	@brief A sorted container of keys that may repeat, stored in the same
+	*	AVL tree as %set.
+	*
+	*	@param Key Type of key objects.
+	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*	@param Allocator Allocator type, rebound to the node type.
+	*
+	*	Every key is a node, equivalent keys are kept next to each other in
+	*	insertion order (see avl::detail::bst_insert_equal_position()).
+	*	Subtree sizes make count() logN however many equivalent keys there
+	*	are, and let range erase split between equivalent keys. When only the
+	*	number of occurrences matters, %counted_set keeps one node per key.
+	*	The bookkeeping is avl::detail::tree_base of %set with its
+	*	duplicate-allowing insert policy.
+	*	The end sentinel is a node too, so Key has to be default constructible.
+	*/
+	template<
+			typename Key,
+			typename Compare = std::less<Key>,
+			typename Allocator = std::allocator<Key>
+			>
+	class multiset : private avl::detail::tree_base<set_node<Key>, avl::detail::identity_key, Compare, Allocator, false>
+	{
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef Key value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef Compare key_compare;
+			typedef Compare value_compare;
+			typedef Key& reference;
+			typedef Key* pointer;
+			typedef const Key& const_reference;
+			typedef const Key* const_pointer;
+			typedef Allocator allocator_type;
+			// @}
+		private:
+			// Convenience
+			using tree_type = avl::detail::tree_base<set_node<Key>, avl::detail::identity_key, Compare, Allocator, false>;
+			using typename tree_type::node_type;
+			using typename tree_type::pool_type;
+			using typename tree_type::position_type;
+			using tree_type::compare;
+
+			// Tree
+			using tree_type::pool;
+			using tree_type::root;
+			using tree_type::first;
+			using tree_type::last;
+			using tree_type::END;
+			using tree_type::_size;
+			using tree_type::find_node;
+			using tree_type::lower_node;
+			using tree_type::upper_node;
+			using tree_type::insert_position;
+			using tree_type::hint_position;
+			using tree_type::link_node;
+			using tree_type::unlink;
+			using tree_type::erase_nodes;
+			using tree_type::ensure_end;
+			template<typename K>
+			using transparent_key = std::enable_if_t<avl::detail::is_transparent<Compare>::value, K>;
+		public:
+			class const_iterator;
+
+			// Iterator
+			// @@{
+			/*
+			* @brief Bidirectional %multiset iterator, a node threaded in key order.
+			*
+			* Keys are read only, changing one could break the order.
+			*/
+			class iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef typename multiset::value_type value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const value_type* pointer;
+					typedef const value_type& reference;
+
+					// Friend <3
+					friend class multiset;
+					friend class const_iterator;
+
+					// Constructor
+					iterator(node_type *ptr = nullptr);
+
+					// Operators
+					iterator& operator++();
+					iterator operator++(int);
+					iterator& operator--();
+					iterator operator--(int);
+
+					// Relation
+					bool operator==(const iterator &other) const;
+					bool operator!=(const iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *ptr;
+			};
+			// @@}
+
+			// Const Iterator
+			// @@{
+			class const_iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef typename multiset::value_type value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const value_type* pointer;
+					typedef const value_type& reference;
+
+					// Friend <3
+					friend class multiset;
+
+					// Constructor
+					const_iterator(node_type *ptr = nullptr);
+					const_iterator(const iterator &other);							// Convert
+
+					// Operators
+					const_iterator& operator++();
+					const_iterator operator++(int);
+					const_iterator& operator--();
+					const_iterator operator--(int);
+
+					// Relation
+					bool operator==(const const_iterator &other) const;
+					bool operator!=(const const_iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					node_type *ptr;
+			};
+			// @@}
+
+			// Reverse Iterator
+			typedef std::reverse_iterator<iterator> reverse_iterator;
+
+			// Const Reverse Iterator
+			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			// Constructor
+			multiset(void);																		// Default
+			explicit multiset(const Allocator &alloc);											// Allocator
+			explicit multiset(const Compare &comp, const Allocator &alloc = Allocator{});		// Comparator
+			multiset(const multiset &other);													// Copy
+			multiset(multiset &&other) noexcept;												// Move
+			multiset(const std::initializer_list<value_type> &ilist);							// Init list
+			multiset(const std::initializer_list<value_type> &ilist, const Compare &comp,
+					const Allocator &alloc = Allocator{});										// Init list, comparator
+
+			// Assignment
+			multiset& operator=(const multiset &other);								// Copy
+			multiset& operator=(multiset &&other) noexcept;							// Move
+			multiset& operator=(const std::initializer_list<value_type> &ilist);	// Init list
+
+			// Iterators
+			iterator begin(void) noexcept;
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			iterator end(void) noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+
+			// Reverse Iterators
+			reverse_iterator rbegin(void) noexcept;
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			reverse_iterator rend(void) noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Modifiers
+			void clear(void);
+
+			// Insert
+			iterator insert(const value_type &value);
+			iterator insert(value_type &&value);
+			iterator insert(const_iterator hint, const value_type &value);
+			iterator insert(const_iterator hint, value_type &&value);
+			void insert(const std::initializer_list<value_type> &ilist);
+			template<typename InputIt>
+			void insert(InputIt first, InputIt last);
+
+			// Emplace
+			template<class... Args>
+			iterator emplace(Args &&...args);
+			template<class... Args>
+			iterator emplace_hint(const_iterator hint, Args &&...args);
+
+			// Erase
+			iterator erase(const_iterator position);
+			iterator erase(const_iterator first, const_iterator last);
+			size_type erase(const key_type &key);
+
+			// Swap
+			void swap(multiset &other) noexcept;
+
+			// Lookup
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
+
+			// Find
+			iterator find(const key_type &key);
+			const_iterator find(const key_type &key) const;
+
+			// Equal range
+			std::pair<iterator, iterator> equal_range(const key_type &key);
+			std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const;
+
+			// Bounds
+			iterator lower_bound(const key_type &key);
+			const_iterator lower_bound(const key_type &key) const;
+			iterator upper_bound(const key_type &key);
+			const_iterator upper_bound(const key_type &key) const;
+
+			// Heterogeneous lookup, only with a transparent Compare (e.g. std::less<>)
+			template<typename K, typename = transparent_key<K>>
+			size_type count(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			bool contains(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator find(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator find(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			std::pair<iterator, iterator> equal_range(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator lower_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator lower_bound(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator upper_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator upper_bound(const K &key) const;
+
+			// Order statistics
+			iterator nth(size_type k);
+			const_iterator nth(size_type k) const;
+
+			// Observers
+			key_compare key_comp(void) const;
+			value_compare value_comp(void) const;
+			allocator_type get_allocator(void) const;
+
+			// Diagnostics
+			using tree_type::stats;
+			void validate(void) const;
+	};
+	// @@@}
+
+// Multiset implementation:
+// @@@{
+// Iterator
+// @@{
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::iterator::iterator(node_type *ptr)
+	:	ptr{ptr}
+{}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator&
+multiset<Key, Compare, Allocator>::iterator::operator++()
+{
+	ptr = ptr->next;
+	return *this;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::iterator::operator++(int)
+{
+	iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator&
+multiset<Key, Compare, Allocator>::iterator::operator--()
+{
+	ptr = ptr->prev;
+	return *this;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::iterator::operator--(int)
+{
+	iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+bool multiset<Key, Compare, Allocator>::iterator::operator==(const iterator &other) const
+{
+	return ptr == other.ptr;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+bool multiset<Key, Compare, Allocator>::iterator::operator!=(const iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator::reference
+multiset<Key, Compare, Allocator>::iterator::operator*() const
+{
+	return ptr->key;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator::pointer
+multiset<Key, Compare, Allocator>::iterator::operator->() const
+{
+	return &ptr->key;
+}
+// @@}
+
+// Const Iterator
+// @@{
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::const_iterator::const_iterator(node_type *ptr)
+	:	ptr{ptr}
+{}
+
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::const_iterator::const_iterator(const iterator &other)
+	:	ptr{other.ptr}
+{}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator&
+multiset<Key, Compare, Allocator>::const_iterator::operator++()
+{
+	ptr = ptr->next;
+	return *this;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::const_iterator::operator++(int)
+{
+	const_iterator ret{*this};
+	++*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator&
+multiset<Key, Compare, Allocator>::const_iterator::operator--()
+{
+	ptr = ptr->prev;
+	return *this;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::const_iterator::operator--(int)
+{
+	const_iterator ret{*this};
+	--*this;
+	return ret;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+bool multiset<Key, Compare, Allocator>::const_iterator::operator==(const const_iterator &other) const
+{
+	return ptr == other.ptr;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+bool multiset<Key, Compare, Allocator>::const_iterator::operator!=(const const_iterator &other) const
+{
+	return !(*this == other);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator::reference
+multiset<Key, Compare, Allocator>::const_iterator::operator*() const
+{
+	return ptr->key;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator::pointer
+multiset<Key, Compare, Allocator>::const_iterator::operator->() const
+{
+	return &ptr->key;
+}
+// @@}
+
+// Multiset
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds empty %multiset.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(void)
+	:	multiset(Allocator{})
+{}
+
+/*
+* @brief Builds empty %multiset whose nodes are allocated through @alloc.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(const Allocator &alloc)
+	:	multiset(Compare{}, alloc)
+{}
+
+/*
+* @brief Builds empty %multiset ordered by @comp.
+*
+* @param comp Comparator, copied once and used by reference afterwards.
+* @param alloc Allocator for the nodes.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(const Compare &comp, const Allocator &alloc)
+	:	tree_type{comp, alloc}
+{}
+
+/*
+* @brief %multiset Copy constructor, copies the tree node for node with its
+* shape, so equivalent keys keep their order, in linear time.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(const multiset &other)
+	:	multiset(other.compare(), std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+{
+	tree_type::copy_nodes(other);
+}
+
+/*
+* @brief %multiset Move constructor, @other is left empty.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(multiset &&other) noexcept
+	:	tree_type{std::move(other)}
+{}
+
+/*
+* @brief Builds %multiset from an std::initializer_list, keeping every key.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(const std::initializer_list<value_type> &ilist)
+	:	multiset()
+{
+	insert(ilist);
+}
+
+/*
+* @brief Builds %multiset ordered by @comp from an std::initializer_list.
+*/
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>::multiset(const std::initializer_list<value_type> &ilist, const Compare &comp, const Allocator &alloc)
+	:	multiset(comp, alloc)
+{
+	insert(ilist);
+}
+// @}
+
+// Assignment:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>&
+multiset<Key, Compare, Allocator>::operator=(const multiset &other)
+{
+	if(this != &other)
+	{
+		multiset tmp{other};
+		swap(tmp);
+	}
+
+	return *this;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>&
+multiset<Key, Compare, Allocator>::operator=(multiset &&other) noexcept
+{
+	if(this != &other)
+	{
+		swap(other);
+		other.clear();
+	}
+
+	return *this;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+multiset<Key, Compare, Allocator>&
+multiset<Key, Compare, Allocator>::operator=(const std::initializer_list<value_type> &ilist)
+{
+	clear();
+	insert(ilist);
+	return *this;
+}
+// @}
+
+// Iterators:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::begin(void) noexcept
+{
+	return empty() ? iterator{END} : iterator{first};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::begin(void) const noexcept
+{
+	return empty() ? const_iterator{END} : const_iterator{first};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::cbegin(void) const noexcept
+{
+	return begin();
+}
+
+/*
+* End is the sentinel closing the threaded list, so it can be decremented.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::end(void) noexcept
+{
+	return iterator{END};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::end(void) const noexcept
+{
+	return const_iterator{END};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::cend(void) const noexcept
+{
+	return end();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::reverse_iterator
+multiset<Key, Compare, Allocator>::rbegin(void) noexcept
+{
+	return reverse_iterator{end()};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_reverse_iterator
+multiset<Key, Compare, Allocator>::rbegin(void) const noexcept
+{
+	return const_reverse_iterator{end()};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_reverse_iterator
+multiset<Key, Compare, Allocator>::crbegin(void) const noexcept
+{
+	return rbegin();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::reverse_iterator
+multiset<Key, Compare, Allocator>::rend(void) noexcept
+{
+	return reverse_iterator{begin()};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_reverse_iterator
+multiset<Key, Compare, Allocator>::rend(void) const noexcept
+{
+	return const_reverse_iterator{begin()};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_reverse_iterator
+multiset<Key, Compare, Allocator>::crend(void) const noexcept
+{
+	return rend();
+}
+// @}
+
+// Capacity:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+bool multiset<Key, Compare, Allocator>::empty(void) const noexcept
+{
+	return 0 == _size;
+}
+
+/*
+* @brief Returns number of keys, equivalent ones counted each.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::size_type
+multiset<Key, Compare, Allocator>::size(void) const noexcept
+{
+	return _size;
+}
+// @}
+
+// Modifiers:
+// @{
+/*
+* @brief Erases all keys, node memory is released one chunk at a time.
+*/
+template<typename Key, typename Compare, typename Allocator>
+void multiset<Key, Compare, Allocator>::clear(void)
+{
+	tree_type::clear_nodes();
+}
+
+/*
+* @brief Inserts a copy of @value after the keys equivalent to it.
+*
+* @return %iterator to the inserted key, insertion always succeeds.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::insert(const value_type &value)
+{
+	return emplace(value);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::insert(value_type &&value)
+{
+	return emplace(std::move(value));
+}
+
+/*
+* @brief Inserts a copy of @value right before @hint if it belongs there,
+* see avl::detail::bst_hint_equal_position().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::insert(const_iterator hint, const value_type &value)
+{
+	return emplace_hint(hint, value);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::insert(const_iterator hint, value_type &&value)
+{
+	return emplace_hint(hint, std::move(value));
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void multiset<Key, Compare, Allocator>::insert(const std::initializer_list<value_type> &ilist)
+{
+	insert(ilist.begin(), ilist.end());
+}
+
+/*
+* @brief Inserts keys of [@first, @last), each one hinted with end(),
+* so a sorted range is appended with one comparison per key.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename InputIt>
+void multiset<Key, Compare, Allocator>::insert(InputIt first, InputIt last)
+{
+	for(; first != last; ++first)
+		insert(cend(), *first);
+}
+
+/*
+* @brief Builds a key from @args and inserts it after the keys equivalent to it.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<class... Args>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::emplace(Args &&...args)
+{
+	ensure_end();
+	node_type *node{pool.create(std::forward<Args>(args)...)};
+	link_node(insert_position(node->key), node);
+
+	return iterator{node};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<class... Args>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::emplace_hint(const_iterator hint, Args &&...args)
+{
+	ensure_end();
+	node_type *node{pool.create(std::forward<Args>(args)...)};
+	link_node(hint_position(hint.ptr, node->key), node);
+
+	return iterator{node};
+}
+
+/*
+* @brief Erases key at @position, returns %iterator to the next one.
+*
+* Only iterators to the erased key are invalidated.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::erase(const_iterator position)
+{
+	if(cend() == position)
+		return end();
+
+	iterator ret{position.ptr->next};
+	unlink(position.ptr);
+	pool.destroy(position.ptr);
+
+	return ret;
+}
+
+/*
+* @brief Erases keys in [@first, @last), logN + K for K keys, see erase_nodes().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::erase(const_iterator first, const_iterator last)
+{
+	if(first != last)
+		erase_nodes(first.ptr, last.ptr);
+
+	return iterator{last.ptr};
+}
+
+/*
+* @brief Erases every key equivalent to @key, returns number of keys erased.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::size_type
+multiset<Key, Compare, Allocator>::erase(const key_type &key)
+{
+	auto [from, to] = equal_range(key);
+	return from == to ? 0 : erase_nodes(from.ptr, to.ptr);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void multiset<Key, Compare, Allocator>::swap(multiset &other) noexcept
+{
+	tree_type::swap_tree(other);
+}
+// @}
+
+// Lookup:
+// @{
+/*
+* @brief Returns number of keys equivalent to @key.
+*
+* Difference of two ranks, logN however many there are.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::size_type
+multiset<Key, Compare, Allocator>::count(const key_type &key) const
+{
+	const node_type *node{root};
+	return avl::detail::upper_rank(node, key, compare()) - avl::detail::rank(node, key, compare());
+}
+
+template<typename Key, typename Compare, typename Allocator>
+bool multiset<Key, Compare, Allocator>::contains(const key_type &key) const
+{
+	return END != find_node(key);
+}
+
+/*
+* @brief Returns %iterator to the first key equivalent to @key, or end().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::find(const key_type &key)
+{
+	return iterator{find_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::find(const key_type &key) const
+{
+	return const_iterator{find_node(key)};
+}
+
+/*
+* @brief Returns the range of keys equivalent to @key, in insertion order.
+*/
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename multiset<Key, Compare, Allocator>::iterator,
+		typename multiset<Key, Compare, Allocator>::iterator>
+multiset<Key, Compare, Allocator>::equal_range(const key_type &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename multiset<Key, Compare, Allocator>::const_iterator,
+		typename multiset<Key, Compare, Allocator>::const_iterator>
+multiset<Key, Compare, Allocator>::equal_range(const key_type &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+/*
+* @brief Returns %iterator to the first key not less than @key, or end().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::lower_bound(const key_type &key)
+{
+	return iterator{lower_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::lower_bound(const key_type &key) const
+{
+	return const_iterator{lower_node(key)};
+}
+
+/*
+* @brief Returns %iterator to the first key greater than @key, or end().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::upper_bound(const key_type &key)
+{
+	return iterator{upper_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::upper_bound(const key_type &key) const
+{
+	return const_iterator{upper_node(key)};
+}
+
+/*
+* @brief Heterogeneous lookup, @key is compared as it is, without building a Key.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::size_type
+multiset<Key, Compare, Allocator>::count(const K &key) const
+{
+	const node_type *node{root};
+	return avl::detail::upper_rank(node, key, compare()) - avl::detail::rank(node, key, compare());
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+bool multiset<Key, Compare, Allocator>::contains(const K &key) const
+{
+	return END != find_node(key);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::find(const K &key)
+{
+	return iterator{find_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::find(const K &key) const
+{
+	return const_iterator{find_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+std::pair<typename multiset<Key, Compare, Allocator>::iterator,
+		typename multiset<Key, Compare, Allocator>::iterator>
+multiset<Key, Compare, Allocator>::equal_range(const K &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+std::pair<typename multiset<Key, Compare, Allocator>::const_iterator,
+		typename multiset<Key, Compare, Allocator>::const_iterator>
+multiset<Key, Compare, Allocator>::equal_range(const K &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::lower_bound(const K &key)
+{
+	return iterator{lower_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::lower_bound(const K &key) const
+{
+	return const_iterator{lower_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::upper_bound(const K &key)
+{
+	return iterator{upper_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::upper_bound(const K &key) const
+{
+	return const_iterator{upper_node(key)};
+}
+// @}
+
+// Order statistics:
+// @{
+/*
+* @brief Returns %iterator to the @k-th smallest key (counting from 0 and
+* counting equivalent keys each), or end() if @k >= size().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::iterator
+multiset<Key, Compare, Allocator>::nth(size_type k)
+{
+	return k < _size ? iterator{avl::detail::select(root, k)} : end();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::const_iterator
+multiset<Key, Compare, Allocator>::nth(size_type k) const
+{
+	return k < _size ? const_iterator{avl::detail::select(root, k)} : cend();
+}
+// @}
+
+// Observers:
+// @{
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::key_compare
+multiset<Key, Compare, Allocator>::key_comp(void) const
+{
+	return compare();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::value_compare
+multiset<Key, Compare, Allocator>::value_comp(void) const
+{
+	return compare();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+typename multiset<Key, Compare, Allocator>::allocator_type
+multiset<Key, Compare, Allocator>::get_allocator(void) const
+{
+	return allocator_type{pool.get_allocator()};
+}
+// @}
+
+// Diagnostics:
+// @{
+/*
+* @brief Checks every invariant of %multiset, equivalent keys allowed,
+* see avl::detail::tree_base::check_tree().
+*/
+template<typename Key, typename Compare, typename Allocator>
+void multiset<Key, Compare, Allocator>::validate(void) const
+{
+	tree_type::check_tree("multiset");
+}
+// @}
+// @@}
+// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_MULTISET_HPP_
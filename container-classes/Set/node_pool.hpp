@@ -0,0 +1,717 @@
+#ifndef _CONTAINERS_NODE_POOL_HPP_
+#define _CONTAINERS_NODE_POOL_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace containers
+{
+
+	// Node Pool declaration:
+	// @@{
+	/*
+	* @brief Slab allocator for tree nodes.
+	*
+	* @param Node Type of nodes handed out.
+	* @param Allocator Allocator used for the slabs, rebound to %Node.
+	*
+	* Nodes are carved out of chunks that double in size (up to max_chunk
+	* nodes), so neighbouring keys inserted together end up next to each
+	* other in memory. Destroyed nodes go on an intrusive free list and are
+	* handed out again before the current chunk is touched.
+	* The first slot of every chunk stores the chunk list, so releasing the
+	* whole pool is O(chunks) and needs no memory of its own.
+	*
+	* Pools whose nodes move between each other (node handles, merge) put
+	* their slabs in a shared %slab_group with share() and join(). A grouped
+	* pool no longer owns its slabs, they go back to the allocator with the
+	* last pool of the group. Slots a grouped pool frees are handed back to
+	* the group on join(), release() and destruction, and a member takes
+	* them before cutting a new slab, so the group never holds more slabs
+	* than its members needed at once.
+	*/
+	template<typename Node, typename Allocator>
+	class node_pool
+	{
+		public:
+			// Typedefs:
+			// @{
+			typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> allocator_type;
+			typedef size_t size_type;
+			// @}
+
+			// Constants:
+			// @{
+			static constexpr size_type first_chunk = 32;
+			static constexpr size_type max_chunk = 4096;
+			// @}
+
+			// Shared slabs
+			struct slab_group;
+			typedef std::shared_ptr<slab_group> group_ptr;
+
+			// Constructor
+			explicit node_pool(const Allocator &alloc = Allocator{});
+			node_pool(const node_pool &other) = delete;
+			node_pool(node_pool &&other) noexcept;
+
+			// Destructor
+			~node_pool(void);
+
+			// Assignment
+			node_pool& operator=(const node_pool &other) = delete;
+			node_pool& operator=(node_pool &&other) noexcept;
+
+			// Nodes
+			template<class ...Args>
+			Node* create(Args &&...args);
+			void destroy(Node *node);
+
+			// Nodes outside of the slabs (sentinels)
+			template<class ...Args>
+			Node* create_detached(Args &&...args);
+			void destroy_detached(Node *node);
+
+			// Modifiers
+			void release(void) noexcept;
+			void splice(node_pool &other);
+			void swap(node_pool &other) noexcept;
+
+			// Sharing
+			group_ptr share(void);
+			void join(const group_ptr &group);
+			static void recycle(const group_ptr &group, Node *slot);
+
+			// Observers
+			allocator_type get_allocator(void) const;
+			size_type chunks(void) const noexcept;
+			size_type capacity(void) const noexcept;
+		private:
+			// Convenience
+			using traits = std::allocator_traits<allocator_type>;
+
+			// Slot headers, constructed inside unused node storage
+			struct chunk_header
+			{
+				Node *next;
+				size_type count;
+			};
+
+			struct free_slot
+			{
+				free_slot *next;
+			};
+
+			static_assert(sizeof(chunk_header) <= sizeof(Node) && sizeof(free_slot) <= sizeof(Node),
+					"node_pool: node too small to hold the bookkeeping");
+
+			// Helpers
+			Node* take(void);
+			void grow(void);
+			bool adopt(void);
+			void give_back(bool tail) noexcept;
+			void push_free(Node *slot) noexcept;
+			void resolve(void) noexcept;
+			static void free_chunks(allocator_type &alloc, Node *chunk_list) noexcept;
+			static std::mutex& group_mutex(void);
+
+			// Data
+			allocator_type alloc;
+			Node *chunk_list, *bump, *bump_end;
+			free_slot *free_list, *free_tail;
+			size_type next_chunk, chunk_count;
+			group_ptr group;
+	};
+	// @@}
+
+	// Slab Group declaration:
+	// @@{
+	/*
+	* @brief Slabs owned jointly by pools that exchange nodes.
+	*
+	* Joining two groups moves the slabs of one into the other and leaves
+	* a @parent link behind, pools still pointing at the emptied group
+	* follow it on their next grow() or join(). Only a group without a
+	* parent holds slabs and free slots. Group links and the free list
+	* change under group_mutex().
+	*/
+	template<typename Node, typename Allocator>
+	struct node_pool<Node, Allocator>::slab_group
+	{
+		// Constructor
+		explicit slab_group(const allocator_type &alloc);
+
+		// Destructor
+		~slab_group(void);
+
+		// Data
+		allocator_type alloc;
+		Node *chunk_list;
+		free_slot *free_list, *free_tail;
+		size_type chunk_count;
+		group_ptr parent;
+	};
+	// @@}
+
+	// Node Pool implementation:
+	// @@{
+	// Construction/destruction:
+	// @{
+	/*
+	* @brief Builds empty %node_pool, no memory is allocated until the first node.
+	*
+	* @param alloc Allocator to rebind and use for the slabs.
+	*/
+	template<typename Node, typename Allocator>
+	node_pool<Node, Allocator>::node_pool(const Allocator &alloc)
+		:	alloc{alloc},
+			chunk_list{nullptr},
+			bump{nullptr},
+			bump_end{nullptr},
+			free_list{nullptr},
+			free_tail{nullptr},
+			next_chunk{first_chunk},
+			chunk_count{0},
+			group{}
+	{}
+
+	/*
+	* @brief %node_pool Move constructor, takes over all slabs of @other.
+	*/
+	template<typename Node, typename Allocator>
+	node_pool<Node, Allocator>::node_pool(node_pool &&other) noexcept
+		:	alloc{std::move(other.alloc)},
+			chunk_list{other.chunk_list},
+			bump{other.bump},
+			bump_end{other.bump_end},
+			free_list{other.free_list},
+			free_tail{other.free_tail},
+			next_chunk{other.next_chunk},
+			chunk_count{other.chunk_count},
+			group{std::move(other.group)}
+	{
+		other.chunk_list = other.bump = other.bump_end = nullptr;
+		other.free_list = other.free_tail = nullptr;
+		other.next_chunk = first_chunk;
+		other.chunk_count = 0;
+	}
+
+	/*
+	* Releases all slabs, a grouped pool hands its free slots to the group
+	* and leaves it. Nodes still alive are not destroyed.
+	*/
+	template<typename Node, typename Allocator>
+	node_pool<Node, Allocator>::~node_pool(void)
+	{
+		if(group)
+		{
+			std::lock_guard<std::mutex> lock{group_mutex()};
+			resolve();
+			give_back(true);
+			group.reset();
+		}
+		else
+			free_chunks(alloc, chunk_list);
+	}
+	// @}
+
+	// Assignment:
+	// @{
+	/*
+	* @brief %node_pool Move assignment, slabs held by *this are released.
+	*/
+	template<typename Node, typename Allocator>
+	node_pool<Node, Allocator>&
+	node_pool<Node, Allocator>::operator=(node_pool &&other) noexcept
+	{
+		node_pool tmp{std::move(other)};
+		swap(tmp);
+		return *this;
+	}
+	// @}
+
+	// Nodes:
+	// @{
+	/*
+	* @brief Builds a %Node from @args in a pooled slot.
+	*
+	* @param ...args Forwarded to constructor of %Node.
+	*
+	* If the constructor throws the slot goes back to the free list.
+	*/
+	template<typename Node, typename Allocator>
+	template<class ...Args>
+	Node* node_pool<Node, Allocator>::create(Args &&...args)
+	{
+		Node *slot{take()};
+		try
+		{
+			traits::construct(alloc, slot, std::forward<Args>(args)...);
+		}
+		catch(...)
+		{
+			push_free(slot);
+			throw;
+		}
+
+		return slot;
+	}
+
+	/*
+	* @brief Destroys @node and keeps its slot for the next create().
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::destroy(Node *node)
+	{
+		traits::destroy(alloc, node);
+		push_free(node);
+	}
+
+	/*
+	* @brief Builds a %Node from @args in its own allocation.
+	*
+	* Used for nodes that have to outlive release(), like the end sentinel.
+	*/
+	template<typename Node, typename Allocator>
+	template<class ...Args>
+	Node* node_pool<Node, Allocator>::create_detached(Args &&...args)
+	{
+		Node *node{traits::allocate(alloc, 1)};
+		try
+		{
+			traits::construct(alloc, node, std::forward<Args>(args)...);
+		}
+		catch(...)
+		{
+			traits::deallocate(alloc, node, 1);
+			throw;
+		}
+
+		return node;
+	}
+
+	/*
+	* @brief Destroys and deallocates a node made by create_detached().
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::destroy_detached(Node *node)
+	{
+		traits::destroy(alloc, node);
+		traits::deallocate(alloc, node, 1);
+	}
+	// @}
+
+	// Modifiers:
+	// @{
+	/*
+	* @brief Gives every slab back to the allocator in O(chunks).
+	*
+	* Nodes are not destroyed, the owner has to have destroyed any node
+	* whose destructor matters before calling this.
+	* The slabs of a group may still hold nodes of other pools, a grouped
+	* pool hands its free slots to the group and stays in it, so the nodes
+	* it makes next reuse them. The slabs are freed only if no other pool
+	* or node handle uses the group.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::release(void) noexcept
+	{
+		if(group)
+		{
+			std::lock_guard<std::mutex> lock{group_mutex()};
+			resolve();
+			give_back(true);
+			if(1 == group.use_count())
+				group.reset();
+		}
+		else
+			free_chunks(alloc, chunk_list);
+
+		chunk_list = bump = bump_end = nullptr;
+		free_list = free_tail = nullptr;
+		next_chunk = first_chunk;
+		chunk_count = 0;
+	}
+
+	/*
+	* @brief Takes over every slab of @other, which is left empty.
+	*
+	* Live nodes of @other become nodes of *this, so a tree can move between
+	* pools without touching its nodes. The allocators have to compare equal.
+	* Free slots of @other are handed out by *this, the unused end of its
+	* last slab is not. O(chunks of @other). If either pool is grouped the
+	* two are joined instead.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::splice(node_pool &other)
+	{
+		if(group || other.group)
+		{
+			join(other.share());
+			other.release();
+			return;
+		}
+
+		if(nullptr == other.chunk_list)
+			return;
+
+		Node *tail{other.chunk_list};
+		while(reinterpret_cast<chunk_header*>(tail)->next)
+			tail = reinterpret_cast<chunk_header*>(tail)->next;
+
+		reinterpret_cast<chunk_header*>(tail)->next = chunk_list;
+		chunk_list = other.chunk_list;
+		chunk_count += other.chunk_count;
+
+		if(other.free_list)
+		{
+			other.free_tail->next = free_list;
+			if(nullptr == free_list)
+				free_tail = other.free_tail;
+			free_list = other.free_list;
+		}
+
+		other.chunk_list = other.bump = other.bump_end = nullptr;
+		other.free_list = other.free_tail = nullptr;
+		other.next_chunk = first_chunk;
+		other.chunk_count = 0;
+	}
+
+	/*
+	* Swaps slabs (and allocators) of *this and @other.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::swap(node_pool &other) noexcept
+	{
+		using std::swap;
+		swap(alloc, other.alloc);
+		swap(chunk_list, other.chunk_list);
+		swap(bump, other.bump);
+		swap(bump_end, other.bump_end);
+		swap(free_list, other.free_list);
+		swap(free_tail, other.free_tail);
+		swap(next_chunk, other.next_chunk);
+		swap(chunk_count, other.chunk_count);
+		swap(group, other.group);
+	}
+	// @}
+
+	// Sharing:
+	// @{
+	/*
+	* @brief Moves the slabs of *this into a group, returns the group.
+	*
+	* The group is allocated the first time, afterwards this only follows
+	* parent links. A node handed out with the group stays valid as long
+	* as the group does.
+	*/
+	template<typename Node, typename Allocator>
+	typename node_pool<Node, Allocator>::group_ptr
+	node_pool<Node, Allocator>::share(void)
+	{
+		std::lock_guard<std::mutex> lock{group_mutex()};
+		if(nullptr == group)
+		{
+			group = std::make_shared<slab_group>(alloc);
+			group->chunk_list = chunk_list;
+			group->chunk_count = chunk_count;
+			chunk_list = nullptr;
+		}
+		resolve();
+
+		return group;
+	}
+
+	/*
+	* @brief Puts *this and @other_group in one group.
+	*
+	* Afterwards nodes of either can be owned by *this. The allocators have
+	* to compare equal. The free slots of *this go to the group, so they
+	* are not lost to the other members, which is all that happens when
+	* both are already joined.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::join(const group_ptr &other_group)
+	{
+		share();
+
+		std::lock_guard<std::mutex> lock{group_mutex()};
+		resolve();
+		give_back(false);
+		group_ptr other{other_group};
+		while(other->parent)
+			other = other->parent;
+		if(other == group)
+			return;
+
+		// Chunk lists are short (chunks grow to max_chunk nodes), append ours to theirs
+		if(other->chunk_list)
+		{
+			Node *tail{other->chunk_list};
+			while(reinterpret_cast<chunk_header*>(tail)->next)
+				tail = reinterpret_cast<chunk_header*>(tail)->next;
+			reinterpret_cast<chunk_header*>(tail)->next = group->chunk_list;
+			group->chunk_list = other->chunk_list;
+		}
+		group->chunk_count += other->chunk_count;
+		if(other->free_list)
+		{
+			other->free_tail->next = group->free_list;
+			if(nullptr == group->free_list)
+				group->free_tail = other->free_tail;
+			group->free_list = other->free_list;
+		}
+		other->chunk_list = nullptr;
+		other->free_list = other->free_tail = nullptr;
+		other->chunk_count = 0;
+		other->parent = group;
+	}
+
+	/*
+	* @brief Puts @slot, a destroyed node of @group, on the free list of the group.
+	*
+	* For nodes that die outside of any pool, like the node of a %node_handle.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::recycle(const group_ptr &group, Node *slot)
+	{
+		std::lock_guard<std::mutex> lock{group_mutex()};
+		slab_group *root{group.get()};
+		while(root->parent)
+			root = root->parent.get();
+
+		root->free_list = ::new(static_cast<void*>(slot)) free_slot{root->free_list};
+		if(nullptr == root->free_tail)
+			root->free_tail = root->free_list;
+	}
+	// @}
+
+	// Observers:
+	// @{
+	/*
+	* Returns copy of the allocator used for the slabs.
+	*/
+	template<typename Node, typename Allocator>
+	typename node_pool<Node, Allocator>::allocator_type
+	node_pool<Node, Allocator>::get_allocator(void) const
+	{
+		return alloc;
+	}
+
+	/*
+	* Returns number of slabs currently held, by the whole group if grouped.
+	*/
+	template<typename Node, typename Allocator>
+	typename node_pool<Node, Allocator>::size_type
+	node_pool<Node, Allocator>::chunks(void) const noexcept
+	{
+		if(nullptr == group)
+			return chunk_count;
+
+		std::lock_guard<std::mutex> lock{group_mutex()};
+		const slab_group *root{group.get()};
+		while(root->parent)
+			root = root->parent.get();
+
+		return root->chunk_count;
+	}
+
+	/*
+	* Returns number of node slots in the slabs, used, free and chunk headers
+	* alike, by the whole group if grouped. Walks the slab list, O(chunks).
+	*/
+	template<typename Node, typename Allocator>
+	typename node_pool<Node, Allocator>::size_type
+	node_pool<Node, Allocator>::capacity(void) const noexcept
+	{
+		auto count{[](const Node *chunk) {
+			size_type ret{0};
+			for(; chunk; chunk = reinterpret_cast<const chunk_header*>(chunk)->next)
+				ret += reinterpret_cast<const chunk_header*>(chunk)->count;
+			return ret;
+		}};
+
+		if(nullptr == group)
+			return count(chunk_list);
+
+		std::lock_guard<std::mutex> lock{group_mutex()};
+		const slab_group *root{group.get()};
+		while(root->parent)
+			root = root->parent.get();
+
+		return count(root->chunk_list);
+	}
+	// @}
+
+	// Helpers:
+	// @{
+	/*
+	* Returns an unconstructed slot, recycled ones first. A grouped pool
+	* takes the free slots of the group before it grows.
+	*/
+	template<typename Node, typename Allocator>
+	Node* node_pool<Node, Allocator>::take(void)
+	{
+		if(nullptr == free_list && bump == bump_end && !(group && adopt()))
+			grow();
+
+		if(free_list)
+		{
+			free_slot *slot{free_list};
+			free_list = slot->next;
+			if(nullptr == free_list)
+				free_tail = nullptr;
+			return reinterpret_cast<Node*>(slot);
+		}
+
+		return bump++;
+	}
+
+	/*
+	* Allocates the next slab, one slot bigger than its capacity for the header.
+	* A grouped pool adds it to its group.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::grow(void)
+	{
+		Node *chunk{traits::allocate(alloc, next_chunk + 1)};
+
+		if(group)
+		{
+			std::lock_guard<std::mutex> lock{group_mutex()};
+			resolve();
+			::new(static_cast<void*>(chunk)) chunk_header{group->chunk_list, next_chunk + 1};
+			group->chunk_list = chunk;
+			++group->chunk_count;
+		}
+		else
+		{
+			::new(static_cast<void*>(chunk)) chunk_header{chunk_list, next_chunk + 1};
+			chunk_list = chunk;
+			++chunk_count;
+		}
+
+		bump = chunk + 1;
+		bump_end = chunk + next_chunk + 1;
+		next_chunk = std::min(2 * next_chunk, max_chunk);
+	}
+
+	/*
+	* Moves the free list of the group to *this, false if it was empty.
+	*/
+	template<typename Node, typename Allocator>
+	bool node_pool<Node, Allocator>::adopt(void)
+	{
+		std::lock_guard<std::mutex> lock{group_mutex()};
+		resolve();
+		if(nullptr == group->free_list)
+			return false;
+
+		free_list = group->free_list;
+		free_tail = group->free_tail;
+		group->free_list = group->free_tail = nullptr;
+
+		return true;
+	}
+
+	/*
+	* Moves the free list of *this to the group, O(1). With @tail the
+	* unused end of the last slab goes too, slot by slot, for a pool that
+	* will not bump allocate from it again (release(), destruction).
+	* group_mutex() has to be held and @group resolved.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::give_back(bool tail) noexcept
+	{
+		for(; tail && bump != bump_end; ++bump)
+			push_free(bump);
+
+		if(nullptr == free_list)
+			return;
+
+		free_tail->next = group->free_list;
+		if(nullptr == group->free_list)
+			group->free_tail = free_tail;
+		group->free_list = free_list;
+		free_list = free_tail = nullptr;
+	}
+
+	/*
+	* Puts the unconstructed @slot on the free list.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::push_free(Node *slot) noexcept
+	{
+		free_list = ::new(static_cast<void*>(slot)) free_slot{free_list};
+		if(nullptr == free_tail)
+			free_tail = free_list;
+	}
+
+	/*
+	* Points @group at the group holding the slabs, group_mutex() has to be held.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::resolve(void) noexcept
+	{
+		while(group->parent)
+			group = group->parent;
+	}
+
+	/*
+	* Deallocates every slab on @chunk_list.
+	*/
+	template<typename Node, typename Allocator>
+	void node_pool<Node, Allocator>::free_chunks(allocator_type &alloc, Node *chunk_list) noexcept
+	{
+		while(chunk_list)
+		{
+			chunk_header *header{reinterpret_cast<chunk_header*>(chunk_list)};
+			Node *next{header->next};
+			size_type count{header->count};
+
+			traits::deallocate(alloc, chunk_list, count);
+			chunk_list = next;
+		}
+	}
+
+	/*
+	* One lock for the links between groups, taken when a grouped pool grows
+	* or joins, which is once per slab or per new pair of pools.
+	*/
+	template<typename Node, typename Allocator>
+	std::mutex& node_pool<Node, Allocator>::group_mutex(void)
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+	// @}
+	// @@}
+
+	// Slab Group implementation:
+	// @@{
+	template<typename Node, typename Allocator>
+	node_pool<Node, Allocator>::slab_group::slab_group(const allocator_type &alloc)
+		:	alloc{alloc},
+			chunk_list{nullptr},
+			free_list{nullptr},
+			free_tail{nullptr},
+			chunk_count{0},
+			parent{}
+	{}
+
+	/*
+	* Frees the slabs, runs when the last pool and the last node handle let go.
+	*/
+	template<typename Node, typename Allocator>
+	node_pool<Node, Allocator>::slab_group::~slab_group(void)
+	{
+		free_chunks(alloc, chunk_list);
+	}
+	// @@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_NODE_POOL_HPP_
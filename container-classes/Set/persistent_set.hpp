@@ -0,0 +1,1019 @@
+#ifndef _CONTAINERS_PERSISTENT_SET_HPP_
+#define _CONTAINERS_PERSISTENT_SET_HPP_
+
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "set.hpp"
+
+namespace containers::persistent::detail
+{
+
+	// Persistent Node declaration:
+	// @@{
+	/*
+	* @brief An immutable, reference counted node of %persistent_set.
+	*
+	* @param Key Type of key objects.
+	*
+	* Once built a node never changes, it is shared by every version of the
+	* set that reaches it. There is no parent pointer, a node can have
+	* many parents. @references counts the parents and the roots pointing
+	* to the node, the node and its reference to each child go away when
+	* it drops to 0.
+	*/
+	template<typename Key>
+	struct persistent_node
+	{
+		// Constructor
+		template<class ...Args>
+		persistent_node(const persistent_node *left, const persistent_node *right, Args &&...args);
+
+		// Data
+		Key key;
+		const persistent_node *left, *right;
+		int height;
+		size_t size;
+		mutable std::atomic<size_t> references;
+	};
+	// @@}
+
+	// Persistent Node implementation:
+	// @@{
+	/*
+	* @brief Builds node with given children, takes over one reference to each.
+	*/
+	template<typename Key>
+	template<class ...Args>
+	persistent_node<Key>::persistent_node(const persistent_node *left, const persistent_node *right, Args &&...args)
+		:	key(std::forward<Args>(args)...),
+			left{left},
+			right{right},
+			height{1 + std::max(avl::detail::node_height(left), avl::detail::node_height(right))},
+			size{1 + avl::detail::node_size(left) + avl::detail::node_size(right)},
+			references{1}
+	{}
+	// @@}
+
+	/*
+	* Adds a reference to @node, returns @node.
+	*/
+	template<typename Key>
+	const persistent_node<Key>* acquire(const persistent_node<Key> *node)
+	{
+		if(node)
+			node->references.fetch_add(1, std::memory_order_relaxed);
+
+		return node;
+	}
+
+	/*
+	* @brief Drops a reference to @node, frees it if it was the last one.
+	*
+	* Freeing a node drops its references to its children in turn. The
+	* left child recurses and the right one loops, so the stack stays
+	* within the height of the tree.
+	*/
+	template<typename Key>
+	void release(const persistent_node<Key> *node)
+	{
+		while(node && 1 == node->references.fetch_sub(1, std::memory_order_acq_rel))
+		{
+			release(node->left);
+			const persistent_node<Key> *right{node->right};
+			delete node;
+			node = right;
+		}
+	}
+
+	// Node Reference declaration:
+	// @@{
+	/*
+	* @brief Owns one reference to a %persistent_node, like an intrusive shared_ptr.
+	*
+	* Path copying builds nodes bottom up, a subtree that is not attached
+	* to a node yet is held in one of these, so an exception anywhere on
+	* the way frees exactly the nodes built so far.
+	*/
+	template<typename Key>
+	class node_ref
+	{
+		public:
+			// Convenience
+			using node_type = persistent_node<Key>;
+
+			// Constructor
+			node_ref(void) noexcept;
+			explicit node_ref(const node_type *node) noexcept;		// takes over a reference
+			node_ref(const node_ref &other) noexcept;
+			node_ref(node_ref &&other) noexcept;
+
+			// Destructor
+			~node_ref(void);
+
+			// Assignment
+			node_ref& operator=(node_ref other) noexcept;
+
+			// Access
+			const node_type* get(void) const noexcept;
+			const node_type* operator->() const noexcept;
+			const node_type* detach(void) noexcept;
+
+			// Sharing
+			static node_ref share(const node_type *node) noexcept;
+		private:
+			// Data
+			const node_type *node;
+	};
+	// @@}
+
+	// Node Reference implementation:
+	// @@{
+	template<typename Key>
+	node_ref<Key>::node_ref(void) noexcept
+		:	node{nullptr}
+	{}
+
+	template<typename Key>
+	node_ref<Key>::node_ref(const node_type *node) noexcept
+		:	node{node}
+	{}
+
+	template<typename Key>
+	node_ref<Key>::node_ref(const node_ref &other) noexcept
+		:	node{acquire(other.node)}
+	{}
+
+	template<typename Key>
+	node_ref<Key>::node_ref(node_ref &&other) noexcept
+		:	node{other.detach()}
+	{}
+
+	template<typename Key>
+	node_ref<Key>::~node_ref(void)
+	{
+		release(node);
+	}
+
+	template<typename Key>
+	node_ref<Key>& node_ref<Key>::operator=(node_ref other) noexcept
+	{
+		std::swap(node, other.node);
+		return *this;
+	}
+
+	template<typename Key>
+	const persistent_node<Key>* node_ref<Key>::get(void) const noexcept
+	{
+		return node;
+	}
+
+	template<typename Key>
+	const persistent_node<Key>* node_ref<Key>::operator->() const noexcept
+	{
+		return node;
+	}
+
+	/*
+	* Gives up the reference without dropping it, the caller owns it now.
+	*/
+	template<typename Key>
+	const persistent_node<Key>* node_ref<Key>::detach(void) noexcept
+	{
+		const node_type *ret{node};
+		node = nullptr;
+		return ret;
+	}
+
+	/*
+	* Returns a new reference to @node, which stays referenced by its owners.
+	*/
+	template<typename Key>
+	node_ref<Key> node_ref<Key>::share(const node_type *node) noexcept
+	{
+		return node_ref{acquire(node)};
+	}
+	// @@}
+
+	/*
+	* @brief Builds a node from @args with subtrees @left and @right.
+	*
+	* The subtrees are only attached once the node exists, if building it
+	* throws they are dropped with @left and @right.
+	*/
+	template<typename Key, class ...Args>
+	node_ref<Key> make_node(node_ref<Key> left, node_ref<Key> right, Args &&...args)
+	{
+		auto node{new persistent_node<Key>(left.get(), right.get(), std::forward<Args>(args)...)};
+		left.detach();
+		right.detach();
+
+		return node_ref<Key>{node};
+	}
+
+	/*
+	* @brief Builds a node with @key over @left and @right, rotating if needed.
+	*
+	* @param key Key of the new node.
+	* @param left Left subtree.
+	* @param right Right subtree, heights of the two differ by at most 2.
+	*
+	* The same single and double rotations as avl::detail::balance_tree(),
+	* but nodes are never modified, the rotated ones are copies. The
+	* children they keep are shared with the old version.
+	*/
+	template<typename Key>
+	node_ref<Key> balance(const Key &key, node_ref<Key> left, node_ref<Key> right)
+	{
+		using avl::detail::node_height;
+		using avl::detail::get_balance_factor;
+		using ref = node_ref<Key>;
+
+		int balance{node_height(left.get()) - node_height(right.get())};
+
+		if(balance > 1)										// left subtree unbalance
+		{
+			auto l{left.get()};
+			if(get_balance_factor(l) >= 0)					// single right rotation
+				return make_node(ref::share(l->left), make_node(ref::share(l->right), std::move(right), key), l->key);
+
+			auto lr{l->right};								// left-right rotation
+			return make_node(make_node(ref::share(l->left), ref::share(lr->left), l->key),
+					make_node(ref::share(lr->right), std::move(right), key), lr->key);
+		}
+		else if(balance < -1)								// right subtree unbalance
+		{
+			auto r{right.get()};
+			if(get_balance_factor(r) <= 0)					// single left rotation
+				return make_node(make_node(std::move(left), ref::share(r->left), key), ref::share(r->right), r->key);
+
+			auto rl{r->left};								// right-left rotation
+			return make_node(make_node(std::move(left), ref::share(rl->left), key),
+					make_node(ref::share(rl->right), ref::share(r->right), r->key), rl->key);
+		}
+
+		return make_node(std::move(left), std::move(right), key);
+	}
+
+	/*
+	* @brief Copies the path from @node to where @key belongs and adds it there.
+	*
+	* @param inserted Set to true if @key was not in the tree.
+	*
+	* @return node_ref New root of the subtree, empty if nothing changed.
+	* Only the height of the tree worth of nodes is built, everything off
+	* the path is shared.
+	*/
+	template<typename Key, typename K, typename Compare>
+	node_ref<Key> insert_path(const persistent_node<Key> *node, K &&key, Compare comp, bool &inserted)
+	{
+		using ref = node_ref<Key>;
+
+		if(nullptr == node)
+		{
+			inserted = true;
+			return make_node(ref{}, ref{}, std::forward<K>(key));
+		}
+
+		if(comp(key, node->key))
+		{
+			ref left{insert_path(node->left, std::forward<K>(key), comp, inserted)};
+			return inserted ? balance(node->key, std::move(left), ref::share(node->right)) : ref{};
+		}
+		if(comp(node->key, key))
+		{
+			ref right{insert_path(node->right, std::forward<K>(key), comp, inserted)};
+			return inserted ? balance(node->key, ref::share(node->left), std::move(right)) : ref{};
+		}
+
+		return ref{};
+	}
+
+	/*
+	* @brief Copies the path to the smallest key of @node without that key.
+	*
+	* @param min Set to the node with the smallest key, which stays owned by the old tree.
+	*/
+	template<typename Key>
+	node_ref<Key> remove_min(const persistent_node<Key> *node, const persistent_node<Key> *&min)
+	{
+		using ref = node_ref<Key>;
+
+		if(nullptr == node->left)
+		{
+			min = node;
+			return ref::share(node->right);
+		}
+
+		ref left{remove_min(node->left, min)};
+		return balance(node->key, std::move(left), ref::share(node->right));
+	}
+
+	/*
+	* @brief Copies the path from @node to @key without @key.
+	*
+	* @param erased Set to true if @key was in the tree.
+	*
+	* @return node_ref New root of the subtree, empty if nothing changed.
+	* A node with two children is replaced by a copy of its successor.
+	*/
+	template<typename Key, typename Compare>
+	node_ref<Key> erase_path(const persistent_node<Key> *node, const Key &key, Compare comp, bool &erased)
+	{
+		using ref = node_ref<Key>;
+
+		if(nullptr == node)
+			return ref{};
+
+		if(comp(key, node->key))
+		{
+			ref left{erase_path(node->left, key, comp, erased)};
+			return erased ? balance(node->key, std::move(left), ref::share(node->right)) : ref{};
+		}
+		if(comp(node->key, key))
+		{
+			ref right{erase_path(node->right, key, comp, erased)};
+			return erased ? balance(node->key, ref::share(node->left), std::move(right)) : ref{};
+		}
+
+		erased = true;
+		if(nullptr == node->left)
+			return ref::share(node->right);
+		if(nullptr == node->right)
+			return ref::share(node->left);
+
+		const persistent_node<Key> *min{nullptr};
+		ref right{remove_min(node->right, min)};
+		return balance(min->key, ref::share(node->left), std::move(right));
+	}
+
+	/*
+	* @brief Builds a perfectly balanced tree of the next @count keys at @first.
+	*
+	* Keys are taken in order, left subtree first, so @first only has to be
+	* a forward iterator and nothing is sorted or buffered.
+	*/
+	template<typename Key, typename ForwardIt>
+	node_ref<Key> build_balanced(ForwardIt &first, size_t count)
+	{
+		if(0 == count)
+			return node_ref<Key>{};
+
+		node_ref<Key> left{build_balanced<Key>(first, count / 2)};
+		ForwardIt middle{first};
+		++first;
+		node_ref<Key> right{build_balanced<Key>(first, count - count / 2 - 1)};
+
+		return make_node(std::move(left), std::move(right), *middle);
+	}
+
+} // nested namespace containers::persistent::detail
+
+namespace containers
+{
+
+	// Persistent Set declaration:
+	// @@@{
+	/*
+	*	@brief An immutable sorted set of unique keys, every change makes a new version.
+	*
+	*	@param Key Type of key objects.
+	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*
+	*	insert() and erase() leave *this alone and return the changed set.
+	*	The new version copies only the path from the root to the change
+	*	(O(logN) nodes), the rest of the AVL tree is shared between the
+	*	versions through reference counted nodes. Copying a version, i.e.
+	*	taking a snapshot, is O(1).
+	*	Nodes never change, so any number of threads can read versions that
+	*	share nodes, and drop them, without locking. A single %persistent_set
+	*	object is no more thread safe than a std::shared_ptr.
+	*/
+	template<
+			typename Key,
+			typename Compare = std::less<Key>
+			>
+	class persistent_set
+	{
+		private:
+			// Convenience
+			using node_type = persistent::detail::persistent_node<Key>;
+			using node_ref = persistent::detail::node_ref<Key>;
+		public:
+			// Typedefs:
+			// @{
+			typedef Key key_type;
+			typedef Key value_type;
+			typedef size_t size_type;
+			typedef ptrdiff_t difference_type;
+			typedef Compare key_compare;
+			typedef Compare value_compare;
+			typedef const Key& reference;
+			typedef const Key& const_reference;
+			typedef const Key* pointer;
+			typedef const Key* const_pointer;
+			// @}
+
+			// Const Iterator
+			// @@{
+			/*
+			* @brief Bidirectional iterator over one version.
+			*
+			* Nodes have no parent pointer, so a step searches from the root
+			* for the next key, O(logN). for_each() walks a version in linear time.
+			* An iterator stays valid as long as its version exists.
+			*/
+			class const_iterator
+			{
+				public:
+					// Typedefs
+					typedef std::bidirectional_iterator_tag iterator_category;
+					typedef Key value_type;
+					typedef ptrdiff_t difference_type;
+					typedef const Key* pointer;
+					typedef const Key& reference;
+
+					// Friend <3
+					friend class persistent_set;
+
+					// Constructor
+					const_iterator(const node_type *root = nullptr, const node_type *node = nullptr);
+
+					// Operators
+					const_iterator& operator++();
+					const_iterator operator++(int);
+					const_iterator& operator--();
+					const_iterator operator--(int);
+
+					// Relation
+					bool operator==(const const_iterator &other) const;
+					bool operator!=(const const_iterator &other) const;
+
+					// Access
+					reference operator*() const;
+					pointer operator->() const;
+				private:
+					// Data
+					const node_type *root, *node;
+			};
+			// @@}
+
+			// Iterator, keys are read-only anyway
+			typedef const_iterator iterator;
+
+			// Reverse Iterators
+			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+			typedef const_reverse_iterator reverse_iterator;
+
+			// Constructor
+			persistent_set(void) noexcept;									// Default
+			persistent_set(const persistent_set &other) noexcept;			// Copy, O(1)
+			persistent_set(persistent_set &&other) noexcept;				// Move
+			persistent_set(const std::initializer_list<Key> &ilist);		// Init list
+			template<typename Allocator>
+			explicit persistent_set(const set<Key, Compare, Allocator> &other);	// From %set
+
+			// Bulk build
+			template<typename ForwardIt>
+			static persistent_set from_sorted(ForwardIt first, ForwardIt last);
+
+			// Assignment
+			persistent_set& operator=(const persistent_set &other) noexcept;
+			persistent_set& operator=(persistent_set &&other) noexcept;
+
+			// Iterators
+			const_iterator begin(void) const noexcept;
+			const_iterator cbegin(void) const noexcept;
+			const_iterator end(void) const noexcept;
+			const_iterator cend(void) const noexcept;
+
+			// Reverse Iterators
+			const_reverse_iterator rbegin(void) const noexcept;
+			const_reverse_iterator crbegin(void) const noexcept;
+			const_reverse_iterator rend(void) const noexcept;
+			const_reverse_iterator crend(void) const noexcept;
+
+			// Capacity
+			bool empty(void) const noexcept;
+			size_type size(void) const noexcept;
+
+			// Versions
+			[[nodiscard]] persistent_set insert(const value_type &value) const;
+			[[nodiscard]] persistent_set insert(value_type &&value) const;
+			[[nodiscard]] persistent_set erase(const key_type &key) const;
+			[[nodiscard]] persistent_set clear(void) const noexcept;
+
+			// Swap
+			void swap(persistent_set &other) noexcept;
+
+			// Lookup
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
+			const_iterator find(const key_type &key) const;
+			std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const;
+			const_iterator lower_bound(const key_type &key) const;
+			const_iterator upper_bound(const key_type &key) const;
+
+			// Traversal
+			template<class Function>
+			void for_each(Function f) const;
+
+			// Observers
+			key_compare key_comp(void) const;
+			value_compare value_comp(void) const;
+		private:
+			// Constructor
+			explicit persistent_set(node_ref root) noexcept;
+
+			// Helpers
+			template<typename K>
+			persistent_set insert_unique(K &&value) const;
+			const node_type* find_node(const key_type &key) const;
+
+			// Data
+			node_ref root;
+	};
+	// @@@}
+
+	// Persistent Set implementation:
+	// @@@{
+	// Const Iterator
+	// @@{
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>::const_iterator::const_iterator(const node_type *root, const node_type *node)
+		:	root{root},
+			node{node}
+	{}
+
+	/*
+	* Moves to the smallest key greater than the current one, end() after the last.
+	*/
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator&
+	persistent_set<Key, Compare>::const_iterator::operator++()
+	{
+		Compare comp{};
+		const node_type *next{nullptr};
+
+		for(const node_type *it{root}; it; )
+		{
+			if(comp(node->key, it->key))
+			{
+				next = it;
+				it = it->left;
+			}
+			else
+				it = it->right;
+		}
+
+		node = next;
+		return *this;
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::const_iterator::operator++(int)
+	{
+		const_iterator ret{*this};
+		++*this;
+		return ret;
+	}
+
+	/*
+	* Moves to the largest key less than the current one, the last key from end().
+	*/
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator&
+	persistent_set<Key, Compare>::const_iterator::operator--()
+	{
+		Compare comp{};
+		const node_type *prev{nullptr};
+
+		for(const node_type *it{root}; it; )
+		{
+			if(nullptr == node || comp(it->key, node->key))
+			{
+				prev = it;
+				it = it->right;
+			}
+			else
+				it = it->left;
+		}
+
+		node = prev;
+		return *this;
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::const_iterator::operator--(int)
+	{
+		const_iterator ret{*this};
+		--*this;
+		return ret;
+	}
+
+	template<typename Key, typename Compare>
+	bool persistent_set<Key, Compare>::const_iterator::operator==(const const_iterator &other) const
+	{
+		return node == other.node;
+	}
+
+	template<typename Key, typename Compare>
+	bool persistent_set<Key, Compare>::const_iterator::operator!=(const const_iterator &other) const
+	{
+		return node != other.node;
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator::reference
+	persistent_set<Key, Compare>::const_iterator::operator*() const
+	{
+		return node->key;
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator::pointer
+	persistent_set<Key, Compare>::const_iterator::operator->() const
+	{
+		return &node->key;
+	}
+	// @@}
+
+	// Persistent Set
+	// @@{
+	// Construction:
+	// @{
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>::persistent_set(void) noexcept
+		:	root{}
+	{}
+
+	/*
+	* @brief Shares the tree of @other, O(1).
+	*/
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>::persistent_set(const persistent_set &other) noexcept
+		:	root{other.root}
+	{}
+
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>::persistent_set(persistent_set &&other) noexcept
+		:	root{std::move(other.root)}
+	{}
+
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>::persistent_set(const std::initializer_list<Key> &ilist)
+		:	root{}
+	{
+		for(const auto &key : ilist)
+			*this = insert(key);
+	}
+
+	/*
+	* @brief Builds a persistent copy of @other in linear time.
+	*
+	* Keys of a %set are already sorted and unique, so they go straight
+	* into a balanced tree. Snapshots of the result are then O(1).
+	*/
+	template<typename Key, typename Compare>
+	template<typename Allocator>
+	persistent_set<Key, Compare>::persistent_set(const set<Key, Compare, Allocator> &other)
+		:	persistent_set(from_sorted(other.begin(), other.end()))
+	{}
+
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>::persistent_set(node_ref root) noexcept
+		:	root{std::move(root)}
+	{}
+
+	/*
+	* @brief Builds %persistent_set from a range sorted by Compare without repeated keys.
+	*
+	* Takes linear time and builds a perfectly balanced tree.
+	*/
+	template<typename Key, typename Compare>
+	template<typename ForwardIt>
+	persistent_set<Key, Compare>
+	persistent_set<Key, Compare>::from_sorted(ForwardIt first, ForwardIt last)
+	{
+		size_t count{static_cast<size_t>(std::distance(first, last))};
+		return persistent_set{persistent::detail::build_balanced<Key>(first, count)};
+	}
+	// @}
+
+	// Assignment:
+	// @{
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>&
+	persistent_set<Key, Compare>::operator=(const persistent_set &other) noexcept
+	{
+		root = other.root;
+		return *this;
+	}
+
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>&
+	persistent_set<Key, Compare>::operator=(persistent_set &&other) noexcept
+	{
+		root = std::move(other.root);
+		return *this;
+	}
+	// @}
+
+	// Iterators:
+	// @{
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::begin(void) const noexcept
+	{
+		const node_type *node{root.get()};
+		while(node && node->left)
+			node = node->left;
+
+		return const_iterator{root.get(), node};
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::cbegin(void) const noexcept
+	{
+		return begin();
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::end(void) const noexcept
+	{
+		return const_iterator{root.get(), nullptr};
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::cend(void) const noexcept
+	{
+		return end();
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_reverse_iterator
+	persistent_set<Key, Compare>::rbegin(void) const noexcept
+	{
+		return const_reverse_iterator{end()};
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_reverse_iterator
+	persistent_set<Key, Compare>::crbegin(void) const noexcept
+	{
+		return rbegin();
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_reverse_iterator
+	persistent_set<Key, Compare>::rend(void) const noexcept
+	{
+		return const_reverse_iterator{begin()};
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_reverse_iterator
+	persistent_set<Key, Compare>::crend(void) const noexcept
+	{
+		return rend();
+	}
+	// @}
+
+	// Capacity:
+	// @{
+	template<typename Key, typename Compare>
+	bool persistent_set<Key, Compare>::empty(void) const noexcept
+	{
+		return nullptr == root.get();
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::size_type
+	persistent_set<Key, Compare>::size(void) const noexcept
+	{
+		return avl::detail::node_size(root.get());
+	}
+	// @}
+
+	// Versions:
+	// @{
+	/*
+	* @brief Returns this version with @value added.
+	*
+	* Builds O(logN) new nodes, the rest is shared with *this. If @value is
+	* already present the result shares the whole tree and nothing is built.
+	*/
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>
+	persistent_set<Key, Compare>::insert(const value_type &value) const
+	{
+		return insert_unique(value);
+	}
+
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>
+	persistent_set<Key, Compare>::insert(value_type &&value) const
+	{
+		return insert_unique(std::move(value));
+	}
+
+	/*
+	* @brief Returns this version without @key.
+	*
+	* Builds O(logN) new nodes, if @key is not present nothing is built.
+	*/
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>
+	persistent_set<Key, Compare>::erase(const key_type &key) const
+	{
+		bool erased{false};
+		node_ref changed{persistent::detail::erase_path(root.get(), key, Compare{}, erased)};
+
+		return erased ? persistent_set{std::move(changed)} : *this;
+	}
+
+	/*
+	* Returns an empty version. Nodes of *this are only freed with the last
+	* version using them.
+	*/
+	template<typename Key, typename Compare>
+	persistent_set<Key, Compare>
+	persistent_set<Key, Compare>::clear(void) const noexcept
+	{
+		return persistent_set{};
+	}
+
+	template<typename Key, typename Compare>
+	void persistent_set<Key, Compare>::swap(persistent_set &other) noexcept
+	{
+		std::swap(root, other.root);
+	}
+	// @}
+
+	// Lookup:
+	// @{
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::size_type
+	persistent_set<Key, Compare>::count(const key_type &key) const
+	{
+		return find_node(key) ? 1 : 0;
+	}
+
+	template<typename Key, typename Compare>
+	bool persistent_set<Key, Compare>::contains(const key_type &key) const
+	{
+		return nullptr != find_node(key);
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::find(const key_type &key) const
+	{
+		return const_iterator{root.get(), find_node(key)};
+	}
+
+	template<typename Key, typename Compare>
+	std::pair<typename persistent_set<Key, Compare>::const_iterator,
+			typename persistent_set<Key, Compare>::const_iterator>
+	persistent_set<Key, Compare>::equal_range(const key_type &key) const
+	{
+		return std::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	/*
+	* Returns %const_iterator to the first key not less than @key, or end().
+	*/
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::lower_bound(const key_type &key) const
+	{
+		Compare comp{};
+		const node_type *ret{nullptr};
+
+		for(const node_type *node{root.get()}; node; )
+		{
+			if(comp(node->key, key))
+				node = node->right;
+			else
+			{
+				ret = node;
+				node = node->left;
+			}
+		}
+
+		return const_iterator{root.get(), ret};
+	}
+
+	/*
+	* Returns %const_iterator to the first key greater than @key, or end().
+	*/
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::const_iterator
+	persistent_set<Key, Compare>::upper_bound(const key_type &key) const
+	{
+		Compare comp{};
+		const node_type *ret{nullptr};
+
+		for(const node_type *node{root.get()}; node; )
+		{
+			if(comp(key, node->key))
+			{
+				ret = node;
+				node = node->left;
+			}
+			else
+				node = node->right;
+		}
+
+		return const_iterator{root.get(), ret};
+	}
+	// @}
+
+	/*
+	* @brief Calls @f with every key in ascending order.
+	*
+	* Walks the tree with an explicit stack in linear time, unlike the
+	* iterators which search from the root on every step.
+	*/
+	template<typename Key, typename Compare>
+	template<class Function>
+	void persistent_set<Key, Compare>::for_each(Function f) const
+	{
+		const node_type *stack[2 * sizeof(size_type) * 8];			// AVL height < 1.45 * log2(N + 2)
+		int top{0};
+
+		for(const node_type *node{root.get()}; node || top; )
+		{
+			for(; node; node = node->left)
+				stack[top++] = node;
+
+			node = stack[--top];
+			f(node->key);
+			node = node->right;
+		}
+	}
+
+	// Observers:
+	// @{
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::key_compare
+	persistent_set<Key, Compare>::key_comp(void) const
+	{
+		return Compare{};
+	}
+
+	template<typename Key, typename Compare>
+	typename persistent_set<Key, Compare>::value_compare
+	persistent_set<Key, Compare>::value_comp(void) const
+	{
+		return Compare{};
+	}
+	// @}
+
+	// Helpers:
+	// @{
+	template<typename Key, typename Compare>
+	template<typename K>
+	persistent_set<Key, Compare>
+	persistent_set<Key, Compare>::insert_unique(K &&value) const
+	{
+		bool inserted{false};
+		node_ref changed{persistent::detail::insert_path(root.get(), std::forward<K>(value), Compare{}, inserted)};
+
+		return inserted ? persistent_set{std::move(changed)} : *this;
+	}
+
+	template<typename Key, typename Compare>
+	const typename persistent_set<Key, Compare>::node_type*
+	persistent_set<Key, Compare>::find_node(const key_type &key) const
+	{
+		Compare comp{};
+		const node_type *node{root.get()};
+
+		while(node)
+		{
+			if(comp(key, node->key))
+				node = node->left;
+			else if(comp(node->key, key))
+				node = node->right;
+			else
+				break;
+		}
+
+		return node;
+	}
+	// @}
+	// @@}
+	// @@@}
+
+} // namespace containers
+
+#endif // _CONTAINERS_PERSISTENT_SET_HPP_
@@ -1,11 +1,21 @@
 #ifndef _CONTAINERS_SET_HPP_
 #define _CONTAINERS_SET_HPP_
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "set_node.hpp"
 #include "set_detail.hpp"
+#include "set_join.hpp"
+#include "set_stats.hpp"
+#include "node_pool.hpp"
 
 namespace containers
 {
@@ -20,17 +30,50 @@ namespace containers
 	*
 	*	@param Key Type of key objects.
 	*	@param Compare Comparison object function type, defaults to std::less<Key>.
+	*	@param Allocator Allocator type, defaults to std::allocator<Key>.
 	*
 	* 	The private tree data is stored as an AVL self balancing tree.
+	*	Nodes come from a %node_pool that allocates them in chunks through
+	*	Allocator (rebound to the node type) and recycles erased ones.
+	*	The comparator is stored and passed by reference to every search,
+	*	a stateless one takes no space (see avl::detail::compare_holder).
+	*	Pool, tree, sentinel and size are kept by avl::detail::tree_base,
+	*	shared with %map, %multiset and %interval_tree.
 	*/
 	template<
 			typename Key,
-			typename Compare = std::less<Key>
+			typename Compare = std::less<Key>,
+			typename Allocator = std::allocator<Key>
 			>
-	class set
+	class set : private avl::detail::tree_base<set_node<Key>, avl::detail::identity_key, Compare, Allocator>
 	{
 		// Convenience
-		using node_type = set_node<Key>;
+		using tree_type = avl::detail::tree_base<set_node<Key>, avl::detail::identity_key, Compare, Allocator>;
+		using typename tree_type::node_type;
+		using typename tree_type::pool_type;
+		using typename tree_type::position_type;
+		using tree_type::compare;
+
+		// Tree
+		using tree_type::pool;
+		using tree_type::root;
+		using tree_type::first;
+		using tree_type::last;
+		using tree_type::END;
+		using tree_type::_size;
+		using tree_type::find_node;
+		using tree_type::lower_node;
+		using tree_type::upper_node;
+		using tree_type::insert_position;
+		using tree_type::hint_position;
+		using tree_type::link_node;
+		using tree_type::unlink;
+		using tree_type::erase_nodes;
+		using tree_type::ensure_end;
+		using tree_type::detach_threads;
+		using tree_type::update_bounds;
+		template<typename K>
+		using transparent_key = std::enable_if_t<avl::detail::is_transparent<Compare>::value, K>;
 
 		public:
 			// Typedefs:
@@ -45,12 +88,16 @@ namespace containers
 			typedef Key* pointer;
 			typedef const Key& const_reference;
 			typedef const Key* const_pointer;
+			typedef Allocator allocator_type;
 			// @}
 
 			// Inner Classes:
 			// @{
 			class iterator;
 			class const_iterator;
+			class node_handle;
+			struct insert_return_type;
+			class range_view;
 			// @}
 
 			// Iterator:
@@ -66,7 +113,8 @@ namespace containers
 			* @param Key& Defines %reference.
 			* @param ptrdiff_t Defines %difference_type.
 			*
-			* Private data contains current node pointer and const pointer to containing %set.
+			* Private data is the current node pointer, nodes are threaded in
+			* order so stepping is one load and needs nothing from the %set.
 			*/
 			class iterator : public std::iterator<	std::bidirectional_iterator_tag,	// %iterator type
 													Key, ptrdiff_t, Key*, Key&>			// %iterator info
@@ -76,7 +124,7 @@ namespace containers
 					friend class set;
 
 					// Constructor
-					iterator(node_type *ptr = nullptr, const set *superset = nullptr);	// Default
+					iterator(node_type *ptr = nullptr);	// Default
 					iterator(const iterator &other);									// Copy
 					iterator(iterator &&other);											// Move
 
@@ -102,10 +150,18 @@ namespace containers
 					// Access
 					reference operator*() const;
 					pointer operator->() const;
+
+					// Distance in logN, found by ADL (using std::distance; distance(a, b);)
+					friend difference_type distance(const iterator &first, const iterator &last)
+					{
+						return last.index() - first.index();
+					}
 				private:
+					// Helpers
+					difference_type index(void) const { return set::index_of(ptr); }
+
 					// Data
 					node_type *ptr;
-					const set *superset;
 			};
 			// @@}
 
@@ -122,7 +178,8 @@ namespace containers
 			* @param const Key& Defines %const_reference.
 			* @param ptrdiff_t Defines %difference_type.
 			*
-			* Private data contains current node pointer and const pointer to containing %set.
+			* Private data is the current node pointer, nodes are threaded in
+			* order so stepping is one load and needs nothing from the %set.
 			*/
 			class const_iterator : public std::iterator<	std::bidirectional_iterator_tag,				// %iterator type
 															const Key, ptrdiff_t, const Key*, const Key&>	// %iterator info
@@ -132,7 +189,7 @@ namespace containers
 					friend class set;
 
 					// Constructor
-					const_iterator(node_type *ptr = nullptr, const set *superset = nullptr);	// Default
+					const_iterator(node_type *ptr = nullptr);	// Default
 					const_iterator(const const_iterator &other);								// Copy
 					const_iterator(const_iterator &&other);										// Move
 					const_iterator(const iterator &other);										// Convert
@@ -160,10 +217,104 @@ namespace containers
 					// Access
 					const_reference operator*() const;
 					const_pointer operator->() const;
+
+					// Distance in logN, found by ADL (using std::distance; distance(a, b);)
+					friend difference_type distance(const const_iterator &first, const const_iterator &last)
+					{
+						return last.index() - first.index();
+					}
 				private:
+					// Helpers
+					difference_type index(void) const { return set::index_of(ptr); }
+
 					// Data
 					node_type *ptr;
+			};
+			// @@}
+
+			// Node Handle:
+			// @@{
+			/*
+			* @brief Owns a node taken out of a %set by extract().
+			*
+			* Carries the key to insert() of any %set with an equal allocator
+			* without copying it or allocating. The node stays in the slabs it
+			* came from, which the handle keeps alive. An empty handle owns nothing.
+			*/
+			class node_handle
+			{
+				public:
+					// Friend
+					friend class set;
+
+					// Constructor
+					node_handle(void) noexcept;							// Default
+					node_handle(const node_handle &other) = delete;		// Copy
+					node_handle(node_handle &&other) noexcept;			// Move
+
+					// Destructor
+					~node_handle(void);
+
+					// Assignment
+					node_handle& operator=(const node_handle &other) = delete;	// Copy
+					node_handle& operator=(node_handle &&other) noexcept;		// Move
+
+					// Observers
+					bool empty(void) const noexcept;
+					explicit operator bool(void) const noexcept;
+					value_type& value(void) const;
+					allocator_type get_allocator(void) const;
+
+					// Swap
+					void swap(node_handle &other) noexcept;
+				private:
+					// Constructor
+					node_handle(node_type *node, typename pool_type::group_ptr slabs, const Allocator &alloc);
+
+					// Helpers
+					void reset(void) noexcept;
+
+					// Data
+					node_type *node;
+					typename pool_type::group_ptr slabs;
+					Allocator alloc;
+			};
+			// @@}
+
+			// Insert Return Type
+			struct insert_return_type
+			{
+				iterator position;
+				bool inserted;
+				node_handle node;
+			};
+
+			// Range View:
+			// @@{
+			/*
+			* @brief Keys of a %set in [lo, hi), returned by range().
+			*
+			* Holds the bounds only, begin() and end() look them up when called
+			* (logN each), so a view stays usable while the %set changes.
+			* An empty range is returned for hi <= lo.
+			*/
+			class range_view
+			{
+				public:
+					// Constructor
+					range_view(const set &superset, const key_type &lo, const key_type &hi);
+
+					// Iterators
+					const_iterator begin(void) const;
+					const_iterator end(void) const;
+
+					// Capacity
+					bool empty(void) const;
+					size_type size(void) const;
+				private:
+					// Data
 					const set *superset;
+					key_type lo, hi;
 			};
 			// @@}
 
@@ -174,13 +325,21 @@ namespace containers
 			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
 			// Constructor
-			set(void);										// Default
-			set(const set &other);							// Copy
-			set(set &&other) noexcept;						// Move
-			set(const std::initializer_list<Key> &ilist);	// Init list
-
-			// Destructor
-			~set(void);
+			set(void);																		// Default
+			explicit set(const Allocator &alloc);											// Allocator
+			explicit set(const Compare &comp, const Allocator &alloc = Allocator{});		// Comparator
+			set(const set &other);															// Copy
+			set(set &&other) noexcept;														// Move
+			set(const std::initializer_list<Key> &ilist);									// Init list
+			set(const std::initializer_list<Key> &ilist, const Compare &comp,
+					const Allocator &alloc = Allocator{});									// Init list, comparator
+
+			// Bulk build
+			template<typename ForwardIt>
+			static set from_sorted(ForwardIt first, ForwardIt last, const Allocator &alloc = Allocator{});
+			template<typename ForwardIt>
+			static set from_sorted(ForwardIt first, ForwardIt last, const Compare &comp,
+					const Allocator &alloc = Allocator{});
 
 			// Assignment
 			set& operator=(const set &other);							// Copy
@@ -216,20 +375,51 @@ namespace containers
 			void insert(const std::initializer_list<Key> &ilist);
 			template<typename BidirIt>
 			void insert(BidirIt begin, BidirIt end);
+			template<typename ForwardIt>
+			void insert_sorted(ForwardIt first, ForwardIt last);
+			template<typename InputIt>
+			void insert_batch(InputIt first, InputIt last);
+
+			// Hinted insert
+			iterator insert(const_iterator hint, const value_type &value);
+			iterator insert(const_iterator hint, value_type &&value);
+
+			// Node handles
+			node_handle extract(const_iterator position);
+			node_handle extract(const key_type &key);
+			insert_return_type insert(node_handle &&nh);
+			iterator insert(const_iterator hint, node_handle &&nh);
 
 			// Emplace
 			template<class... Args>
 			std::pair<iterator, bool> emplace(Args &&...args);
+			template<class... Args>
+			iterator emplace_hint(const_iterator hint, Args &&...args);
 
 			// Erase
 			const_iterator erase(const_iterator position);
 			const_iterator erase(const_iterator begin, const_iterator end);
 			size_type erase(const key_type &key);
+			size_type erase_range(const key_type &lo, const key_type &hi);
+
+			// Swap
+			void swap(set &other) noexcept;
+
+			// Merge
+			void merge(set &other);
+			void merge(set &&other);
 
-			// Swap void swap(set &other);
+			// Set algebra
+			template<typename K, typename C, typename A>
+			friend set<K, C, A> set_union(set<K, C, A> lhs, set<K, C, A> rhs);
+			template<typename K, typename C, typename A>
+			friend set<K, C, A> set_intersection(set<K, C, A> lhs, set<K, C, A> rhs);
+			template<typename K, typename C, typename A>
+			friend set<K, C, A> set_difference(set<K, C, A> lhs, set<K, C, A> rhs);
 
 			// Lookup
-			size_type count(const key_type &key);
+			size_type count(const key_type &key) const;
+			bool contains(const key_type &key) const;
 
 			// Find
 			iterator find(const key_type &key);
@@ -245,14 +435,56 @@ namespace containers
 			iterator upper_bound(const key_type &key);
 			const_iterator upper_bound(const key_type &key) const;
 
+			// Heterogeneous lookup, only with a transparent Compare (e.g. std::less<>)
+			template<typename K, typename = transparent_key<K>>
+			size_type count(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			bool contains(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator find(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator find(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			std::pair<iterator, iterator> equal_range(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator lower_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator lower_bound(const K &key) const;
+			template<typename K, typename = transparent_key<K>>
+			iterator upper_bound(const K &key);
+			template<typename K, typename = transparent_key<K>>
+			const_iterator upper_bound(const K &key) const;
+
+			// Order statistics
+			iterator nth(size_type k);
+			const_iterator nth(size_type k) const;
+			size_type rank(const key_type &key) const;
+
+			// Ranges
+			size_type count_range(const key_type &lo, const key_type &hi) const;
+			range_view range(const key_type &lo, const key_type &hi) const;
+
 			// Observers
 			key_compare key_comp(void) const;
 			value_compare value_comp(void) const;
+			allocator_type get_allocator(void) const;
+
+			// Diagnostics
+			using tree_type::stats;
+			void validate(void) const;
 		private:
-			// Data
-			node_type *root, *first, *last;
-			node_type *END;
-			size_type _size;
+			// Helpers
+			template<typename K>
+			std::pair<iterator, bool> insert_unique(K &&value);
+			template<typename K>
+			std::pair<iterator, bool> insert_at(position_type position, K &&value);
+			bool shares_allocator(const set &other) const;
+			template<typename Operation>
+			void combine(set &&other, Operation operation);
+			std::pair<node_type*, node_type*> adopt(set &&other);
+			static difference_type index_of(const node_type *node);
 	};
 	// @@@}
 
@@ -264,15 +496,13 @@ namespace containers
 // Construction/destruction:
 // @{
 /*
-* @brief Builds %iterator from node pointer and %set pointer.
+* @brief Builds %iterator from node pointer.
 *
 * @param ptr Pointer to %set node.
-* @param set Pointer to %set containing node.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::iterator::iterator(node_type *ptr, const set *superset)
-	:	ptr{ptr},
-		superset{superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::iterator::iterator(node_type *ptr)
+	:	ptr{ptr}
 {}
 
 /*
@@ -280,10 +510,9 @@ set<Key, Compare>::iterator::iterator(node_type *ptr, const set *superset)
 *
 * @param other %iterator reference.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::iterator::iterator(const iterator &other)
-	:	ptr{other.ptr},
-		superset{other.superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::iterator::iterator(const iterator &other)
+	:	ptr{other.ptr}
 {}
 
 /*
@@ -291,23 +520,20 @@ set<Key, Compare>::iterator::iterator(const iterator &other)
 *
 * @param other %iterator rvalue reference.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::iterator::iterator(iterator &&other)
-	:	ptr{other.ptr},
-		superset{other.superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::iterator::iterator(iterator &&other)
+	:	ptr{other.ptr}
 {
 	other.ptr = nullptr;
-	other.superset = nullptr;
 }
 
 /*
 * Destroys %iterator instance.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::iterator::~iterator(void)
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::iterator::~iterator(void)
 {
 	ptr = nullptr;
-	superset = nullptr;
 }
 // @}
 
@@ -318,12 +544,11 @@ set<Key, Compare>::iterator::~iterator(void)
 *
 * @param other %iterator reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator&
-set<Key, Compare>::iterator::operator=(const iterator &other)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator&
+set<Key, Compare, Allocator>::iterator::operator=(const iterator &other)
 {
 	ptr = other.ptr;
-	superset = other.superset;
 	return *this;
 }
 
@@ -332,12 +557,11 @@ set<Key, Compare>::iterator::operator=(const iterator &other)
 *
 * @param other %iterator rvalue reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator&
-set<Key, Compare>::iterator::operator=(iterator &&other)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator&
+set<Key, Compare, Allocator>::iterator::operator=(iterator &&other)
 {
 	ptr = other.ptr;
-	superset = other.superset;
 	other.ptr = nullptr;
 	return *this;
 }
@@ -348,31 +572,14 @@ set<Key, Compare>::iterator::operator=(iterator &&other)
 /*
 * @brief Preincrement operator overload for %iterator.
 *
-* Moves %iterator to first successor (ascending) of Key pointed to by %iterator.
+* Moves %iterator to first successor (ascending) of Key pointed to by %iterator,
+* one load through the threaded links.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator&
-set<Key, Compare>::iterator::operator++()
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator&
+set<Key, Compare, Allocator>::iterator::operator++()
 {
-	if(superset->last == ptr)
-		ptr = superset->END;
-	else if(ptr->right)
-	{
-		ptr = ptr->right;
-		while(ptr->left)
-			ptr = ptr->left;
-	}
-	else
-	{
-		node_type *parent_ptr{ptr->parent};
-		while(parent_ptr && ptr == parent_ptr->right)
-		{
-			ptr = parent_ptr;
-			parent_ptr = parent_ptr->parent;
-		}
-
-		ptr = parent_ptr;
-	}
+	ptr = ptr->next;
 
 	return *this;
 }
@@ -382,9 +589,9 @@ set<Key, Compare>::iterator::operator++()
 *
 * Returns current %iterator and moves to successor (ascending).
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::iterator::operator++(int)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::iterator::operator++(int)
 {
 	iterator ret{*this};
 	++(*this);
@@ -396,31 +603,11 @@ set<Key, Compare>::iterator::operator++(int)
 *
 * Moves %iterator to first precedessor (descending) of Key pointed to by %iterator.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator&
-set<Key, Compare>::iterator::operator--()
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator&
+set<Key, Compare, Allocator>::iterator::operator--()
 {
-	if(ptr == superset->END)
-	{
-		ptr = superset->last;
-	}
-	else if(ptr->left)
-	{
-		ptr = ptr->left;
-		while(ptr->right)
-			ptr = ptr->right;
-	}
-	else
-	{
-		node_type *parentptr{ptr->parent};
-		while(parentptr && ptr == parentptr->left)
-		{
-			ptr = parentptr;
-			parentptr = parentptr->parent;
-		}
-
-		ptr = parentptr;
-	}
+	ptr = ptr->prev;
 
 	return *this;
 }
@@ -430,9 +617,9 @@ set<Key, Compare>::iterator::operator--()
 *
 * Returns current %iterator and moves to predecessor (descending).
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::iterator::operator--(int)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::iterator::operator--(int)
 {
 	iterator ret{*this};
 	--(*this);
@@ -445,8 +632,8 @@ set<Key, Compare>::iterator::operator--(int)
 /*
 * Returns bool indicating if passed %iterator comares equal to *this.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::iterator::operator==(const iterator &other) const
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::iterator::operator==(const iterator &other) const
 {
 	return ptr == other.ptr;
 }
@@ -454,8 +641,8 @@ bool set<Key, Compare>::iterator::operator==(const iterator &other) const
 /*
 * Returns bool indicating if passed %const_iterator comares equal to *this.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::iterator::operator==(const const_iterator &other) const
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::iterator::operator==(const const_iterator &other) const
 {
 	return ptr == other.ptr;
 }
@@ -463,8 +650,8 @@ bool set<Key, Compare>::iterator::operator==(const const_iterator &other) const
 /*
 * Returns bool indicating if passed %iterator compares unequal to *this.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::iterator::operator!=(const iterator &other) const
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::iterator::operator!=(const iterator &other) const
 {
 	return !(*this == other);
 }
@@ -472,8 +659,8 @@ bool set<Key, Compare>::iterator::operator!=(const iterator &other) const
 /*
 * Returns bool indicating if passed %const_iterator compares unequal to *this.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::iterator::operator!=(const const_iterator &other) const
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::iterator::operator!=(const const_iterator &other) const
 {
 	return !(*this == other);
 }
@@ -484,9 +671,9 @@ bool set<Key, Compare>::iterator::operator!=(const const_iterator &other) const
 /*
 * Dereference operator for %iterator. Returns %reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::reference
-set<Key, Compare>::iterator::operator*() const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::reference
+set<Key, Compare, Allocator>::iterator::operator*() const
 {
 	return ptr->key;
 }
@@ -494,9 +681,9 @@ set<Key, Compare>::iterator::operator*() const
 /*
 * Pointer operator for iterator. Returns %pointer.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::pointer
-set<Key, Compare>::iterator::operator->() const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::pointer
+set<Key, Compare, Allocator>::iterator::operator->() const
 {
 	return &(ptr)->key;
 }
@@ -508,15 +695,13 @@ set<Key, Compare>::iterator::operator->() const
 // Constructor:
 // @{
 /*
-* @brief Builds %const_iterator from node pointer and %set pointer.
+* @brief Builds %const_iterator from node pointer.
 *
 * @param ptr Pointer to %set node.
-* @param set Const ointer to %set containing node.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::const_iterator::const_iterator(node_type *ptr, const set *superset)
-	:	ptr{ptr},
-		superset{superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::const_iterator::const_iterator(node_type *ptr)
+	:	ptr{ptr}
 {}
 
 /*
@@ -524,10 +709,9 @@ set<Key, Compare>::const_iterator::const_iterator(node_type *ptr, const set *sup
 *
 * @param other Const %const_iterator reference.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::const_iterator::const_iterator(const const_iterator &other)
-	:	ptr{other.ptr},
-		superset{other.superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::const_iterator::const_iterator(const const_iterator &other)
+	:	ptr{other.ptr}
 {}
 
 /*
@@ -535,13 +719,11 @@ set<Key, Compare>::const_iterator::const_iterator(const const_iterator &other)
 *
 * @param other %const_iterator rvalue reference.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::const_iterator::const_iterator(const_iterator &&other)
-	:	ptr{other.ptr},
-		superset{other.superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::const_iterator::const_iterator(const_iterator &&other)
+	:	ptr{other.ptr}
 {
 	other.ptr = nullptr;
-	other.superset = nullptr;
 }
 
 /*
@@ -549,10 +731,9 @@ set<Key, Compare>::const_iterator::const_iterator(const_iterator &&other)
 *
 * @param other Const %iterator reference.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::const_iterator::const_iterator(const iterator &other)
-	:	ptr{other.ptr},
-		superset{other.superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::const_iterator::const_iterator(const iterator &other)
+	:	ptr{other.ptr}
 {}
 
 /*
@@ -560,13 +741,11 @@ set<Key, Compare>::const_iterator::const_iterator(const iterator &other)
 *
 * @param other %iterator rvalue reference.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::const_iterator::const_iterator(iterator &&other)
-	:	ptr{other.ptr},
-		superset{other.superset}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::const_iterator::const_iterator(iterator &&other)
+	:	ptr{other.ptr}
 {
 	other.ptr = nullptr;
-	other.superset = nullptr;
 }
 // @}
 
@@ -575,11 +754,10 @@ set<Key, Compare>::const_iterator::const_iterator(iterator &&other)
 /*
 * Destroys %const_iterator.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::const_iterator::~const_iterator(void)
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::const_iterator::~const_iterator(void)
 {
 	ptr = nullptr;
-	superset = nullptr;
 }
 // @}
 
@@ -590,12 +768,11 @@ set<Key, Compare>::const_iterator::~const_iterator(void)
 *
 * @param other Const %const_iterator reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator&
-set<Key, Compare>::const_iterator::operator=(const const_iterator &other)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator&
+set<Key, Compare, Allocator>::const_iterator::operator=(const const_iterator &other)
 {
 	ptr = other.ptr;
-	superset = other.superset;
 	return *this;
 }
 
@@ -604,14 +781,12 @@ set<Key, Compare>::const_iterator::operator=(const const_iterator &other)
 *
 * @param other %const_iterator rvalue reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator&
-set<Key, Compare>::const_iterator::operator=(const_iterator &&other)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator&
+set<Key, Compare, Allocator>::const_iterator::operator=(const_iterator &&other)
 {
 	ptr = other.ptr;
-	superset = other.superset;
 	other.ptr = nullptr;
-	other.superset = nullptr;
 	return *this;
 }
 
@@ -620,12 +795,11 @@ set<Key, Compare>::const_iterator::operator=(const_iterator &&other)
 *
 * @param other Const %iterator reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator&
-set<Key, Compare>::const_iterator::operator=(const iterator &other)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator&
+set<Key, Compare, Allocator>::const_iterator::operator=(const iterator &other)
 {
 	ptr = other.ptr;
-	superset = other.superset;
 	return *this;
 }
 
@@ -634,14 +808,12 @@ set<Key, Compare>::const_iterator::operator=(const iterator &other)
 *
 * @param other %iterator rvalue reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator&
-set<Key, Compare>::const_iterator::operator=(iterator &&other)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator&
+set<Key, Compare, Allocator>::const_iterator::operator=(iterator &&other)
 {
 	ptr = other.ptr;
-	superset = other.superset;
 	other.ptr = nullptr;
-	other.superset = nullptr;
 	return *this;
 }
 // @}
@@ -651,33 +823,14 @@ set<Key, Compare>::const_iterator::operator=(iterator &&other)
 /*
 * @brief Preincrement operator overload for %const_iterator.
 *
-* Moves %const_iterator to first successor (ascending) of Key pointed to by %const_iterator.
+* Moves %const_iterator to first successor (ascending) of Key pointed to by %const_iterator,
+* one load through the threaded links.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator&
-set<Key, Compare>::const_iterator::operator++()
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator&
+set<Key, Compare, Allocator>::const_iterator::operator++()
 {
-	if(superset->last == ptr)
-	{
-		ptr = superset->END;
-	}
-	else if(ptr->right)
-	{
-		ptr = ptr->right;
-		while(ptr->left)
-			ptr = ptr->left;
-	}
-	else
-	{
-		node_type *parent_ptr{ptr->parent};
-		while(parent_ptr && ptr == parent_ptr->right)
-		{
-			ptr = parent_ptr;
-			parent_ptr = parent_ptr->parent;
-		}
-
-		ptr = parent_ptr;
-	}
+	ptr = ptr->next;
 
 	return *this;
 }
@@ -687,9 +840,9 @@ set<Key, Compare>::const_iterator::operator++()
 *
 * Returns current %const_iterator and moves to successor (ascending).
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::const_iterator::operator++(int)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::const_iterator::operator++(int)
 {
 	const_iterator ret{*this};
 	++(*this);
@@ -701,31 +854,11 @@ set<Key, Compare>::const_iterator::operator++(int)
 *
 * Moves %const_iterator to first precedessor (descending) of Key pointed to by %const_iterator.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator&
-set<Key, Compare>::const_iterator::operator--()
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator&
+set<Key, Compare, Allocator>::const_iterator::operator--()
 {
-	if(ptr == superset->END)
-	{
-		ptr = superset->last;
-	}
-	else if(ptr->left)
-	{
-		ptr = ptr->left;
-		while(ptr->right)
-			ptr = ptr->right;
-	}
-	else
-	{
-		node_type *parent_ptr{ptr->parent};
-		while(parent_ptr && ptr == parent_ptr->left)
-		{
-			ptr = parent_ptr;
-			parent_ptr = parent_ptr->parent;
-		}
-
-		ptr = parent_ptr;
-	}
+	ptr = ptr->prev;
 
 	return *this;
 }
@@ -735,9 +868,9 @@ set<Key, Compare>::const_iterator::operator--()
 *
 * Returns current %const_iterator and moves to predecessor (descending).
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::const_iterator::operator--(int)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::const_iterator::operator--(int)
 {
 	const_iterator ret{*this};
 	--(*this);
@@ -750,8 +883,8 @@ set<Key, Compare>::const_iterator::operator--(int)
 /*
 * Returns bool indicating if passed %const_iterator comares equal to *this.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::const_iterator::operator==(const const_iterator &other) const
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::const_iterator::operator==(const const_iterator &other) const
 {
 	return ptr == other.ptr;
 }
@@ -759,8 +892,8 @@ bool set<Key, Compare>::const_iterator::operator==(const const_iterator &other)
 /*
 * Returns bool indicating if passed %const_iterator comares unequal to *this.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::const_iterator::operator!=(const const_iterator &other) const
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::const_iterator::operator!=(const const_iterator &other) const
 {
 	return !(*this == other);
 }
@@ -771,9 +904,9 @@ bool set<Key, Compare>::const_iterator::operator!=(const const_iterator &other)
 /*
 * Dereference operator for %const_iterator. Returns %const_reference.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_reference
-set<Key, Compare>::const_iterator::operator*() const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_reference
+set<Key, Compare, Allocator>::const_iterator::operator*() const
 {
 	return ptr->key;
 }
@@ -781,15 +914,208 @@ set<Key, Compare>::const_iterator::operator*() const
 /*
 * Pointer operator for %const_iterator. Returns %const_pointer.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_pointer
-set<Key, Compare>::const_iterator::operator->() const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_pointer
+set<Key, Compare, Allocator>::const_iterator::operator->() const
 {
 	return &(ptr)->key;
 }
 // @}
 // @@}
 
+// Node Handle
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds an empty %node_handle.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::node_handle::node_handle(void) noexcept
+	:	node{nullptr},
+		slabs{},
+		alloc{}
+{}
+
+/*
+* @brief Takes over the node of @other, which is left empty.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::node_handle::node_handle(node_handle &&other) noexcept
+	:	node{other.node},
+		slabs{std::move(other.slabs)},
+		alloc{std::move(other.alloc)}
+{
+	other.node = nullptr;
+}
+
+/*
+* @brief Builds %node_handle owning @node, an unlinked node from @slabs.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::node_handle::node_handle(node_type *node, typename pool_type::group_ptr slabs,
+		const Allocator &alloc)
+	:	node{node},
+		slabs{std::move(slabs)},
+		alloc{alloc}
+{}
+
+/*
+* Destroys the key if the handle still owns one. The slot goes back to
+* the free list of the slabs, see node_pool::recycle().
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::node_handle::~node_handle(void)
+{
+	reset();
+}
+// @}
+
+// Assignment:
+// @{
+/*
+* @brief %node_handle Move assignment, a key owned by *this is destroyed.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::node_handle&
+set<Key, Compare, Allocator>::node_handle::operator=(node_handle &&other) noexcept
+{
+	node_handle tmp{std::move(other)};
+	swap(tmp);
+	return *this;
+}
+// @}
+
+// Observers:
+// @{
+/*
+* Returns true if the handle owns no node.
+*/
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::node_handle::empty(void) const noexcept
+{
+	return nullptr == node;
+}
+
+/*
+* Returns true if the handle owns a node.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::node_handle::operator bool(void) const noexcept
+{
+	return nullptr != node;
+}
+
+/*
+* @brief Returns the key of the owned node, the handle must not be empty.
+*
+* The key may be modified, e.g. to insert it under a new value.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::value_type&
+set<Key, Compare, Allocator>::node_handle::value(void) const
+{
+	return node->key;
+}
+
+/*
+* Returns copy of the allocator of the %set the node came from.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::allocator_type
+set<Key, Compare, Allocator>::node_handle::get_allocator(void) const
+{
+	return alloc;
+}
+// @}
+
+// Swap:
+// @{
+/*
+* @brief Swaps the nodes of *this and @other.
+*/
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::node_handle::swap(node_handle &other) noexcept
+{
+	using std::swap;
+	swap(node, other.node);
+	swap(slabs, other.slabs);
+	swap(alloc, other.alloc);
+}
+// @}
+
+// Helpers:
+// @{
+/*
+* Destroys the owned node, if any, and leaves the handle empty.
+*/
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::node_handle::reset(void) noexcept
+{
+	if(node)
+	{
+		typename pool_type::allocator_type node_alloc{alloc};
+		std::allocator_traits<typename pool_type::allocator_type>::destroy(node_alloc, node);
+		pool_type::recycle(slabs, node);
+		node = nullptr;
+	}
+	slabs.reset();
+}
+// @}
+// @@}
+
+// Range View
+// @@{
+/*
+* @brief Builds %range_view of the keys of @superset in [@lo, @hi).
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::range_view::range_view(const set &superset, const key_type &lo, const key_type &hi)
+	:	superset{&superset},
+		lo{lo},
+		hi{hi}
+{}
+
+/*
+* Returns %const_iterator to the first key not less than lo.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::range_view::begin(void) const
+{
+	return superset->lower_bound(lo);
+}
+
+/*
+* Returns %const_iterator to the first key not less than hi, begin() if hi <= lo.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::range_view::end(void) const
+{
+	return superset->compare()(lo, hi) ? superset->lower_bound(hi) : begin();
+}
+
+/*
+* Returns true if no key of the %set is in the range.
+*/
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::range_view::empty(void) const
+{
+	return begin() == end();
+}
+
+/*
+* Returns number of keys in the range in logN, see count_range().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::range_view::size(void) const
+{
+	return superset->count_range(lo, hi);
+}
+// @@}
+
 // Set:
 // @@{
 // Construction/destruction:
@@ -797,13 +1123,28 @@ set<Key, Compare>::const_iterator::operator->() const
 /*
 * @brief Builds empty %set.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::set(void)
-	:	root{nullptr},
-		first{nullptr},
-		last{nullptr},
-		END{new node_type},
-		_size{0}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(void)
+	:	set(Allocator{})
+{}
+
+/*
+* @brief Builds empty %set whose nodes are allocated through @alloc.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(const Allocator &alloc)
+	:	set(Compare{}, alloc)
+{}
+
+/*
+* @brief Builds empty %set ordered by @comp.
+*
+* @param comp Comparator, copied once and used by reference afterwards.
+* @param alloc Allocator for the nodes.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(const Compare &comp, const Allocator &alloc)
+	:	tree_type{comp, alloc}
 {}
 
 /*
@@ -811,19 +1152,15 @@ set<Key, Compare>::set(void)
 *
 * @param other %set object to copy.
 *
-* Creates a %set instance from elements in other. This is done in
-* linear O(N) time where N is other.size().
+* Creates a %set instance from elements in other. The tree is copied
+* node by node with its shape, without comparisons or rebalancing,
+* in linear O(N) time where N is other.size().
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::set(const set &other)
-	:	root{nullptr},
-		first{nullptr},
-		last{nullptr},
-		END{new node_type},
-		_size{0}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(const set &other)
+	:	set(other.compare(), std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
 {
-	for(const auto &e : other)
-		insert(e);
+	tree_type::copy_nodes(other);
 }
 
 /*
@@ -832,21 +1169,13 @@ set<Key, Compare>::set(const set &other)
 * @param other %set object to move.
 *
 * Creates an identical %set instance from elements in other. This is done in
-* linear O(N) time where N is other.size()
+* linear O(N) time where N is other.size(). The comparator is copied, so
+* @other stays usable.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::set(set &&other) noexcept
-	:	root{other.root},
-		first{other.first},
-		last{other.last},
-		END{other.END},
-		_size{std::move(other._size)}
-{
-	other.root = nullptr;
-	other.first = nullptr;
-	other.last = nullptr;
-	other.END = nullptr;
-}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(set &&other) noexcept
+	:	tree_type{std::move(other)}
+{}
 
 /*
 * @brief Builds %set from and std::initializer_list.
@@ -856,29 +1185,54 @@ set<Key, Compare>::set(set &&other) noexcept
 * Creates %set from elements in ilist. This is O(N) if list is sorted,
 * otherwise NlogN where N equals ilist.size().
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::set(const std::initializer_list<Key> &ilist)
-	:	root{nullptr},
-		first{nullptr},
-		last{nullptr},
-		END{new node_type},
-		_size{0}
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(const std::initializer_list<Key> &ilist)
+	:	set()
+{
+	insert(ilist);
+}
+
+/*
+* @brief Builds %set ordered by @comp from an std::initializer_list.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>::set(const std::initializer_list<Key> &ilist, const Compare &comp, const Allocator &alloc)
+	:	set(comp, alloc)
 {
-	for(const auto &e : ilist)
-		insert(e);
+	insert(ilist);
 }
 
 /*
-* @brief Destructor for %set.
+* @brief Builds %set from a range sorted by Compare.
+*
+* @param first Start of the range.
+* @param last One past the last element of the range.
+* @param alloc Allocator to use.
 *
-* Releases all resources held by %set.
+* Equivalent keys in the range are stored once. The tree is built perfectly
+* balanced in linear time, the range is not checked for sortedness.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>::~set(void)
+template<typename Key, typename Compare, typename Allocator>
+template<typename ForwardIt>
+set<Key, Compare, Allocator>
+set<Key, Compare, Allocator>::from_sorted(ForwardIt first, ForwardIt last, const Allocator &alloc)
 {
-	clear();
-	if(nullptr != END)
-		delete END;
+	set ret{alloc};
+	ret.insert_sorted(first, last);
+	return ret;
+}
+
+/*
+* @brief Builds %set from a range sorted by @comp, see from_sorted(ForwardIt, ForwardIt, const Allocator&).
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename ForwardIt>
+set<Key, Compare, Allocator>
+set<Key, Compare, Allocator>::from_sorted(ForwardIt first, ForwardIt last, const Compare &comp, const Allocator &alloc)
+{
+	set ret{comp, alloc};
+	ret.insert_sorted(first, last);
+	return ret;
 }
 // @}
 
@@ -890,15 +1244,18 @@ set<Key, Compare>::~set(void)
 * @param other %set object to be copied
 *
 * All elements are copied and any existing are erased.
-* This is done in linear time.
+* This is done in linear time, if copying throws *this is unchanged.
 */
-template<typename Key, typename Compare>
-set<Key, Compare>&
-set<Key, Compare>::operator=(const set &other)
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>&
+set<Key, Compare, Allocator>::operator=(const set &other)
 {
-	clear();
-	for(const auto &e : other)
-		insert(e);
+	if(this != &other)
+	{
+		set tmp{other};
+		swap(tmp);
+	}
+
 	return *this;
 }
 
@@ -907,25 +1264,19 @@ set<Key, Compare>::operator=(const set &other)
 *
 * @param other %set object to be moved
 *
-* All elements are moves and any existing are erased.
-* This is done in linear time.
+* All elements are moved and any existing are erased.
+* This is done in linear time (constant for trivially destructible keys).
 */
-template<typename Key, typename Compare>
-set<Key, Compare>&
-set<Key, Compare>::operator=(set &&other)
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>&
+set<Key, Compare, Allocator>::operator=(set &&other)
 {
-	clear();
-
-	root = other.root;
-	first = other.first;
-	last = other.last;
-	END = other.END;
-	_size = std::move(other._size);
+	if(this == &other)
+		return *this;
 
-	other.root = nullptr;
-	other.first = nullptr;
-	other.last = nullptr;
-	other.END = nullptr;
+	// Swap everything, our old nodes go away with @other
+	swap(other);
+	other.clear();
 
 	return *this;
 }
@@ -938,14 +1289,13 @@ set<Key, Compare>::operator=(set &&other)
 * All elements from ilist are copied into %set. Old data is erased.
 * This is done in NlogN time (linear if ilist is sorted)
 */
-template<typename Key, typename Compare>
-set<Key, Compare>&
-set<Key, Compare>::operator=(const std::initializer_list<Key> &ilist)
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator>&
+set<Key, Compare, Allocator>::operator=(const std::initializer_list<Key> &ilist)
 {
 	clear();
-	for(const auto &e : ilist)
-		insert(e);
-	return this;
+	insert(ilist);
+	return *this;
 }
 // @}
 
@@ -955,66 +1305,66 @@ set<Key, Compare>::operator=(const std::initializer_list<Key> &ilist)
 * Returns %iterator that points to the first element in %set.
 * Iteration is done in ascending order set by Compare
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::begin(void) noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::begin(void) noexcept
 {
-	return (empty()) ? iterator{END, this} : iterator{first, this};
+	return (empty()) ? iterator{END} : iterator{first};
 }
 
 /*
 * Returns const (read-only) %iterator that points to the first element in %set.
 * Iteration is done in ascending order set by Compare
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::begin(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::begin(void) const noexcept
 {
-	return (empty()) ? const_iterator{END, this} : const_iterator{first, this};
+	return (empty()) ? const_iterator{END} : const_iterator{first};
 }
 
 /*
 * Returns const (read-only) %const_iterator that points to the first element in %set.
 * Iteration is done in ascending order set by Compare
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::cbegin(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::cbegin(void) const noexcept
 {
-	return (empty()) ? const_iterator{END, this} : const_iterator{first, this};
+	return (empty()) ? const_iterator{END} : const_iterator{first};
 }
 
 /*
 * Returns %iterator that points to one past the last element.
 * Iteration is done in ascending order set by Compare
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::end(void) noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::end(void) noexcept
 {
-	return iterator{END, this};
+	return iterator{END};
 }
 
 /*
 * Returns const (read-only) %iterator that points to one past the last element.
 * Iteration is done in ascending order set by Compare
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::end(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::end(void) const noexcept
 {
-	return const_iterator{END, this};
+	return const_iterator{END};
 }
 
 /*
 * Returns const (read-only) %const_iterator that points to one past the last element.
 * Iteration is done in ascending order set by Compare
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::cend(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::cend(void) const noexcept
 {
-	return const_iterator{END, this};
+	return const_iterator{END};
 }
 // @}
 
@@ -1024,9 +1374,9 @@ set<Key, Compare>::cend(void) const noexcept
 * Returns an %iterator that points to the last element in %set.
 * Iteration is done in descending order set by Compare.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::reverse_iterator
-set<Key, Compare>::rbegin(void) noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::reverse_iterator
+set<Key, Compare, Allocator>::rbegin(void) noexcept
 {
 	return reverse_iterator{end()};
 }
@@ -1035,9 +1385,9 @@ set<Key, Compare>::rbegin(void) noexcept
 * Returns a const (read-only) %iterator that points to the last element in %set.
 * Iteration is done in descending order set by Compare.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_reverse_iterator
-set<Key, Compare>::rbegin(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_reverse_iterator
+set<Key, Compare, Allocator>::rbegin(void) const noexcept
 {
 	return const_reverse_iterator{end()};
 }
@@ -1046,9 +1396,9 @@ set<Key, Compare>::rbegin(void) const noexcept
 * Returns a const (read-only) %const_iterator that points to the last element in %set.
 * Iteration is done in descending order set by Compare.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_reverse_iterator
-set<Key, Compare>::crbegin(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_reverse_iterator
+set<Key, Compare, Allocator>::crbegin(void) const noexcept
 {
 	return const_reverse_iterator{cend()};
 }
@@ -1057,9 +1407,9 @@ set<Key, Compare>::crbegin(void) const noexcept
 * Returns an %reverse_iterator that points to the first element in %set.
 * Iteration is done in descending order.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::reverse_iterator
-set<Key, Compare>::rend(void) noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::reverse_iterator
+set<Key, Compare, Allocator>::rend(void) noexcept
 {
 	return reverse_iterator{begin()};
 }
@@ -1068,9 +1418,9 @@ set<Key, Compare>::rend(void) noexcept
 * Returns a const (read-only) %reverse_iterator that points to the first element in %set.
 * Iteration is done in descending order.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_reverse_iterator
-set<Key, Compare>::rend(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_reverse_iterator
+set<Key, Compare, Allocator>::rend(void) const noexcept
 {
 	return const_reverse_iterator{begin()};
 }
@@ -1079,9 +1429,9 @@ set<Key, Compare>::rend(void) const noexcept
 * Returns a const (read-only) %const_reverse_iterator that points to the first element in %set.
 * Iteration is done in descending order.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_reverse_iterator
-set<Key, Compare>::crend(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_reverse_iterator
+set<Key, Compare, Allocator>::crend(void) const noexcept
 {
 	return const_reverse_iterator{cbegin()};
 }
@@ -1092,8 +1442,8 @@ set<Key, Compare>::crend(void) const noexcept
 /*
 * Returns indicator if %set is empty.
 */
-template<typename Key, typename Compare>
-bool set<Key, Compare>::empty(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::empty(void) const noexcept
 {
 	return (0 == size());
 }
@@ -1101,9 +1451,9 @@ bool set<Key, Compare>::empty(void) const noexcept
 /*
 * Returns number of unique keys in %set.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::size_type
-set<Key, Compare>::size(void) const noexcept
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::size(void) const noexcept
 {
 	return _size;
 }
@@ -1112,14 +1462,14 @@ set<Key, Compare>::size(void) const noexcept
 // Modifiers:
 // @{
 /*
-* Erase all keys in %set. This is done in linear time.
+* Erase all keys in %set. Keys are destroyed in linear time, node memory
+* is released one chunk at a time, so for trivially destructible keys
+* this is O(chunks).
 */
-template<typename Key, typename Compare>
-void set<Key, Compare>::clear(void)
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::clear(void)
 {
-	avl::detail::bst_delete(root);
-	_size = 0;
-	root = last = first = nullptr;
+	tree_type::clear_nodes();
 }
 
 /*
@@ -1132,38 +1482,11 @@ void set<Key, Compare>::clear(void)
 * Otherwise (end(), false) is returned.
 * Insertion is done in logN time where N is the number of elements in %set.
 */
-template<typename Key, typename Compare>
-std::pair<typename set<Key, Compare>::iterator, bool>
-set<Key, Compare>::insert(const value_type &value)
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename set<Key, Compare, Allocator>::iterator, bool>
+set<Key, Compare, Allocator>::insert(const value_type &value)
 {
-	if(empty())
-	{
-		root = new node_type{value};
-		first = last = root;
-		++_size;
-		return std::make_pair(iterator{root, this}, true);
-	}
-
-	auto istatus{avl::detail::bst_insert(root, value, Compare{})};
-
-	if(!istatus.first)
-		return std::make_pair(end(), false);
-	else if(!istatus.second)
-		return std::make_pair(iterator{istatus.first, this}, false);
-
-	++_size;
-	first = avl::detail::minimum(root);
-	last = avl::detail::maximum(root);
-
-	node_type *tmp{istatus.first};
-
-	while(tmp)
-	{
-		tmp = tmp->parent;
-		avl::detail::balance_tree(tmp, root);
-	}
-
-	return std::make_pair(iterator{istatus.first, this}, true);
+	return insert_unique(value);
 }
 
 /*
@@ -1176,38 +1499,11 @@ set<Key, Compare>::insert(const value_type &value)
 * Otherwise (end(), false) is returned.
 * Insertion is done in logN time where N is the number of elements in %set.
 */
-template<typename Key, typename Compare>
-std::pair<typename set<Key, Compare>::iterator, bool>
-set<Key, Compare>::insert(value_type &&value)
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename set<Key, Compare, Allocator>::iterator, bool>
+set<Key, Compare, Allocator>::insert(value_type &&value)
 {
-	if(empty())
-	{
-		root = new node_type{std::move(value)};
-		first = last = root;
-		++_size;
-		return std::make_pair(iterator{root, this}, true);
-	}
-
-	auto istatus{avl::detail::bst_insert(root, std::move(value), Compare{})};
-
-	if(!istatus.first)
-		return std::make_pair(end(), false);
-	else if(!istatus.second)
-		return std::make_pair(iterator{istatus.first, this}, false);
-
-	++_size;
-	first = avl::detail::minimum(root);
-	last = avl::detail::maximum(root);
-
-	node_type *tmp{istatus.first};
-
-	while(tmp)
-	{
-		tmp = tmp->parent;
-		avl::detail::balance_tree(tmp, root);
-	}
-
-	return std::make_pair(iterator{istatus.first, this}, true);
+	return insert_unique(std::move(value));
 }
 
 /*
@@ -1216,14 +1512,14 @@ set<Key, Compare>::insert(value_type &&value)
 * @param ililst An std::initializer_list.
 *
 * Inserts all elements from @ilist not already in %set. Insertion is done in
-* ilist.size() * logN time where N is the number of elements in %set.
+* ilist.size() * logN time where N is the number of elements in %set, or
+* linear time if @ilist is sorted.
 *
 */
-template<typename Key, typename Compare>
-void set<Key, Compare>::insert(const std::initializer_list<Key> &ilist)
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::insert(const std::initializer_list<Key> &ilist)
 {
-	for(auto &e : ilist)
-		insert(e);
+	insert(ilist.begin(), ilist.end());
 }
 
 /*
@@ -1234,60 +1530,396 @@ void set<Key, Compare>::insert(const std::initializer_list<Key> &ilist)
 *
 * Inserts all elements in range [begin, end) not already in %set.
 * Insertion is done in distance(first, last) * logN time where N is the number of elements in %set.
+* A range that is already sorted goes through insert_sorted().
 */
-template<typename Key, typename Compare>
+template<typename Key, typename Compare, typename Allocator>
 template<typename BidirIt>
-void set<Key, Compare>::insert(BidirIt begin, BidirIt end)
+void set<Key, Compare, Allocator>::insert(BidirIt begin, BidirIt end)
 {
+	if(std::is_sorted(begin, end, std::cref(compare())))
+	{
+		insert_sorted(begin, end);
+		return;
+	}
+
 	for(auto it = begin; it != end; ++it)
 		insert(*it);
 }
 
-// Emplace:
-// @{
 /*
-* @brief Inserts a new element constructed in-place with given @args.
+* @brief Inserts a range sorted by Compare.
 *
-* @param ...args Forwarded to costructor of %Key via std::forward<Args>(args)...
+* @param first Start of the range.
+* @param last One past the last element of the range.
+*
+* Keys already in %set and repeated keys in the range are skipped.
+* A short range, or one that starts past the largest key, is inserted key
+* by key, each search starting from the node inserted before it
+* (M * log(N/M) at worst, M for an append). Otherwise the range is merged
+* with the existing keys and all nodes are relinked into a perfectly
+* balanced tree in N + M time. Existing nodes are reused, so iterators
+* stay valid, and if building a new node throws *this is unchanged.
 */
-template<typename Key, typename Compare>
-template<class... Args>
-std::pair<typename set<Key, Compare>::iterator, bool>
-set<Key, Compare>::emplace(Args &&...args)
+template<typename Key, typename Compare, typename Allocator>
+template<typename ForwardIt>
+void set<Key, Compare, Allocator>::insert_sorted(ForwardIt first, ForwardIt last)
 {
-	return insert(Key{std::forward<Args>(args)...});
-}
-// @}
+	size_type count{static_cast<size_type>(std::distance(first, last))};
+	if(0 == count)
+		return;
+	ensure_end();
 
-/*
+	const Compare &comp{compare()};
+	if(root && (count * static_cast<size_type>(root->height) < _size || comp(this->last->key, *first)))
+	{
+		node_type *finger{nullptr};
+		for(; first != last; ++first)
+		{
+			const Key &key{*first};
+			std::pair<node_type*, int> position;
+			if(comp(this->last->key, key))
+				position = std::make_pair(this->last, 1);
+			else if(finger && comp(finger->key, key))
+				position = avl::detail::bst_finger_position(finger, key, comp);
+			else
+				position = avl::detail::bst_insert_position(root, key, comp);
+			finger = insert_at(position, *first).first.ptr;
+		}
+		return;
+	}
+
+	std::vector<node_type*> nodes, created;
+	nodes.reserve(_size + count);
+	created.reserve(count);
+
+	auto it{begin()};
+	try
+	{
+		for(; first != last; ++first)
+		{
+			while(END != it.ptr && comp(*it, *first))
+			{
+				nodes.push_back(it.ptr);
+				++it;
+			}
+
+			if(END != it.ptr && !comp(*first, *it))						// already in %set
+				continue;
+			if(!nodes.empty() && !comp(nodes.back()->key, *first))		// repeated in the range
+				continue;
+
+			created.push_back(pool.create(*first));
+			nodes.push_back(created.back());
+		}
+	}
+	catch(...)
+	{
+		for(auto node : created)
+			pool.destroy(node);
+		throw;
+	}
+
+	for(; END != it.ptr; ++it)
+		nodes.push_back(it.ptr);
+
+	root = avl::detail::link_balanced(nodes.data(), nodes.size(), static_cast<node_type*>(nullptr));
+	avl::detail::thread_sorted(nodes.data(), nodes.size(), END);
+	this->first = nodes.front();
+	this->last = nodes.back();
+	_size = nodes.size();
+}
+
+/*
+* @brief Inserts an unsorted range in one batch.
+*
+* @param first Start of the range.
+* @param last One past the last element of the range.
+*
+* The keys are copied out and sorted first, then go through insert_sorted(),
+* so consecutive keys are found from each other instead of from the root.
+* Pays off for nearly sorted streams and for batches that are large
+* compared to %set.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename InputIt>
+void set<Key, Compare, Allocator>::insert_batch(InputIt first, InputIt last)
+{
+	std::vector<Key> batch(first, last);
+	std::sort(batch.begin(), batch.end(), std::cref(compare()));
+
+	insert_sorted(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+}
+
+/*
+* @brief Hinted insertion function for %set.
+*
+* @param hint %const_iterator to the element @value should precede.
+* @param value Value to be inserted.
+*
+* Returns %iterator to the inserted element or to the equivalent one already in %set.
+* With a correct hint, e.g. end() for a key larger than all others, the position is
+* found in constant time. A hint before the right position is used as a finger
+* (log of the distance), any other hint costs the usual logN search.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::insert(const_iterator hint, const value_type &value)
+{
+	return insert_at(hint_position(hint.ptr, value), value).first;
+}
+
+/*
+* @brief Hinted move insertion function for %set, see insert(const_iterator, const value_type&).
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::insert(const_iterator hint, value_type &&value)
+{
+	return insert_at(hint_position(hint.ptr, static_cast<const Key&>(value)), std::move(value)).first;
+}
+
+/*
+* @brief Takes the node at @position out of %set.
+*
+* @param position %const_iterator to the element, must not be end().
+*
+* The node is unlinked in logN and handed over with its key untouched,
+* nothing is allocated or copied. Only iterators to it are invalidated.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::node_handle
+set<Key, Compare, Allocator>::extract(const_iterator position)
+{
+	node_type *node{position.ptr};
+	auto slabs{pool.share()};
+
+	unlink(node);
+
+	return node_handle{node, std::move(slabs), get_allocator()};
+}
+
+/*
+* @brief Takes the node with @key out of %set, returns an empty handle if there is none.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::node_handle
+set<Key, Compare, Allocator>::extract(const key_type &key)
+{
+	auto position{find(key)};
+	if(end() == position)
+		return node_handle{};
+
+	return extract(const_iterator{position});
+}
+
+/*
+* @brief Links the node owned by @nh into %set.
+*
+* @param nh Handle from extract() of a %set with an equal allocator.
+*
+* Returns where the key is and whether it was inserted. If an equivalent
+* key is already in %set, @nh is given back in the result unchanged.
+* No allocation or key copy is made, only the logN search and rebalancing.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::insert_return_type
+set<Key, Compare, Allocator>::insert(node_handle &&nh)
+{
+	if(nh.empty())
+		return insert_return_type{end(), false, node_handle{}};
+
+	auto position{insert_position(nh.node->key)};
+	if(position.first && 0 == position.second)
+		return insert_return_type{iterator{position.first}, false, std::move(nh)};
+
+	ensure_end();
+	pool.join(nh.slabs);
+	node_type *node{nh.node};
+	link_node(position, node);
+	nh.node = nullptr;
+	nh.slabs.reset();
+
+	return insert_return_type{iterator{node}, true, node_handle{}};
+}
+
+/*
+* @brief Hinted %node_handle insertion, see insert(const_iterator, const value_type&).
+*
+* Returns %iterator to the inserted key, or to the equivalent one in %set
+* in which case @nh keeps its node.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::insert(const_iterator hint, node_handle &&nh)
+{
+	if(nh.empty())
+		return end();
+
+	auto position{hint_position(hint.ptr, static_cast<const Key&>(nh.node->key))};
+	if(position.first && 0 == position.second)
+		return iterator{position.first};
+
+	ensure_end();
+	pool.join(nh.slabs);
+	node_type *node{nh.node};
+	link_node(position, node);
+	nh.node = nullptr;
+	nh.slabs.reset();
+
+	return iterator{node};
+}
+
+/*
+* @brief Swaps contents of *this and @other in constant time.
+*
+* Nodes do not move, the pools holding them are swapped as well.
+*/
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::swap(set &other) noexcept
+{
+	tree_type::swap_tree(other);
+}
+
+/*
+* @brief Moves every key of @other that is not in *this into *this.
+*
+* @param other %set to take keys from, keys already in *this stay there.
+*
+* Each key of @other is looked up here (M * logN), then the new keys are
+* linked as a balanced tree and joined in with the union of set_union().
+* @other is rebuilt from what is left in linear time. With equal allocators
+* the nodes themselves move and the two sets share their slabs from then
+* on, no node is allocated and no key is copied. Otherwise the keys are
+* moved into nodes of *this.
+*/
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::merge(set &other)
+{
+	if(this == &other || other.empty())
+		return;
+	ensure_end();
+
+	bool relink{shares_allocator(other)};
+
+	std::vector<node_type*> kept, moved, fresh;
+	for(auto it = other.begin(); it != other.end(); ++it)
+	{
+		if(avl::detail::bst_find(root, *it, compare()))
+			kept.push_back(it.ptr);
+		else
+			moved.push_back(it.ptr);
+	}
+
+	if(moved.empty())
+		return;
+
+	if(relink)
+	{
+		pool.join(other.pool.share());
+		fresh.swap(moved);
+	}
+	else
+	{
+		fresh.reserve(moved.size());
+		try
+		{
+			for(auto node : moved)
+				fresh.push_back(pool.create(std::move_if_noexcept(node->key)));
+		}
+		catch(...)
+		{
+			for(auto node : fresh)
+				pool.destroy(node);
+			throw;
+		}
+
+		for(auto node : moved)
+			other.pool.destroy(node);
+	}
+
+	other.root = avl::detail::link_balanced(kept.data(), kept.size(), static_cast<node_type*>(nullptr));
+	avl::detail::thread_sorted(kept.data(), kept.size(), other.END);
+	other._size = kept.size();
+	other.update_bounds();
+
+	std::vector<node_type*> garbage;
+	node_type *delta{avl::detail::link_balanced(fresh.data(), fresh.size(), static_cast<node_type*>(nullptr))};
+	avl::detail::thread_sorted(fresh.data(), fresh.size(), static_cast<node_type*>(nullptr));
+	node_type *head{detach_threads()};
+	root = avl::detail::union_trees(root, delta, compare(), garbage, avl::detail::fork_depth());
+	avl::detail::join_threads(root, head, fresh.front(), garbage, END, compare());
+
+	_size += fresh.size();
+	update_bounds();
+}
+
+/*
+* @brief Moves every key of @other into *this, @other is left empty.
+*
+* Equivalent keys of @other are dropped. Takes O(m log(n/m + 1)) work,
+* see set_union().
+*/
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::merge(set &&other)
+{
+	if(this != &other)
+		combine(std::move(other), [](auto a, auto b, const auto &comp, auto &garbage, int depth)
+				{ return avl::detail::union_trees(a, b, comp, garbage, depth); });
+}
+
+// Emplace:
+// @{
+/*
+* @brief Inserts a new element constructed in-place with given @args.
+*
+* @param ...args Forwarded to costructor of %Key via std::forward<Args>(args)...
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<class... Args>
+std::pair<typename set<Key, Compare, Allocator>::iterator, bool>
+set<Key, Compare, Allocator>::emplace(Args &&...args)
+{
+	return insert(Key{std::forward<Args>(args)...});
+}
+
+/*
+* @brief Inserts a new element constructed in-place, searching from @hint.
+*
+* @param hint %const_iterator to the element the new one should precede.
+* @param ...args Forwarded to costructor of %Key.
+*
+* See insert(const_iterator, const value_type&) for how @hint is used.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<class... Args>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::emplace_hint(const_iterator hint, Args &&...args)
+{
+	return insert(hint, Key{std::forward<Args>(args)...});
+}
+// @}
+
+/*
 * @brief Erase element at @position.
 *
 * @param position %const_iterator to element to be erased.
 *
 * Erasing is done in logN time where N is the number of elements in %set.
 * Returns %iterator to successor (ascending) of element in %set.
+* Only iterators to the erased element are invalidated.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::erase(const_iterator position)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::erase(const_iterator position)
 {
 	if(cend() == position)
 		return cend();
 
 	auto ret{position};
 	++ret;
-	auto par{avl::detail::bst_erase(position.ptr)};
-
-	while(par)
-	{
-		avl::detail::balance_tree(par, root);
-		par = par->parent;
-	}
-
-	first = avl::detail::minimum(root);
-	last = avl::detail::maximum(root);
+	unlink(position.ptr);
+	pool.destroy(position.ptr);
 
-	--_size;
 	return ret;
 }
 
@@ -1297,16 +1929,35 @@ set<Key, Compare>::erase(const_iterator position)
 * @param begin Start of range to be erased.
 * @param end One past the last element to be erased.
 *
-* Erasing is done in distance(first, last) * logN where N is the number of elements in %set.
+* The range is cut out of the tree with two splits and one join, so
+* erasing K keys takes logN + K (destroying them) instead of K * logN.
+* Only iterators to erased elements are invalidated.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::erase(const_iterator begin, const_iterator end)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::erase(const_iterator begin, const_iterator end)
 {
-	for(auto it = begin; it != end; ++it)
-		erase(const_iterator{it.ptr, this});
+	if(begin != end)
+		erase_nodes(begin.ptr, end.ptr);
 
-	return const_iterator{end};
+	return end;
+}
+
+/*
+* @brief Erases every key in [@lo, @hi), returns how many were erased.
+*
+* Nothing is erased if @hi compares less than or equal to @lo.
+* Takes logN + K for K erased keys, see erase(const_iterator, const_iterator).
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::erase_range(const key_type &lo, const key_type &hi)
+{
+	if(!compare()(lo, hi))
+		return 0;
+
+	node_type *from{lower_bound(lo).ptr}, *to{lower_bound(hi).ptr};
+	return from == to ? 0 : erase_nodes(from, to);
 }
 
 /*
@@ -1317,9 +1968,9 @@ set<Key, Compare>::erase(const_iterator begin, const_iterator end)
 * If key is in set it will be erased, otherwise nothing happens.
 * Complexity is logN where N is the number of elements in %set.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::size_type
-set<Key, Compare>::erase(const key_type &key)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::erase(const key_type &key)
 {
 	auto node{find(key)};
 	if(end() == node)
@@ -1336,14 +1987,20 @@ set<Key, Compare>::erase(const key_type &key)
 /*
 * Returns number of elements which compare equal to @key in %set (1 or 0 is returned).
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::size_type
-set<Key, Compare>::count(const key_type &key)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::count(const key_type &key) const
 {
-	if(end() == find(key))
-		return 0;
+	return contains(key) ? 1 : 0;
+}
 
-	return 1;
+/*
+* Returns true if a key equivalent to @key is in %set.
+*/
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::contains(const key_type &key) const
+{
+	return nullptr != avl::detail::bst_find(root, key, compare());
 }
 
 /*
@@ -1354,16 +2011,11 @@ set<Key, Compare>::count(const key_type &key)
 * Returns %iterator to key, or end() if no such key is found.
 * Complexity is logN where N is the number of elements in %set.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::find(const key_type &key)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::find(const key_type &key)
 {
-	node_type *tmp{avl::detail::bst_find(root, key, Compare{})};
-
-	if(tmp)
-		return iterator{tmp, this};
-	else
-		return end();
+	return iterator{find_node(key)};
 }
 
 /*
@@ -1374,31 +2026,26 @@ set<Key, Compare>::find(const key_type &key)
 * Returns %const_iterator (read-only) to key, or cend() if no such key is found.
 * Complexity is logN where N is the number of elements in %set.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::find(const key_type &key) const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::find(const key_type &key) const
 {
-	node_type *tmp{avl::detail::bst_find(root, key, Compare{})};
-
-	if(tmp)
-		return const_iterator{tmp, this};
-	else
-		return cend();
+	return const_iterator{find_node(key)};
 }
 //@}
 
 // Equal range:
 // @{
-template<typename Key, typename Compare>
-std::pair<typename set<Key, Compare>::iterator, typename set<Key, Compare>::iterator>
-set<Key, Compare>::equal_range(const key_type &key)
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename set<Key, Compare, Allocator>::iterator, typename set<Key, Compare, Allocator>::iterator>
+set<Key, Compare, Allocator>::equal_range(const key_type &key)
 {
 	return std::make_pair(lower_bound(key), upper_bound(key));
 }
 
-template<typename Key, typename Compare>
-std::pair<typename set<Key, Compare>::const_iterator, typename set<Key, Compare>::const_iterator>
-set<Key, Compare>::equal_range(const key_type &key) const
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename set<Key, Compare, Allocator>::const_iterator, typename set<Key, Compare, Allocator>::const_iterator>
+set<Key, Compare, Allocator>::equal_range(const key_type &key) const
 {
 	return std::make_pair(lower_bound(key), upper_bound(key));
 }
@@ -1415,15 +2062,11 @@ set<Key, Compare>::equal_range(const key_type &key) const
 *
 * A lower bound is the first element in %set not less than @key.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::lower_bound(const key_type &key)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::lower_bound(const key_type &key)
 {
-	node_type *bound{avl::detail::bst_lower_bound(root, key, Compare{})};
-	if(bound)
-		return iterator{bound, this};
-
-	return end();
+	return iterator{lower_node(key)};
 }
 
 /*
@@ -1435,15 +2078,11 @@ set<Key, Compare>::lower_bound(const key_type &key)
 *
 * A lower bound is the first element in %set not less than @key.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::lower_bound(const key_type &key) const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::lower_bound(const key_type &key) const
 {
-	node_type *bound{avl::detail::bst_lower_bound(root, key, Compare{})};
-	if(bound)
-		return const_iterator{bound, this};
-
-	return cend();
+	return const_iterator{lower_node(key)};
 }
 
 /*
@@ -1455,15 +2094,11 @@ set<Key, Compare>::lower_bound(const key_type &key) const
 *
 * An upper bound is the first element in %set greater than @key.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::iterator
-set<Key, Compare>::upper_bound(const key_type &key)
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::upper_bound(const key_type &key)
 {
-	node_type *bound{avl::detail::bst_upper_bound(root, key, Compare{})};
-	if(bound)
-		return iterator{bound, this};
-
-	return end();
+	return iterator{upper_node(key)};
 }
 
 /*
@@ -1475,15 +2110,179 @@ set<Key, Compare>::upper_bound(const key_type &key)
 *
 * An upper bound is the first element in %set greater than @key.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::const_iterator
-set<Key, Compare>::upper_bound(const key_type &key) const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::upper_bound(const key_type &key) const
+{
+	return const_iterator{upper_node(key)};
+}
+// @}
+
+// Heterogeneous lookup:
+// @{
+/*
+* The overloads below take anything Compare can compare with a key, so
+* a set<std::string, std::less<>> can be searched with a std::string_view
+* or a const char* without building a temporary std::string.
+* They only exist if Compare::is_transparent is declared.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::count(const K &key) const
+{
+	return contains(key) ? 1 : 0;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+bool set<Key, Compare, Allocator>::contains(const K &key) const
+{
+	return nullptr != avl::detail::bst_find(root, key, compare());
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::find(const K &key)
+{
+	return iterator{find_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::find(const K &key) const
+{
+	return const_iterator{find_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+std::pair<typename set<Key, Compare, Allocator>::iterator, typename set<Key, Compare, Allocator>::iterator>
+set<Key, Compare, Allocator>::equal_range(const K &key)
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+std::pair<typename set<Key, Compare, Allocator>::const_iterator, typename set<Key, Compare, Allocator>::const_iterator>
+set<Key, Compare, Allocator>::equal_range(const K &key) const
+{
+	return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::lower_bound(const K &key)
+{
+	return iterator{lower_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::lower_bound(const K &key) const
+{
+	return const_iterator{lower_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::upper_bound(const K &key)
+{
+	return iterator{upper_node(key)};
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K, typename>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::upper_bound(const K &key) const
+{
+	return const_iterator{upper_node(key)};
+}
+// @}
+
+// Order statistics:
+// @{
+/*
+* @brief Returns %iterator to the @k-th smallest key (counting from 0).
+*
+* @param k Index of the key.
+*
+* @return %iterator to the key, or end() if @k >= size().
+*
+* Every node stores the size of its subtree, so this is logN.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::iterator
+set<Key, Compare, Allocator>::nth(size_type k)
 {
-	node_type *bound{avl::detail::bst_upper_bound(root, key, Compare{})};
-	if(bound)
-		return const_iterator{bound, this};
+	if(k >= _size)
+		return end();
 
-	return cend();
+	return iterator{avl::detail::select(root, k)};
+}
+
+/*
+* @brief Returns %const_iterator (read-only) to the @k-th smallest key (counting from 0).
+*
+* @return %const_iterator to the key, or cend() if @k >= size().
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::const_iterator
+set<Key, Compare, Allocator>::nth(size_type k) const
+{
+	if(k >= _size)
+		return cend();
+
+	return const_iterator{avl::detail::select(root, k)};
+}
+
+/*
+* @brief Returns number of keys in %set that compare less than @key.
+*
+* Also the index lower_bound(@key) would have. Complexity is logN.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::rank(const key_type &key) const
+{
+	return avl::detail::rank(static_cast<const node_type*>(root), key, compare());
+}
+// @}
+
+// Ranges:
+// @{
+/*
+* @brief Returns number of keys in [@lo, @hi), 0 if @hi <= @lo.
+*
+* Difference of two ranks, logN whatever the size of the range.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::size_type
+set<Key, Compare, Allocator>::count_range(const key_type &lo, const key_type &hi) const
+{
+	if(!compare()(lo, hi))
+		return 0;
+
+	return rank(hi) - rank(lo);
+}
+
+/*
+* @brief Returns a %range_view of the keys in [@lo, @hi).
+*
+* Nothing is looked up until the view is iterated, e.g.
+* for(auto &key : set.range(lo, hi)) ...
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::range_view
+set<Key, Compare, Allocator>::range(const key_type &lo, const key_type &hi) const
+{
+	return range_view{*this, lo, hi};
 }
 // @}
 
@@ -1492,24 +2291,224 @@ set<Key, Compare>::upper_bound(const key_type &key) const
 /*
 * Returns instance of comparator used for comparing keys.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::key_compare
-set<Key, Compare>::key_comp(void) const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::key_compare
+set<Key, Compare, Allocator>::key_comp(void) const
 {
-	return Compare{};
+	return compare();
 }
 
 /*
 * Returns instance of comparator used for comparing values.
 */
-template<typename Key, typename Compare>
-typename set<Key, Compare>::value_compare
-set<Key, Compare>::value_comp(void) const
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::value_compare
+set<Key, Compare, Allocator>::value_comp(void) const
+{
+	return compare();
+}
+
+/*
+* Returns copy of the allocator the nodes are allocated with.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::allocator_type
+set<Key, Compare, Allocator>::get_allocator(void) const
+{
+	return allocator_type{pool.get_allocator()};
+}
+// @}
+
+// Diagnostics:
+// @{
+/*
+* @brief Checks every invariant of %set, throws std::logic_error naming
+* the first one that is broken, see avl::detail::tree_base::check_tree().
+*
+* Linear in the size of %set, meant for tests and debugging.
+*/
+template<typename Key, typename Compare, typename Allocator>
+void set<Key, Compare, Allocator>::validate(void) const
+{
+	tree_type::check_tree("set");
+}
+// @}
+
+// Helpers:
+// @{
+/*
+* @brief Shared body of both insert overloads.
+*
+* @param value Value to insert, copied or moved into the new node.
+*
+* The position is found first and a node is only taken from the pool
+* once the insertion is known to succeed.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename K>
+std::pair<typename set<Key, Compare, Allocator>::iterator, bool>
+set<Key, Compare, Allocator>::insert_unique(K &&value)
+{
+	return insert_at(insert_position(value), std::forward<K>(value));
+}
+
+/*
+* @brief Links a new node with @value at @position found by one of the
+* avl::detail::bst_*_position functions.
+*
+* Only takes a node from the pool if @position is not an equivalent key.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename K>
+std::pair<typename set<Key, Compare, Allocator>::iterator, bool>
+set<Key, Compare, Allocator>::insert_at(position_type position, K &&value)
+{
+	if(position.first && 0 == position.second)
+		return std::make_pair(iterator{position.first}, false);
+
+	ensure_end();
+	node_type *node{pool.create(std::forward<K>(value))};
+	link_node(position, node);
+
+	return std::make_pair(iterator{node}, true);
+}
+
+/*
+* Returns true if nodes of @other can be owned by *this.
+*/
+template<typename Key, typename Compare, typename Allocator>
+bool set<Key, Compare, Allocator>::shares_allocator(const set &other) const
+{
+	return std::allocator_traits<Allocator>::is_always_equal::value || get_allocator() == other.get_allocator();
+}
+
+/*
+* @brief Runs a join based tree operation on the trees of *this and @other.
+*
+* @param other %set whose nodes are taken over, left empty.
+* @param operation One of the avl::detail::*_trees functions.
+*
+* Nodes the operation drops are given back to the pool afterwards, on
+* this thread, so the pool is never touched from two threads at once.
+*/
+template<typename Key, typename Compare, typename Allocator>
+template<typename Operation>
+void set<Key, Compare, Allocator>::combine(set &&other, Operation operation)
+{
+	ensure_end();
+	size_type total{_size + other._size};
+	auto [other_root, other_head] = adopt(std::move(other));
+	node_type *head{detach_threads()};
+
+	std::vector<node_type*> garbage;
+	root = operation(root, other_root, compare(), garbage, avl::detail::fork_depth());
+	avl::detail::join_threads(root, head, other_head, garbage, END, compare());
+
+	for(auto node : garbage)
+		pool.destroy(node);
+
+	_size = total - garbage.size();
+	update_bounds();
+}
+
+/*
+* @brief Moves the nodes of @other into the pool of *this.
+*
+* @return Root of the tree of @other and first node of its list, which
+* ends in nullptr on both sides. @other is left empty.
+*
+* With equal allocators the slabs of @other are spliced in and no node
+* moves, otherwise the tree is rebuilt here with its keys moved.
+*/
+template<typename Key, typename Compare, typename Allocator>
+std::pair<typename set<Key, Compare, Allocator>::node_type*, typename set<Key, Compare, Allocator>::node_type*>
+set<Key, Compare, Allocator>::adopt(set &&other)
 {
-	return Compare{};
+	node_type *ret{nullptr}, *head{nullptr};
+
+	if(shares_allocator(other))
+	{
+		pool.splice(other.pool);
+		ret = other.root;
+		head = other.detach_threads();
+		other.root = nullptr;
+	}
+	else
+	{
+		avl::detail::clone_tree(other.root, ret, static_cast<node_type*>(nullptr),
+				[this](node_type *node) { return pool.create(std::move(node->key)); });
+		avl::detail::thread_tree(ret, static_cast<node_type*>(nullptr));
+		head = ret ? avl::detail::minimum(ret) : nullptr;
+	}
+
+	other.clear();
+
+	return std::make_pair(ret, head);
+}
+
+/*
+* Returns in-order index of @node, size() for the end sentinel, which is
+* the only node with height 0 and comes right after the largest node.
+*/
+template<typename Key, typename Compare, typename Allocator>
+typename set<Key, Compare, Allocator>::difference_type
+set<Key, Compare, Allocator>::index_of(const node_type *node)
+{
+	if(nullptr == node)									// end() of a moved-from %set
+		return 0;
+	if(0 == node->height)
+		return node->prev == node ? 0 : static_cast<difference_type>(avl::detail::node_index(node->prev)) + 1;
+
+	return static_cast<difference_type>(avl::detail::node_index(node));
 }
 // @}
 // @@}
+
+// Set algebra:
+// @@{
+/*
+* @brief Union of two sets.
+*
+* @param lhs, rhs Sets to unite, pass with std::move to avoid copying them.
+*
+* Built with AVL split/join in O(m log(n/m + 1)) work for sizes m <= n.
+* Big subtrees are handled in parallel. For equivalent keys the one
+* from @lhs is kept.
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator> set_union(set<Key, Compare, Allocator> lhs, set<Key, Compare, Allocator> rhs)
+{
+	lhs.combine(std::move(rhs), [](auto a, auto b, const auto &comp, auto &garbage, int depth)
+			{ return avl::detail::union_trees(a, b, comp, garbage, depth); });
+	return lhs;
+}
+
+/*
+* @brief Intersection of two sets, keys are taken from @lhs.
+*
+* Same complexity as set_union().
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator> set_intersection(set<Key, Compare, Allocator> lhs, set<Key, Compare, Allocator> rhs)
+{
+	lhs.combine(std::move(rhs), [](auto a, auto b, const auto &comp, auto &garbage, int depth)
+			{ return avl::detail::intersect_trees(a, b, comp, garbage, depth); });
+	return lhs;
+}
+
+/*
+* @brief Keys of @lhs that have no equivalent in @rhs.
+*
+* Same complexity as set_union().
+*/
+template<typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator> set_difference(set<Key, Compare, Allocator> lhs, set<Key, Compare, Allocator> rhs)
+{
+	lhs.combine(std::move(rhs), [](auto a, auto b, const auto &comp, auto &garbage, int depth)
+			{ return avl::detail::difference_trees(a, b, comp, garbage, depth); });
+	return lhs;
+}
+// @@}
 // @@@}
 
 } // namespace container
@@ -1,28 +1,127 @@
 #ifndef _CONTAINER_SET_DETAIL_HPP_
 #define _CONTAINER_SET_DETAIL_HPP_
 
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include "set_node.hpp"
-#include "color.hpp"
 
 namespace containers::avl::detail
 {
 
 	/*
-	* Function used for calculating height of %set_node
-	* relative to its children.
+	* True if @Compare declares is_transparent, which allows lookup with
+	* any type it can compare with a key.
+	*/
+	template<typename Compare, typename = void>
+	struct is_transparent : std::false_type {};
+
+	template<typename Compare>
+	struct is_transparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+	/*
+	* @brief Key extractors, return the part of a node value the tree is ordered by.
+	*
+	* Search functions take one as their last argument. A %set node holds
+	* just its key, so the default is the identity, a %map node holds a
+	* std::pair and is ordered by its first member.
+	*/
+	struct identity_key
+	{
+		template<typename T>
+		const T& operator()(const T &value) const noexcept { return value; }
+	};
+
+	struct first_key
+	{
+		template<typename T>
+		const typename T::first_type& operator()(const T &value) const noexcept { return value.first; }
+	};
+
+	/*
+	* @brief Stores the comparator of a tree.
+	*
+	* An empty, non final @Compare (std::less and other stateless function
+	* objects) is a private base, so it adds nothing to the size of the tree.
+	* Any other @Compare, e.g. one holding a collation table, is a member.
 	*/
+	template<typename Compare, bool = std::is_empty<Compare>::value && !std::is_final<Compare>::value>
+	class compare_holder : private Compare
+	{
+		public:
+			explicit compare_holder(const Compare &comp) : Compare(comp) {}
+
+			const Compare& compare(void) const noexcept { return *this; }
+			void swap_compare(compare_holder &other) { std::swap(static_cast<Compare&>(*this), static_cast<Compare&>(other)); }
+	};
+
+	template<typename Compare>
+	class compare_holder<Compare, false>
+	{
+		public:
+			explicit compare_holder(const Compare &comp) : comp(comp) {}
+
+			const Compare& compare(void) const noexcept { return comp; }
+			void swap_compare(compare_holder &other) { std::swap(comp, other.comp); }
+		private:
+			Compare comp;
+	};
+
+	/*
+	* Returns height of the subtree rooted at @node, 0 for an empty subtree.
+	* Heights are stored in the nodes, so this is O(1). Works on any node
+	* with height, size, left and right members, as do the two below.
+	*/
+	template<typename Node>
+	int node_height(const Node *node)
+	{
+		return node ? node->height : 0;
+	}
+
+	/*
+	* Returns number of nodes in the subtree rooted at @node in O(1).
+	*/
+	template<typename Node>
+	size_t node_size(const Node *node)
+	{
+		return node ? node->size : 0;
+	}
+
+	/*
+	* True if node values of type @Key keep a summary of their subtree
+	* (e.g. the largest end of an interval, see %interval_tree), through a
+	* member update(const Key *left, const Key *right) that recomputes it
+	* from the values of the children, nullptr for a missing child.
+	*/
+	template<typename Key, typename = void>
+	struct is_augmented : std::false_type {};
+
 	template<typename Key>
-	size_t node_height(set_node<Key> *&node)
+	struct is_augmented<Key, std::void_t<decltype(std::declval<Key&>().update(
+			std::declval<const Key*>(), std::declval<const Key*>()))>> : std::true_type {};
+
+	/*
+	* @brief Recalculates stored height and subtree size of @node from its children.
+	*
+	* @param node pointer to %set_node, children must have correct values.
+	*
+	* An augmented value (see is_augmented) is refreshed here too, so it is
+	* kept up to date by every rotation and rebalance, like the size.
+	*/
+	template<typename Key>
+	void update_node(set_node<Key> *node)
 	{
-		size_t height{0};
 		if(node)
 		{
-			size_t left = node_height(node->left);
-			size_t right = node_height(node->right);
-			height = 1 + std::max(left, right);
+			node->height = 1 + std::max(node_height(node->left), node_height(node->right));
+			node->size = 1 + node_size(node->left) + node_size(node->right);
+			if constexpr(is_augmented<Key>::value)
+				node->key.update(node->left ? &node->left->key : nullptr, node->right ? &node->right->key : nullptr);
 		}
-
-		return height;
 	}
 
 	/*
@@ -30,8 +129,8 @@ namespace containers::avl::detail
 	*
 	* @param node pointer to %set_node.
 	*/
-	template<typename Key>
-	int get_balance_factor(set_node<Key> *&node)
+	template<typename Node>
+	int get_balance_factor(const Node *node)
 	{
 		if(nullptr == node)
 			return 0;
@@ -39,38 +138,18 @@ namespace containers::avl::detail
 		return node_height(node->left) - node_height(node->right);
 	}
 
-	// Will be deleted
-	template<typename Key>
-	void preodrer(set_node<Key> *&node)
-	{
-		if(nullptr == node)
-			return;
-
-		preodrer(node->left);
-
-		if(node->left && node->right)
-			std::cerr << YELLOW;
-		else if(node->right)
-			std::cerr << BLUE;
-		else if(node->left)
-			std::cerr << GREEN;
-		else
-			std::cerr << RED;
-
-		if(get_balance_factor(node) > 1 || get_balance_factor(node) < -1)
-			std::cerr << BOLDRED << "OH SHIT FML SMTH IS BROKEN " << get_balance_factor(node) << " ";
-
-		std::cerr << node->key << RESET << " ";
-
-		preodrer(node->right);
-	}
-	// Will be deleted
-
+	/*
+	* @brief Rotates subtree rooted at @node to the left.
+	*
+	* @param node Root of subtree, must have a right child.
+	* @param root Root of the tree, updated if @node was the root.
+	*
+	* Heights and sizes of @node and its right child (the new subtree root) are
+	* updated, nothing above them changes because of the rotation itself.
+	*/
 	template<typename Key>
-	void left_rotate(set_node<Key> *&node, set_node<Key> *&root)
+	void left_rotate(set_node<Key> *node, set_node<Key> *&root)
 	{
-		//std::cerr << BOLDRED <<  "\nleft rotation of " << node->key << "\n" << RESET;
-
 		set_node<Key>* tmp{node->right};
 		set_node<Key>* tmp2{tmp->left};
 
@@ -88,17 +167,24 @@ namespace containers::avl::detail
 		else
 			root = tmp;
 
-		tmp->left->right = tmp2;
+		node->right = tmp2;
 		if(tmp2)
-			tmp2->parent = tmp->left;
+			tmp2->parent = node;
+
+		update_node(node);
+		update_node(tmp);
 	}
 
+	/*
+	* @brief Rotates subtree rooted at @node to the right.
+	*
+	* @param node Root of subtree, must have a left child.
+	* @param root Root of the tree, updated if @node was the root.
+	*/
 	template<typename Key>
-	void right_rotate(set_node<Key> *&node, set_node<Key> *&root)
+	void right_rotate(set_node<Key> *node, set_node<Key> *&root)
 	{
-		//std::cerr << BOLDBLUE << "\nright rotation of " << node->key << "\n" << RESET;
-
-		set_node<Key>* 	tmp{node->left};
+		set_node<Key>* tmp{node->left};
 		set_node<Key>* tmp2{tmp->right};
 
 		tmp->right = node;
@@ -115,9 +201,12 @@ namespace containers::avl::detail
 		else
 			root = tmp;
 
-		tmp->right->left = tmp2;
+		node->left = tmp2;
 		if(tmp2)
-			tmp2->parent = tmp->right;
+			tmp2->parent = node;
+
+		update_node(node);
+		update_node(tmp);
 	}
 
 	/*
@@ -127,10 +216,17 @@ namespace containers::avl::detail
 	* @param root Root of the tree.
 	*
 	* Balancing function, read included documentation for more information.
+	* Updates height and size of @node first, its children must already be correct.
+	*
+	* @return set_node* Root of the subtree after balancing.
 	*/
 	template<typename Key>
-	void balance_tree(set_node<Key> *&node, set_node<Key> *&root)
+	set_node<Key>* balance_tree(set_node<Key> *node, set_node<Key> *&root)
 	{
+		if(nullptr == node)
+			return nullptr;
+
+		update_node(node);
 		int balance{get_balance_factor(node)};
 
 		if(balance > 1) 							// left subtree unbalance
@@ -138,12 +234,64 @@ namespace containers::avl::detail
 			if(get_balance_factor(node->left) < 0)	// right child of left subtree is the cause
 				left_rotate(node->left, root);
 			right_rotate(node, root);
+			return node->parent;
 		}
 		else if(balance < -1) 						// right subtree unbalance
 		{
 			if(get_balance_factor(node->right) > 0)	// left child of right subtree is the cause
 				right_rotate(node->right, root);
 			left_rotate(node, root);
+			return node->parent;
+		}
+
+		return node;
+	}
+
+	/*
+	* @brief Rebalances every ancestor from @node up to the root.
+	*
+	* @param node Lowest node whose subtree changed.
+	* @param root Root of the tree.
+	*
+	* Walks at most the height of the tree, so this is logN.
+	*/
+	template<typename Key>
+	void rebalance_path(set_node<Key> *node, set_node<Key> *&root)
+	{
+		while(node)
+			node = balance_tree(node, root)->parent;
+	}
+
+	/*
+	* @brief Rebalances ancestors of a node that was just linked as a leaf.
+	*
+	* @param node Parent of the new leaf.
+	* @param root Root of the tree.
+	*
+	* After an insertion the AVL fix-up can stop at the first subtree whose
+	* height did not change (a rotation always restores the old height),
+	* the ancestors above it only gain one key in their subtree size.
+	* Appending in order thus rebalances O(1) nodes amortized. Augmented
+	* values can change all the way up, so those ancestors get update_node().
+	*/
+	template<typename Key>
+	void rebalance_insert(set_node<Key> *node, set_node<Key> *&root)
+	{
+		while(node)
+		{
+			int before{node->height};
+			set_node<Key> *top{balance_tree(node, root)};
+			node = top->parent;
+			if(top->height == before)
+				break;
+		}
+
+		for(; node; node = node->parent)
+		{
+			if constexpr(is_augmented<Key>::value)
+				update_node(node);
+			else
+				++node->size;
 		}
 	}
 
@@ -174,136 +322,548 @@ namespace containers::avl::detail
 	}
 
 	/*
-	* @brief Standard BST insertion function.
+	* Returns next node in order after @node, nullptr for the largest one.
+	*/
+	template<typename Key>
+	set_node<Key>* successor(set_node<Key> *node)
+	{
+		if(node->right)
+			return minimum(node->right);
+
+		while(node->parent && node == node->parent->right)
+			node = node->parent;
+
+		return node->parent;
+	}
+
+	/*
+	* Returns previous node in order before @node, nullptr for the smallest one.
+	*/
+	template<typename Key>
+	set_node<Key>* predecessor(set_node<Key> *node)
+	{
+		if(node->left)
+			return maximum(node->left);
+
+		while(node->parent && node == node->parent->left)
+			node = node->parent;
+
+		return node->parent;
+	}
+
+	/*
+	* @brief Finds where @value belongs in the tree.
 	*
-	* @param node pointer to reference of %set_node.
-	* @param value Value to insert (& or && not specified, will be deduced at compile time)
-	* @param comp Comparator to use for insertion.
+	* @param root Root of tree to traverse.
+	* @param value Key to look for, only the key is needed to find the place.
+	* @param comp Comparator to use.
+	* @param key_of Extracts the key of a node value.
+	*
+	* @return set_node* Node to attach the new node to, node equivalent to @value,
+	* 		or nullptr if the tree is empty.
+	* @return int -1/1 if the new node becomes the left/right child, 0 if @value is already present.
 	*
-	* @return set_node* Pointer to new node or to node that prevented insertion.
-	* @return bool Indicator whether insertion was successful.
+	* Nothing is allocated, so the caller only builds a node when insertion will succeed.
+	* One comparison per level: the descent only asks whether a key is less
+	* than @value and remembers the last one that is not, which is the only
+	* candidate for an equivalent key and is checked once at the bottom.
 	*/
-	template<typename Key, typename Compare>
-	std::pair<set_node<Key>*, bool> bst_insert(set_node<Key> *&node, Key value, Compare comp)
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	std::pair<set_node<Key>*, int> bst_insert_position(set_node<Key> *root, const K &value, const Compare &comp,
+			KeyOf key_of = KeyOf{})
 	{
-		if(nullptr == node)					// protect the function
-			return std::make_pair(nullptr, false);
-		else if(comp(value, node->key))		// @value compares less than @node->key
+		set_node<Key> *parent{nullptr}, *candidate{nullptr};
+		int side{0};
+
+		while(root)
 		{
-			if(nullptr == node->left)
+			parent = root;
+			if(comp(key_of(root->key), value))			// @value goes right of @root
 			{
-				node->left = new set_node<Key>{value};
-				node->left->parent = node;
-				return std::make_pair(node->left, true);
+				side = 1;
+				root = root->right;
 			}
+			else										// @root is not less than @value
+			{
+				candidate = root;
+				side = -1;
+				root = root->left;
+			}
+		}
+
+		if(candidate && !comp(value, key_of(candidate->key)))	// equivalent, will not be added
+			return std::make_pair(candidate, 0);
 
-			return bst_insert(node->left, value, comp);
+		return std::make_pair(parent, side);
+	}
+
+	/*
+	* @brief Finds where @value belongs, starting from @finger instead of the root.
+	*
+	* @param finger Node with a key less than @value.
+	*
+	* @return Same as bst_insert_position().
+	*
+	* Climbs while the parent is not greater than @value, then descends from
+	* there, the subtree reached holds every key between @finger and @value.
+	* That is O(log d) for @value d positions after @finger, O(1) when
+	* keys arrive in increasing order.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	std::pair<set_node<Key>*, int> bst_finger_position(set_node<Key> *finger, const K &value, const Compare &comp,
+			KeyOf key_of = KeyOf{})
+	{
+		while(finger->parent && !comp(value, key_of(finger->parent->key)))
+			finger = finger->parent;
+
+		return bst_insert_position(finger, value, comp, key_of);
+	}
+
+	/*
+	* @brief Finds where @value belongs using @hint, the node it should precede.
+	*
+	* @param root Root of the tree.
+	* @param hint Node after @value, nullptr for the end.
+	* @param last Largest node of the tree.
+	*
+	* @return Same as bst_insert_position().
+	*
+	* If @value belongs right before @hint, the new leaf goes either right of
+	* the predecessor of @hint or left of @hint, one of them is always free,
+	* so a good hint costs two comparisons. A @value after @hint is found
+	* from @hint as a finger, anything else falls back to a search from @root.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	std::pair<set_node<Key>*, int> bst_hint_position(set_node<Key> *root, set_node<Key> *hint, set_node<Key> *last,
+			const K &value, const Compare &comp, KeyOf key_of = KeyOf{})
+	{
+		if(nullptr == root)
+			return std::make_pair(root, 0);
+
+		if(nullptr == hint || comp(value, key_of(hint->key)))
+		{
+			set_node<Key> *prev{hint ? predecessor(hint) : last};
+			if(nullptr == prev || comp(key_of(prev->key), value))
+			{
+				if(prev && nullptr == prev->right)
+					return std::make_pair(prev, 1);
+				return std::make_pair(hint, -1);
+			}
+			if(!comp(value, key_of(prev->key)))
+				return std::make_pair(prev, 0);
+
+			return bst_insert_position(root, value, comp, key_of);
 		}
-		else if(comp(node->key, value))		// @value compares greater than @node->key
+
+		if(!comp(key_of(hint->key), value))
+			return std::make_pair(hint, 0);
+
+		return bst_finger_position(hint, value, comp, key_of);
+	}
+
+	/*
+	* @brief Finds where @value goes in a tree that keeps equivalent keys.
+	*
+	* @return set_node* Node to attach the new node to, nullptr if the tree is empty.
+	* @return int -1/1 if the new node becomes the left/right child, never 0.
+	*
+	* Goes right on equivalent keys, so the new node lands after all of
+	* them and equivalent keys stay in insertion order.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	std::pair<set_node<Key>*, int> bst_insert_equal_position(set_node<Key> *root, const K &value, const Compare &comp,
+			KeyOf key_of = KeyOf{})
+	{
+		set_node<Key> *parent{nullptr};
+		int side{1};
+
+		while(root)
 		{
-			if(nullptr == node->right)
+			parent = root;
+			if(comp(value, key_of(root->key)))			// @value goes left of @root
+			{
+				side = -1;
+				root = root->left;
+			}
+			else										// after @root, even if equivalent
 			{
-				node->right = new set_node<Key>{value};
-				node->right->parent = node;
-				return std::make_pair(node->right, true);
+				side = 1;
+				root = root->right;
 			}
+		}
+
+		return std::make_pair(parent, side);
+	}
 
-			return bst_insert(node->right, value, comp);
+	/*
+	* @brief Finds where @value goes right before @hint in a tree that keeps equivalent keys.
+	*
+	* @param hint Node after @value, nullptr for the end.
+	* @param last Largest node of the tree.
+	*
+	* @return Same as bst_insert_equal_position().
+	*
+	* Like bst_hint_position(), a @value between the predecessor of @hint
+	* and @hint costs two comparisons, anything else searches from @root.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	std::pair<set_node<Key>*, int> bst_hint_equal_position(set_node<Key> *root, set_node<Key> *hint, set_node<Key> *last,
+			const K &value, const Compare &comp, KeyOf key_of = KeyOf{})
+	{
+		if(nullptr == root)
+			return std::make_pair(root, 1);
+
+		if(nullptr == hint || !comp(key_of(hint->key), value))
+		{
+			set_node<Key> *prev{hint ? predecessor(hint) : last};
+			if(nullptr == prev || !comp(value, key_of(prev->key)))
+			{
+				if(prev && nullptr == prev->right)
+					return std::make_pair(prev, 1);
+				return std::make_pair(hint, -1);
+			}
 		}
-		else								// @value compares equivalent to @node->key, will not be added
-			return std::make_pair(node, false);
+
+		return bst_insert_equal_position(root, value, comp, key_of);
+	}
+
+	/*
+	* @brief Links a new leaf into the tree.
+	*
+	* @param node New node, must not be linked anywhere yet.
+	* @param parent Node returned by bst_insert_position, nullptr makes @node the root.
+	* @param side Side returned by bst_insert_position.
+	* @param root Root of the tree.
+	*/
+	template<typename Key>
+	void bst_link(set_node<Key> *node, set_node<Key> *parent, int side, set_node<Key> *&root)
+	{
+		node->parent = parent;
+		node->left = node->right = nullptr;
+		node->height = 1;
+		node->size = 1;
+
+		if(nullptr == parent)
+			root = node;
+		else if(side < 0)
+			parent->left = node;
+		else
+			parent->right = node;
+	}
+
+	/*
+	* @brief Replaces @node with @child in the parent of @node.
+	*
+	* @param node Node being unlinked.
+	* @param child Node taking its place, may be nullptr.
+	* @param root Root of the tree, updated if @node was the root.
+	*/
+	template<typename Key>
+	void replace_child(set_node<Key> *node, set_node<Key> *child, set_node<Key> *&root)
+	{
+		if(child)
+			child->parent = node->parent;
+
+		if(nullptr == node->parent)
+			root = child;
+		else if(node->parent->left == node)
+			node->parent->left = child;
+		else
+			node->parent->right = child;
 	}
 
 	/*
 	* @brief Standard BST erase function.
 	*
 	* @param node Pointer to node to be removed.
+	* @param root Root of the tree, updated if it changes.
+	*
+	* @return set_node* Lowest node whose subtree lost a level, rebalancing starts here.
+	*
+	* When @node has two children its successor is relinked into its place
+	* instead of having its key moved, so no other node is invalidated.
+	* @node is only unlinked, releasing it is up to the caller.
 	*/
 	template<typename Key>
-	set_node<Key>* bst_erase(set_node<Key> *node)
+	set_node<Key>* bst_erase(set_node<Key> *node, set_node<Key> *&root)
 	{
 		if(nullptr == node)											// protect the function
 			return nullptr;
 
-		static set_node<Key> *ret{nullptr};								// save a neighbour, we need this for balancing
+		set_node<Key> *ret{node->parent};							// save a neighbour, we need this for balancing
 
-		if(nullptr == node->left && nullptr == node->right)			// node to remove is a leaf
+		if(nullptr == node->left)									// at most a right child
+			replace_child(node, node->right, root);
+		else if(nullptr == node->right)								// left child only
+			replace_child(node, node->left, root);
+		else														// node has both children
 		{
-			if(node->parent)
-			{
-				ret = node->parent;
+			set_node<Key> *succ{minimum(node->right)};
 
-				if(node->parent->left == node)
-					node->parent->left = nullptr;
-				else
-					node->parent->right = nullptr;
+			if(succ->parent != node)								// detach successor, its right child moves up
+			{
+				ret = succ->parent;
+				replace_child(succ, succ->right, root);
+				succ->right = node->right;
+				succ->right->parent = succ;
 			}
-			delete node;
-			node = nullptr;
+			else
+				ret = succ;
+
+			replace_child(node, succ, root);
+			succ->left = node->left;
+			succ->left->parent = succ;
+			succ->height = node->height;
+			succ->size = node->size;
 		}
-		else if(nullptr != node->left && nullptr == node->right)	// node has left child only
+
+		return ret;
+	}
+
+	/*
+	* @brief Links an in-order array of nodes into a perfectly balanced tree.
+	*
+	* @param nodes Nodes in ascending order, their links are overwritten.
+	* @param n Number of nodes.
+	* @param parent Parent of the subtree being built.
+	*
+	* @return set_node* Root of the new subtree.
+	*
+	* Every subtree gets the middle element as its root, so the result is an
+	* AVL tree with correct heights. Linear in @n.
+	*/
+	template<typename Key>
+	set_node<Key>* link_balanced(set_node<Key> **nodes, size_t n, set_node<Key> *parent)
+	{
+		if(0 == n)
+			return nullptr;
+
+		size_t mid{n / 2};
+		set_node<Key> *node{nodes[mid]};
+
+		node->parent = parent;
+		node->left = link_balanced(nodes, mid, node);
+		node->right = link_balanced(nodes + mid + 1, n - mid - 1, node);
+		update_node(node);
+
+		return node;
+	}
+
+	/*
+	* @brief Structural copy of the subtree rooted at @source.
+	*
+	* @param source Subtree to copy.
+	* @param target Link the copy is stored in, set before recursing so a
+	* 		partial copy stays reachable if @make throws.
+	* @param parent Parent of the copy.
+	* @param make Returns a new node holding a copy (or the moved key) of its argument.
+	*
+	* Shape and heights are copied as they are, so no comparisons or rotations
+	* are needed. Linear in the size of the subtree.
+	*/
+	template<typename Key, typename Make>
+	void clone_tree(set_node<Key> *source, set_node<Key> *&target, set_node<Key> *parent, Make make)
+	{
+		if(nullptr == source)
 		{
-			ret = node->left;
+			target = nullptr;
+			return;
+		}
 
-			//set_node<Key> *tmp{node};
-			node->left->parent = node->parent;
-			if(node->parent)
-			{
-				if(node->parent->left == node)
-					node->parent->left = node->left;
-				else
-					node->parent->right = node->left;
-			}
+		target = make(source);
+		target->parent = parent;
+		target->left = target->right = nullptr;
+		target->height = source->height;
+		target->size = source->size;
 
-			delete node;
-			node = nullptr;
+		clone_tree(source->left, target->left, target, make);
+		clone_tree(source->right, target->right, target, make);
+	}
+
+	/*
+	* @brief Threads @n nodes, sorted by key, into a list closed by @end.
+	*
+	* @param end Sentinel before the first and after the last node, or
+	* 		nullptr for a list ending in nullptr on both sides.
+	*
+	* Linear in @n, the tree links are not touched.
+	*/
+	template<typename Key>
+	void thread_sorted(set_node<Key> **nodes, size_t n, set_node<Key> *end)
+	{
+		set_node<Key> *prev{end};
+		for(size_t i = 0; i < n; ++i)
+		{
+			nodes[i]->prev = prev;
+			if(prev)
+				prev->next = nodes[i];
+			prev = nodes[i];
 		}
-		else if(nullptr == node->left && nullptr != node->right)	// node has right child only
+
+		if(prev)
+			prev->next = end;
+		if(end)
+			end->prev = prev;
+	}
+
+	/*
+	* @brief Threads every node of the tree under @root in order, see thread_sorted().
+	*
+	* Walks the tree once with successor(), linear in its size.
+	*/
+	template<typename Key>
+	void thread_tree(set_node<Key> *root, set_node<Key> *end)
+	{
+		set_node<Key> *prev{end};
+		for(set_node<Key> *node = root ? minimum(root) : nullptr; node; node = successor(node))
 		{
-			ret = node->right;
+			node->prev = prev;
+			if(prev)
+				prev->next = node;
+			prev = node;
+		}
+
+		if(prev)
+			prev->next = end;
+		if(end)
+			end->prev = prev;
+	}
+
+	/*
+	* @brief Links @node into the list right after @prev, which is not nullptr.
+	*/
+	template<typename Key>
+	void thread_after(set_node<Key> *node, set_node<Key> *prev)
+	{
+		node->prev = prev;
+		node->next = prev->next;
+		if(node->next)
+			node->next->prev = node;
+		prev->next = node;
+	}
+
+	/*
+	* @brief Takes @node out of the list it is threaded in.
+	*/
+	template<typename Key>
+	void unthread(set_node<Key> *node)
+	{
+		if(node->prev)
+			node->prev->next = node->next;
+		if(node->next)
+			node->next->prev = node->prev;
+	}
 
-			//set_node<Key> *tmp{node};
-			node->right->parent = node->parent;
-			if(node->parent)
+	/*
+	* @brief Finds the node with in-order index @k.
+	*
+	* @param root Root of tree to traverse.
+	* @param k Zero based index, must be less than the size of the tree.
+	*/
+	template<typename Key>
+	set_node<Key>* select(set_node<Key> *root, size_t k)
+	{
+		while(root)
+		{
+			size_t left{node_size(root->left)};
+			if(k < left)
+				root = root->left;
+			else if(k > left)
 			{
-				if(node->parent->left == node)
-					node->parent->left = node->right;
-				else
-					node->parent->right = node->right;
+				k -= left + 1;
+				root = root->right;
 			}
+			else
+				break;
+		}
 
-			delete node;
-			node = nullptr;
+		return root;
+	}
+
+	/*
+	* @brief Counts keys in the tree that compare less than @key.
+	*
+	* @param root Root of tree to traverse.
+	* @param key Key to rank.
+	* @param comp Comparator to use.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	size_t rank(const set_node<Key> *root, const K &key, const Compare &comp, KeyOf key_of = KeyOf{})
+	{
+		size_t ret{0};
+		while(root)
+		{
+			if(comp(key_of(root->key), key))
+			{
+				ret += node_size(root->left) + 1;
+				root = root->right;
+			}
+			else
+				root = root->left;
 		}
-		else														// node has both children
+
+		return ret;
+	}
+
+	/*
+	* @brief Counts keys in the tree that do not compare greater than @key.
+	*
+	* The index upper_bound(@key) would have, so with rank() it counts
+	* equivalent keys in logN.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	size_t upper_rank(const set_node<Key> *root, const K &key, const Compare &comp, KeyOf key_of = KeyOf{})
+	{
+		size_t ret{0};
+		while(root)
 		{
-			set_node<Key> *tmp{minimum(node->right)};
-			node->key = std::move(tmp->key);
-			bst_erase(tmp);
+			if(comp(key, key_of(root->key)))
+				root = root->left;
+			else
+			{
+				ret += node_size(root->left) + 1;
+				root = root->right;
+			}
 		}
 
 		return ret;
 	}
 
+	/*
+	* @brief Returns in-order index of @node by walking up to the root.
+	*/
+	template<typename Key>
+	size_t node_index(const set_node<Key> *node)
+	{
+		size_t ret{node_size(node->left)};
+		for(; node->parent; node = node->parent)
+			if(node->parent->right == node)
+				ret += node_size(node->parent->left) + 1;
+
+		return ret;
+	}
+
 	/*
 	* @brief Standard BST search function.
 	*
 	* @param root Root of tree to traverse.
-	* @param key Key to find.
+	* @param key Key to find, anything @comp can compare with a %Key.
 	* @param comp Comparator to use.
 	*/
-	template<typename Key, typename Compare>
-	set_node<Key>* bst_find(set_node<Key> *root, Key key, Compare comp)
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	set_node<Key>* bst_find(set_node<Key> *root, const K &key, const Compare &comp, KeyOf key_of = KeyOf{})
 	{
-		if(nullptr == root)
-			return nullptr;
+		while(root)
+		{
+			if(comp(key, key_of(root->key)))			// @key compares less than @root->key
+				root = root->left;
+			else if(comp(key_of(root->key), key))		// @key compares greater than @root->key
+				root = root->right;
+			else										// @key is equivalent to @root->key
+				return root;
+		}
 
-		if(comp(key, root->key))		// @key compares less than @root->key
-			return bst_find(root->left, key, comp);
-		else if(comp(root->key, key))	// @key compares greater than @root->key
-			return bst_find(root->right, key, comp);
-		else							// @key is equivalent to @root->key
-			return root;
+		return nullptr;
 	}
 
 	/*
@@ -315,20 +875,19 @@ namespace containers::avl::detail
 	*
 	* A lower bound is the first element not less than @key.
 	*/
-	template<typename Key, typename Compare>
-	set_node<Key>* bst_lower_bound(set_node<Key> *root, Key key, Compare comp)
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	set_node<Key>* bst_lower_bound(set_node<Key> *root, const K &key, const Compare &comp, KeyOf key_of = KeyOf{})
 	{
-		if(nullptr == root)
-			return nullptr;
-
-		static set_node<Key> *ret{nullptr};
-
-		if(comp(root->key, key))
-			bst_lower_bound(root->right, key, comp);
-		else
+		set_node<Key> *ret{nullptr};
+		while(root)
 		{
-			ret = root;
-			bst_lower_bound(root->left, key, comp);
+			if(comp(key_of(root->key), key))	// bound is in the right subtree
+				root = root->right;
+			else
+			{
+				ret = root;
+				root = root->left;
+			}
 		}
 
 		return ret;
@@ -343,21 +902,20 @@ namespace containers::avl::detail
 	*
 	* An upper bound is the first element greater than @key.
 	*/
-	template<typename Key, typename Compare>
-	set_node<Key>* bst_upper_bound(set_node<Key> *root, Key key, Compare comp)
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	set_node<Key>* bst_upper_bound(set_node<Key> *root, const K &key, const Compare &comp, KeyOf key_of = KeyOf{})
 	{
-		if(nullptr == root)
-			return nullptr;
-
-		static set_node<Key> *ret{nullptr};
-
-		if(comp(key, root->key))
+		set_node<Key> *ret{nullptr};
+		while(root)
 		{
-			ret = root;
-			bst_upper_bound(root->left, key, comp);
+			if(comp(key, key_of(root->key)))
+			{
+				ret = root;
+				root = root->left;
+			}
+			else								// bound is in the right subtree
+				root = root->right;
 		}
-		else
-			bst_upper_bound(root->right, key, comp);
 
 		return ret;
 	}
@@ -366,21 +924,563 @@ namespace containers::avl::detail
 	* @brief Standard BST delete function.
 	*
 	* @param root Root of subtree to delete.
+	* @param release Called on every node once its children are gone.
+	*
+	* Walks the tree in post order through the parent pointers, so no
+	* stack is used however deep the tree is.
 	*/
-	template<typename Key>
-	void bst_delete(set_node<Key> *&root)
+	template<typename Key, typename Release>
+	void bst_delete(set_node<Key> *&root, Release release)
 	{
-		if(nullptr == root)
-			return;
+		set_node<Key> *node{root};
+		while(node)
+		{
+			if(node->left)
+				node = node->left;
+			else if(node->right)
+				node = node->right;
+			else										// leaf, unhook it and go up
+			{
+				set_node<Key> *parent{node == root ? nullptr : node->parent};
+				if(parent)
+				{
+					if(parent->left == node)
+						parent->left = nullptr;
+					else
+						parent->right = nullptr;
+				}
 
-		//std::cerr << MAGENTA << "Deleting node: " << root->key << RESET << std::endl;
+				release(node);
+				node = parent;
+			}
+		}
 
-		bst_delete(root->left);
-		bst_delete(root->right);
-		delete root;
 		root = nullptr;
 	}
 
 } // nested namespace container::avl::detail
 
+// The tree base below needs the pool, split/join and the checks, which build on the helpers above
+#include "node_pool.hpp"
+#include "set_join.hpp"
+#include "set_stats.hpp"
+
+namespace containers::avl::detail
+{
+
+	// Tree Base declaration:
+	// @@{
+	/*
+	* @brief Node bookkeeping shared by the AVL containers.
+	*
+	* @param Node Node type, a %set_node.
+	* @param KeyOf Key extractor, see identity_key.
+	* @param Compare Comparison object function type, applied to extracted keys.
+	* @param Allocator Allocator type, rebound to %Node by the pool.
+	* @param Unique Insert policy, false lets equivalent keys repeat.
+	*
+	* Holds the node pool, the tree, its first and last nodes, the size and
+	* the END sentinel closing the threaded list, and keeps them in step as
+	* nodes are linked, unlinked and erased in runs. Containers derive from
+	* it privately and add their iterators and searches on top.
+	* With @Unique a new key goes nowhere if an equivalent one is in the
+	* tree, otherwise it goes after its equivalents, in insertion order, and
+	* lookups and range erases find the first of them.
+	* END is made on construction and again by ensure_end() once it was
+	* moved away, and destroyed with the base.
+	* An augmented value (see is_augmented) is kept here without any help
+	* from the container: every relink goes through update_node(), in the
+	* rotations, up the path in rebalance_insert() and rebalance_path(),
+	* and in split() and join().
+	*/
+	template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique = true>
+	class tree_base : private compare_holder<Compare>
+	{
+		protected:
+			// Convenience
+			using node_type = Node;
+			using pool_type = node_pool<Node, Allocator>;
+			using position_type = std::pair<Node*, int>;
+			using compare_base = compare_holder<Compare>;
+			using compare_base::compare;
+			typedef size_t size_type;
+
+			// Constructor
+			tree_base(const Compare &comp, const Allocator &alloc);
+			tree_base(const tree_base &other) = delete;
+			tree_base(tree_base &&other) noexcept;
+
+			// Destructor
+			~tree_base(void);
+
+			// Assignment
+			tree_base& operator=(const tree_base &other) = delete;
+
+			// Nodes
+			void copy_nodes(const tree_base &other);
+			void clear_nodes(void);
+			void swap_tree(tree_base &other) noexcept;
+
+			// Lookup, END if there is no such node
+			template<typename K>
+			Node* find_node(const K &key) const;
+			template<typename K>
+			Node* lower_node(const K &key) const;
+			template<typename K>
+			Node* upper_node(const K &key) const;
+
+			// Positions for a new node
+			template<typename K>
+			position_type insert_position(const K &key) const;
+			template<typename K>
+			position_type hint_position(Node *hint, const K &key) const;
+
+			// Linking
+			void link_node(position_type position, Node *node);
+			void unlink(Node *node);
+			size_type erase_nodes(Node *from, Node *to);
+
+			// Threads and bounds
+			void ensure_end(void);
+			Node* detach_threads(void);
+			void update_bounds(void);
+
+			// Diagnostics
+			tree_stats stats(void) const;
+			void check_tree(const char *name) const;
+			template<typename Check>
+			void check_tree(const char *name, Check check) const;
+
+			// Data
+			pool_type pool;
+			Node *root, *first, *last;
+			Node *END;
+			size_type _size;
+	};
+	// @@}
+
+// Tree Base implementation:
+// @@{
+// Construction/destruction:
+// @{
+/*
+* @brief Builds an empty tree ordered by @comp, with nodes allocated through @alloc.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+tree_base<Node, KeyOf, Compare, Allocator, Unique>::tree_base(const Compare &comp, const Allocator &alloc)
+	:	compare_base{comp},
+		pool{alloc},
+		root{nullptr},
+		first{nullptr},
+		last{nullptr},
+		END{nullptr},
+		_size{0}
+{
+	ensure_end();
+}
+
+/*
+* @brief Takes over the nodes and sentinel of @other, which is left
+* empty and without a sentinel. The comparator is copied.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+tree_base<Node, KeyOf, Compare, Allocator, Unique>::tree_base(tree_base &&other) noexcept
+	:	compare_base{other.compare()},
+		pool{std::move(other.pool)},
+		root{other.root},
+		first{other.first},
+		last{other.last},
+		END{other.END},
+		_size{other._size}
+{
+	other.root = other.first = other.last = other.END = nullptr;
+	other._size = 0;
+}
+
+/*
+* Destroys every node and the sentinel.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+tree_base<Node, KeyOf, Compare, Allocator, Unique>::~tree_base(void)
+{
+	clear_nodes();
+	if(nullptr != END)
+		pool.destroy_detached(END);
+}
+// @}
+
+// Nodes:
+// @{
+/*
+* @brief Copies the tree of @other into this empty one node for node,
+* with its shape, without comparisons or rebalancing, in linear time.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::copy_nodes(const tree_base &other)
+{
+	clone_tree(other.root, root, static_cast<Node*>(nullptr),
+			[this](const Node *node) { return pool.create(node->key); });
+	thread_tree(root, END);
+
+	_size = other._size;
+	update_bounds();
+}
+
+/*
+* @brief Destroys all nodes. Keys are destroyed in linear time, node memory
+* is released one chunk at a time, so for trivially destructible keys
+* this is O(chunks).
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::clear_nodes(void)
+{
+	if constexpr(!std::is_trivially_destructible<Node>::value)
+		bst_delete(root, [this](Node *node) { pool.destroy(node); });
+
+	pool.release();
+	_size = 0;
+	root = first = last = nullptr;
+	if(END)
+		END->prev = END->next = END;
+}
+
+/*
+* @brief Swaps trees, pools and comparators with @other in constant time, no node moves.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::swap_tree(tree_base &other) noexcept
+{
+	using std::swap;
+	compare_base::swap_compare(other);
+	pool.swap(other.pool);
+	swap(root, other.root);
+	swap(first, other.first);
+	swap(last, other.last);
+	swap(END, other.END);
+	swap(_size, other._size);
+}
+// @}
+
+// Lookup:
+// @{
+/*
+* Returns the node with a key equivalent to @key, the first of them if
+* keys repeat, END if there is none.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+template<typename K>
+Node* tree_base<Node, KeyOf, Compare, Allocator, Unique>::find_node(const K &key) const
+{
+	Node *node;
+	if constexpr(Unique)
+		node = bst_find(root, key, compare(), KeyOf{});
+	else
+	{
+		node = bst_lower_bound(root, key, compare(), KeyOf{});
+		if(node && compare()(key, KeyOf{}(node->key)))
+			node = nullptr;
+	}
+
+	return node ? node : END;
+}
+
+/*
+* Returns the first node whose key is not less than @key, END if there is none.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+template<typename K>
+Node* tree_base<Node, KeyOf, Compare, Allocator, Unique>::lower_node(const K &key) const
+{
+	Node *node{bst_lower_bound(root, key, compare(), KeyOf{})};
+	return node ? node : END;
+}
+
+/*
+* Returns the first node whose key is greater than @key, END if there is none.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+template<typename K>
+Node* tree_base<Node, KeyOf, Compare, Allocator, Unique>::upper_node(const K &key) const
+{
+	Node *node{bst_upper_bound(root, key, compare(), KeyOf{})};
+	return node ? node : END;
+}
+// @}
+
+// Positions:
+// @{
+/*
+* @brief Finds where @key belongs, see bst_insert_position(), or
+* bst_insert_equal_position() after its equivalents if keys repeat.
+*
+* Keys past either end are placed with one comparison each.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+template<typename K>
+typename tree_base<Node, KeyOf, Compare, Allocator, Unique>::position_type
+tree_base<Node, KeyOf, Compare, Allocator, Unique>::insert_position(const K &key) const
+{
+	const Compare &comp{compare()};
+	KeyOf key_of;
+
+	if constexpr(Unique)
+	{
+		if(last && comp(key_of(last->key), key))		// appending past the largest key
+			return std::make_pair(last, 1);
+	}
+	else if(last && !comp(key, key_of(last->key)))		// appending, also after an equivalent largest key
+		return std::make_pair(last, 1);
+	if(first && comp(key, key_of(first->key)))			// prepending before the smallest key
+		return std::make_pair(first, -1);
+
+	if constexpr(Unique)
+		return bst_insert_position(root, key, comp, key_of);
+	else
+		return bst_insert_equal_position(root, key, comp, key_of);
+}
+
+/*
+* @brief Finds where @key belongs using @hint (END for none), see
+* bst_hint_position() and bst_hint_equal_position().
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+template<typename K>
+typename tree_base<Node, KeyOf, Compare, Allocator, Unique>::position_type
+tree_base<Node, KeyOf, Compare, Allocator, Unique>::hint_position(Node *hint, const K &key) const
+{
+	Node *node{END == hint ? nullptr : hint};
+	if constexpr(Unique)
+		return bst_hint_position(root, node, last, key, compare(), KeyOf{});
+	else
+		return bst_hint_equal_position(root, node, last, key, compare(), KeyOf{});
+}
+// @}
+
+// Linking:
+// @{
+/*
+* @brief Links @node, new or extracted, as a leaf at @position and rebalances.
+*
+* @param position Free position found by one of the bst_*_position functions.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::link_node(position_type position, Node *node)
+{
+	bst_link(node, position.first, position.second, root);
+	++_size;
+
+	// A left child comes right before its parent, a right child right after
+	if(nullptr == position.first)
+		thread_after(node, END);
+	else if(position.second < 0)
+		thread_after(node, position.first->prev);
+	else
+		thread_after(node, position.first);
+
+	if(nullptr == first || (position.second < 0 && position.first == first))
+		first = node;
+	if(nullptr == last || (position.second > 0 && position.first == last))
+		last = node;
+
+	rebalance_insert(node->parent, root);
+}
+
+/*
+* @brief Unlinks @node from the tree and rebalances, the node is not destroyed.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::unlink(Node *node)
+{
+	if(node == first)
+		first = END == node->next ? nullptr : node->next;
+	if(node == last)
+		last = END == node->prev ? nullptr : node->prev;
+
+	unthread(node);
+	rebalance_path(bst_erase(node, root), root);
+	--_size;
+}
+
+/*
+* @brief Erases the nodes from @from up to, not including, @to (END for all up to the end).
+*
+* @return Number of nodes erased.
+*
+* The run is cut out of the threaded list in O(1). The tree is split
+* before @from and before @to and the outer parts are joined back
+* (logN), so no node is rebalanced on its own. Then the run is destroyed.
+* If keys repeat @from or @to may sit among equivalent keys, so the
+* splits go by index instead of by key.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+typename tree_base<Node, KeyOf, Compare, Allocator, Unique>::size_type
+tree_base<Node, KeyOf, Compare, Allocator, Unique>::erase_nodes(Node *from, Node *to)
+{
+	KeyOf key_of;
+	size_type begin{0}, end{0};
+	if constexpr(!Unique)
+	{
+		begin = node_index(from);
+		end = END == to ? _size : node_index(to);
+	}
+
+	Node *before{from->prev};
+	before->next = to;
+	to->prev = before;
+
+	Node *left, *found, *rest;
+	if constexpr(Unique)
+		std::tie(left, found, rest) = split(root, key_of(from->key), compare(), key_of);
+	else
+		std::tie(left, found, rest) = split_at(root, begin);
+	(void)found;												// @from itself, destroyed below
+	if(END == to)
+		root = left;
+	else
+	{
+		Node *middle, *kept, *right;
+		if constexpr(Unique)
+			std::tie(middle, kept, right) = split(rest, key_of(to->key), compare(), key_of);
+		else
+			std::tie(middle, kept, right) = split_at(rest, end - begin - 1);
+		(void)middle;
+		root = join(left, kept, right);
+	}
+	if(root)
+		root->parent = nullptr;
+
+	size_type count{0};
+	while(from != to)
+	{
+		Node *next{from->next};
+		pool.destroy(from);
+		from = next;
+		++count;
+	}
+
+	_size -= count;
+	first = END == END->next ? nullptr : END->next;
+	last = END == END->prev ? nullptr : END->prev;
+
+	return count;
+}
+// @}
+
+// Threads and bounds:
+// @{
+/*
+* @brief Makes the end sentinel, again for a tree whose sentinel was moved away.
+*
+* END closes the threaded list on both sides, an empty list points at END.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::ensure_end(void)
+{
+	if(END)
+		return;
+
+	END = pool.create_detached();
+	END->height = 0;									// marks the sentinel, see set::index_of()
+	END->prev = END->next = END;
+}
+
+/*
+* @brief Cuts the list of nodes loose from END, returns its first node.
+*
+* The list then ends in nullptr on both sides, as join_threads() expects.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+Node* tree_base<Node, KeyOf, Compare, Allocator, Unique>::detach_threads(void)
+{
+	if(nullptr == first)
+		return nullptr;
+
+	first->prev = nullptr;
+	last->next = nullptr;
+	END->prev = END->next = END;
+
+	return first;
+}
+
+/*
+* Recalculates first and last from root in logN time.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::update_bounds(void)
+{
+	if(root)
+	{
+		first = minimum(root);
+		last = maximum(root);
+	}
+	else
+		first = last = nullptr;
+}
+// @}
+
+// Diagnostics:
+// @{
+/*
+* @brief Returns height, depth and balance distribution of the tree and
+* the memory it takes, see %tree_stats.
+*
+* Linear in the size of the tree, meant for monitoring and tuning, not hot paths.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+tree_stats tree_base<Node, KeyOf, Compare, Allocator, Unique>::stats(void) const
+{
+	tree_stats ret{collect_stats(static_cast<const Node*>(root))};
+	size_type sentinel{END ? sizeof(Node) : 0};
+
+	ret.node_bytes = sizeof(Node);
+	ret.used_bytes = _size * sizeof(Node) + sentinel;
+	ret.reserved_bytes = pool.capacity() * sizeof(Node) + sentinel;
+
+	return ret;
+}
+
+/*
+* @brief Checks every invariant of the tree, throws std::logic_error
+* starting with @name and naming the first one that is broken.
+*
+* BST order, AVL balance, stored heights and sizes, parent links, the
+* threaded list and the cached size, first and last nodes. Linear in the
+* size of the tree, meant for tests and debugging.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::check_tree(const char *name) const
+{
+	check_tree(name, [](const Node*) { return static_cast<const char*>(nullptr); });
+}
+
+/*
+* @brief Checks every invariant of the tree as above, then calls @check
+* with every node in order, which returns what is broken in that node
+* (e.g. a stale augmented value) or nullptr.
+*/
+template<typename Node, typename KeyOf, typename Compare, typename Allocator, bool Unique>
+template<typename Check>
+void tree_base<Node, KeyOf, Compare, Allocator, Unique>::check_tree(const char *name, Check check) const
+{
+	const Node *tree{root};
+	const char *error{find_violation(tree, _size, compare(), Unique, KeyOf{})};
+	if(nullptr == error && END)
+		error = find_thread_violation(tree, static_cast<const Node*>(END));
+	if(nullptr == error && root && (first != minimum(root) || last != maximum(root)))
+		error = "first or last node is stale";
+	if(nullptr == error && nullptr == root && (first || last))
+		error = "first or last node set in an empty tree";
+
+	// Every node was reached above, so the threaded list covers the tree
+	for(const Node *node = first; nullptr == error && node && node != END; node = node->next)
+		error = check(node);
+
+	if(error)
+		throw std::logic_error(std::string(name) + ": " + error);
+}
+// @}
+// @@}
+
+} // nested namespace container::avl::detail
+
 #endif // _CONTAINER_SET_DETAIL_HPP_
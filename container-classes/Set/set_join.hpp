@@ -0,0 +1,461 @@
+// set_detail.hpp includes this header after its helpers, so it goes first
+#include "set_detail.hpp"
+
+#ifndef _CONTAINER_SET_JOIN_HPP_
+#define _CONTAINER_SET_JOIN_HPP_
+
+#include <future>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "set_node.hpp"
+
+namespace containers::avl::detail
+{
+
+	/*
+	* Subtrees lower than this are never handed to another thread.
+	*/
+	constexpr int parallel_height = 14;
+
+	/*
+	* Returns how many levels of the set algebra recursion may fork,
+	* enough to give every hardware thread some work.
+	*/
+	inline int fork_depth(void)
+	{
+		unsigned threads{std::thread::hardware_concurrency()};
+		int depth{0};
+		while(threads > 1u)
+		{
+			threads = (threads + 1) / 2;
+			++depth;
+		}
+
+		return depth;
+	}
+
+	/*
+	* @brief Detaches @node from its parent and children.
+	*
+	* @return std::tuple Former left and right subtrees, both made roots.
+	*/
+	template<typename Key>
+	std::tuple<set_node<Key>*, set_node<Key>*> detach(set_node<Key> *node)
+	{
+		set_node<Key> *left{node->left}, *right{node->right};
+		if(left)
+			left->parent = nullptr;
+		if(right)
+			right->parent = nullptr;
+
+		node->parent = node->left = node->right = nullptr;
+		node->height = 1;
+		node->size = 1;
+
+		return std::make_tuple(left, right);
+	}
+
+	/*
+	* @brief AVL join.
+	*
+	* @param left Tree whose keys all compare less than @key->key.
+	* @param key Detached node.
+	* @param right Tree whose keys all compare greater than @key->key.
+	*
+	* @return set_node* Root of a balanced tree holding everything.
+	*
+	* @key is hung on the spine of the taller tree at the height of the lower
+	* one and the path above it is rebalanced, so the cost is the height
+	* difference of the two trees.
+	*/
+	template<typename Key>
+	set_node<Key>* join(set_node<Key> *left, set_node<Key> *key, set_node<Key> *right)
+	{
+		int lh{node_height(left)}, rh{node_height(right)};
+
+		if(left)
+			left->parent = nullptr;
+		if(right)
+			right->parent = nullptr;
+
+		if(lh > rh + 1)									// walk down the right spine of @left
+		{
+			set_node<Key> *parent{nullptr}, *cut{left};
+			while(node_height(cut) > rh + 1)
+			{
+				parent = cut;
+				cut = cut->right;
+			}
+
+			key->left = cut;
+			key->right = right;
+			parent->right = key;
+			key->parent = parent;
+		}
+		else if(rh > lh + 1)							// walk down the left spine of @right
+		{
+			set_node<Key> *parent{nullptr}, *cut{right};
+			while(node_height(cut) > lh + 1)
+			{
+				parent = cut;
+				cut = cut->left;
+			}
+
+			key->right = cut;
+			key->left = left;
+			parent->left = key;
+			key->parent = parent;
+		}
+		else											// heights close enough, @key is the new root
+		{
+			key->left = left;
+			key->right = right;
+			key->parent = nullptr;
+		}
+
+		if(key->left)
+			key->left->parent = key;
+		if(key->right)
+			key->right->parent = key;
+		update_node(key);
+
+		set_node<Key> *root{(lh > rh + 1) ? left : (rh > lh + 1) ? right : key};
+		rebalance_path(key->parent, root);
+
+		return root;
+	}
+
+	/*
+	* @brief Splits @node around @key.
+	*
+	* @param node Root of tree to split, consumed.
+	* @param key Key to split around.
+	* @param comp Comparator to use.
+	* @param key_of Extracts the key of a node value, see identity_key.
+	*
+	* @return std::tuple Tree of keys less than @key, detached node equivalent
+	* 		to @key (or nullptr) and tree of keys greater than @key.
+	*/
+	template<typename Key, typename K, typename Compare, typename KeyOf = identity_key>
+	std::tuple<set_node<Key>*, set_node<Key>*, set_node<Key>*> split(set_node<Key> *node, const K &key, const Compare &comp,
+			KeyOf key_of = KeyOf{})
+	{
+		if(nullptr == node)
+			return std::make_tuple(nullptr, nullptr, nullptr);
+
+		auto [left, right] = detach(node);
+
+		if(comp(key, key_of(node->key)))		// everything right of @node stays right
+		{
+			auto [less, found, greater] = split(left, key, comp, key_of);
+			return std::make_tuple(less, found, join(greater, node, right));
+		}
+		else if(comp(key_of(node->key), key))	// everything left of @node stays left
+		{
+			auto [less, found, greater] = split(right, key, comp, key_of);
+			return std::make_tuple(join(left, node, less), found, greater);
+		}
+
+		return std::make_tuple(left, node, right);
+	}
+
+	/*
+	* @brief Splits @node around the node with in-order index @k.
+	*
+	* @param node Root of tree to split, consumed.
+	* @param k Zero based index, must be less than the size of the tree.
+	*
+	* @return std::tuple Tree of the first @k nodes, detached node @k and tree
+	* 		of the nodes after it.
+	*
+	* Like split() but guided by subtree sizes, so it also cuts between
+	* equivalent keys.
+	*/
+	template<typename Key>
+	std::tuple<set_node<Key>*, set_node<Key>*, set_node<Key>*> split_at(set_node<Key> *node, size_t k)
+	{
+		size_t index{node_size(node->left)};
+		auto [left, right] = detach(node);
+
+		if(k < index)
+		{
+			auto [less, found, greater] = split_at(left, k);
+			return std::make_tuple(less, found, join(greater, node, right));
+		}
+		else if(k > index)
+		{
+			auto [less, found, greater] = split_at(right, k - index - 1);
+			return std::make_tuple(join(left, node, less), found, greater);
+		}
+
+		return std::make_tuple(left, node, right);
+	}
+
+	/*
+	* @brief Removes the largest node of a non-empty tree.
+	*
+	* @return std::tuple Remaining tree and the detached largest node.
+	*/
+	template<typename Key>
+	std::tuple<set_node<Key>*, set_node<Key>*> split_last(set_node<Key> *node)
+	{
+		auto [left, right] = detach(node);
+		if(nullptr == right)
+			return std::make_tuple(left, node);
+
+		auto [rest, last] = split_last(right);
+		return std::make_tuple(join(left, node, rest), last);
+	}
+
+	/*
+	* @brief Join without a middle key, every key of @left is less than every key of @right.
+	*/
+	template<typename Key>
+	set_node<Key>* join2(set_node<Key> *left, set_node<Key> *right)
+	{
+		if(nullptr == left)
+		{
+			if(right)
+				right->parent = nullptr;
+			return right;
+		}
+
+		auto [rest, last] = split_last(left);
+		return join(rest, last, right);
+	}
+
+	/*
+	* @brief Runs @left_op and @right_op, on two threads if the subtrees are big enough.
+	*
+	* @param fork Whether @left_op may run on another thread.
+	* @param garbage Nodes to release, @left_op gets its own list when it
+	* 		runs in parallel, which is appended afterwards.
+	*
+	* @return std::tuple Results of @left_op and @right_op.
+	*/
+	template<typename Key, typename LeftOp, typename RightOp>
+	std::tuple<set_node<Key>*, set_node<Key>*> fork_join(bool fork, std::vector<set_node<Key>*> &garbage,
+			LeftOp left_op, RightOp right_op)
+	{
+		if(!fork)
+		{
+			set_node<Key> *left{left_op(garbage)};
+			return std::make_tuple(left, right_op(garbage));
+		}
+
+		std::vector<set_node<Key>*> left_garbage;
+		auto left{std::async(std::launch::async, [&] { return left_op(left_garbage); })};
+		set_node<Key> *right{right_op(garbage)};
+		set_node<Key> *left_root{left.get()};
+
+		garbage.insert(garbage.end(), left_garbage.begin(), left_garbage.end());
+		return std::make_tuple(left_root, right);
+	}
+
+	/*
+	* @brief Moves every node of @node to @garbage.
+	*/
+	template<typename Key>
+	void discard(set_node<Key> *node, std::vector<set_node<Key>*> &garbage)
+	{
+		if(nullptr == node)
+			return;
+
+		discard(node->left, garbage);
+		discard(node->right, garbage);
+		garbage.push_back(node);
+	}
+
+	/*
+	* @brief Join based union of two trees.
+	*
+	* @param a First tree, consumed.
+	* @param b Second tree, consumed.
+	* @param comp Comparator to use.
+	* @param garbage Receives nodes of @b equivalent to a node of @a.
+	* @param depth Number of levels that may still fork.
+	*
+	* @return set_node* Root of the union.
+	*
+	* Work is O(m log(n/m + 1)) for trees of sizes m <= n.
+	*/
+	template<typename Key, typename Compare>
+	set_node<Key>* union_trees(set_node<Key> *a, set_node<Key> *b, const Compare &comp, std::vector<set_node<Key>*> &garbage, int depth)
+	{
+		if(nullptr == a)
+			return b;
+		if(nullptr == b)
+			return a;
+
+		bool fork{depth > 0 && node_height(a) >= parallel_height && node_height(b) >= parallel_height};
+		auto [a_left, a_right] = detach(a);
+		auto [b_left, found, b_right] = split(b, a->key, comp);
+		if(found)
+			garbage.push_back(found);
+
+		auto [left, right] = fork_join<Key>(fork, garbage,
+				[&, a_left = a_left, b_left = b_left](auto &g) { return union_trees(a_left, b_left, comp, g, depth - 1); },
+				[&, a_right = a_right, b_right = b_right](auto &g) { return union_trees(a_right, b_right, comp, g, depth - 1); });
+
+		return join(left, a, right);
+	}
+
+	/*
+	* @brief Join based intersection of two trees.
+	*
+	* @return set_node* Root of the intersection, made of nodes of @a.
+	*
+	* Nodes of @a without an equivalent in @b and all nodes of @b go to @garbage.
+	*/
+	template<typename Key, typename Compare>
+	set_node<Key>* intersect_trees(set_node<Key> *a, set_node<Key> *b, const Compare &comp, std::vector<set_node<Key>*> &garbage, int depth)
+	{
+		if(nullptr == a || nullptr == b)
+		{
+			discard(a, garbage);
+			discard(b, garbage);
+			return nullptr;
+		}
+
+		bool fork{depth > 0 && node_height(a) >= parallel_height && node_height(b) >= parallel_height};
+		auto [a_left, a_right] = detach(a);
+		auto [b_left, found, b_right] = split(b, a->key, comp);
+
+		auto [left, right] = fork_join<Key>(fork, garbage,
+				[&, a_left = a_left, b_left = b_left](auto &g) { return intersect_trees(a_left, b_left, comp, g, depth - 1); },
+				[&, a_right = a_right, b_right = b_right](auto &g) { return intersect_trees(a_right, b_right, comp, g, depth - 1); });
+
+		if(found)
+		{
+			garbage.push_back(found);
+			return join(left, a, right);
+		}
+
+		garbage.push_back(a);
+		return join2(left, right);
+	}
+
+	/*
+	* @brief Join based difference of two trees.
+	*
+	* @return set_node* Root of the nodes of @a without an equivalent in @b.
+	*
+	* All other nodes of both trees go to @garbage.
+	*/
+	template<typename Key, typename Compare>
+	set_node<Key>* difference_trees(set_node<Key> *a, set_node<Key> *b, const Compare &comp, std::vector<set_node<Key>*> &garbage, int depth)
+	{
+		if(nullptr == a || nullptr == b)
+		{
+			discard(b, garbage);
+			return a;
+		}
+
+		bool fork{depth > 0 && node_height(a) >= parallel_height && node_height(b) >= parallel_height};
+		auto [b_left, b_right] = detach(b);
+		auto [a_left, found, a_right] = split(a, b->key, comp);
+		garbage.push_back(b);
+		if(found)
+			garbage.push_back(found);
+
+		auto [left, right] = fork_join<Key>(fork, garbage,
+				[&, a_left = a_left, b_left = b_left](auto &g) { return difference_trees(a_left, b_left, comp, g, depth - 1); },
+				[&, a_right = a_right, b_right = b_right](auto &g) { return difference_trees(a_right, b_right, comp, g, depth - 1); });
+
+		return join2(left, right);
+	}
+
+	/*
+	* @brief Rebuilds the in-order list after one of the *_trees operations.
+	*
+	* @param root Root of the result.
+	* @param a First node of the list of the first tree, both ends nullptr.
+	* @param b First node of the list of the second tree, same.
+	* @param garbage Nodes the operation dropped.
+	* @param end Sentinel closing the list of the result.
+	* @param comp Comparator to use.
+	*
+	* Rotations and joins keep the order of the nodes of either tree, so
+	* dropping @garbage from the two lists leaves two sorted lists holding
+	* the result. The shorter one, S, is spliced into the other at the
+	* predecessors of its nodes in @root (S * logN), or both are merged
+	* (N) when that is cheaper. The shorter list is found by walking both
+	* in step, so intersection and difference, where the second list is
+	* empty, cost O(garbage).
+	*/
+	template<typename Key, typename Compare>
+	void join_threads(set_node<Key> *root, set_node<Key> *a, set_node<Key> *b, const std::vector<set_node<Key>*> &garbage,
+			set_node<Key> *end, const Compare &comp)
+	{
+		for(auto node : garbage)
+		{
+			if(node == a)
+				a = node->next;
+			else if(node == b)
+				b = node->next;
+			unthread(node);
+		}
+
+		size_t shorter{0};
+		set_node<Key> *x{a}, *y{b};
+		for(; x && y; x = x->next, y = y->next)
+			++shorter;
+		if(nullptr == x)
+			std::swap(a, b);								// @b is the shorter list
+
+		set_node<Key> *head{a};
+		if(b && shorter * static_cast<size_t>(node_height(root)) < node_size(root))
+		{
+			while(b)
+			{
+				set_node<Key> *node{b}, *prev{predecessor(node)};
+				b = b->next;
+				if(prev)
+					thread_after(node, prev);
+				else
+				{
+					node->prev = nullptr;
+					node->next = head;
+					head->prev = node;
+					head = node;
+				}
+			}
+		}
+		else if(b)
+		{
+			set_node<Key> *tail{nullptr};
+			head = nullptr;
+			while(a || b)
+			{
+				set_node<Key> *&from{(nullptr == b || (a && comp(a->key, b->key))) ? a : b};
+				set_node<Key> *node{from};
+				from = from->next;
+
+				node->prev = tail;
+				if(tail)
+					tail->next = node;
+				else
+					head = node;
+				tail = node;
+			}
+			tail->next = nullptr;
+		}
+
+		if(nullptr == root)
+		{
+			end->prev = end->next = end;
+			return;
+		}
+
+		set_node<Key> *tail{maximum(root)};
+		head->prev = end;
+		end->next = head;
+		tail->next = end;
+		end->prev = tail;
+	}
+
+} // nested namespace container::avl::detail
+
+#endif // _CONTAINER_SET_JOIN_HPP_
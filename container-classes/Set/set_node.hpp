@@ -15,7 +15,12 @@ namespace containers
 	*
 	* Stores pointer to left and right child whose keys compare
 	* less than and greater than respectively to key.
-	* Also stores parent pointer for iteration purposes.
+	* Also stores parent pointer and the height and number of nodes of the
+	* subtree rooted at the node, which the AVL balancing keeps up to date
+	* so balance factors are O(1) and rank/select queries are logN.
+	* @prev and @next thread the nodes in key order, so iterating is a
+	* single load per step. Rotations keep the order, only linking and
+	* unlinking a node touches them.
 	*/
 	template<typename T>
 	struct set_node
@@ -36,7 +41,10 @@ namespace containers
 
 		// Data
 		T key;
+		int height;									// next to @key, fills its padding for small keys
 		ptr parent, left, right;
+		ptr prev, next;
+		size_t size;
 	};
 	// @@}
 
@@ -50,9 +58,13 @@ namespace containers
 	template<typename T>
 	set_node<T>::set_node(void)
 		:	key{},
+			height{1},
 			parent{nullptr},
 			left{nullptr},
-			right{nullptr}
+			right{nullptr},
+			prev{nullptr},
+			next{nullptr},
+			size{1}
 	{}
 
 	/*
@@ -63,9 +75,13 @@ namespace containers
 	template<typename T>
 	set_node<T>::set_node(const T &key)
 		:	key{key},
+			height{1},
 			parent{nullptr},
 			left{nullptr},
-			right{nullptr}
+			right{nullptr},
+			prev{nullptr},
+			next{nullptr},
+			size{1}
 	{}
 
 	/*
@@ -76,9 +92,13 @@ namespace containers
 	template<typename T>
 	set_node<T>::set_node(T &&key)
 		:	key{std::move(key)},
+			height{1},
 			parent{nullptr},
 			left{nullptr},
-			right{nullptr}
+			right{nullptr},
+			prev{nullptr},
+			next{nullptr},
+			size{1}
 	{}
 
 	/*
@@ -90,9 +110,13 @@ namespace containers
 	template<class ...Args>
 	set_node<T>::set_node(Args &&...args)
 		:	key{std::forward<Args>(args)...},
+			height{1},
 			parent{nullptr},
 			left{nullptr},
-			right{nullptr}
+			right{nullptr},
+			prev{nullptr},
+			next{nullptr},
+			size{1}
 	{}
 	// @}
 
@@ -109,6 +133,10 @@ namespace containers
 		parent = other.parent;
 		left = other.left;
 		right = other.right;
+		prev = other.prev;
+		next = other.next;
+		height = other.height;
+		size = other.size;
 
 		return *this;
 	}
@@ -124,10 +152,16 @@ namespace containers
 		parent = other.parent;
 		left = other.left;
 		right = other.right;
+		prev = other.prev;
+		next = other.next;
+		height = other.height;
+		size = other.size;
 
 		other.parent = nullptr;
 		other.left = nullptr;
 		other.right = nullptr;
+		other.prev = nullptr;
+		other.next = nullptr;
 
 		return *this;
 	}
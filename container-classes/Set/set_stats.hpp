@@ -0,0 +1,212 @@
+// set_detail.hpp includes this header after its helpers, so it goes first
+#include "set_detail.hpp"
+
+#ifndef _CONTAINER_SET_STATS_HPP_
+#define _CONTAINER_SET_STATS_HPP_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "set_node.hpp"
+
+namespace containers
+{
+
+	// Tree Stats declaration:
+	// @@{
+	/*
+	* @brief Shape and memory footprint of a tree, see set::stats().
+	*
+	* Depths count edges from the root, a search ending at a node of depth d
+	* goes through d + 1 nodes. An AVL tree is at most ~1.44 times taller than
+	* @min_height, @average_depth against log2(size) tells how far lookups
+	* are from that in practice.
+	*/
+	struct tree_stats
+	{
+		size_t size{0};						// nodes in the tree
+		int height{0};						// levels, 0 for an empty tree
+		int min_height{0};					// levels of a complete tree with @size nodes
+		int max_depth{0};					// depth of the deepest node, height - 1
+		double average_depth{0};			// mean depth over all nodes
+
+		// Balance factor distribution, nothing else is legal in an AVL tree
+		size_t left_heavy{0};				// left subtree one level taller
+		size_t balanced{0};					// subtrees of equal height
+		size_t right_heavy{0};				// right subtree one level taller
+
+		// Memory
+		size_t node_bytes{0};				// one node
+		size_t used_bytes{0};				// nodes in the tree and the end sentinel
+		size_t reserved_bytes{0};			// node pool slabs (free slots included) and the sentinel
+	};
+	// @@}
+
+} // namespace containers
+
+namespace containers::avl::detail
+{
+
+	/*
+	* @brief Measures the shape of the tree under @root.
+	*
+	* Depths are measured by walking the tree, balance factors come from
+	* the stored heights. Memory fields are left for the container to fill.
+	* Uses a stack instead of recursion, linear in the size of the tree.
+	*/
+	template<typename Key>
+	tree_stats collect_stats(const set_node<Key> *root)
+	{
+		tree_stats ret;
+		if(nullptr == root)
+			return ret;
+
+		size_t depth_sum{0};
+		std::vector<std::pair<const set_node<Key>*, int>> stack{{root, 0}};
+		while(!stack.empty())
+		{
+			auto [node, depth] = stack.back();
+			stack.pop_back();
+
+			++ret.size;
+			depth_sum += depth;
+			ret.max_depth = std::max(ret.max_depth, depth);
+
+			int balance{get_balance_factor(node)};
+			if(balance > 0)
+				++ret.left_heavy;
+			else if(balance < 0)
+				++ret.right_heavy;
+			else
+				++ret.balanced;
+
+			if(node->left)
+				stack.emplace_back(node->left, depth + 1);
+			if(node->right)
+				stack.emplace_back(node->right, depth + 1);
+		}
+
+		ret.height = ret.max_depth + 1;
+		ret.average_depth = static_cast<double>(depth_sum) / ret.size;
+		while((size_t{1} << ret.min_height) - 1 < ret.size)
+			++ret.min_height;
+
+		return ret;
+	}
+
+	/*
+	* @brief Checks the structure of the tree under @root.
+	*
+	* @param root Root of the tree.
+	* @param limit Number of nodes the tree should have, a walk reaching
+	* 		more (e.g. through a cycle) stops there.
+	* @param comp Comparator to use.
+	* @param unique Whether equivalent keys are a violation (false for %multiset).
+	* @param key_of Extracts the key of a node value.
+	*
+	* @return Description of the first broken invariant, nullptr if there is none.
+	*
+	* Checks parent links, stored heights and sizes against the children,
+	* AVL balance, and that an in-order walk sees keys in order. Links are
+	* only followed downwards, so a bad parent pointer is reported rather
+	* than followed. Linear in the size of the tree.
+	*/
+	template<typename Key, typename Compare, typename KeyOf = identity_key>
+	const char* find_violation(const set_node<Key> *root, size_t limit, const Compare &comp, bool unique,
+			KeyOf key_of = KeyOf{})
+	{
+		if(nullptr == root)
+			return 0 == limit ? nullptr : "empty tree, nonzero size";
+		if(root->parent)
+			return "root has a parent";
+
+		// Pre order, so walking it backwards meets children before parents
+		std::vector<const set_node<Key>*> order{root};
+		for(size_t i = 0; i < order.size(); ++i)
+		{
+			if(order.size() > limit)
+				return "more nodes than the size (or a cycle)";
+
+			const set_node<Key> *node{order[i]};
+			for(const set_node<Key> *child : {node->left, node->right})
+				if(child)
+				{
+					if(child->parent != node)
+						return "child does not point back at its parent";
+					order.push_back(child);
+				}
+		}
+		if(order.size() != limit)
+			return "fewer nodes than the size";
+
+		for(auto it = order.rbegin(); it != order.rend(); ++it)
+		{
+			const set_node<Key> *node{*it};
+			if(node->height != 1 + std::max(node_height(node->left), node_height(node->right)))
+				return "stored height does not match the children";
+			if(node->size != 1 + node_size(node->left) + node_size(node->right))
+				return "stored size does not match the children";
+
+			int balance{get_balance_factor(node)};
+			if(balance > 1 || balance < -1)
+				return "balance factor out of [-1, 1]";
+		}
+
+		// In order, every key after the previous one
+		const set_node<Key> *prev{nullptr}, *node{root};
+		std::vector<const set_node<Key>*> stack;
+		while(node || !stack.empty())
+		{
+			for(; node; node = node->left)
+				stack.push_back(node);
+			node = stack.back();
+			stack.pop_back();
+
+			if(prev && comp(key_of(node->key), key_of(prev->key)))
+				return "keys out of order";
+			if(prev && unique && !comp(key_of(prev->key), key_of(node->key)))
+				return "equivalent keys in a unique tree";
+
+			prev = node;
+			node = node->right;
+		}
+
+		return nullptr;
+	}
+
+	/*
+	* @brief Checks the threaded list from @end against the tree under @root.
+	*
+	* @return Description of the first broken invariant, nullptr if there is none.
+	*
+	* The list has to visit the nodes of an in-order walk, in that order,
+	* with matching back links, and close at @end. Assumes the tree itself
+	* passed find_violation().
+	*/
+	template<typename Key>
+	const char* find_thread_violation(const set_node<Key> *root, const set_node<Key> *end)
+	{
+		const set_node<Key> *expected{root ? minimum(const_cast<set_node<Key>*>(root)) : end};
+		const set_node<Key> *node{end->next};
+		if(node->prev != end)
+			return "first node does not link back to the end sentinel";
+
+		while(node != end)
+		{
+			if(node != expected)
+				return "threaded list out of tree order";
+			if(node->next->prev != node)
+				return "threaded list back link broken";
+
+			const set_node<Key> *next{successor(const_cast<set_node<Key>*>(node))};
+			expected = next ? next : end;
+			node = node->next;
+		}
+
+		return expected == end ? nullptr : "threaded list ends early";
+	}
+
+} // nested namespace container::avl::detail
+
+#endif // _CONTAINER_SET_STATS_HPP_
@@ -0,0 +1,197 @@
+/*
+* Stress test of %concurrent_set against a sequential reference.
+*
+* Every round starts from an empty set, so the towers grow while the
+* threads run, the case a pre-filled set never exercises. Each round has
+* two phases:
+* - Every thread inserts and erases keys from a shared narrow range, but
+*   only keys it owns (key % threads), so it can check every result
+*   against its own std::set while still racing with its neighbours on
+*   the same links. Lookups of any key run in between.
+* - All threads insert the same keys, then erase them: exactly one insert
+*   and one erase per key may succeed.
+* After each phase concurrent_set::validate() checks the order on every
+* level, and the contents are compared with the union of the references.
+* Built with sanitizers by `make fuzz`.
+*
+* Usage: concurrent.out [seed [rounds]]. Prints the seed, round and phase
+* of the first mismatch and returns 1.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_set.hpp"
+
+constexpr int threads = 4;
+constexpr size_t operations = 2000;
+constexpr int span = 256;
+
+using tested_type = containers::concurrent_set<int>;
+using reference_type = std::set<int>;
+
+/*
+* Thrown on the first difference, caught in main().
+*/
+struct mismatch : std::runtime_error
+{
+	using std::runtime_error::runtime_error;
+};
+
+void expect(bool ok, const char *what)
+{
+	if(!ok)
+		throw mismatch(what);
+}
+
+/*
+* Checks the invariants of @tested and compares its keys with @reference.
+*/
+void compare(const tested_type &tested, const reference_type &reference)
+{
+	try
+	{
+		tested.validate();
+	}
+	catch(const std::logic_error &e)
+	{
+		throw mismatch(e.what());
+	}
+
+	std::vector<int> keys;
+	tested.for_each([&keys](int key) { keys.push_back(key); });
+	expect(tested.size() == reference.size(), "size");
+	expect(std::equal(keys.begin(), keys.end(), reference.begin(), reference.end()), "contents");
+}
+
+/*
+* Starts @threads threads running @f(thread index) at once and joins them.
+*/
+template<typename F>
+void run_threads(F f)
+{
+	std::atomic<bool> go{false};
+	std::vector<std::thread> workers;
+	for(int t = 0; t < threads; ++t)
+		workers.emplace_back([&go, &f, t]() {
+			while(!go.load())
+				std::this_thread::yield();
+			f(t);
+		});
+
+	go.store(true);
+	for(auto &w : workers)
+		w.join();
+}
+
+/*
+* Owned keys phase, every thread checks the results on its own keys.
+*/
+void owned_phase(tested_type &tested, reference_type &merged, unsigned long seed)
+{
+	std::vector<reference_type> references(threads);
+	std::atomic<bool> ok{true};
+
+	run_threads([&](int t) {
+		std::mt19937 engine{static_cast<std::mt19937::result_type>(seed * threads + t)};
+		reference_type &reference{references[t]};
+
+		for(size_t i = 0; i < operations && ok.load(std::memory_order_relaxed); ++i)
+		{
+			int key{static_cast<int>(engine() % (span / threads)) * threads + t};
+			bool result, expected;
+			switch(engine() % 4)
+			{
+				case 0:
+				case 1:
+					result = tested.insert(key);
+					expected = reference.insert(key).second;
+					break;
+				case 2:
+					result = tested.erase(key);
+					expected = 1 == reference.erase(key);
+					break;
+				default:
+					result = tested.contains(key);
+					expected = 1 == reference.count(key);
+					tested.contains(static_cast<int>(engine() % span));
+					break;
+			}
+
+			if(result != expected)
+				ok.store(false);
+		}
+	});
+
+	expect(ok, "insert, erase or contains result");
+	for(const auto &reference : references)
+		merged.insert(reference.begin(), reference.end());
+	compare(tested, merged);
+}
+
+/*
+* Shared keys phase, every thread inserts then erases the same keys.
+*/
+void shared_phase(tested_type &tested, reference_type &merged)
+{
+	std::atomic<size_t> inserted{0}, erased{0};
+	std::vector<int> keys;
+	for(int key = 0; key < span; ++key)
+		if(0 == merged.count(key))
+			keys.push_back(key);
+
+	run_threads([&](int t) {
+		for(size_t i = 0; i < keys.size(); ++i)
+			inserted += tested.insert(keys[(i + t * keys.size() / threads) % keys.size()]);
+	});
+	expect(inserted == keys.size(), "one insert per shared key");
+	merged.insert(keys.begin(), keys.end());
+	compare(tested, merged);
+
+	run_threads([&](int t) {
+		for(size_t i = 0; i < keys.size(); ++i)
+			erased += tested.erase(keys[(i + t * keys.size() / threads) % keys.size()]);
+	});
+	expect(erased == keys.size(), "one erase per shared key");
+	for(int key : keys)
+		merged.erase(key);
+	compare(tested, merged);
+}
+
+int
+main (int argc, char **argv)
+{
+	unsigned long seed{argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1};
+	size_t rounds{argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100};
+
+	for(size_t r = 0; r < rounds; ++r)
+	{
+		const char *phase{"owned keys"};
+		try
+		{
+			tested_type tested;
+			reference_type merged;
+
+			owned_phase(tested, merged, seed * rounds + r);
+			phase = "shared keys";
+			shared_phase(tested, merged);
+		}
+		catch(const mismatch &e)
+		{
+			std::cout << "concurrent: seed " << seed << ", round " << r << ", " << phase
+				<< ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "concurrent: seed " << seed << ", " << rounds << " rounds of " << threads << " threads, ok" << std::endl;
+
+	return 0;
+}
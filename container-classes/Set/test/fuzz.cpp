@@ -0,0 +1,336 @@
+/*
+* Differential fuzz test of %set against std::set.
+*
+* Applies random operations to a containers::set<int> and a std::set<int>,
+* compares what every operation returns, and compares the contents and
+* runs set::validate() every few operations, so a balancing or threading
+* bug shows up close to the operation that caused it. A second pair of
+* sets takes part in node handle moves, merges and set algebra. Rounds
+* alternate between a narrow key range (many duplicates and erase hits)
+* and a wide one. Built with sanitizers by `make fuzz`.
+*
+* Usage: fuzz.out [seed [rounds]]. Prints the seed, round and operation
+* of the first mismatch and returns 1.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../set.hpp"
+
+constexpr size_t operations = 400;
+constexpr size_t check_every = 16;
+
+using tested_type = containers::set<int>;
+using reference_type = std::set<int>;
+
+/*
+* Thrown on the first difference, caught in main().
+*/
+struct mismatch : std::runtime_error
+{
+	using std::runtime_error::runtime_error;
+};
+
+void expect(bool ok, const char *what)
+{
+	if(!ok)
+		throw mismatch(what);
+}
+
+/*
+* Compares contents both ways and checks the invariants of @tested.
+*/
+void compare(const tested_type &tested, const reference_type &reference)
+{
+	try
+	{
+		tested.validate();
+	}
+	catch(const std::logic_error &e)
+	{
+		throw mismatch(e.what());
+	}
+
+	expect(tested.size() == reference.size(), "size");
+	expect(std::equal(tested.begin(), tested.end(), reference.begin(), reference.end()), "contents");
+	expect(std::equal(tested.rbegin(), tested.rend(), reference.rbegin(), reference.rend()), "reverse contents");
+}
+
+/*
+* One round, @span is the width of the key range.
+*/
+class fuzz_round
+{
+	public:
+		fuzz_round(std::mt19937 &engine, int span)
+			:	engine{engine},
+				span{span}
+		{}
+
+		void run(void)
+		{
+			for(size_t i = 0; i < operations; ++i)
+			{
+				step(engine() % 22);
+				if(0 == i % check_every)
+				{
+					compare(a, ra);
+					compare(b, rb);
+				}
+			}
+
+			compare(a, ra);
+			compare(b, rb);
+		}
+
+		const char *operation{""};
+	private:
+		int key(void) { return static_cast<int>(engine() % static_cast<unsigned>(span)) - span / 2; }
+		size_t index(size_t size) { return engine() % (size + 1); }
+
+		std::vector<int> keys(size_t count)
+		{
+			std::vector<int> ret(count);
+			for(auto &k : ret)
+				k = key();
+			return ret;
+		}
+
+		void step(unsigned choice)
+		{
+			switch(choice)
+			{
+				case 0: case 1: case 2:
+				{
+					operation = "insert";
+					int k{key()};
+					auto [it, inserted] = a.insert(k);
+					expect(inserted == ra.insert(k).second && *it == k, operation);
+					break;
+				}
+				case 3:
+				{
+					operation = "insert with hint";
+					int k{key()};
+					auto it{a.insert(a.lower_bound(key()), k)};
+					ra.insert(k);
+					expect(*it == k, operation);
+					break;
+				}
+				case 4:
+				{
+					operation = "emplace";
+					int k{key()};
+					expect(a.emplace(k).second == ra.emplace(k).second, operation);
+					break;
+				}
+				case 5: case 6:
+				{
+					operation = "erase key";
+					int k{key()};
+					expect(a.erase(k) == ra.erase(k), operation);
+					break;
+				}
+				case 7:
+				{
+					operation = "erase position";
+					size_t i{index(ra.size())};
+					auto it{a.erase(a.nth(i))};
+					auto rit{i < ra.size() ? ra.erase(std::next(ra.begin(), i)) : ra.end()};
+					expect((a.cend() == it) == (ra.end() == rit) && (ra.end() == rit || *it == *rit), operation);
+					break;
+				}
+				case 8:
+				{
+					operation = "erase iterator range";
+					size_t i{index(ra.size())}, j{index(ra.size())};
+					if(i > j)
+						std::swap(i, j);
+					a.erase(a.nth(i), a.nth(j));
+					ra.erase(std::next(ra.begin(), i), std::next(ra.begin(), j));
+					break;
+				}
+				case 9:
+				{
+					operation = "erase_range";
+					int lo{key()}, hi{key()};
+					size_t erased{lo < hi ? static_cast<size_t>(std::distance(ra.lower_bound(lo), ra.lower_bound(hi))) : 0};
+					if(lo < hi)
+						ra.erase(ra.lower_bound(lo), ra.lower_bound(hi));
+					expect(a.erase_range(lo, hi) == erased, operation);
+					break;
+				}
+				case 10:
+				{
+					operation = "extract and insert node handle";
+					int k{key()};
+					auto nh{a.extract(k)};
+					expect(nh.empty() == (0 == ra.erase(k)), operation);
+					if(nh)
+					{
+						auto result{b.insert(std::move(nh))};
+						expect(result.inserted == rb.insert(k).second && result.node.empty() == result.inserted, operation);
+					}
+					break;
+				}
+				case 11:
+				{
+					operation = "merge";
+					a.merge(b);
+					ra.merge(rb);
+					compare(b, rb);
+					break;
+				}
+				case 12:
+				{
+					operation = "insert_sorted";
+					std::vector<int> range{keys(engine() % 64)};
+					std::sort(range.begin(), range.end());
+					a.insert_sorted(range.begin(), range.end());
+					ra.insert(range.begin(), range.end());
+					break;
+				}
+				case 13:
+				{
+					operation = "insert_batch";
+					std::vector<int> range{keys(engine() % 64)};
+					b.insert_batch(range.begin(), range.end());
+					rb.insert(range.begin(), range.end());
+					break;
+				}
+				case 14:
+				{
+					operation = "lookup";
+					int k{key()};
+					expect(a.contains(k) == (0 != ra.count(k)) && a.count(k) == ra.count(k), operation);
+					expect((a.end() == a.find(k)) == (ra.end() == ra.find(k)), operation);
+					auto lb{a.lower_bound(k)};
+					auto ub{a.upper_bound(k)};
+					auto rlb{ra.lower_bound(k)};
+					auto rub{ra.upper_bound(k)};
+					expect((a.end() == lb) == (ra.end() == rlb) && (a.end() == lb || *lb == *rlb), operation);
+					expect((a.end() == ub) == (ra.end() == rub) && (a.end() == ub || *ub == *rub), operation);
+					break;
+				}
+				case 15:
+				{
+					operation = "order statistics";
+					int k{key()}, hi{key()};
+					size_t i{index(ra.size())};
+					expect(a.rank(k) == static_cast<size_t>(std::distance(ra.begin(), ra.lower_bound(k))), operation);
+					expect(i == ra.size() ? a.end() == a.nth(i) : *a.nth(i) == *std::next(ra.begin(), i), operation);
+					size_t inside{k < hi ? static_cast<size_t>(std::distance(ra.lower_bound(k), ra.lower_bound(hi))) : 0};
+					auto view{a.range(k, hi)};
+					expect(a.count_range(k, hi) == inside && view.size() == inside, operation);
+					expect(static_cast<size_t>(std::distance(view.begin(), view.end())) == inside, operation);
+					break;
+				}
+				case 16:
+				{
+					operation = "set algebra";
+					reference_type result;
+					switch(engine() % 3)
+					{
+						case 0:
+							a = set_union(a, b);
+							std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(result, result.end()));
+							break;
+						case 1:
+							a = set_intersection(a, b);
+							std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(result, result.end()));
+							break;
+						default:
+							a = set_difference(a, b);
+							std::set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(result, result.end()));
+					}
+					ra.swap(result);
+					break;
+				}
+				case 17:
+				{
+					operation = "copy and move";
+					tested_type copy{a};
+					compare(copy, ra);
+					a = std::move(copy);
+					expect(copy.empty(), operation);
+					copy.insert(key());										// usable after being moved from
+					break;
+				}
+				case 18:
+				{
+					operation = "swap";
+					a.swap(b);
+					ra.swap(rb);
+					break;
+				}
+				case 19:
+				{
+					operation = "from_sorted";
+					a = tested_type::from_sorted(ra.begin(), ra.end());
+					break;
+				}
+				case 20:
+				{
+					operation = "erase all from the front";
+					size_t count{engine() % 8};
+					for(; count > 0 && !ra.empty(); --count)
+					{
+						a.erase(a.cbegin());
+						ra.erase(ra.begin());
+					}
+					break;
+				}
+				default:
+				{
+					operation = "clear";
+					if(0 == engine() % 8)
+					{
+						a.clear();
+						ra.clear();
+					}
+				}
+			}
+		}
+
+		std::mt19937 &engine;
+		int span;
+		tested_type a, b;
+		reference_type ra, rb;
+};
+
+int
+main (int argc, char **argv)
+{
+	unsigned long seed{argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1};
+	size_t rounds{argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000};
+
+	std::mt19937 engine{static_cast<std::mt19937::result_type>(seed)};
+	for(size_t r = 0; r < rounds; ++r)
+	{
+		int span{0 == r % 2 ? 64 : 1 << 20};
+		fuzz_round current{engine, span};
+		try
+		{
+			current.run();
+		}
+		catch(const mismatch &e)
+		{
+			std::cout << "fuzz: seed " << seed << ", round " << r << ", after " << current.operation
+				<< ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "fuzz: seed " << seed << ", " << rounds << " rounds of " << operations << " operations, ok" << std::endl;
+
+	return 0;
+}
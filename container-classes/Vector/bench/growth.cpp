@@ -0,0 +1,310 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Growth benchmark and leak check for container::vector.
+// Every allocation goes through a counting allocator that remembers the size
+// of each block, so a deallocation with the wrong size or a block that is
+// never given back makes the program exit with 1. Element constructions and
+// destructions are counted the same way. Move assignment between vectors
+// whose allocators compare unequal is checked with allocators that remember
+// which instance made each block.
+// Run with --quick for the sanitizer/valgrind builds.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/pool/pool_alloc.hpp>
+#include "../include/Vector.hpp"
+
+namespace detail
+{
+
+	// <bookkeeping shared by all counting allocators>
+	struct _alloc_stats
+	{
+		static std::map<void*, size_t> _live;
+		static size_t _wrong_size;
+		static size_t _allocations;
+	};
+	std::map<void*, size_t> _alloc_stats::_live{};
+	size_t _alloc_stats::_wrong_size{0};
+	size_t _alloc_stats::_allocations{0};
+
+	// <allocator that checks every deallocation against its allocation>
+	template<typename T, typename Base = std::allocator<T>>
+	struct _counting_allocator : private Base
+	{
+		typedef T value_type;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef T* pointer;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef _counting_allocator<U, typename std::allocator_traits<Base>::template rebind_alloc<U>> other;
+		};
+
+		_counting_allocator() = default;
+		template<typename U, typename B>
+		_counting_allocator(const _counting_allocator<U, B>&) {}
+
+		T* allocate(size_t _n)
+		{
+			T *p{Base::allocate(_n)};
+			_alloc_stats::_live[p] = _n;
+			++_alloc_stats::_allocations;
+			return p;
+		}
+
+		void deallocate(T *_p, size_t _n)
+		{
+			auto it{_alloc_stats::_live.find(_p)};
+			if(_alloc_stats::_live.end() == it || it->second != _n)
+				++_alloc_stats::_wrong_size;
+			else
+				_alloc_stats::_live.erase(it);
+
+			Base::deallocate(_p, _n);
+		}
+
+		bool operator==(const _counting_allocator&) const { return true; }
+		bool operator!=(const _counting_allocator&) const { return false; }
+	};
+
+	// <stateful counting allocator, every default constructed instance is a different arena>
+	template<typename T, bool _propagate>
+	struct _arena_allocator : _counting_allocator<T>
+	{
+		typedef std::integral_constant<bool, _propagate> propagate_on_container_move_assignment;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef _arena_allocator<U, _propagate> other;
+		};
+
+		static std::map<void*, int> _owner;
+		static int _arenas;
+		int _id;
+
+		_arena_allocator() : _id{++_arenas} {}
+		template<typename U>
+		_arena_allocator(const _arena_allocator<U, _propagate> &_a) : _id{_a._id} {}
+
+		T* allocate(size_t _n)
+		{
+			T *p{_counting_allocator<T>::allocate(_n)};
+			_owner[p] = _id;
+			return p;
+		}
+
+		// <a block given back to another arena counts as a wrong deallocation>
+		void deallocate(T *_p, size_t _n)
+		{
+			auto it{_owner.find(_p)};
+			if(_owner.end() == it || it->second != _id)
+				++_alloc_stats::_wrong_size;
+			else
+				_owner.erase(it);
+
+			_counting_allocator<T>::deallocate(_p, _n);
+		}
+
+		bool operator==(const _arena_allocator &_a) const { return _id == _a._id; }
+		bool operator!=(const _arena_allocator &_a) const { return _id != _a._id; }
+	};
+	template<typename T, bool _propagate>
+	std::map<void*, int> _arena_allocator<T, _propagate>::_owner{};
+	template<typename T, bool _propagate>
+	int _arena_allocator<T, _propagate>::_arenas{0};
+
+	// <element that counts how many instances are alive>
+	template<bool _noexcept_move>
+	struct _tracked
+	{
+		static long _alive;
+		static long _throw_after;
+		double _value;
+
+		_tracked(double _v = 0) : _value{_v} { ++_alive; }
+		_tracked(const _tracked &_t) : _value{_t._value}
+		{
+			if(0 == _throw_after--)
+				throw std::runtime_error("copy failed");
+			++_alive;
+		}
+		_tracked(_tracked &&_t) noexcept(_noexcept_move) : _value{_t._value} { ++_alive; }
+		~_tracked() { --_alive; }
+		_tracked& operator=(const _tracked&) = default;
+		_tracked& operator=(_tracked&&) = default;
+	};
+	template<bool _noexcept_move>
+	long _tracked<_noexcept_move>::_alive{0};
+	template<bool _noexcept_move>
+	long _tracked<_noexcept_move>::_throw_after{-1};
+
+}
+
+// <time _f in milliseconds>
+template<typename F>
+double
+measure(F _f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	_f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// <fill a vector with push_back and make sure the contents are right>
+template<typename V>
+double
+push_back_bench(size_t _n)
+{
+	double ret{measure([_n] {
+		V v{};
+		for(size_t i = 0; i < _n; ++i)
+			v.push_back(static_cast<double>(i));
+
+		if(v.size() != _n || v[_n - 1] != static_cast<double>(_n - 1))
+			throw std::logic_error("push_back lost an element");
+	})};
+
+	return ret;
+}
+
+// <growth, copies and erases with counted allocations and elements>
+template<bool _noexcept_move>
+bool
+leak_check(size_t _n)
+{
+	using element = detail::_tracked<_noexcept_move>;
+	using vect = container::vector<element, detail::_counting_allocator<element>>;
+
+	{
+		vect v{};
+		for(size_t i = 0; i < _n; ++i)
+		{
+			v.push_back(element(i));
+			v.push_back(v[i / 2]);
+		}
+
+		vect copy{v};
+		copy = v;
+		copy.insert(copy.begin() + copy.size() / 2, element(-1));
+		copy.erase(copy.begin(), copy.begin() + copy.size() / 3);
+		copy.pop_back();
+		v = std::move(copy);
+
+		// <copies of a moved-from vector and an empty list own no buffer>
+		vect from_moved{copy};
+		vect from_empty(std::initializer_list<element>{});
+		from_moved = vect(std::initializer_list<element>{});
+		from_empty.push_back(element(0));
+
+		v.clear();
+		v.push_back(element(1));
+
+		// <a copy that throws in the middle of a relocation must leave v intact>
+		if(!_noexcept_move)
+		{
+			vect w{};
+			while(w.size() != w.capacity())
+				w.push_back(element(2));
+
+			size_t size{w.size()};
+			element::_throw_after = static_cast<long>(size / 2);
+			try
+			{
+				w.push_back(element(3));
+			}
+			catch(const std::runtime_error&)
+			{}
+			element::_throw_after = -1;
+
+			if(w.size() != size || w[0]._value != 2)
+				return false;
+		}
+	}
+
+	return 0 == element::_alive;
+}
+
+// <move assignment between vectors with different arenas>
+template<bool _propagate>
+bool
+arena_check(size_t _n)
+{
+	using element = detail::_tracked<true>;
+	using vect = container::vector<element, detail::_arena_allocator<element, _propagate>>;
+
+	bool ret{true};
+	{
+		vect v{}, w{}, u{};
+		for(size_t i = 0; i < _n; ++i)
+			w.push_back(element(i));
+
+		v = std::move(w);
+		ret = v.size() == _n && v[_n - 1]._value == static_cast<double>(_n - 1) && w.empty();
+
+		w.push_back(element(1));
+		u = std::move(v);
+		ret = ret && u.size() == _n && v.empty();
+	}
+
+	return ret && 0 == element::_alive;
+}
+
+int
+main(int argc, char **argv)
+{
+	bool quick{argc > 1 && 0 == std::strcmp(argv[1], "--quick")};
+	size_t n{quick ? size_t{100000} : size_t{30000000}};
+
+	bool ok{leak_check<true>(quick ? 1000 : 100000)};
+	std::cout << "elements destroyed (noexcept move):  " << (ok ? "yes" : "NO") << std::endl;
+
+	bool ok_copy{leak_check<false>(quick ? 1000 : 100000)};
+	std::cout << "elements destroyed (throwing move):  " << (ok_copy ? "yes" : "NO") << std::endl;
+
+	bool ok_arena{arena_check<false>(1000) && arena_check<true>(1000)};
+	std::cout << "move between arenas:                 " << (ok_arena ? "yes" : "NO") << std::endl;
+
+	std::cout << "push_back " << n << " doubles:" << std::endl;
+	std::cout << "  container::vector, std::allocator:             "
+		<< push_back_bench<container::vector<double>>(n) << " ms" << std::endl;
+	std::cout << "  std::vector, std::allocator:                   "
+		<< push_back_bench<std::vector<double>>(n) << " ms" << std::endl;
+	std::cout << "  container::vector, boost::pool_allocator:      "
+		<< push_back_bench<container::vector<double, boost::pool_allocator<double>>>(n) << " ms" << std::endl;
+	std::cout << "  container::vector, counting allocator:         "
+		<< push_back_bench<container::vector<double, detail::_counting_allocator<double>>>(n) << " ms" << std::endl;
+
+	size_t lost{detail::_alloc_stats::_live.size()};
+
+	std::cout << "allocations:                         " << detail::_alloc_stats::_allocations << std::endl;
+	std::cout << "wrong size or allocator:             " << detail::_alloc_stats::_wrong_size << std::endl;
+	std::cout << "blocks never deallocated:            " << lost << std::endl;
+
+	return (ok && ok_copy && ok_arena && 0 == lost && 0 == detail::_alloc_stats::_wrong_size) ? 0 : 1;
+}
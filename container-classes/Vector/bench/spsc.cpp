@@ -0,0 +1,240 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Throughput and latency of container::spsc_queue against the mutex protected
+// container::vector hand-off it replaces.
+// Throughput: one thread produces _n integers, the other consumes them, once
+// element by element and once in batches.
+// Latency: two queues bounce a single token back and forth, the round trip
+// time is the average over all bounces.
+// Both sides yield when they have nothing to do so the numbers stay sane on
+// machines with a single core.
+// Run with --quick for a smaller run.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "../include/Vector.hpp"
+#include "../include/SpscQueue.hpp"
+
+// <time _f in milliseconds>
+template<typename F>
+double
+measure(F _f)
+{
+	auto start{std::chrono::steady_clock::now()};
+	_f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// <mutex protected container::vector, the consumer swaps the whole batch out>
+struct locked_vector
+{
+	std::mutex _m;
+	container::vector<size_t> _v;
+};
+
+// <returns the sum of everything consumed>
+size_t
+locked_throughput(size_t _n, size_t _batch)
+{
+	locked_vector shared{};
+	std::thread producer([&] {
+		for(size_t i = 0; i < _n; )
+		{
+			std::lock_guard<std::mutex> lock{shared._m};
+			for(size_t end = std::min(_n, i + _batch); i < end; ++i)
+				shared._v.push_back(i);
+		}
+	});
+
+	size_t sum{0}, consumed{0};
+	container::vector<size_t> local{};
+	while(consumed < _n)
+	{
+		{
+			std::lock_guard<std::mutex> lock{shared._m};
+			local.swap(shared._v);
+		}
+		if(local.empty())
+			std::this_thread::yield();
+
+		for(size_t i = 0; i < local.size(); ++i)
+			sum += local[i];
+		consumed += local.size();
+		local.clear();
+	}
+	producer.join();
+
+	return sum;
+}
+
+size_t
+spsc_throughput(size_t _n, size_t _batch)
+{
+	container::spsc_queue<size_t> q(4096);
+	std::thread producer([&] {
+		size_t buffer[256];
+		for(size_t i = 0; i < _n; )
+		{
+			if(1 == _batch)
+			{
+				if(q.try_push(i))
+					++i;
+				else
+					std::this_thread::yield();
+				continue;
+			}
+
+			size_t n{std::min(_batch, _n - i)};
+			for(size_t j = 0; j < n; ++j)
+				buffer[j] = i + j;
+
+			size_t pushed{q.try_push_n(buffer, n)};
+			if(0 == pushed)
+				std::this_thread::yield();
+			i += pushed;
+		}
+	});
+
+	size_t sum{0}, consumed{0}, buffer[256];
+	while(consumed < _n)
+	{
+		size_t popped{0};
+		if(1 == _batch)
+			popped = q.try_pop(buffer[0]) ? 1 : 0;
+		else
+			popped = q.try_pop_n(buffer, _batch);
+
+		if(0 == popped)
+			std::this_thread::yield();
+
+		for(size_t j = 0; j < popped; ++j)
+			sum += buffer[j];
+		consumed += popped;
+	}
+	producer.join();
+
+	return sum;
+}
+
+// <average round trip in nanoseconds>
+double
+spsc_latency(size_t _rounds)
+{
+	container::spsc_queue<size_t> ping(2), pong(2);
+	std::thread echo([&] {
+		size_t token{0};
+		for(size_t i = 0; i < _rounds; ++i)
+		{
+			while(!ping.try_pop(token))
+				std::this_thread::yield();
+			while(!pong.try_push(token + 1))
+				std::this_thread::yield();
+		}
+	});
+
+	size_t token{0};
+	double ms{measure([&] {
+		for(size_t i = 0; i < _rounds; ++i)
+		{
+			while(!ping.try_push(token))
+				std::this_thread::yield();
+			while(!pong.try_pop(token))
+				std::this_thread::yield();
+		}
+	})};
+	echo.join();
+
+	return (token == _rounds) ? ms * 1e6 / _rounds : -1;
+}
+
+double
+locked_latency(size_t _rounds)
+{
+	locked_vector ping{}, pong{};
+	auto send{[](locked_vector &_l, size_t _t) {
+		std::lock_guard<std::mutex> lock{_l._m};
+		_l._v.push_back(_t);
+	}};
+	auto receive{[](locked_vector &_l, size_t &_t) {
+		std::lock_guard<std::mutex> lock{_l._m};
+		if(_l._v.empty())
+			return false;
+		_t = _l._v.back();
+		_l._v.pop_back();
+		return true;
+	}};
+
+	std::thread echo([&] {
+		size_t token{0};
+		for(size_t i = 0; i < _rounds; ++i)
+		{
+			while(!receive(ping, token))
+				std::this_thread::yield();
+			send(pong, token + 1);
+		}
+	});
+
+	size_t token{0};
+	double ms{measure([&] {
+		for(size_t i = 0; i < _rounds; ++i)
+		{
+			send(ping, token);
+			while(!receive(pong, token))
+				std::this_thread::yield();
+		}
+	})};
+	echo.join();
+
+	return (token == _rounds) ? ms * 1e6 / _rounds : -1;
+}
+
+int
+main(int argc, char **argv)
+{
+	bool quick{argc > 1 && 0 == std::strcmp(argv[1], "--quick")};
+	size_t n{quick ? size_t{1000000} : size_t{20000000}};
+	size_t rounds{quick ? size_t{10000} : size_t{200000}};
+	size_t expected{n * (n - 1) / 2};
+	bool ok{true};
+
+	auto report{[&](const char *_name, size_t (*_f)(size_t, size_t), size_t _batch) {
+		size_t sum{0};
+		double ms{measure([&] { sum = _f(n, _batch); })};
+		ok = ok && expected == sum;
+		std::cout << _name << ms << " ms, " << (n / ms / 1000) << " M elements/s" << std::endl;
+	}};
+
+	std::cout << "throughput, " << n << " elements:" << std::endl;
+	report("  mutex + container::vector, batch 1:    ", locked_throughput, 1);
+	report("  mutex + container::vector, batch 256:  ", locked_throughput, 256);
+	report("  spsc_queue, try_push/try_pop:          ", spsc_throughput, 1);
+	report("  spsc_queue, try_push_n/try_pop_n 256:  ", spsc_throughput, 256);
+
+	double locked{locked_latency(rounds)}, spsc{spsc_latency(rounds)};
+	ok = ok && 0 < locked && 0 < spsc;
+	std::cout << "round trip latency, " << rounds << " rounds:" << std::endl;
+	std::cout << "  mutex + container::vector:             " << locked << " ns" << std::endl;
+	std::cout << "  spsc_queue:                            " << spsc << " ns" << std::endl;
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
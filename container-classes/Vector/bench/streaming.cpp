@@ -0,0 +1,96 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Streaming benchmark for container::vector.
+// Compares scans through container::vector::iterator with for_each_streaming()
+// and std::fill/std::copy with fill_nt()/copy_nt() on 30M doubles (240MB per
+// vector). The pointer range versions are used so the stores stream even on
+// machines whose last level cache is larger than the buffers.
+// Run with --quick for a smaller run.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "../include/Vector.hpp"
+#include "../include/Streaming.hpp"
+
+// <time _f in milliseconds, best of _runs>
+template<typename F>
+double
+measure(F _f, size_t _runs = 5)
+{
+	double best{0};
+	for(size_t i = 0; i < _runs; ++i)
+	{
+		auto start{std::chrono::steady_clock::now()};
+		_f();
+		double t{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()};
+		if(0 == i || t < best)
+			best = t;
+	}
+
+	return best;
+}
+
+int
+main(int argc, char **argv)
+{
+	bool quick{argc > 1 && 0 == std::strcmp(argv[1], "--quick")};
+	size_t n{quick ? size_t{1000000} : size_t{30000000}};
+
+	container::vector<double> src(n, 1.0), dst(n, 0.0);
+	double *b{src.data()}, *e{src.data() + n};
+	double sum{0};
+	bool ok{true};
+
+	std::cout << n << " doubles, streaming threshold " << (container::streaming_threshold() >> 20) << " MB:" << std::endl;
+
+	std::cout << "  sum, container::vector::iterator:   "
+		<< measure([&] {
+			sum = 0;
+			for(auto it = src.begin(); it != src.end(); ++it)
+				sum += *it;
+		}) << " ms" << std::endl;
+	ok = ok && static_cast<double>(n) == sum;
+
+	std::cout << "  sum, for_each_streaming:            "
+		<< measure([&] {
+			sum = 0;
+			container::for_each_streaming(b, e, [&sum](double _d) { sum += _d; });
+		}) << " ms" << std::endl;
+	ok = ok && static_cast<double>(n) == sum;
+
+	std::cout << "  fill, std::fill:                    "
+		<< measure([&] { std::fill(dst.data(), dst.data() + n, 2.0); }) << " ms" << std::endl;
+	std::cout << "  fill, fill_nt:                      "
+		<< measure([&] { container::fill_nt(dst.data(), dst.data() + n, 3.0); }) << " ms" << std::endl;
+	ok = ok && std::all_of(dst.data(), dst.data() + n, [](double _d) { return 3.0 == _d; });
+
+	std::cout << "  copy, std::copy:                    "
+		<< measure([&] { std::copy(b, e, dst.data()); }) << " ms" << std::endl;
+	ok = ok && std::equal(b, e, dst.data());
+
+	container::fill_nt(dst, 0.0);
+	std::cout << "  copy, copy_nt:                      "
+		<< measure([&] { container::copy_nt(b, e, dst.data()); }) << " ms" << std::endl;
+	ok = ok && std::equal(b, e, dst.data());
+
+	std::cout << "results match: " << (ok ? "yes" : "NO") << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Descritption in main.cpp
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _BIT_VECTOR_TEST_HPP_
+#define _BIT_VECTOR_TEST_HPP_
+
+#include <vector>
+#include <random>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "../include/BitVector.hpp"
+
+// <TestFixture class declaration>
+template<
+		typename A = std::allocator<std::uint64_t>,
+		size_t _size = 1000000
+		>
+class bit_vector_test_fixture : public CppUnit::TestFixture
+{
+	public:
+		void setUp();
+		void tearDown();
+	private:
+		// <add bit_vector_test_fixture<A, _size> to CppUnit::TestSuite>
+		CPPUNIT_TEST_SUITE(bit_vector_test_fixture);
+
+		// <test methods>
+		CPPUNIT_TEST(push_back_test);
+		CPPUNIT_TEST(resize_test);
+		CPPUNIT_TEST(count_test);
+		CPPUNIT_TEST(bitwise_test);
+		CPPUNIT_TEST(rank_select_test);
+
+		CPPUNIT_TEST_SUITE_END();
+		// </add>
+
+		// <tester functions>
+		void push_back_test(void);
+		void resize_test(void);
+		void count_test(void);
+		void bitwise_test(void);
+		void rank_select_test(void);
+		// </tester functions>
+
+		// <fill _bv and _ref with the same random bits>
+		void generate(container::bit_vector<A> &_bv, std::vector<bool> &_ref);
+
+		// <local variables to use durring testing>
+		std::mt19937_64 _engine;
+		container::bit_vector<A> *_bv1, *_bv2;
+		std::vector<bool> _ref1, _ref2;
+		// </variables>
+};
+// </declaration>
+
+// <convenience aliases>
+using def_bit_vect = bit_vector_test_fixture<std::allocator<std::uint64_t>, 1000000>;
+// </convenience aliases>
+
+// <registration>
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(def_bit_vect, "bit_vector, allocator=std::allocator<std::uint64_t>, size=1,000,000");
+// </registration>
+
+// <TestFixture class implementation>
+
+// <initializer functions>
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::setUp()
+{
+	_engine.seed(std::random_device{}());
+	_bv1 = new container::bit_vector<A>;
+	_bv2 = new container::bit_vector<A>;
+	generate(*_bv1, _ref1);
+	generate(*_bv2, _ref2);
+}
+
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::tearDown()
+{
+	delete _bv1;
+	delete _bv2;
+	_ref1.clear();
+	_ref2.clear();
+}
+
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::generate(container::bit_vector<A> &_bv, std::vector<bool> &_ref)
+{
+	// <vary the density so sparse and dense words both get exercised>
+	std::bernoulli_distribution bit{std::uniform_real_distribution<double>{0.01, 0.99}(_engine)};
+	for(size_t i = 0; i < _size; ++i)
+	{
+		bool b{bit(_engine)};
+		_bv.push_back(b);
+		_ref.push_back(b);
+	}
+}
+// </initializer functions>
+
+// <tester functions>
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::push_back_test(void)
+{
+	CPPUNIT_ASSERT_MESSAGE("push_back - size", _bv1->size() == _ref1.size());
+	CPPUNIT_ASSERT_MESSAGE("push_back - words", _bv1->num_words() == (_size + 63) / 64);
+
+	bool equal{true};
+	for(size_t i = 0; i < _size; ++i)
+		equal = equal && ((*_bv1)[i] == _ref1[i]);
+	CPPUNIT_ASSERT_MESSAGE("push_back - contents", equal);
+
+	for(size_t i = 0; i < 100; ++i)
+	{
+		_bv1->pop_back();
+		_ref1.pop_back();
+	}
+	CPPUNIT_ASSERT_MESSAGE("pop_back - size", _bv1->size() == _ref1.size());
+	CPPUNIT_ASSERT_MESSAGE("pop_back - count",
+			_bv1->count() == static_cast<size_t>(std::count(_ref1.begin(), _ref1.end(), true)));
+}
+
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::resize_test(void)
+{
+	_bv1->resize(_size / 2 + 3);
+	_ref1.resize(_size / 2 + 3);
+	_bv1->resize(_size + 77, true);
+	_ref1.resize(_size + 77, true);
+
+	bool equal{true};
+	for(size_t i = 0; i < _ref1.size(); ++i)
+		equal = equal && (_bv1->test(i) == _ref1[i]);
+
+	CPPUNIT_ASSERT_MESSAGE("resize - size", _bv1->size() == _ref1.size());
+	CPPUNIT_ASSERT_MESSAGE("resize - contents", equal);
+}
+
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::count_test(void)
+{
+	size_t expected = std::count(_ref1.begin(), _ref1.end(), true);
+	CPPUNIT_ASSERT_MESSAGE("count", _bv1->count() == expected);
+
+	_bv1->flip();
+	CPPUNIT_ASSERT_MESSAGE("count - flip", _bv1->count() == _size - expected);
+
+	_bv1->set();
+	CPPUNIT_ASSERT_MESSAGE("count - set", _bv1->count() == _size && _bv1->all());
+
+	_bv1->reset();
+	CPPUNIT_ASSERT_MESSAGE("count - reset", 0 == _bv1->count() && _bv1->none());
+}
+
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::bitwise_test(void)
+{
+	container::bit_vector<A> v_and{*_bv1 & *_bv2}, v_or{*_bv1 | *_bv2}, v_xor{*_bv1 ^ *_bv2}, v_andnot{*_bv1};
+	v_andnot.and_not(*_bv2);
+
+	bool equal{true};
+	for(size_t i = 0; i < _size; ++i)
+	{
+		equal = equal && (v_and[i] == (_ref1[i] && _ref2[i]));
+		equal = equal && (v_or[i] == (_ref1[i] || _ref2[i]));
+		equal = equal && (v_xor[i] == (_ref1[i] != _ref2[i]));
+		equal = equal && (v_andnot[i] == (_ref1[i] && !_ref2[i]));
+	}
+
+	CPPUNIT_ASSERT_MESSAGE("bitwise - contents", equal);
+}
+
+template<typename A, size_t _size>
+void
+bit_vector_test_fixture<A, _size>::rank_select_test(void)
+{
+	std::vector<size_t> ones;
+	for(size_t i = 0; i < _size; ++i)
+		if(_ref1[i])
+			ones.push_back(i);
+
+	// <rank and select must agree with and without the index>
+	for(int indexed = 0; indexed < 2; ++indexed)
+	{
+		if(indexed)
+			_bv1->build_index();
+
+		bool rank_ok{true}, select_ok{true};
+		for(size_t i = 0; i <= _size; i += 1 + indexed * 16)
+			rank_ok = rank_ok && (_bv1->rank(i) == static_cast<size_t>(std::lower_bound(ones.begin(), ones.end(), i) - ones.begin()));
+
+		for(size_t k = 0; k < ones.size(); k += 1 + (1 - indexed) * 16)
+			select_ok = select_ok && (_bv1->select(k) == ones[k]);
+
+		CPPUNIT_ASSERT_MESSAGE("rank", rank_ok);
+		CPPUNIT_ASSERT_MESSAGE("select", select_ok);
+		CPPUNIT_ASSERT_MESSAGE("select - out of range", _bv1->select(ones.size()) == _bv1->size());
+	}
+
+	(*_bv1)[0].flip();
+	CPPUNIT_ASSERT_MESSAGE("index invalidated by write", !_bv1->indexed());
+}
+// </tester functions>
+
+// </implementation>
+
+#endif /* #ifndef _BIT_VECTOR_TEST_HPP_ */
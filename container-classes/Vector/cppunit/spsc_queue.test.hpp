@@ -0,0 +1,185 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Descritption in main.cpp
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _SPSC_QUEUE_TEST_HPP_
+#define _SPSC_QUEUE_TEST_HPP_
+
+#include <thread>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "../include/SpscQueue.hpp"
+
+// <TestFixture class declaration>
+template<
+		size_t _capacity = 1024,
+		size_t _count = 1000000
+		>
+class spsc_queue_test_fixture : public CppUnit::TestFixture
+{
+	public:
+		void setUp();
+		void tearDown();
+	private:
+		// <add spsc_queue_test_fixture<_capacity, _count> to CppUnit::TestSuite>
+		CPPUNIT_TEST_SUITE(spsc_queue_test_fixture);
+
+		// <test methods>
+		CPPUNIT_TEST(fifo_test);
+		CPPUNIT_TEST(batch_test);
+		CPPUNIT_TEST(threaded_test);
+
+		CPPUNIT_TEST_SUITE_END();
+		// </add>
+
+		// <tester functions>
+		void fifo_test(void);
+		void batch_test(void);
+		void threaded_test(void);
+		// </tester functions>
+
+		// <local variables to use durring testing>
+		container::spsc_queue<size_t> *_q;
+		// </variables>
+};
+// </declaration>
+
+// <convenience aliases>
+using def_spsc_queue = spsc_queue_test_fixture<1000, 1000000>;
+// </convenience aliases>
+
+// <registration>
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(def_spsc_queue, "spsc_queue, value_type=size_t, capacity=1,024, count=1,000,000");
+// </registration>
+
+// <TestFixture class implementation>
+
+// <initializer functions>
+template<size_t _capacity, size_t _count>
+void
+spsc_queue_test_fixture<_capacity, _count>::setUp()
+{
+	_q = new container::spsc_queue<size_t>(_capacity);
+}
+
+template<size_t _capacity, size_t _count>
+void
+spsc_queue_test_fixture<_capacity, _count>::tearDown()
+{
+	delete _q;
+}
+// </initializer functions>
+
+// <tester functions>
+template<size_t _capacity, size_t _count>
+void
+spsc_queue_test_fixture<_capacity, _count>::fifo_test(void)
+{
+	CPPUNIT_ASSERT_MESSAGE("capacity - power of two",
+			_q->capacity() >= _capacity && 0 == (_q->capacity() & (_q->capacity() - 1)));
+
+	size_t out{0}, next{0}, expected{0};
+	CPPUNIT_ASSERT_MESSAGE("try_pop - empty", !_q->try_pop(out));
+
+	// <go around the buffer a few times so the indices wrap>
+	for(size_t round = 0; round < 4; ++round)
+	{
+		while(_q->try_push(next))
+			++next;
+		CPPUNIT_ASSERT_MESSAGE("try_push - full", _q->size_approx() == _q->capacity());
+
+		for(size_t i = 0; i < _q->capacity() / 2 + round; ++i)
+		{
+			CPPUNIT_ASSERT(_q->try_pop(out));
+			CPPUNIT_ASSERT_MESSAGE("try_pop - order", out == expected++);
+		}
+	}
+
+	while(_q->try_pop(out))
+		CPPUNIT_ASSERT_MESSAGE("try_pop - order", out == expected++);
+	CPPUNIT_ASSERT_MESSAGE("try_pop - everything popped", expected == next && _q->empty_approx());
+}
+
+template<size_t _capacity, size_t _count>
+void
+spsc_queue_test_fixture<_capacity, _count>::batch_test(void)
+{
+	std::vector<size_t> in(_q->capacity() + 100), out(_q->capacity() + 100);
+	for(size_t i = 0; i < in.size(); ++i)
+		in[i] = i;
+
+	CPPUNIT_ASSERT_MESSAGE("try_push_n - stops when full", _q->try_push_n(in.begin(), in.size()) == _q->capacity());
+	CPPUNIT_ASSERT_MESSAGE("try_pop_n - partial", _q->try_pop_n(out.begin(), 10) == 10);
+	CPPUNIT_ASSERT_MESSAGE("try_push_n - refills", _q->try_push_n(in.begin() + _q->capacity(), 100) == 10);
+
+	size_t popped{_q->try_pop_n(out.begin() + 10, out.size())};
+	CPPUNIT_ASSERT_MESSAGE("try_pop_n - stops when empty", popped == _q->capacity());
+	CPPUNIT_ASSERT_MESSAGE("try_pop_n - contents",
+			std::equal(in.begin(), in.begin() + _q->capacity() + 10, out.begin()));
+}
+
+template<size_t _capacity, size_t _count>
+void
+spsc_queue_test_fixture<_capacity, _count>::threaded_test(void)
+{
+	std::thread producer([this] {
+		size_t batch[64];
+		for(size_t i = 0; i < _count; )
+		{
+			if(i % 3)
+			{
+				if(_q->try_push(i))
+					++i;
+				else
+					std::this_thread::yield();
+				continue;
+			}
+
+			size_t n{std::min<size_t>(64, _count - i)};
+			for(size_t j = 0; j < n; ++j)
+				batch[j] = i + j;
+
+			size_t pushed{_q->try_push_n(batch, n)};
+			if(0 == pushed)
+				std::this_thread::yield();
+			i += pushed;
+		}
+	});
+
+	bool ordered{true};
+	size_t expected{0}, batch[64];
+	while(expected < _count)
+	{
+		size_t popped{_q->try_pop_n(batch, 64)};
+		if(0 == popped)
+			std::this_thread::yield();
+
+		for(size_t j = 0; j < popped; ++j)
+			ordered = ordered && batch[j] == expected++;
+	}
+	producer.join();
+
+	CPPUNIT_ASSERT_MESSAGE("threads - order", ordered);
+	CPPUNIT_ASSERT_MESSAGE("threads - drained", _q->empty_approx());
+}
+// </tester functions>
+
+// </implementation>
+
+#endif /* #ifndef _SPSC_QUEUE_TEST_HPP_ */
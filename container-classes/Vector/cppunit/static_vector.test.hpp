@@ -0,0 +1,211 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Descritption in main.cpp
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _STATIC_VECTOR_TEST_HPP_
+#define _STATIC_VECTOR_TEST_HPP_
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "../include/StaticVector.hpp"
+#include "./vector.test.hpp"
+
+// <compile time checks>
+namespace detail
+{
+
+	// <lookup table of the first N squares, filled with push_back at compile time>
+	template<size_t N>
+	constexpr container::static_vector<unsigned, N> _squares()
+	{
+		container::static_vector<unsigned, N> ret{};
+		for(unsigned i = 0; i < N; ++i)
+			ret.push_back(i * i);
+
+		return ret;
+	}
+
+	constexpr auto _table{_squares<16>()};
+	static_assert(_table.size() == 16, "static_vector - constexpr push_back");
+	static_assert(_table[15] == 225 && _table.back() == 225, "static_vector - constexpr contents");
+	static_assert(*(_table.end() - 2) == 196, "static_vector - constexpr iterators");
+
+	constexpr container::static_vector<int, 4> _erased()
+	{
+		container::static_vector<int, 4> ret{1, 2, 3, 4};
+		ret.erase(ret.begin() + 1);
+		ret.insert(ret.begin(), 0);
+		return ret;
+	}
+	static_assert(_erased()[0] == 0 && _erased()[1] == 1 && _erased()[2] == 3 && _erased().size() == 4,
+			"static_vector - constexpr insert/erase");
+
+	// <NOTE: pushing a fifth element here, or building _squares<16> into a
+	//  static_vector<unsigned, 8>, fails to compile>
+
+}
+
+// <TestFixture class declaration>
+template<
+		typename T,
+		size_t _capacity = 4096,
+		typename _element_generator = detail::_rand_gen
+		>
+class static_vector_test_fixture : public CppUnit::TestFixture
+{
+	public:
+		void setUp();
+		void tearDown();
+	private:
+		// <add static_vector_test_fixture<T, _capacity, _element_generator> to CppUnit::TestSuite>
+		CPPUNIT_TEST_SUITE(static_vector_test_fixture);
+
+		// <test methods>
+		CPPUNIT_TEST(push_back_test);
+		CPPUNIT_TEST(overflow_test);
+		CPPUNIT_TEST(insert_erase_test);
+		CPPUNIT_TEST(swap_test);
+
+		CPPUNIT_TEST_SUITE_END();
+		// </add>
+
+		// <tester functions>
+		void push_back_test(void);
+		void overflow_test(void);
+		void insert_erase_test(void);
+		void swap_test(void);
+		// </tester functions>
+
+		// <local variables to use durring testing>
+		container::static_vector<T, _capacity> *_v1;
+		std::vector<T> _ref;
+		// </variables>
+};
+// </declaration>
+
+// <convenience aliases>
+using def_static_vect = static_vector_test_fixture<double, 4096>;
+// </convenience aliases>
+
+// <registration>
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(def_static_vect, "static_vector, value_type=double, capacity=4096");
+// </registration>
+
+// <TestFixture class implementation>
+
+// <initializer functions>
+template<typename T, size_t _capacity, typename _element_generator>
+void
+static_vector_test_fixture<T, _capacity, _element_generator>::setUp()
+{
+	_element_generator gen{};
+	_v1 = new container::static_vector<T, _capacity>;
+	for(size_t i = 0; i < _capacity / 2; ++i)
+	{
+		T tmp(gen());
+		_v1->push_back(tmp);
+		_ref.push_back(tmp);
+	}
+}
+
+template<typename T, size_t _capacity, typename _element_generator>
+void
+static_vector_test_fixture<T, _capacity, _element_generator>::tearDown()
+{
+	delete _v1;
+	_ref.clear();
+}
+// </initializer functions>
+
+// <tester functions>
+template<typename T, size_t _capacity, typename _element_generator>
+void
+static_vector_test_fixture<T, _capacity, _element_generator>::push_back_test(void)
+{
+	CPPUNIT_ASSERT_MESSAGE("push_back - size", _v1->size() == _ref.size());
+	CPPUNIT_ASSERT_MESSAGE("push_back - contents", std::equal(_v1->begin(), _v1->end(), _ref.begin()));
+	CPPUNIT_ASSERT_MESSAGE("push_back - reverse contents", std::equal(_v1->rbegin(), _v1->rend(), _ref.rbegin()));
+
+	_v1->pop_back();
+	_ref.pop_back();
+	CPPUNIT_ASSERT_MESSAGE("pop_back - contents",
+			_v1->size() == _ref.size() && std::equal(_v1->cbegin(), _v1->cend(), _ref.begin()));
+}
+
+template<typename T, size_t _capacity, typename _element_generator>
+void
+static_vector_test_fixture<T, _capacity, _element_generator>::overflow_test(void)
+{
+	while(!_v1->full())
+		_v1->push_back(T{});
+
+	bool thrown{false};
+	try
+	{
+		_v1->push_back(T{});
+	}
+	catch(const std::length_error&)
+	{
+		thrown = true;
+	}
+
+	CPPUNIT_ASSERT_MESSAGE("overflow - throws", thrown);
+	CPPUNIT_ASSERT_MESSAGE("overflow - size unchanged", _v1->size() == _capacity);
+}
+
+template<typename T, size_t _capacity, typename _element_generator>
+void
+static_vector_test_fixture<T, _capacity, _element_generator>::insert_erase_test(void)
+{
+	std::mt19937 gen{std::random_device{}()};
+	for(size_t i = 0; i < 100; ++i)
+	{
+		std::uniform_int_distribution<size_t> pos_gen(0, _ref.size() - 1);
+		size_t pos{pos_gen(gen)};
+		_v1->insert(_v1->begin() + pos, _v1->at(_v1->size() - 1 - pos));
+		_ref.insert(_ref.begin() + pos, _ref.at(_ref.size() - 1 - pos));
+
+		pos = pos_gen(gen);
+		_v1->erase(_v1->begin() + pos, _v1->begin() + pos + 2);
+		_ref.erase(_ref.begin() + pos, _ref.begin() + pos + 2);
+	}
+
+	CPPUNIT_ASSERT_MESSAGE("insert/erase - size", _v1->size() == _ref.size());
+	CPPUNIT_ASSERT_MESSAGE("insert/erase - contents", std::equal(_v1->begin(), _v1->end(), _ref.begin()));
+}
+
+template<typename T, size_t _capacity, typename _element_generator>
+void
+static_vector_test_fixture<T, _capacity, _element_generator>::swap_test(void)
+{
+	container::static_vector<T, _capacity> other(3, T{});
+	_v1->swap(other);
+
+	CPPUNIT_ASSERT_MESSAGE("swap - sizes", _v1->size() == 3 && other.size() == _ref.size());
+	CPPUNIT_ASSERT_MESSAGE("swap - contents", std::equal(other.begin(), other.end(), _ref.begin()));
+	CPPUNIT_ASSERT_MESSAGE("swap - find", _v1->end() != _v1->find(T{}));
+}
+// </tester functions>
+
+// </implementation>
+
+#endif /* #ifndef _STATIC_VECTOR_TEST_HPP_ */
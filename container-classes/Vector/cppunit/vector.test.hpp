@@ -89,6 +89,7 @@ class vector_test_fixture : public CppUnit::TestFixture
 		CPPUNIT_TEST(copy_assignment_test);
 		CPPUNIT_TEST(move_assignment_test);
 		CPPUNIT_TEST(push_back_test);
+		CPPUNIT_TEST(reserve_test);
 		CPPUNIT_TEST(pop_back_test);
 		CPPUNIT_TEST(swap_test);
 		CPPUNIT_TEST(clear_test);
@@ -115,6 +116,7 @@ class vector_test_fixture : public CppUnit::TestFixture
 
 		// <data access/modification>
 		void push_back_test(void);
+		void reserve_test(void);
 		void pop_back_test(void);
 		void swap_test(void);
 		void clear_test(void);
@@ -326,6 +328,32 @@ vector_test_fixture<T, A, _size, _element_generator, _BinaryPredicate>::push_bac
 			std::equal(_v1->begin(), _v1->end(), std_vect.begin(), _BinaryPredicate{}));
 }
 
+template<
+		typename T,
+		typename A,
+		size_t _size,
+		typename _element_generator,
+		typename _BinaryPredicate
+		>
+void
+vector_test_fixture<T, A, _size, _element_generator, _BinaryPredicate>::reserve_test(void)
+{
+	std::generate(_v2->begin(), _v2->end(), _element_generator{});
+	_v1->reserve(_size);
+	CPPUNIT_ASSERT_MESSAGE("reserve - capacity", _v1->capacity() >= _size);
+
+	typename container::vector<T, A>::size_type capacity{_v1->capacity()};
+	for(size_t i = 0; i < _size; ++i)
+		_v1->push_back(_v2->at(i));
+
+	CPPUNIT_ASSERT_MESSAGE("reserve - no reallocation", _v1->capacity() == capacity);
+	CPPUNIT_ASSERT_MESSAGE("reserve - contents",
+			std::equal(_v1->begin(), _v1->end(), _v2->begin(), _BinaryPredicate{}));
+
+	_v1->clear();
+	CPPUNIT_ASSERT_MESSAGE("clear - capacity kept", _v1->capacity() == capacity);
+}
+
 template<
 		typename T,
 		typename A,
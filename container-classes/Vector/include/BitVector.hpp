@@ -0,0 +1,698 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// A packed vector of bits stored in 64-bit words.
+// Flags take one bit each instead of one byte, count() is a popcount over
+// the words and the bitwise operators work a whole word at a time, so the
+// compiler vectorizes them.
+// After build_index() rank() and select() are answered from a table of
+// cumulative counts kept for every 512 bits (8 words), which costs about
+// 12.5% on top of the bits themselves.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _BIT_VECTOR_HPP_
+#define _BIT_VECTOR_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace container
+{
+
+// <declaration>
+	template <typename A = std::allocator<std::uint64_t>>
+	class bit_vector
+	{
+		public:
+			// <typedefs>
+			typedef A allocator_type;
+			typedef std::uint64_t word_type;
+			typedef std::size_t size_type;
+			typedef bool value_type;
+			typedef bool const_reference;
+			// </typedefs>
+
+			// <constants>
+			static constexpr size_type word_bits = 64;
+			static constexpr size_type block_words = 8;
+			static constexpr size_type block_bits = word_bits * block_words;
+			// </constants>
+
+			// <reference - inner class>
+			class reference
+			{
+				public:
+					// <friends>
+					friend class bit_vector<A>;
+					// </friends>
+
+					// <assignment operators>
+					reference& operator=(bool _b);
+					reference& operator=(const reference &_r);
+					// </assignment operators>
+
+					// <conversion>
+					operator bool() const;
+					// </conversion>
+
+					void flip();
+				private:
+					reference(word_type *_w, word_type _m, bool *_i);
+
+					word_type *_word;
+					word_type _mask;
+					bool *_indexed;
+			};
+			// </reference - inner class>
+
+			// <constructors>
+			bit_vector(const size_type &_s = 0, bool _b = false);
+			bit_vector(const bit_vector<A> &_v);
+			bit_vector(bit_vector<A> &&_v);
+			~bit_vector();
+			// </constructors>
+
+			// <assignment operators>
+			bit_vector<A>& operator=(const bit_vector<A> &_v);
+			bit_vector<A>& operator=(bit_vector<A> &&_v);
+			// </assignment operators>
+
+			// <data access/modification>
+			void push_back(bool _b);
+			void pop_back(void);
+			void resize(const size_type &_s, bool _b = false);
+			void swap(bit_vector<A> &_v);
+			void clear(void);
+			bool test(const size_type &_p) const;
+			void set(const size_type &_p, bool _b = true);
+			void reset(const size_type &_p);
+			void flip(const size_type &_p);
+			void set(void);
+			void reset(void);
+			void flip(void);
+			inline reference operator[](const size_type &_p) { return reference{_data + _p / word_bits, word_type{1} << (_p % word_bits), &_indexed}; }
+			inline const_reference operator[](const size_type &_p) const { return test(_p); }
+			// </data access/modification>
+
+			// <bitwise operations>
+			bit_vector<A>& operator&=(const bit_vector<A> &_v);
+			bit_vector<A>& operator|=(const bit_vector<A> &_v);
+			bit_vector<A>& operator^=(const bit_vector<A> &_v);
+			bit_vector<A>& and_not(const bit_vector<A> &_v);
+			// </bitwise operations>
+
+			// <queries>
+			size_type count(void) const;
+			bool any(void) const;
+			bool none(void) const;
+			bool all(void) const;
+			// </queries>
+
+			// <rank/select>
+			void build_index(void);
+			size_type rank(const size_type &_p) const;
+			size_type select(const size_type &_k) const;
+			inline bool indexed(void) const { return _indexed; }
+			// </rank/select>
+
+			inline size_type size(void) const { return _size; }
+			inline bool empty(void) const { return (0 == _size) ? true : false; }
+			inline size_type num_words(void) const { return _words(_size); }
+			inline word_type* data(void) { return _data; }
+			inline const word_type* data(void) const { return _data; }
+
+		private:
+			// <helpers>
+			static inline size_type _words(const size_type &_s) { return (_s + word_bits - 1) / word_bits; }
+			static inline size_type _popcount(word_type _w) { return __builtin_popcountll(_w); }
+			static size_type _select_in_word(word_type _w, size_type _k);
+			void _reserve(const size_type &_w);
+			void _clear_tail(void);
+			// </helpers>
+
+			// <data>
+			allocator_type _allocator;
+			word_type *_data;
+			size_type _size;
+			size_type _alloc;
+			size_type *_rank;
+			size_type _rank_alloc;
+			bool _indexed;
+			// </data>
+	};
+// </declaration>
+
+// <implementation>
+
+// <reference implementation>
+
+	// <constructor>
+	template <typename A>
+	bit_vector<A>::reference::reference(word_type *_w, word_type _m, bool *_i)
+	:_word{_w},_mask{_m},_indexed{_i}
+	{}
+
+	// <assign bit>
+	template <typename A>
+	typename bit_vector<A>::reference&
+	bit_vector<A>::reference::operator=(bool _b)
+	{
+		if(_b)
+			*_word |= _mask;
+		else
+			*_word &= ~_mask;
+
+		*_indexed = false;
+		return *this;
+	}
+
+	// <assign from other bit>
+	template <typename A>
+	typename bit_vector<A>::reference&
+	bit_vector<A>::reference::operator=(const reference &_r)
+	{
+		return *this = static_cast<bool>(_r);
+	}
+
+	// <conversion>
+	template <typename A>
+	bit_vector<A>::reference::operator bool() const
+	{
+		return 0 != (*_word & _mask);
+	}
+
+	// <flip>
+	template <typename A>
+	void
+	bit_vector<A>::reference::flip()
+	{
+		*_word ^= _mask;
+		*_indexed = false;
+	}
+
+// </reference implementation>
+
+
+// <bit_vector - implementation>
+
+	// <constructors>
+
+	// <default constructor>
+	template <typename A>
+	bit_vector<A>::bit_vector(const size_type &_s, bool _b)
+	:_allocator{},_data{nullptr},_size{0},_alloc{0},_rank{nullptr},_rank_alloc{0},_indexed{false}
+	{
+		resize(_s, _b);
+	}
+
+	// <copy constructor>
+	template <typename A>
+	bit_vector<A>::bit_vector(const bit_vector<A> &_v)
+	:_allocator{_v._allocator},_data{nullptr},_size{0},_alloc{0},_rank{nullptr},_rank_alloc{0},_indexed{false}
+	{
+		_reserve(_v.num_words());
+		std::copy(_v._data, _v._data + _v.num_words(), _data);
+		_size = _v._size;
+	}
+
+	// <move constructor>
+	template <typename A>
+	bit_vector<A>::bit_vector(bit_vector<A> &&_v)
+	:_allocator{std::move(_v._allocator)},_data{_v._data},_size{_v._size},_alloc{_v._alloc},
+	 _rank{_v._rank},_rank_alloc{_v._rank_alloc},_indexed{_v._indexed}
+	{
+		_v._data = nullptr;
+		_v._rank = nullptr;
+		_v._size = _v._alloc = _v._rank_alloc = 0;
+		_v._indexed = false;
+	}
+
+	// <deconstructor>
+	template <typename A>
+	bit_vector<A>::~bit_vector()
+	{
+		if(_alloc)
+			_allocator.deallocate(_data, _alloc);
+
+		if(_rank_alloc)
+		{
+			typename std::allocator_traits<A>::template rebind_alloc<size_type> rank_allocator{_allocator};
+			rank_allocator.deallocate(_rank, _rank_alloc);
+		}
+	}
+	// </constructors>
+
+	// <assignment operators>
+
+	// <copy assignment>
+	template <typename A>
+	bit_vector<A>&
+	bit_vector<A>::operator=(const bit_vector<A> &_v)
+	{
+		if(this != &_v)
+		{
+			bit_vector<A> tmp{_v};
+			swap(tmp);
+		}
+
+		return *this;
+	}
+
+	// <move assignment>
+	template <typename A>
+	bit_vector<A>&
+	bit_vector<A>::operator=(bit_vector<A> &&_v)
+	{
+		bit_vector<A> tmp{std::move(_v)};
+		swap(tmp);
+
+		return *this;
+	}
+	// </assignment operators>
+
+	// <data access/modification>
+	template <typename A>
+	void
+	bit_vector<A>::push_back(bool _b)
+	{
+		if(_size == _alloc * word_bits)
+			_reserve(std::max<size_type>(_alloc + _alloc / 2, _alloc + 1));
+
+		if(0 == _size % word_bits)
+			_data[_size / word_bits] = 0;
+
+		++_size;
+		set(_size - 1, _b);
+	}
+
+	template <typename A>
+	void
+	bit_vector<A>::pop_back(void)
+	{
+		--_size;
+		_clear_tail();
+		_indexed = false;
+	}
+
+	// <resize>
+	template <typename A>
+	void
+	bit_vector<A>::resize(const size_type &_s, bool _b)
+	{
+		size_type old_words{num_words()}, new_words{_words(_s)};
+		_reserve(new_words);
+
+		if(_s > _size)
+		{
+			// <fill the rest of the last partial word, then whole words>
+			if(_size % word_bits)
+			{
+				word_type tail_mask{~word_type{0} << (_size % word_bits)};
+				if(_b)
+					_data[old_words - 1] |= tail_mask;
+				else
+					_data[old_words - 1] &= ~tail_mask;
+			}
+
+			std::fill(_data + old_words, _data + new_words, _b ? ~word_type{0} : word_type{0});
+		}
+
+		_size = _s;
+		_clear_tail();
+		_indexed = false;
+	}
+
+	// <swap>
+	template <typename A>
+	void
+	bit_vector<A>::swap(bit_vector<A> &_v)
+	{
+		std::swap(_allocator, _v._allocator);
+		std::swap(_data, _v._data);
+		std::swap(_size, _v._size);
+		std::swap(_alloc, _v._alloc);
+		std::swap(_rank, _v._rank);
+		std::swap(_rank_alloc, _v._rank_alloc);
+		std::swap(_indexed, _v._indexed);
+	}
+
+	// <clear>
+	template <typename A>
+	void
+	bit_vector<A>::clear(void)
+	{
+		_size = 0;
+		_indexed = false;
+	}
+
+	// <single bit access>
+	template <typename A>
+	bool
+	bit_vector<A>::test(const size_type &_p) const
+	{
+		return 0 != (_data[_p / word_bits] >> (_p % word_bits) & 1);
+	}
+
+	template <typename A>
+	void
+	bit_vector<A>::set(const size_type &_p, bool _b)
+	{
+		word_type mask{word_type{1} << (_p % word_bits)};
+		if(_b)
+			_data[_p / word_bits] |= mask;
+		else
+			_data[_p / word_bits] &= ~mask;
+
+		_indexed = false;
+	}
+
+	template <typename A>
+	void
+	bit_vector<A>::reset(const size_type &_p)
+	{
+		set(_p, false);
+	}
+
+	template <typename A>
+	void
+	bit_vector<A>::flip(const size_type &_p)
+	{
+		_data[_p / word_bits] ^= word_type{1} << (_p % word_bits);
+		_indexed = false;
+	}
+
+	// <whole vector access>
+	template <typename A>
+	void
+	bit_vector<A>::set(void)
+	{
+		std::fill(_data, _data + num_words(), ~word_type{0});
+		_clear_tail();
+		_indexed = false;
+	}
+
+	template <typename A>
+	void
+	bit_vector<A>::reset(void)
+	{
+		std::fill(_data, _data + num_words(), word_type{0});
+		_indexed = false;
+	}
+
+	template <typename A>
+	void
+	bit_vector<A>::flip(void)
+	{
+		for(size_type i = 0, n = num_words(); i < n; ++i)
+			_data[i] = ~_data[i];
+
+		_clear_tail();
+		_indexed = false;
+	}
+	// </data access/modification>
+
+	// <bitwise operations>
+	// <NOTE: the operand is treated as zero extended or truncated to size() of *this,
+	//  the loops below are plain word loops so they are vectorized at -O2/-O3>
+	template <typename A>
+	bit_vector<A>&
+	bit_vector<A>::operator&=(const bit_vector<A> &_v)
+	{
+		size_type n{num_words()}, common{std::min(n, _v.num_words())};
+		word_type *lhs{_data};
+		const word_type *rhs{_v._data};
+
+		for(size_type i = 0; i < common; ++i)
+			lhs[i] &= rhs[i];
+		std::fill(lhs + common, lhs + n, word_type{0});
+
+		_clear_tail();
+		_indexed = false;
+		return *this;
+	}
+
+	template <typename A>
+	bit_vector<A>&
+	bit_vector<A>::operator|=(const bit_vector<A> &_v)
+	{
+		size_type common{std::min(num_words(), _v.num_words())};
+		word_type *lhs{_data};
+		const word_type *rhs{_v._data};
+
+		for(size_type i = 0; i < common; ++i)
+			lhs[i] |= rhs[i];
+
+		_clear_tail();
+		_indexed = false;
+		return *this;
+	}
+
+	template <typename A>
+	bit_vector<A>&
+	bit_vector<A>::operator^=(const bit_vector<A> &_v)
+	{
+		size_type common{std::min(num_words(), _v.num_words())};
+		word_type *lhs{_data};
+		const word_type *rhs{_v._data};
+
+		for(size_type i = 0; i < common; ++i)
+			lhs[i] ^= rhs[i];
+
+		_clear_tail();
+		_indexed = false;
+		return *this;
+	}
+
+	// <clears every bit that is set in _v>
+	template <typename A>
+	bit_vector<A>&
+	bit_vector<A>::and_not(const bit_vector<A> &_v)
+	{
+		size_type common{std::min(num_words(), _v.num_words())};
+		word_type *lhs{_data};
+		const word_type *rhs{_v._data};
+
+		for(size_type i = 0; i < common; ++i)
+			lhs[i] &= ~rhs[i];
+
+		_indexed = false;
+		return *this;
+	}
+	// </bitwise operations>
+
+	// <queries>
+	template <typename A>
+	typename bit_vector<A>::size_type
+	bit_vector<A>::count(void) const
+	{
+		size_type ret{0};
+		for(size_type i = 0, n = num_words(); i < n; ++i)
+			ret += _popcount(_data[i]);
+
+		return ret;
+	}
+
+	template <typename A>
+	bool
+	bit_vector<A>::any(void) const
+	{
+		for(size_type i = 0, n = num_words(); i < n; ++i)
+			if(_data[i])
+				return true;
+
+		return false;
+	}
+
+	template <typename A>
+	bool
+	bit_vector<A>::none(void) const
+	{
+		return !any();
+	}
+
+	template <typename A>
+	bool
+	bit_vector<A>::all(void) const
+	{
+		return count() == _size;
+	}
+	// </queries>
+
+	// <rank/select>
+
+	// <build cumulative counts, one entry per 512 bits plus the total>
+	template <typename A>
+	void
+	bit_vector<A>::build_index(void)
+	{
+		size_type n{num_words()}, blocks{n / block_words + 1};
+		typename std::allocator_traits<A>::template rebind_alloc<size_type> rank_allocator{_allocator};
+
+		if(_rank_alloc < blocks + 1)
+		{
+			if(_rank_alloc)
+				rank_allocator.deallocate(_rank, _rank_alloc);
+
+			_rank_alloc = blocks + 1;
+			_rank = rank_allocator.allocate(_rank_alloc);
+		}
+
+		size_type total{0};
+		for(size_type b = 0; b < blocks; ++b)
+		{
+			_rank[b] = total;
+			for(size_type i = b * block_words, e = std::min(n, i + block_words); i < e; ++i)
+				total += _popcount(_data[i]);
+		}
+		_rank[blocks] = total;
+
+		_indexed = true;
+	}
+
+	// <number of set bits in [0, _p)>
+	template <typename A>
+	typename bit_vector<A>::size_type
+	bit_vector<A>::rank(const size_type &_p) const
+	{
+		size_type word{_p / word_bits}, ret{0}, i{0};
+
+		if(_indexed)
+		{
+			ret = _rank[word / block_words];
+			i = word / block_words * block_words;
+		}
+
+		for(; i < word; ++i)
+			ret += _popcount(_data[i]);
+
+		if(_p % word_bits)
+			ret += _popcount(_data[word] & ~(~word_type{0} << (_p % word_bits)));
+
+		return ret;
+	}
+
+	// <position of the set bit with rank _k (0 based), or size() if there is none>
+	template <typename A>
+	typename bit_vector<A>::size_type
+	bit_vector<A>::select(const size_type &_k) const
+	{
+		size_type n{num_words()}, word{0}, remaining{_k};
+
+		if(_indexed)
+		{
+			size_type blocks{n / block_words + 1};
+			if(_k >= _rank[blocks])
+				return _size;
+
+			// <last block whose cumulative count is not greater than _k>
+			size_type block = std::upper_bound(_rank, _rank + blocks, _k) - _rank - 1;
+			remaining -= _rank[block];
+			word = block * block_words;
+		}
+
+		for(; word < n; ++word)
+		{
+			size_type ones{_popcount(_data[word])};
+			if(remaining < ones)
+				return word * word_bits + _select_in_word(_data[word], remaining);
+
+			remaining -= ones;
+		}
+
+		return _size;
+	}
+	// </rank/select>
+
+	// <helpers>
+
+	// <position of the _k-th set bit inside _w>
+	template <typename A>
+	typename bit_vector<A>::size_type
+	bit_vector<A>::_select_in_word(word_type _w, size_type _k)
+	{
+#ifdef __BMI2__
+		return __builtin_ctzll(_pdep_u64(word_type{1} << _k, _w));
+#else
+		for(; _k; --_k)
+			_w &= _w - 1;
+
+		return __builtin_ctzll(_w);
+#endif
+	}
+
+	// <make room for at least _w words>
+	template <typename A>
+	void
+	bit_vector<A>::_reserve(const size_type &_w)
+	{
+		if(_w <= _alloc)
+			return;
+
+		word_type *tmp{_allocator.allocate(_w)};
+		std::copy(_data, _data + num_words(), tmp);
+
+		if(_alloc)
+			_allocator.deallocate(_data, _alloc);
+
+		_data = tmp;
+		_alloc = _w;
+	}
+
+	// <keep the unused bits of the last word zero so whole word operations stay exact>
+	template <typename A>
+	void
+	bit_vector<A>::_clear_tail(void)
+	{
+		if(_size % word_bits)
+			_data[_size / word_bits] &= ~(~word_type{0} << (_size % word_bits));
+	}
+	// </helpers>
+
+// </bit_vector - implementation>
+
+// <non-member bitwise operators>
+	template <typename A>
+	bit_vector<A>
+	operator&(bit_vector<A> _l, const bit_vector<A> &_r)
+	{
+		return _l &= _r;
+	}
+
+	template <typename A>
+	bit_vector<A>
+	operator|(bit_vector<A> _l, const bit_vector<A> &_r)
+	{
+		return _l |= _r;
+	}
+
+	template <typename A>
+	bit_vector<A>
+	operator^(bit_vector<A> _l, const bit_vector<A> &_r)
+	{
+		return _l ^= _r;
+	}
+// </non-member bitwise operators>
+
+// </implementation>
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. The slots live in a container::vector that is allocated once, with
+// the capacity rounded up to a power of two so an index maps to a slot with a
+// mask instead of a division.
+// The head (consumer) and tail (producer) counters sit on their own cache
+// lines, next to the copy of the other side's counter that the owning thread
+// last saw. A thread only reloads the other counter when the cached one says
+// the queue is full (producer) or empty (consumer), so most operations touch
+// no shared cache line besides the slot itself.
+// NOTE: T has to be default constructible, the slots are constructed up front
+// and assigned to on push.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _SPSC_QUEUE_HPP_
+#define _SPSC_QUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include "Vector.hpp"
+
+namespace container
+{
+
+// <declaration>
+	template <typename T, typename A = std::allocator<T>>
+	class spsc_queue
+	{
+		public:
+			// <typedefs>
+			typedef std::size_t size_type;
+			typedef T value_type;
+			typedef A allocator_type;
+			// </typedefs>
+
+			// <constants>
+			static constexpr size_type cache_line = 64;
+			// </constants>
+
+			// <constructors>
+			explicit spsc_queue(const size_type &_capacity = 1024);
+			spsc_queue(const spsc_queue&) = delete;
+			spsc_queue& operator=(const spsc_queue&) = delete;
+			// </constructors>
+
+			// <producer side>
+			bool try_push(const T &_t);
+			bool try_push(T &&_t);
+			template <typename It>
+			size_type try_push_n(It _first, const size_type &_n);
+			// </producer side>
+
+			// <consumer side>
+			bool try_pop(T &_t);
+			template <typename It>
+			size_type try_pop_n(It _out, const size_type &_n);
+			// </consumer side>
+
+			// <capacity>
+			inline size_type capacity(void) const { return _mask + 1; }
+			size_type size_approx(void) const;
+			inline bool empty_approx(void) const { return 0 == size_approx(); }
+			// </capacity>
+		private:
+			// <private functions>
+			static size_type _round_up(size_type _n);
+			template <typename U>
+			bool _push(U &&_u);
+			// </private functions>
+
+			// <shared, read only after construction>
+			vector<T, A> _buffer;
+			size_type _mask;
+			// </shared>
+
+			// <consumer cache line>
+			alignas(cache_line) std::atomic<size_type> _head;
+			size_type _tail_cache;
+			// </consumer cache line>
+
+			// <producer cache line>
+			alignas(cache_line) std::atomic<size_type> _tail;
+			size_type _head_cache;
+			// </producer cache line>
+	};
+// </declaration>
+
+// <implementation>
+
+	// <constructor>
+	template <typename T, typename A>
+	spsc_queue<T, A>::spsc_queue(const size_type &_capacity)
+	:_buffer(_round_up(_capacity)),_mask{_round_up(_capacity) - 1},_head{0},_tail_cache{0},_tail{0},_head_cache{0}
+	{}
+	// </constructor>
+
+	// <producer side>
+	template <typename T, typename A>
+	bool
+	spsc_queue<T, A>::try_push(const T &_t)
+	{
+		return _push(_t);
+	}
+
+	template <typename T, typename A>
+	bool
+	spsc_queue<T, A>::try_push(T &&_t)
+	{
+		return _push(std::move(_t));
+	}
+
+	// <pushes up to _n elements from _first, returns how many were pushed>
+	template <typename T, typename A>
+	template <typename It>
+	typename spsc_queue<T, A>::size_type
+	spsc_queue<T, A>::try_push_n(It _first, const size_type &_n)
+	{
+		const size_type tail{_tail.load(std::memory_order_relaxed)};
+		size_type free{capacity() - (tail - _head_cache)};
+		if(free < _n)
+		{
+			_head_cache = _head.load(std::memory_order_acquire);
+			free = capacity() - (tail - _head_cache);
+		}
+
+		const size_type count{std::min(free, _n)};
+		for(size_type i = 0; i < count; ++i, ++_first)
+			_buffer[(tail + i) & _mask] = *_first;
+
+		// <one release store publishes the whole batch>
+		_tail.store(tail + count, std::memory_order_release);
+		return count;
+	}
+	// </producer side>
+
+	// <consumer side>
+	template <typename T, typename A>
+	bool
+	spsc_queue<T, A>::try_pop(T &_t)
+	{
+		const size_type head{_head.load(std::memory_order_relaxed)};
+		if(head == _tail_cache)
+		{
+			_tail_cache = _tail.load(std::memory_order_acquire);
+			if(head == _tail_cache)
+				return false;
+		}
+
+		_t = std::move(_buffer[head & _mask]);
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// <pops up to _n elements into _out, returns how many were popped>
+	template <typename T, typename A>
+	template <typename It>
+	typename spsc_queue<T, A>::size_type
+	spsc_queue<T, A>::try_pop_n(It _out, const size_type &_n)
+	{
+		const size_type head{_head.load(std::memory_order_relaxed)};
+		size_type available{_tail_cache - head};
+		if(available < _n)
+		{
+			_tail_cache = _tail.load(std::memory_order_acquire);
+			available = _tail_cache - head;
+		}
+
+		const size_type count{std::min(available, _n)};
+		for(size_type i = 0; i < count; ++i, ++_out)
+			*_out = std::move(_buffer[(head + i) & _mask]);
+
+		_head.store(head + count, std::memory_order_release);
+		return count;
+	}
+	// </consumer side>
+
+	// <capacity>
+	// <NOTE: only exact when neither side is running>
+	template <typename T, typename A>
+	typename spsc_queue<T, A>::size_type
+	spsc_queue<T, A>::size_approx(void) const
+	{
+		const size_type head{_head.load(std::memory_order_acquire)};
+		const size_type tail{_tail.load(std::memory_order_acquire)};
+		return (tail > head) ? tail - head : 0;
+	}
+	// </capacity>
+
+	// <private functions>
+	template <typename T, typename A>
+	typename spsc_queue<T, A>::size_type
+	spsc_queue<T, A>::_round_up(size_type _n)
+	{
+		size_type ret{2};
+		while(ret < _n)
+			ret <<= 1;
+
+		return ret;
+	}
+
+	template <typename T, typename A>
+	template <typename U>
+	bool
+	spsc_queue<T, A>::_push(U &&_u)
+	{
+		const size_type tail{_tail.load(std::memory_order_relaxed)};
+		if(tail - _head_cache == capacity())
+		{
+			_head_cache = _head.load(std::memory_order_acquire);
+			if(tail - _head_cache == capacity())
+				return false;
+		}
+
+		_buffer[tail & _mask] = std::forward<U>(_u);
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+	// </private functions>
+
+// </implementation>
+
+}
+
+#endif
@@ -0,0 +1,510 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// A vector with a fixed capacity N stored inline, so it never touches the heap.
+// The member and iterator interface follows container::vector, and everything
+// is constexpr so lookup tables can be filled at compile time.
+// Going over capacity throws std::length_error, which inside a constant
+// expression is a compile-time error instead of a reallocation.
+// NOTE: all N slots are value-initialized up front (that is what C++17
+// constexpr allows), so T has to be default constructible and popped
+// elements are reset to T{} rather than destroyed.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _STATIC_VECTOR_HPP_
+#define _STATIC_VECTOR_HPP_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace container
+{
+
+// <declaration>
+	template <typename T, std::size_t N>
+	class static_vector
+	{
+		public:
+			// <typedefs>
+			typedef std::size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef T value_type;
+			typedef T& reference;
+			typedef const T& const_reference;
+			typedef T* pointer;
+			typedef const T* const_pointer;
+			// </typedefs>
+
+			// <iterator - inner class>
+			class iterator
+			{
+				public:
+					// <typedefs>
+					typedef std::random_access_iterator_tag iterator_category;
+					typedef T value_type;
+					typedef T& reference;
+					typedef T* pointer;
+					typedef std::ptrdiff_t difference_type;
+					// </typedefs>
+
+					// <friends>
+					friend class static_vector<T, N>;
+					// </friends>
+
+					// <constructors>
+					constexpr iterator(T *_p = nullptr) : _current{_p} {}
+					// </constructors>
+
+					// <iteratrion functions>
+					constexpr iterator& next() { ++_current; return *this; }
+					constexpr iterator& prev() { --_current; return *this; }
+					// </iteration functions>
+
+					// <relation operators>
+					constexpr bool operator==(const iterator &_it) const { return _current == _it._current; }
+					constexpr bool operator!=(const iterator &_it) const { return _current != _it._current; }
+					constexpr bool operator<(const iterator &_it) const { return _current < _it._current; }
+					constexpr bool operator<=(const iterator &_it) const { return _current <= _it._current; }
+					constexpr bool operator>(const iterator &_it) const { return _current > _it._current; }
+					constexpr bool operator>=(const iterator &_it) const { return _current >= _it._current; }
+					// </relation operators>
+
+					// <increment operators>
+					constexpr iterator& operator++() { return next(); }
+					constexpr iterator operator++(int) { iterator ret{*this}; next(); return ret; }
+					constexpr iterator& operator--() { return prev(); }
+					constexpr iterator operator--(int) { iterator ret{*this}; prev(); return ret; }
+					constexpr iterator operator+(const difference_type &_d) const { return iterator{_current + _d}; }
+					constexpr iterator& operator+=(const difference_type &_d) { _current += _d; return *this; }
+					constexpr iterator operator-(const difference_type &_d) const { return iterator{_current - _d}; }
+					constexpr iterator& operator-=(const difference_type &_d) { _current -= _d; return *this; }
+					constexpr difference_type operator-(const iterator &_it) const { return _current - _it._current; }
+					// </increment operators>
+
+					// <reference operators>
+					constexpr reference operator*() const { return *_current; }
+					constexpr pointer operator->() const { return _current; }
+					constexpr reference operator[](const difference_type &_d) const { return _current[_d]; }
+					// </reference operators>
+				private:
+					pointer _current;
+			};
+			// </iterator - inner class>
+
+			// <const_iterator - inner class>
+			class const_iterator
+			{
+				public:
+					// <typedefs>
+					typedef std::random_access_iterator_tag iterator_category;
+					typedef T value_type;
+					typedef const T& reference;
+					typedef const T* pointer;
+					typedef std::ptrdiff_t difference_type;
+					// </typedefs>
+
+					// <constructors>
+					constexpr const_iterator(const T *_p = nullptr) : _current{_p} {}
+					constexpr const_iterator(const iterator &_it) : _current{_it._current} {}
+					// </constructors>
+
+					// <iteration functions>
+					constexpr const_iterator& next() { ++_current; return *this; }
+					constexpr const_iterator& prev() { --_current; return *this; }
+					// </iteration functions>
+
+					// <relation operators>
+					constexpr bool operator==(const const_iterator &_it) const { return _current == _it._current; }
+					constexpr bool operator!=(const const_iterator &_it) const { return _current != _it._current; }
+					constexpr bool operator<(const const_iterator &_it) const { return _current < _it._current; }
+					constexpr bool operator<=(const const_iterator &_it) const { return _current <= _it._current; }
+					constexpr bool operator>(const const_iterator &_it) const { return _current > _it._current; }
+					constexpr bool operator>=(const const_iterator &_it) const { return _current >= _it._current; }
+					// </relation operators>
+
+					// <increment operators>
+					constexpr const_iterator& operator++() { return next(); }
+					constexpr const_iterator operator++(int) { const_iterator ret{*this}; next(); return ret; }
+					constexpr const_iterator& operator--() { return prev(); }
+					constexpr const_iterator operator--(int) { const_iterator ret{*this}; prev(); return ret; }
+					constexpr const_iterator operator+(const difference_type &_d) const { return const_iterator{_current + _d}; }
+					constexpr const_iterator& operator+=(const difference_type &_d) { _current += _d; return *this; }
+					constexpr const_iterator operator-(const difference_type &_d) const { return const_iterator{_current - _d}; }
+					constexpr const_iterator& operator-=(const difference_type &_d) { _current -= _d; return *this; }
+					constexpr difference_type operator-(const const_iterator &_it) const { return _current - _it._current; }
+					// </increment operators>
+
+					// <reference operators>
+					constexpr reference operator*() const { return *_current; }
+					constexpr pointer operator->() const { return _current; }
+					constexpr reference operator[](const difference_type &_d) const { return _current[_d]; }
+					// </reference operators>
+				private:
+					pointer _current;
+			};
+			// </const_iterator - inner class>
+
+			// <reverse iterators>
+			typedef std::reverse_iterator<iterator> reverse_iterator;
+			typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+			// </reverse iterators>
+
+			// <constructors>
+			constexpr static_vector();
+			constexpr static_vector(const size_type &_s, const T &_t = T());
+			constexpr static_vector(const static_vector<T, N> &_v);
+			constexpr static_vector(static_vector<T, N> &&_v);
+			constexpr static_vector(const std::initializer_list<T> &_l);
+			// </constructors>
+
+			// <assignment operators>
+			constexpr static_vector<T, N>& operator=(const static_vector<T, N> &_v);
+			constexpr static_vector<T, N>& operator=(static_vector<T, N> &&_v);
+			constexpr static_vector<T, N>& operator=(const std::initializer_list<T> &_l);
+			// </assignment operators>
+
+			// <data access/modification>
+			constexpr void push_back(const T &_t = T());
+			constexpr void push_back(T &&_t);
+			template <typename... Args>
+			constexpr reference emplace_back(Args &&..._args);
+			constexpr void pop_back(void);
+			constexpr const_reference front(void) const { return _data[0]; }
+			constexpr const_reference back(void) const { return _data[_size - 1]; }
+			constexpr void swap(static_vector<T, N> &_v);
+			constexpr void clear(void);
+			constexpr iterator find(const T &_t);
+			constexpr const_iterator find(const T &_t) const;
+			constexpr reference operator[](const size_type &_p) { return _data[_p]; }
+			constexpr reference at(const size_type &_p) { return _data[_p]; }
+			constexpr const_reference operator[](const size_type &_p) const { return _data[_p]; }
+			constexpr const_reference at(const size_type &_p) const { return _data[_p]; }
+			constexpr pointer data(void) { return _data; }
+			constexpr const_pointer data(void) const { return _data; }
+			// </data access/modification>
+
+			// <iterators>
+			// <forward iterators>
+			constexpr iterator begin() { return iterator{_data}; }
+			constexpr const_iterator begin() const { return const_iterator{_data}; }
+			constexpr const_iterator cbegin() const { return const_iterator{_data}; }
+			constexpr iterator end() { return iterator{_data + _size}; }
+			constexpr const_iterator end() const { return const_iterator{_data + _size}; }
+			constexpr const_iterator cend() const { return const_iterator{_data + _size}; }
+			// <reverse iterators>
+			constexpr reverse_iterator rbegin() { return reverse_iterator{end()}; }
+			constexpr const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+			constexpr const_reverse_iterator crbegin() const { return const_reverse_iterator{cend()}; }
+			constexpr reverse_iterator rend() { return reverse_iterator{begin()}; }
+			constexpr const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+			constexpr const_reverse_iterator crend() const { return const_reverse_iterator{cbegin()}; }
+			// <structure modification>
+			constexpr iterator insert(const_iterator _it, const T &_t);
+			constexpr iterator insert(const_iterator _it, T &&_t);
+			constexpr iterator erase(const_iterator _it);
+			constexpr iterator erase(const_iterator _b, const_iterator _e);
+			// </iterators>
+
+			constexpr size_type size(void) const { return _size; }
+			static constexpr size_type capacity(void) { return N; }
+			static constexpr size_type max_size(void) { return N; }
+			constexpr bool empty() const { return (0 == _size) ? true : false; }
+			constexpr bool full() const { return (N == _size) ? true : false; }
+
+		private:
+			// <growth is not possible, so running out of room is an error>
+			constexpr void _check_room(const size_type &_n) const;
+			constexpr iterator _insert(const size_type &_p, T &&_t);
+
+			// <data>
+			T _data[N ? N : 1];
+			size_type _size;
+			// </data>
+	};
+// </declaration>
+
+// <implementation>
+
+	// <constructors>
+
+	// <default constructor>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>::static_vector()
+	:_data{},_size{0}
+	{}
+
+	// <fill constructor>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>::static_vector(const size_type &_s, const T &_t)
+	:_data{},_size{0}
+	{
+		_check_room(_s);
+		for(; _size < _s; ++_size)
+			_data[_size] = _t;
+	}
+
+	// <copy constructor>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>::static_vector(const static_vector<T, N> &_v)
+	:_data{},_size{_v._size}
+	{
+		for(size_type i = 0; i < _size; ++i)
+			_data[i] = _v._data[i];
+	}
+
+	// <move constructor>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>::static_vector(static_vector<T, N> &&_v)
+	:_data{},_size{_v._size}
+	{
+		for(size_type i = 0; i < _size; ++i)
+			_data[i] = std::move(_v._data[i]);
+
+		_v.clear();
+	}
+
+	// <initializer_list constructor>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>::static_vector(const std::initializer_list<T> &_l)
+	:_data{},_size{0}
+	{
+		_check_room(_l.size());
+		for(const T &e : _l)
+			_data[_size++] = e;
+	}
+	// </constructors>
+
+	// <assignment operators>
+
+	// <copy assignment>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>&
+	static_vector<T, N>::operator=(const static_vector<T, N> &_v)
+	{
+		if(this != &_v)
+		{
+			clear();
+			for(; _size < _v._size; ++_size)
+				_data[_size] = _v._data[_size];
+		}
+
+		return *this;
+	}
+
+	// <move assignment>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>&
+	static_vector<T, N>::operator=(static_vector<T, N> &&_v)
+	{
+		if(this != &_v)
+		{
+			clear();
+			for(; _size < _v._size; ++_size)
+				_data[_size] = std::move(_v._data[_size]);
+
+			_v.clear();
+		}
+
+		return *this;
+	}
+
+	// <initializer_list assignment>
+	template <typename T, std::size_t N>
+	constexpr static_vector<T, N>&
+	static_vector<T, N>::operator=(const std::initializer_list<T> &_l)
+	{
+		_check_room(_l.size());
+		clear();
+		for(const T &e : _l)
+			_data[_size++] = e;
+
+		return *this;
+	}
+	// </assignment operators>
+
+	// <data access/modification>
+	template <typename T, std::size_t N>
+	constexpr void
+	static_vector<T, N>::push_back(const T &_t)
+	{
+		_check_room(_size + 1);
+		_data[_size++] = _t;
+	}
+
+	template <typename T, std::size_t N>
+	constexpr void
+	static_vector<T, N>::push_back(T &&_t)
+	{
+		_check_room(_size + 1);
+		_data[_size++] = std::move(_t);
+	}
+
+	template <typename T, std::size_t N>
+	template <typename... Args>
+	constexpr typename static_vector<T, N>::reference
+	static_vector<T, N>::emplace_back(Args &&..._args)
+	{
+		_check_room(_size + 1);
+		_data[_size] = T(std::forward<Args>(_args)...);
+		return _data[_size++];
+	}
+
+	template <typename T, std::size_t N>
+	constexpr void
+	static_vector<T, N>::pop_back(void)
+	{
+		_data[--_size] = T{};
+	}
+
+	// <swap>
+	template <typename T, std::size_t N>
+	constexpr void
+	static_vector<T, N>::swap(static_vector<T, N> &_v)
+	{
+		size_type common{(_size < _v._size) ? _size : _v._size};
+		for(size_type i = 0; i < common; ++i)
+		{
+			T tmp(std::move(_data[i]));
+			_data[i] = std::move(_v._data[i]);
+			_v._data[i] = std::move(tmp);
+		}
+
+		// <the longer one hands its tail over>
+		static_vector<T, N> &longer{(_size < _v._size) ? _v : *this};
+		static_vector<T, N> &shorter{(_size < _v._size) ? *this : _v};
+		for(size_type i = common; i < longer._size; ++i)
+		{
+			shorter._data[i] = std::move(longer._data[i]);
+			longer._data[i] = T{};
+		}
+
+		size_type tmp{_size};
+		_size = _v._size;
+		_v._size = tmp;
+	}
+
+	// <clear>
+	template <typename T, std::size_t N>
+	constexpr void
+	static_vector<T, N>::clear(void)
+	{
+		while(_size)
+			_data[--_size] = T{};
+	}
+
+	// <find>
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::iterator
+	static_vector<T, N>::find(const T &_t)
+	{
+		for(auto it = begin(); it != end(); ++it)
+			if(*it == _t)
+				return it;
+
+		return end();
+	}
+
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::const_iterator
+	static_vector<T, N>::find(const T &_t) const
+	{
+		for(auto it = cbegin(); it != cend(); ++it)
+			if(*it == _t)
+				return it;
+
+		return cend();
+	}
+	// </find>
+
+	// </data access/modification>
+
+	// <structure modification>
+
+	// <insert - shared by all overloads>
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::iterator
+	static_vector<T, N>::_insert(const size_type &_p, T &&_t)
+	{
+		_check_room(_size + 1);
+
+		for(size_type i = _size; i > _p; --i)
+			_data[i] = std::move(_data[i - 1]);
+
+		_data[_p] = std::move(_t);
+		++_size;
+
+		return iterator{_data + _p};
+	}
+
+	// <insert>
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::iterator
+	static_vector<T, N>::insert(const_iterator _it, const T &_t)
+	{
+		// <copy first, _t may be one of the shifted elements>
+		return _insert(_it - cbegin(), T(_t));
+	}
+
+	// <insert - move argument>
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::iterator
+	static_vector<T, N>::insert(const_iterator _it, T &&_t)
+	{
+		return _insert(_it - cbegin(), T(std::move(_t)));
+	}
+
+	// <erase>
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::iterator
+	static_vector<T, N>::erase(const_iterator _it)
+	{
+		return erase(_it, _it + 1);
+	}
+
+	// <erase ranged>
+	template <typename T, std::size_t N>
+	constexpr typename static_vector<T, N>::iterator
+	static_vector<T, N>::erase(const_iterator _b, const_iterator _e)
+	{
+		size_type first = _b - cbegin(), last = _e - cbegin();
+
+		for(size_type i = last; i < _size; ++i)
+			_data[first + i - last] = std::move(_data[i]);
+
+		for(size_type i = last; i > first; --i)
+			_data[--_size] = T{};
+
+		return iterator{_data + first};
+	}
+	// </structure modification>
+
+	// <capacity check>
+	template <typename T, std::size_t N>
+	constexpr void
+	static_vector<T, N>::_check_room(const size_type &_n) const
+	{
+		if(_n > N)
+			throw std::length_error("static_vector: capacity exceeded");
+	}
+
+// </implementation>
+
+}
+
+#endif
@@ -0,0 +1,215 @@
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// <author info>
+// 	<name>
+// 		Stefan Pantic
+// 	<github>
+// 		https://github.com/syIar/Container-classes
+// 	<university>
+// 		University of Belgrade, Faculty of Mathematics, second year student
+// 	<year>
+// 		Second
+// 	<email>
+// 		stefanpantic13@gmail.com
+// </author info>
+//
+// <description>
+// Bulk scans and writes over container::vector that do not go through the
+// iterator class and do not pollute the cache.
+// for_each_streaming() walks the raw buffer and prefetches ahead, fill_nt()
+// and copy_nt() write with non-temporal (streaming) stores.
+// The vector overloads only stream when the buffer is larger than the last
+// level cache, smaller buffers are better off staying in cache. The pointer
+// overloads always stream.
+// Streaming stores need SSE2 and a trivially copyable T, everything else falls
+// back to std::fill/std::copy.
+// </description>
+// =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _STREAMING_HPP_
+#define _STREAMING_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "Vector.hpp"
+
+namespace container
+{
+
+// <streaming parameters>
+	// <how far ahead for_each_streaming() prefetches>
+	constexpr std::size_t prefetch_distance = 512;
+
+	// <size in bytes above which the vector overloads stream>
+	inline std::size_t
+	streaming_threshold(void)
+	{
+		static const std::size_t threshold{[] {
+			long llc{-1};
+#ifdef _SC_LEVEL3_CACHE_SIZE
+			llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+			if(0 >= llc)
+				llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+			return (0 < llc) ? static_cast<std::size_t>(llc) : std::size_t{8} << 20;
+		}()};
+
+		return threshold;
+	}
+// </streaming parameters>
+
+namespace detail
+{
+
+	// <true if streaming stores can be used for T at all>
+	template <typename T>
+	struct _streamable
+		: std::integral_constant<bool,
+#ifdef __SSE2__
+			std::is_trivially_copyable<T>::value && 0 == 16 % sizeof(T)
+#else
+			false
+#endif
+		>
+	{};
+
+	inline bool
+	_aligned(const void *_p)
+	{
+		return 0 == reinterpret_cast<std::uintptr_t>(_p) % 16;
+	}
+
+}
+
+// <pointer range versions>
+
+	// <calls _f on every element in [_b, _e), prefetching ahead of the scan>
+	template <typename T, typename F>
+	F
+	for_each_streaming(T *_b, T *_e, F _f)
+	{
+		constexpr std::size_t ahead{(prefetch_distance / sizeof(T)) ? prefetch_distance / sizeof(T) : 1};
+
+		T *p{_b};
+		for(; _e - p > static_cast<std::ptrdiff_t>(ahead); ++p)
+		{
+			__builtin_prefetch(p + ahead, 0, 0);
+			_f(*p);
+		}
+		for(; p != _e; ++p)
+			_f(*p);
+
+		return _f;
+	}
+
+	// <assigns _t to every element in [_b, _e) with streaming stores>
+	template <typename T>
+	void
+	fill_nt(T *_b, T *_e, const T &_t)
+	{
+#ifdef __SSE2__
+		if constexpr(detail::_streamable<T>::value)
+		{
+			// <scalar stores until the destination is 16 byte aligned>
+			while(_b != _e && !detail::_aligned(_b))
+				*_b++ = _t;
+
+			if(_b == _e)
+				return;
+
+			alignas(16) unsigned char pattern[16];
+			for(std::size_t i = 0; i < 16; i += sizeof(T))
+				std::memcpy(pattern + i, &_t, sizeof(T));
+
+			const __m128i value{_mm_load_si128(reinterpret_cast<const __m128i*>(pattern))};
+			constexpr std::size_t per_store{16 / sizeof(T)};
+
+			for(; static_cast<std::size_t>(_e - _b) >= per_store; _b += per_store)
+				_mm_stream_si128(reinterpret_cast<__m128i*>(_b), value);
+
+			_mm_sfence();
+		}
+#endif
+		std::fill(_b, _e, _t);
+	}
+
+	// <copies [_b, _e) to _d with streaming stores, returns the end of the destination>
+	template <typename T>
+	T*
+	copy_nt(const T *_b, const T *_e, T *_d)
+	{
+#ifdef __SSE2__
+		if constexpr(detail::_streamable<T>::value)
+		{
+			while(_b != _e && !detail::_aligned(_d))
+				*_d++ = *_b++;
+
+			constexpr std::size_t per_store{16 / sizeof(T)};
+			for(; static_cast<std::size_t>(_e - _b) >= per_store; _b += per_store, _d += per_store)
+				_mm_stream_si128(reinterpret_cast<__m128i*>(_d),
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(_b)));
+
+			_mm_sfence();
+		}
+#endif
+		return std::copy(_b, _e, _d);
+	}
+
+// </pointer range versions>
+
+// <container::vector versions>
+
+	template <typename T, typename A, typename F>
+	F
+	for_each_streaming(const vector<T, A> &_v, F _f)
+	{
+		if(_v.size() * sizeof(T) < streaming_threshold())
+			return std::for_each(_v.data(), _v.data() + _v.size(), _f);
+
+		return for_each_streaming(_v.data(), _v.data() + _v.size(), _f);
+	}
+
+	template <typename T, typename A, typename F>
+	F
+	for_each_streaming(vector<T, A> &_v, F _f)
+	{
+		if(_v.size() * sizeof(T) < streaming_threshold())
+			return std::for_each(_v.data(), _v.data() + _v.size(), _f);
+
+		return for_each_streaming(_v.data(), _v.data() + _v.size(), _f);
+	}
+
+	template <typename T, typename A>
+	void
+	fill_nt(vector<T, A> &_v, const T &_t)
+	{
+		if(_v.size() * sizeof(T) < streaming_threshold())
+			std::fill(_v.data(), _v.data() + _v.size(), _t);
+		else
+			fill_nt(_v.data(), _v.data() + _v.size(), _t);
+	}
+
+	// <copies the elements of _s over the first _s.size() elements of _d>
+	// <NOTE: _d has to be at least as large as _s, it is not resized>
+	template <typename T, typename A1, typename A2>
+	void
+	copy_nt(const vector<T, A1> &_s, vector<T, A2> &_d)
+	{
+		if(_s.size() * sizeof(T) < streaming_threshold())
+			std::copy(_s.data(), _s.data() + _s.size(), _d.data());
+		else
+			copy_nt(_s.data(), _s.data() + _s.size(), _d.data());
+	}
+
+// </container::vector versions>
+
+}
+
+#endif
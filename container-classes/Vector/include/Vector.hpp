@@ -21,10 +21,12 @@
 // =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #ifndef _VECTOR_HPP_
+#define _VECTOR_HPP_
 
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <utility>
 
 namespace container
 {
@@ -117,7 +119,7 @@ namespace container
 					// </typedefs>
 
 					// <constructors>
-					const_iterator(T *_p = nullptr);
+					const_iterator(const T *_p = nullptr);
 					const_iterator(const const_iterator &_cit);
 					const_iterator(const iterator &_cit);
 					const_iterator(const_iterator &&_cit);
@@ -193,12 +195,15 @@ namespace container
 			const_reference back(void) const;
 			void swap(vector<T, A> &_v);
 			void clear(void);
+			void reserve(const size_type &_n);
 			iterator find(const T &_t);
 			const_iterator find(const T &_t) const;
 			inline reference operator[](const size_type &_p) { return _data[_p]; }
 			inline reference at(const size_type &_p) { return _data[_p]; };
 			inline const_reference operator[](const size_type &_p) const { return _data[_p]; }
 			inline const_reference at(const size_type &_p) const { return _data[_p]; }
+			inline pointer data(void) { return _data; }
+			inline const value_type* data(void) const { return _data; }
 			// </data access/modification>
 
 			// <iterators>
@@ -228,9 +233,19 @@ namespace container
 			// </iterators>
 
 			inline size_type size(void) const { return _size; }
+			inline size_type capacity(void) const { return _alloc; }
 			inline bool empty() const { return (0 == _size) ? true : false; }
 
 		private:
+			// <growth>
+			typedef std::allocator_traits<A> _traits;
+			inline size_type _next_capacity(void) const { return (2 > _alloc) ? _alloc + 1 : _alloc + _alloc / 2; }
+			void _reallocate(const size_type &_n);
+			void _release(void);
+			template <typename U>
+			iterator _insert(const size_type &_p, U &&_t);
+			// </growth>
+
 			// <data>
 			allocator_type _allocator;
 			value_type *_data;
@@ -471,7 +486,7 @@ namespace container
 
 	// <default constructor>
 	template <typename T, typename A>
-	vector<T, A>::const_iterator::const_iterator(T *_p)
+	vector<T, A>::const_iterator::const_iterator(const T *_p)
 	:_current{_p}
 	{}
 
@@ -643,7 +658,7 @@ namespace container
 	{
 		const_iterator ret{*this};
 		this->prev();
-		return *this;
+		return ret;
 	}
 
 	// <addition operators>
@@ -714,56 +729,53 @@ namespace container
 	// <default constructor>
 	template <typename T, typename A>
 	vector<T, A>::vector(const size_type &_s, const T &_t)
-	:_allocator{},_data{nullptr},_size{_s},_alloc{(3 > _s) ? 10 : _s}
+	:_allocator{},_data{nullptr},_size{0},_alloc{(3 > _s) ? 10 : _s}
 	{
-		_data = _allocator.allocate(_alloc);
+		_data = _traits::allocate(_allocator, _alloc);
 
-		for(size_type i = 0; i < _size; ++i)
-			_allocator.construct(_data + i, _t);
+		for(; _size < _s; ++_size)
+			_traits::construct(_allocator, _data + _size, _t);
 	}
 
-	// <copy constructor>
+	// <copy constructor - a moved-from source has no buffer and gets none>
 	template <typename T, typename A>
 	vector<T, A>::vector(const vector<T, A> &_v)
-	:_allocator{_v._allocator},_data{nullptr},_size{_v._size},_alloc{_v._alloc}
+	:_allocator{_v._allocator},_data{nullptr},_size{0},_alloc{_v._alloc}
 	{
-		_data = _allocator.allocate(_alloc);
+		if(_alloc)
+			_data = _traits::allocate(_allocator, _alloc);
 
-		for(int i = 0; i < _size; ++i)
-			_allocator.construct(_data + i, _v[i]);
+		for(; _size < _v._size; ++_size)
+			_traits::construct(_allocator, _data + _size, _v[_size]);
 	}
 
 	// <move constructor>
 	template <typename T, typename A>
 	vector<T, A>::vector(vector &&_v)
-	:_allocator{std::move(_v._allocator)},_data{std::move(_v._data)},_size{_v._size},_alloc{_v._alloc}
+	:_allocator{std::move(_v._allocator)},_data{_v._data},_size{_v._size},_alloc{_v._alloc}
 	{
+		_v._data = nullptr;
 		_v._size = 0;
 		_v._alloc = 0;
 	}
 
-	// <initializer_list constructor>
+	// <initializer_list constructor - no buffer for an empty list>
 	template <typename T, typename A>
 	vector<T, A>::vector(const std::initializer_list<T> &_l)
-	:_allocator{},_data{nullptr},_size{_l.size()},_alloc{_l.size()}
+	:_allocator{},_data{nullptr},_size{0},_alloc{_l.size()}
 	{
-		_data = _allocator.allocate(_alloc);
+		if(_alloc)
+			_data = _traits::allocate(_allocator, _alloc);
 
-		for(int i = 0; i < _size; ++i)
-			_allocator.construct(_data + i, *(_l.begin() + i));
+		for(const T &e : _l)
+			_traits::construct(_allocator, _data + _size++, e);
 	}
 
 	// <deconstructor>
 	template <typename T, typename A>
 	vector<T, A>::~vector()
 	{
-		if(_alloc)
-		{
-			for(int i = 0; i < _size; ++i)
-				_allocator.destroy(_data + i);
-
-			_allocator.deallocate(_data, _alloc);
-		}
+		_release();
 	}
 	// </constructors>
 
@@ -774,31 +786,49 @@ namespace container
 	vector<T, A>&
 	vector<T, A>::operator=(const vector<T, A> &_v)
 	{
-		this->clear();
-		_alloc = _v._alloc;
-		_size = _v._size;
-
-		_data = _allocator.allocate(_alloc);
-
-		for(int i = 0; i < _size; ++i)
-			_allocator.construct(_data + i, _v[i]);
+		if(this != &_v)
+		{
+			vector<T, A> tmp{_v};
+			this->swap(tmp);
+		}
 
 		return *this;
 	}
 
 	// <move assignment>
+	// <NOTE: the buffer of _v is taken over only if _allocator can free it afterwards, i.e. the
+	//  allocator propagates on move assignment or the two compare equal, otherwise the elements
+	//  are moved one by one into a buffer of our own>
 	template <typename T, typename A>
 	vector<T, A>&
 	vector<T, A>::operator=(vector &&_v)
 	{
-		this->clear();
-		_data = _v._data;
-		_alloc = _v._allocator;
-		_size = _v._size;
+		if(this == &_v)
+			return *this;
 
-		_v._data = nullptr;
-		_v._alloc = 0;
-		_v._size = 0;
+		if(_traits::propagate_on_container_move_assignment::value || _allocator == _v._allocator)
+		{
+			_release();
+			if constexpr(_traits::propagate_on_container_move_assignment::value)
+				_allocator = std::move(_v._allocator);
+
+			_data = _v._data;
+			_alloc = _v._alloc;
+			_size = _v._size;
+
+			_v._data = nullptr;
+			_v._alloc = 0;
+			_v._size = 0;
+		}
+		else
+		{
+			clear();
+			reserve(_v._size);
+			for(; _size < _v._size; ++_size)
+				_traits::construct(_allocator, _data + _size, std::move(_v._data[_size]));
+
+			_v.clear();
+		}
 
 		return *this;
 	}
@@ -808,18 +838,72 @@ namespace container
 	vector<T, A>&
 	vector<T, A>::operator=(const std::initializer_list<T> &_l)
 	{
-		this->clear();
-		_alloc = _size = _l.size();
-
-		_data = _allocator.allocate(_alloc);
-
-		for(int i = 0; i < _size; ++i)
-			_allocator.construct(_data + i, *(_l.begin() + i));
+		vector<T, A> tmp{_l};
+		this->swap(tmp);
 
 		return *this;
 	}
 	// </assignment operators>
 
+	// <growth>
+
+	// <relocate all elements into a buffer of _n elements>
+	// <NOTE: elements are moved if their move constructor is noexcept and copied otherwise,
+	//  so if a copy throws the new buffer is released and *this is left untouched>
+	template <typename T, typename A>
+	void
+	vector<T, A>::_reallocate(const size_type &_n)
+	{
+		T *tmp{_traits::allocate(_allocator, _n)};
+		size_type constructed{0};
+
+		try
+		{
+			for(; constructed < _size; ++constructed)
+				_traits::construct(_allocator, tmp + constructed, std::move_if_noexcept(_data[constructed]));
+		}
+		catch(...)
+		{
+			for(size_type i = 0; i < constructed; ++i)
+				_traits::destroy(_allocator, tmp + i);
+
+			_traits::deallocate(_allocator, tmp, _n);
+			throw;
+		}
+
+		size_type size{_size};
+		_release();
+		_data = tmp;
+		_size = size;
+		_alloc = _n;
+	}
+
+	// <destroy all elements and give the buffer back with the size it was allocated with>
+	template <typename T, typename A>
+	void
+	vector<T, A>::_release(void)
+	{
+		for(size_type i = 0; i < _size; ++i)
+			_traits::destroy(_allocator, _data + i);
+
+		if(_alloc)
+			_traits::deallocate(_allocator, _data, _alloc);
+
+		_data = nullptr;
+		_size = 0;
+		_alloc = 0;
+	}
+
+	// <reserve>
+	template <typename T, typename A>
+	void
+	vector<T, A>::reserve(const size_type &_n)
+	{
+		if(_n > _alloc)
+			_reallocate(_n);
+	}
+	// </growth>
+
 	// <data access/modification>
 	template <typename T, typename A>
 	void
@@ -827,18 +911,15 @@ namespace container
 	{
 		if(_alloc == _size)
 		{
-			T *tmp{nullptr};
-			_alloc *= (1.5);
-
-			tmp = _allocator.allocate(_alloc);
-
-			std::move(this->begin(), this->end(), tmp);
-			_allocator.deallocate(_data, _size);
-			_data = tmp;
-			tmp = nullptr;
+			// <_t may live inside the buffer that is about to be released>
+			T tmp(_t);
+			_reallocate(_next_capacity());
+			_traits::construct(_allocator, _data + _size, std::move(tmp));
 		}
+		else
+			_traits::construct(_allocator, _data + _size, _t);
 
-		_allocator.construct(_data + _size++, _t);
+		++_size;
 	}
 
 	template <typename T, typename A>
@@ -847,18 +928,14 @@ namespace container
 	{
 		if(_alloc == _size)
 		{
-			T *tmp{nullptr};
-			_alloc *= (1.5);
-
-			tmp = _allocator.allocate(_alloc);
-
-			std::move(this->begin(), this->end(), tmp);
-			_allocator.deallocate(_data, _size);
-			_data = tmp;
-			tmp = nullptr;
+			T tmp(std::move(_t));
+			_reallocate(_next_capacity());
+			_traits::construct(_allocator, _data + _size, std::move(tmp));
 		}
+		else
+			_traits::construct(_allocator, _data + _size, std::move(_t));
 
-		_allocator.construct(_data + _size++, std::move(_t));
+		++_size;
 	}
 
 
@@ -866,7 +943,7 @@ namespace container
 	void
 	vector<T, A>::pop_back(void)
 	{
-		--_size;
+		_traits::destroy(_allocator, _data + --_size);
 	}
 
 	template <typename T, typename A>
@@ -894,19 +971,15 @@ namespace container
 		std::swap(_allocator, _v._allocator);
 	}
 
-	// <clear>
+	// <clear - capacity is kept>
 	template <typename T, typename A>
 	void
 	vector<T, A>::clear(void)
 	{
-		_allocator.deallocate(_data, _alloc);
-		for(int i = 0; i < _size; ++i)
-			_allocator.destroy(_data + i);
+		for(size_type i = 0; i < _size; ++i)
+			_traits::destroy(_allocator, _data + i);
 
 		_size = 0;
-		_alloc = 10;
-
-		_data = _allocator.allocate(_alloc);
 	}
 
 	// <find>
@@ -1025,31 +1098,38 @@ namespace container
 
 	// <structure modification>
 
-	// <insert>
+	// <insert - shared by all overloads>
 	template <typename T, typename A>
+	template <typename U>
 	typename vector<T, A>::iterator
-	vector<T, A>::insert(iterator &_it, const T &_t)
+	vector<T, A>::_insert(const size_type &_p, U &&_t)
 	{
-		if(_alloc == _size)
-		{
-			long base{_it._current - _data};
-			T *tmp{nullptr};
-			_alloc *= (1.5);
+		// <_t may live inside the buffer that is about to be shifted or released>
+		T tmp(std::forward<U>(_t));
 
-			tmp = _allocator.allocate(_alloc);
+		if(_alloc == _size)
+			_reallocate(_next_capacity());
 
-			std::move(this->begin(), this->end(), tmp);
-			_allocator.deallocate(_data, _size);
-			_data = tmp;
-			_it._current = _data + base;
-			tmp = nullptr;
+		if(_p == _size)
+			_traits::construct(_allocator, _data + _size, std::move(tmp));
+		else
+		{
+			// <the slot past the end is raw memory, so it is constructed, not assigned>
+			_traits::construct(_allocator, _data + _size, std::move(_data[_size - 1]));
+			std::move_backward(_data + _p, _data + _size - 1, _data + _size);
+			_data[_p] = std::move(tmp);
 		}
-
-		std::move_backward(_it, this->end(), std::next(this->end()));
-		_allocator.construct(_it._current, _t);
 		++_size;
 
-		return _it;
+		return iterator{_data + _p};
+	}
+
+	// <insert>
+	template <typename T, typename A>
+	typename vector<T, A>::iterator
+	vector<T, A>::insert(iterator &_it, const T &_t)
+	{
+		return _it = _insert(_it._current - _data, _t);
 	}
 
 	// <insert - move iterator>
@@ -1057,26 +1137,7 @@ namespace container
 	typename vector<T, A>::iterator
 	vector<T, A>::insert(iterator &&_it, const T &_t)
 	{
-		if(_alloc == _size)
-		{
-			long base{_it._current - _data};
-			T *tmp{nullptr};
-			_alloc *= (1.5);
-
-			tmp = _allocator.allocate(_alloc);
-
-			std::move(this->begin(), this->end(), tmp);
-			_allocator.deallocate(_data, _size);
-			_data = tmp;
-			_it._current = _data + base;
-			tmp = nullptr;
-		}
-
-		std::move_backward(_it, this->end(), std::next(this->end()));
-		_allocator.construct(_it._current, _t);
-		++_size;
-
-		return _it;
+		return _insert(_it._current - _data, _t);
 	}
 
 	// <insert - move argument>
@@ -1084,26 +1145,7 @@ namespace container
 	typename vector<T, A>::iterator
 	vector<T, A>::insert(iterator &_it, T &&_t)
 	{
-		if(_alloc == _size)
-		{
-			long base{_it._current - _data};
-			T *tmp{nullptr};
-			_alloc *= (1.5);
-
-			tmp = _allocator.allocate(_alloc);
-
-			std::move(this->begin(), this->end(), tmp);
-			_allocator.deallocate(_data, _size);
-			_data = tmp;
-			_it._current = _data + base;
-			tmp = nullptr;
-		}
-
-		std::move_backward(_it, this->end(), std::next(this->end()));
-		_allocator.construct(_it._current, std::move(_t));
-		++_size;
-
-		return _it;
+		return _it = _insert(_it._current - _data, std::move(_t));
 	}
 
 	// <insert - move iterator, move argument>
@@ -1111,26 +1153,7 @@ namespace container
 	typename vector<T, A>::iterator
 	vector<T, A>::insert(iterator &&_it, T &&_t)
 	{
-		if(_alloc == _size)
-		{
-			long base{_it._current - _data};
-			T *tmp{nullptr};
-			_alloc *= (1.5);
-
-			tmp = _allocator.allocate(_alloc);
-
-			std::move(this->begin(), this->end(), tmp);
-			_allocator.deallocate(_data, _size);
-			_data = tmp;
-			_it._current = _data + base;
-			tmp = nullptr;
-		}
-
-		std::move_backward(_it, this->end(), std::next(this->end()));
-		_allocator.construct(_it._current, std::move(_t));
-		++_size;
-
-		return _it;
+		return _insert(_it._current - _data, std::move(_t));
 	}
 
 
@@ -1143,7 +1166,7 @@ namespace container
 			return _it;
 
 		std::move(_it + 1, this->end(), _it);
-		--_size;
+		_traits::destroy(_allocator, _data + --_size);
 
 		return _it;
 	}
@@ -1157,7 +1180,7 @@ namespace container
 			return _it;
 
 		std::move(_it + 1, this->end(), _it);
-		--_size;
+		_traits::destroy(_allocator, _data + --_size);
 
 		return _it;
 	}
@@ -1172,7 +1195,8 @@ namespace container
 
 		long len{_e - _b};
 		std::move(_e, this->end(), _b);
-		_size -= len;
+		for(long i = 0; i < len; ++i)
+			_traits::destroy(_allocator, _data + --_size);
 
 		return _b;
 	}
@@ -1187,7 +1211,8 @@ namespace container
 
 		long len{_e - _b};
 		std::move(_e, this->end(), _b);
-		_size -= len;
+		for(long i = 0; i < len; ++i)
+			_traits::destroy(_allocator, _data + --_size);
 
 		return _b;
 	}
@@ -29,12 +29,15 @@
 #include <boost/pool/pool_alloc.hpp>
 #include <cppunit/ui/text/TextTestRunner.h>
 #include "./cppunit/vector.test.hpp"
+#include "./cppunit/bit_vector.test.hpp"
+#include "./cppunit/static_vector.test.hpp"
+#include "./cppunit/spsc_queue.test.hpp"
 #include "./cppunit/test_info/info.hpp"
 
 int
 main (void)
 {
-	CppUnit::TextTestRunner runner1, runner2, runner3;
+	CppUnit::TextTestRunner runner1, runner2, runner3, runner4, runner5, runner6;
 
 	test_info("double", "std::allocator", 30000000);
 	runner1.addTest(CppUnit::TestFactoryRegistry::getRegistry("value_type=double, allocator=std::allocator<double>, size=30,000,000").makeTest());
@@ -48,5 +51,17 @@ main (void)
 	runner3.addTest(CppUnit::TestFactoryRegistry::getRegistry("value_type=double, allocator=boost::fast_pool_allocator<double>, size=30,000,000").makeTest());
 	runner3.run();
 
+	test_info("bool (bit_vector)", "std::allocator", 1000000);
+	runner4.addTest(CppUnit::TestFactoryRegistry::getRegistry("bit_vector, allocator=std::allocator<std::uint64_t>, size=1,000,000").makeTest());
+	runner4.run();
+
+	test_info("double (static_vector)", "none, inline storage", 4096);
+	runner5.addTest(CppUnit::TestFactoryRegistry::getRegistry("static_vector, value_type=double, capacity=4096").makeTest());
+	runner5.run();
+
+	test_info("size_t (spsc_queue)", "std::allocator", 1000000);
+	runner6.addTest(CppUnit::TestFactoryRegistry::getRegistry("spsc_queue, value_type=size_t, capacity=1,024, count=1,000,000").makeTest());
+	runner6.run();
+
 	return 0;
 }